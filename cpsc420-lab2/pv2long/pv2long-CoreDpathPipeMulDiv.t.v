@@ -202,6 +202,29 @@ module tester;
   end
   `VC_TEST_CASE_END
 
-  `VC_TEST_SUITE_END( 4 )
+  `VC_TEST_CASE_BEGIN( 5, "signed mul" )
+  begin
+
+    t0.src.src.m[ 0] = 67'h0_deadbeef_deadbeef; t0.sink.sink.m[ 0] = 64'h04564f34_216da321;
+    t0.src.src.m[ 1] = 67'h0_80000001_fffffffd; t0.sink.sink.m[ 1] = 64'h00000001_7ffffffd;
+    t0.src.src.m[ 2] = 67'h0_fffffff8_fffffff8; t0.sink.sink.m[ 2] = 64'h00000000_00000040;
+    t0.src.src.m[ 3] = 67'h0_80000000_ffffffff; t0.sink.sink.m[ 3] = 64'h00000000_80000000;
+    t0.src.src.m[ 4] = 67'h0_ffffffff_80000000; t0.sink.sink.m[ 4] = 64'h00000000_80000000;
+    t0.src.src.m[ 5] = 67'h0_80000000_80000000; t0.sink.sink.m[ 5] = 64'h40000000_00000000;
+    t0.src.src.m[ 6] = 67'h0_80000000_00000001; t0.sink.sink.m[ 6] = 64'hffffffff_80000000;
+    t0.src.src.m[ 7] = 67'h0_7fffffff_80000000; t0.sink.sink.m[ 7] = 64'hc0000000_80000000;
+    t0.src.src.m[ 8] = 67'h0_7fffffff_7fffffff; t0.sink.sink.m[ 8] = 64'h3fffffff_00000001;
+    t0.src.src.m[ 9] = 67'h0_ffffffff_00000001; t0.sink.sink.m[ 9] = 64'hffffffff_ffffffff;
+    t0.src.src.m[10] = 67'h0_00000001_ffffffff; t0.sink.sink.m[10] = 64'hffffffff_ffffffff;
+    t0.src.src.m[11] = 67'h0_ffffffff_ffffffff; t0.sink.sink.m[11] = 64'h00000000_00000001;
+
+    #5;   t0_reset = 1'b1;
+    #20;  t0_reset = 1'b0;
+    #10000; `VC_TEST_CHECK( "Is sink finished?", t0_done )
+
+  end
+  `VC_TEST_CASE_END
+
+  `VC_TEST_SUITE_END( 5 )
 
 endmodule
\ No newline at end of file
@@ -0,0 +1,313 @@
+//========================================================================
+// batchrunner.h : Run many target programs from one process
+//========================================================================
+// batch_runner_t runs a list of ELF files, each to completion, in up to
+// njobs forked children at a time and prints a single pass/fail
+// summary. It replaces starting one simulator process per test, where
+// most of the time goes to process startup and building the dispatch
+// tables rather than simulating.
+//
+// run() builds the CP and VP dispatch tables once, before the first
+// fork, so every child starts with them already built. No child writes
+// them, so their pages stay shared, copy-on-write, across children.
+// Each program then gets its own simulator_t, htif_mavenfs_t and
+// appserver_t in its own child, so the process globals a run updates
+// (maven::g_cop0_count, g_stat_cycle_count, softfloat's rounding mode
+// and exception flags) and any exit() or crash on the way stay in that
+// child.
+//
+// Jobs are not run on a pool of threads in one process, each with its
+// own Memory and simulator_t, because the prebuilt objects rule it out:
+//
+//  - libsft's softfloat.o defines float_rounding_mode and
+//    float_exception_flags as plain globals, which every softfloat
+//    routine reads and writes, so concurrent FP programs would round
+//    and flag with each other's state;
+//  - maven::g_cop0_count and g_stat_cycle_count are defined by the
+//    processor objects, which are not part of this package, and are
+//    written on every instruction, so they cannot be made per-thread
+//    from here;
+//  - simulator.o and appserver.o call exit() on a bad syscall or a
+//    panic, which would end every job in the process.
+//
+// A thread pool needs those globals made thread-local and exit()
+// turned into an error return, and the libraries rebuilt.
+//
+// The child sends its result back over a pipe. A child which ends
+// without sending one, by calling exit() itself or dying on a signal,
+// is recorded with its exit status and no counts.
+//
+// batchrun_main() is a main for a batch front end over the runner.
+//
+// A program passes if it exits with status 0. Its instruction count is
+// the cop0 count register at exit, which counts every instruction the
+// program retired on any core, and its cycle count is simulator_t's.
+
+#ifndef __BATCHRUNNER_H
+#define __BATCHRUNNER_H
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "maven-global.h"
+#include "maven-ISA.h"
+#include "simulator.h"
+#include "htif_mavenfs.h"
+#include "appserver.h"
+
+class batch_runner_t
+{
+public:
+  struct result_t
+  {
+    std::string elf;
+    int exit_code;
+    long long insts;
+    long long cycles;
+    double seconds;
+  };
+
+  batch_runner_t(int _njobs)
+    : njobs(_njobs > 0 ? _njobs : 1)
+    , envp(NULL)
+  {
+  }
+
+  void add(const char* elf)
+  {
+    result_t r;
+    r.elf = elf;
+    r.exit_code = -1;
+    r.insts = 0;
+    r.cycles = 0;
+    r.seconds = 0.0;
+    results.push_back(r);
+  }
+
+  // Run every program added so far. Returns the number that failed.
+  int run(char* _envp[])
+  {
+    envp = _envp;
+
+    // Build the dispatch tables once for every child to inherit
+    MavenCPISA::dt();
+    MavenVPISA::dt();
+
+    std::map<pid_t,child_t> running;
+    size_t next = 0;
+    while (next < results.size() || !running.empty())
+    {
+      if (next < results.size() && (int) running.size() < njobs)
+      {
+        child_t c;
+        if (start(next, c))
+          running[c.pid] = c;
+        next++;
+        continue;
+      }
+
+      int status;
+      pid_t pid = waitpid(-1, &status, 0);
+      if (pid < 0)
+        break;
+      if (running.count(pid))
+      {
+        finish(running[pid], status);
+        running.erase(pid);
+      }
+    }
+
+    int nfail = 0;
+    for (size_t i=0; i<results.size(); i++)
+      nfail += results[i].exit_code != 0;
+    return nfail;
+  }
+
+  void dump_summary(FILE* fp)
+  {
+    long long insts = 0;
+    long long cycles = 0;
+    double seconds = 0.0;
+    int npass = 0;
+
+    fprintf(fp, "%-6s %-40s %14s %14s %10s\n",
+            "result", "program", "insts", "cycles", "seconds");
+    for (size_t i=0; i<results.size(); i++)
+    {
+      const result_t& r = results[i];
+      fprintf(fp, "%-6s %-40s %14lld %14lld %10.3f\n",
+              r.exit_code == 0 ? "PASS" : "FAIL", short_name(r.elf),
+              r.insts, r.cycles, r.seconds);
+      npass += r.exit_code == 0;
+      insts += r.insts;
+      cycles += r.cycles;
+      seconds += r.seconds;
+    }
+    fprintf(fp, "%d of %d passed, %lld insts, %lld cycles, %.3f seconds\n",
+            npass, (int) results.size(), insts, cycles, seconds);
+  }
+
+  const std::vector<result_t>& get_results() const
+  {
+    return results;
+  }
+
+private:
+  struct child_t
+  {
+    pid_t pid;
+    int fd;   // read end of the result pipe
+    size_t job;
+  };
+
+  // What a child writes to the pipe, well under PIPE_BUF so it arrives
+  // in one piece
+  struct report_t
+  {
+    int exit_code;
+    long long insts;
+    long long cycles;
+    double seconds;
+  };
+
+  // Fork a child to run results[job]. Returns false, marking the job
+  // failed, if that is not possible.
+  bool start(size_t job, child_t& c)
+  {
+    int fds[2];
+    if (pipe(fds) != 0)
+    {
+      perror("batch_runner_t: pipe");
+      return false;
+    }
+
+    // Otherwise the child would print the parent's buffered output again
+    fflush(stdout);
+    fflush(stderr);
+
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+      perror("batch_runner_t: fork");
+      close(fds[0]);
+      close(fds[1]);
+      return false;
+    }
+
+    if (pid == 0)
+    {
+      close(fds[0]);
+      report_t rep = run_one(results[job]);
+      fflush(stdout);
+      fflush(stderr);
+      ssize_t n = write(fds[1], &rep, sizeof(rep));
+      _exit(n == sizeof(rep) ? 0 : 1);
+    }
+
+    close(fds[1]);
+    c.pid = pid;
+    c.fd = fds[0];
+    c.job = job;
+    return true;
+  }
+
+  void finish(const child_t& c, int status)
+  {
+    result_t& r = results[c.job];
+    report_t rep;
+    if (read(c.fd, &rep, sizeof(rep)) == sizeof(rep))
+    {
+      r.exit_code = rep.exit_code;
+      r.insts = rep.insts;
+      r.cycles = rep.cycles;
+      r.seconds = rep.seconds;
+    }
+    else if (WIFEXITED(status))
+      r.exit_code = WEXITSTATUS(status);
+    else
+    {
+      fprintf(stderr, "%s: killed by signal %d\n", r.elf.c_str(), WTERMSIG(status));
+      r.exit_code = -1;
+    }
+    close(c.fd);
+  }
+
+  // Runs in the child
+  report_t run_one(const result_t& r)
+  {
+    maven::g_cop0_count = 0;
+    maven::g_stat_cycle_count = 0;
+    float_rounding_mode = float_round_nearest_even;
+    float_exception_flags = 0;
+
+    struct timeval start, end;
+    gettimeofday(&start, NULL);
+
+    simulator_t sim;
+    htif_mavenfs_t htif(sim);
+    appserver_t app(htif);
+
+    report_t rep;
+    char name[] = "maven-batch";
+    char* argv[] = { name, (char*) r.elf.c_str(), NULL };
+    rep.exit_code = app.test(2, argv, envp);
+
+    gettimeofday(&end, NULL);
+    rep.insts = maven::g_cop0_count;
+    rep.cycles = sim.cycle;
+    rep.seconds = (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec) / 1e6;
+    return rep;
+  }
+
+  static const char* short_name(const std::string& path)
+  {
+    const char* s = strrchr(path.c_str(), '/');
+    return s ? s+1 : path.c_str();
+  }
+
+  int njobs;
+  char** envp;
+
+  std::vector<result_t> results;
+};
+
+//------------------------------------------------------------------------
+// batchrun_main
+//------------------------------------------------------------------------
+// Usage: <prog> [-j <jobs>] <elf>...
+//
+// Runs the programs with up to <jobs> at a time, one per online host
+// CPU by default, and prints the summary. Returns 0 if every program
+// passed and 1 otherwise.
+
+inline int batchrun_main(int argc, char* argv[], char* envp[])
+{
+  long njobs = sysconf(_SC_NPROCESSORS_ONLN);
+  int i = 1;
+  if (i+1 < argc && strcmp(argv[i], "-j") == 0)
+  {
+    njobs = atoi(argv[i+1]);
+    i += 2;
+  }
+  if (i == argc || njobs < 1)
+  {
+    printf("usage: %s [-j <jobs>] <elf>...\n", argv[0]);
+    return 1;
+  }
+
+  batch_runner_t runner(njobs);
+  for (; i<argc; i++)
+    runner.add(argv[i]);
+
+  int nfail = runner.run(envp);
+  runner.dump_summary(stdout);
+  return nfail ? 1 : 0;
+}
+
+#endif // __BATCHRUNNER_H
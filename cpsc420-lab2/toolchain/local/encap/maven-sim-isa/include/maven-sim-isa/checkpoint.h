@@ -0,0 +1,338 @@
+//========================================================================
+// checkpoint.h : Architectural checkpoints of a simulator_t
+//========================================================================
+// A checkpoint holds the architectural state of every core (CP and VP
+// registers, pc/npc, hi/lo, FPU and the cop0 registers kept in the
+// state), the global counters, and the pages of Memory the program has
+// changed. If Memory::arm_dirty_tracking was called once the ELF was
+// loaded, those are the pages stored to since then, so the file is
+// roughly the size of the data the program wrote; otherwise it is every
+// page that is not all zeros.
+//
+// Checkpoints are taken between calls to run_to_tohost. At that point
+// every VP has run to completion, so the PVFB and the scoreboard are
+// empty and only the VP register state needs saving.
+//
+// The same transfer routines read and write, so the two directions
+// cannot drift apart. The format is host-endian and tied to
+// MAVEN_SYSCFG_* values, which are checked on restore.
+//
+// To restore, construct and configure the simulator as usual
+// (set_num_cores, set_num_physical_regs, set_impl_flags), load the same
+// ELF with the same arguments, then call checkpoint_t::restore before
+// running. A dirty-page checkpoint leaves every page it does not list
+// as the load left it.
+//
+// save_state/restore_state move everything except Memory to and from a
+// host buffer instead of a file, for in-process snapshots (snapshot.h).
+
+#ifndef __CHECKPOINT_H
+#define __CHECKPOINT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "simulator.h"
+#include "maven-global.h"
+#include "maven-PerfCounters.h"
+#include "mips32-Processor.h"
+
+class checkpoint_t
+{
+public:
+  enum
+  {
+    MAGIC   = 0x4b43564d, // "MVCK"
+    VERSION = 4,
+  };
+
+  enum
+  {
+    END_PAGES = 0xffffffff, // ends the page records
+  };
+
+  // Page record kinds
+  enum
+  {
+    PAGE_DATA = 0, // followed by the page
+    PAGE_ZERO = 1, // all zeros
+  };
+
+  static void save(simulator_t& sim, const char* fname)
+  {
+    checkpoint_t ckpt(fname, true);
+    ckpt.transfer(sim);
+    fclose(ckpt.fp);
+  }
+
+  static void restore(simulator_t& sim, const char* fname)
+  {
+    checkpoint_t ckpt(fname, false);
+    ckpt.transfer(sim);
+    fclose(ckpt.fp);
+  }
+
+  // Register and counter state only, to and from a host buffer
+  static void save_state(simulator_t& sim, std::vector<uint8_t>& buf)
+  {
+    buf.clear();
+    checkpoint_t ckpt(&buf, true);
+    ckpt.transfer_state(sim);
+  }
+
+  static void restore_state(simulator_t& sim, std::vector<uint8_t>& buf)
+  {
+    checkpoint_t ckpt(&buf, false);
+    ckpt.transfer_state(sim);
+  }
+
+private:
+  checkpoint_t(std::vector<uint8_t>* _buf, bool _saving)
+    : fp(NULL)
+    , buf(_buf)
+    , pos(0)
+    , saving(_saving)
+  {
+  }
+
+  checkpoint_t(const char* fname, bool _saving)
+    : buf(NULL)
+    , pos(0)
+    , saving(_saving)
+  {
+    fp = fopen(fname, saving ? "wb" : "rb");
+    if (!fp)
+    {
+      printf("Couldn't open checkpoint %s!\n", fname);
+      exit(-1);
+    }
+  }
+
+  //----------------------------------------------------------------------
+  // Primitive transfer
+  //----------------------------------------------------------------------
+
+  void io(void* p, size_t len)
+  {
+    if (buf)
+    {
+      if (saving)
+        buf->insert(buf->end(), (uint8_t*) p, (uint8_t*) p + len);
+      else if (pos + len <= buf->size())
+        memcpy(p, &(*buf)[pos], len);
+      else
+      {
+        printf("Snapshot read past the end!\n");
+        exit(-1);
+      }
+      pos += len;
+      return;
+    }
+
+    size_t n = saving ? fwrite(p, 1, len, fp) : fread(p, 1, len, fp);
+    if (n != len)
+    {
+      printf("Checkpoint %s failed!\n", saving ? "write" : "read");
+      exit(-1);
+    }
+  }
+
+  template <typename T>
+  void io(T& val)
+  {
+    io(&val, sizeof(T));
+  }
+
+  // Saves a constant; on restore checks the file agrees with it
+  void expect(uint32_t val, const char* what)
+  {
+    uint32_t v = val;
+    io(v);
+    if (v != val)
+    {
+      printf("Checkpoint mismatch in %s: file has %u, simulator has %u!\n", what, v, val);
+      exit(-1);
+    }
+  }
+
+  //----------------------------------------------------------------------
+  // Architectural state
+  //----------------------------------------------------------------------
+
+  // Fields shared by MavenCPState and MavenVPState
+  template <typename StateType>
+  void transfer_common(StateType& state)
+  {
+    io(state.R, sizeof(state.R));
+    io(state.pc);
+    io(state.npc);
+    io(state.hi);
+    io(state.lo);
+    io(state.fpu.R, sizeof(state.fpu.R));
+    io(state.fpu.fir);
+    io(state.fpu.fcsr);
+    io(state.branch);
+    io(state.nullify);
+    io(state.exception);
+    io(state.runstate);
+    io(state.flag_mode);
+  }
+
+  void transfer(MavenCPState& state)
+  {
+    transfer_common(state);
+    io(state.epc);
+    io(state.ebase);
+    io(state.cp_cycle);
+    io(state.vector);
+    io(state.vp_mode);
+    io(state.stats_en);
+
+    MavenPerfCounters& perf = MavenPerfCounters::of(state);
+    io(perf.count, sizeof(perf.count));
+    io(perf.enabled);
+    io(perf.select);
+  }
+
+  void transfer(MavenVPState& state)
+  {
+    transfer_common(state);
+    io(state.flags, sizeof(state.flags));
+    io(state.m_nregs);
+  }
+
+  void transfer(MavenVPArray& vparray)
+  {
+    io(vparray.vl);
+    io(vparray.vlmax);
+    io(vparray.num_physical_regs);
+    io(vparray.stats_en);
+
+    for (int i=0; i<MAVEN_SYSCFG_VLEN_MAX; i++)
+    {
+      bool present = vparray.vp[i] != NULL;
+      io(present);
+      if (present != (vparray.vp[i] != NULL))
+      {
+        printf("Checkpoint mismatch in VP %d!\n", i);
+        exit(-1);
+      }
+      if (present)
+        transfer(vparray.vp[i]->state);
+    }
+  }
+
+  void transfer(simulator_t& sim)
+  {
+    transfer_state(sim);
+    transfer(sim.mem);
+  }
+
+  void transfer_state(simulator_t& sim)
+  {
+    expect(MAGIC, "magic");
+    expect(VERSION, "version");
+    expect(MAVEN_SYSCFG_MEMORY_SIZE, "memory size");
+    expect(MAVEN_SYSCFG_VLEN_MAX, "vector length");
+    expect(sim.nproc, "core count");
+
+    io(sim.tid_mask);
+    io(sim.magicmemaddr);
+    io(sim.cycle);
+    io(maven::g_cop0_count);
+    io(maven::g_stat_cycle_count);
+
+    for (int i=0; i<sim.nproc; i++)
+    {
+      transfer(sim.procs[i]->cp.state);
+      transfer(sim.procs[i]->vparray);
+    }
+  }
+
+  //----------------------------------------------------------------------
+  // Memory
+  //----------------------------------------------------------------------
+  // A flag saying whether only dirty pages are listed, then a list of
+  // (vpn, kind[, page]) records ending in END_PAGES. Pages of zeros are
+  // recorded without their contents. A full checkpoint leaves out the
+  // zero pages instead, and restoring it clears any page not listed.
+
+  void transfer(Memory& mem)
+  {
+    bool dirty_only = saving && mem.dirty_tracking_armed();
+    io(dirty_only);
+
+    uint32_t vpn;
+    uint8_t kind;
+
+    if (saving)
+    {
+      for (vpn=0; vpn<Memory::NUM_PAGES; vpn++)
+      {
+        if (dirty_only && !mem.page_dirty(vpn))
+          continue;
+
+        uint8_t* page = &mem.mem[vpn << Memory::PAGE_SHIFT];
+        kind = is_zero(page) ? PAGE_ZERO : PAGE_DATA;
+        if (kind == PAGE_ZERO && !dirty_only)
+          continue;
+
+        io(vpn);
+        io(kind);
+        if (kind == PAGE_DATA)
+          io(page, Memory::PAGE_SIZE);
+      }
+      vpn = END_PAGES;
+      io(vpn);
+      return;
+    }
+
+    std::vector<bool> listed(Memory::NUM_PAGES);
+    for (io(vpn); vpn != END_PAGES; io(vpn))
+    {
+      io(kind);
+      if (vpn >= Memory::NUM_PAGES || kind > PAGE_ZERO)
+      {
+        printf("Checkpoint has bad page %08x!\n", vpn);
+        exit(-1);
+      }
+
+      uint8_t* page = &mem.mem[vpn << Memory::PAGE_SHIFT];
+      if (kind == PAGE_DATA)
+        io(page, Memory::PAGE_SIZE);
+      else if (!is_zero(page))
+        memset(page, 0, Memory::PAGE_SIZE);
+      mem.code_stored(vpn);
+      listed[vpn] = true;
+    }
+
+    if (dirty_only)
+      return;
+
+    // Reading a page the host never committed costs nothing, so only
+    // pages that really hold data get written here
+    for (vpn=0; vpn<Memory::NUM_PAGES; vpn++)
+    {
+      uint8_t* page = &mem.mem[vpn << Memory::PAGE_SHIFT];
+      if (!listed[vpn] && !is_zero(page))
+      {
+        memset(page, 0, Memory::PAGE_SIZE);
+        mem.code_stored(vpn);
+      }
+    }
+  }
+
+  static bool is_zero(const uint8_t* page)
+  {
+    return page[0] == 0 && !memcmp(page, page+1, Memory::PAGE_SIZE-1);
+  }
+
+  FILE* fp;
+  std::vector<uint8_t>* buf; // instead of fp for in-process snapshots
+  size_t pos;
+  bool saving;
+};
+
+#endif // __CHECKPOINT_H
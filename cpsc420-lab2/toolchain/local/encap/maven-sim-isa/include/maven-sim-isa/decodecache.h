@@ -0,0 +1,144 @@
+//========================================================================
+// decodecache.h : Pre-decoded instructions for simulator_t::step_core
+//========================================================================
+
+#ifndef __DECODECACHE_H
+#define __DECODECACHE_H
+
+#include "processor.h"
+#include "maven-global.h"
+#include "maven-VPLanes.h"
+
+//------------------------------------------------------------------------
+// Decode cache
+//------------------------------------------------------------------------
+// MavenProcessor::execute fetches every instruction word afresh and
+// walks the dispatch tables (sdt.h) down to its handler. A decode cache
+// keeps, for each pc, the word and the execute handler the tables
+// resolved it to, so step() can call the handler directly.
+//
+// Fetches use Memory::fetch_uint32, so a MemoryWatch does not see them.
+// Each entry is tagged with the code generation (memory.h) of its page
+// when it was filled, and a hit needs the tag to be current, so
+// self-modifying code and a program loaded over an old one (a
+// checkpoint restore) see the new instruction. A stale entry whose word
+// has not changed, as after a store to data sharing a page with code,
+// only takes its new tag. The cache binds to the Memory of the first
+// core it steps, and must not outlive it.
+//
+// step() runs a scalar CP instruction only. can_step() says whether the
+// next instruction is one; otherwise the caller goes through
+// MavenProcessor::execute as before. That covers a vector fetch in
+// progress, an instruction nullified by a branch-likely, fetch faults,
+// and stats_en, under which the prebuilt code also collects the
+// microarchitectural statistics.
+//
+// With lanes on, the vector commands maven-VPLanes.h has kernels for
+// resolve to its lane handlers instead of the dispatch table's.
+
+class MavenDecodeCache
+{
+public:
+  typedef void (*ExecuteFunction)(MavenCPInstruction*, MavenCPState*);
+
+  struct entry_t
+  {
+    addr_t pc;
+    MavenCPInstruction inst;
+    ExecuteFunction execute;
+  };
+
+  // A cached entry with the code generation it was filled under
+  struct tagged_entry_t
+  {
+    entry_t entry;
+    uint32_t gen;
+  };
+
+  enum
+  {
+    ENTRIES    = 4096,
+    INDEX_MASK = ENTRIES - 1,
+  };
+
+  // Tag of an empty entry, never fetched since it is not aligned
+  static const addr_t INVALID_PC = 0xffffffff;
+
+  MavenDecodeCache()
+    : gens(NULL)
+    , lanes(false)
+    , fills(0)
+  {
+    for (int i=0; i<ENTRIES; i++)
+      entries[i].entry.pc = INVALID_PC;
+  }
+
+  void set_lanes(bool val)
+  {
+    lanes = val;
+  }
+
+  // The handler to run inst with
+  static ExecuteFunction resolve(MavenCP& cp, MavenCPInstruction* inst, bool lanes)
+  {
+    ExecuteFunction f = lanes ? maven_lanes_handler(inst->get_bits()) : NULL;
+    return f ? f : cp.dt.lookup_execute(inst);
+  }
+
+  static bool can_step(const MavenCPState& state)
+  {
+    return !state.vector && !state.nullify && !state.stats_en
+        && !(state.pc & 3) && state.pc < MAVEN_SYSCFG_MEMORY_SIZE;
+  }
+
+  // Execute cp's next instruction the way MavenCP::execute does: clear
+  // branch, run the handler, count the instruction in g_cop0_count and,
+  // unless the handler branched or raised an exception, move on to npc.
+  void step(MavenCP& cp)
+  {
+    MavenCPState& state = cp.state;
+    entry_t& e = lookup(cp, state.pc);
+
+    state.branch = false;
+    e.execute(&e.inst, &state);
+    maven::g_cop0_count++;
+
+    if (!state.branch && state.runstate == MavenCPState::RUNNING)
+    {
+      state.pc = state.npc;
+      state.npc += 4;
+    }
+  }
+
+  entry_t& lookup(MavenCP& cp, addr_t pc)
+  {
+    tagged_entry_t& t = entries[(pc >> 2) & INDEX_MASK];
+    entry_t& e = t.entry;
+    if (__builtin_expect(e.pc == pc && t.gen == gens[pc >> Memory::PAGE_SHIFT], 1))
+      return e;
+
+    if (!gens)
+      gens = cp.mem.code_generations();
+    cp.mem.mark_code(pc >> Memory::PAGE_SHIFT);
+    t.gen = gens[pc >> Memory::PAGE_SHIFT];
+    uint32_t bits = cp.mem.fetch_uint32(pc);
+    if (e.pc == pc && e.inst.get_bits() == bits)
+      return e;
+
+    fills++;
+    e.pc = pc;
+    e.inst.set_bits(bits);
+    e.execute = resolve(cp, &e.inst, lanes);
+    return e;
+  }
+
+  uint64_t get_fills() { return fills; }
+
+private:
+  tagged_entry_t entries[ENTRIES];
+  const uint32_t* gens; // the Memory's code generations, NULL until bound
+  bool lanes;
+  uint64_t fills;
+};
+
+#endif // __DECODECACHE_H
@@ -35,13 +35,170 @@
 
 #include "htif.h"
 #include "types.h"
+#include "elf.h"
 #include <map>
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 class elfloader_t
 {
 public:
   uint32_t load(const char *fname, htif_t& htif, std::map<std::string,addr_t>& symtab);
 
+  // Loader for any memif: each section goes over in one write_bulk
+  // rather than as per-word writes. Instantiated with memif_mavenfs_t
+  // that is a bounds check and a memcpy; load() can forward here with
+  // htif.lmem() as a plain memif_t. The prebuilt load() does not, and
+  // this has no caller in maven-isa-run; there the writes load() makes
+  // reach write_bulk through isarun_memif_t instead.
+  template <class memif_type>
+  uint32_t load_bulk(const char *fname, memif_type& mem, std::map<std::string,addr_t>& symtab)
+  {
+    size_t size;
+    uint8_t* elf = map_file(fname, &size);
+    check_elf(elf, size, fname);
+
+    const Elf32_Ehdr* eh = (const Elf32_Ehdr*) elf;
+    const Elf32_Shdr* sh = (const Elf32_Shdr*) (elf + eh->e_shoff);
+
+    for (int i=0; i<eh->e_shnum; i++)
+    {
+      if (!is_loadable(sh[i]))
+        continue;
+
+      if (mem.write_bulk(sh[i].sh_addr, sh[i].sh_size, elf + sh[i].sh_offset) != memif_t::OK)
+      {
+        printf("Couldn't load section at %08x from %s!\n", sh[i].sh_addr, fname);
+        exit(1);
+      }
+    }
+
+    read_symbols(elf, symtab);
+    uint32_t entry = eh->e_entry;
+    munmap(elf, size);
+    return entry;
+  }
+
+private:
+  static uint8_t* map_file(const char *fname, size_t* size)
+  {
+    int fd = open(fname, O_RDONLY);
+    if (fd < 0)
+    {
+      printf("Couldn't open %s!\n", fname);
+      exit(1);
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size == 0)
+    {
+      printf("Couldn't stat %s or it is empty!\n", fname);
+      exit(1);
+    }
+    *size = st.st_size;
+
+    uint8_t* elf = (uint8_t*) mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (elf == MAP_FAILED)
+    {
+      printf("Couldn't map %s!\n", fname);
+      exit(1);
+    }
+    return elf;
+  }
+
+  // Reject a file whose headers, sections or string tables would be
+  // read past its end, before anything is loaded from it
+  static void check_elf(const uint8_t* elf, size_t size, const char* fname)
+  {
+    const Elf32_Ehdr* eh = (const Elf32_Ehdr*) elf;
+    if (size < sizeof(Elf32_Ehdr) || memcmp(eh->e_ident, "\177ELF", 4) != 0
+        || eh->e_ident[4] != 1  // ELFCLASS32
+        || eh->e_ident[5] != 1) // ELFDATA2LSB
+      bad_elf(fname, "not a 32-bit little-endian ELF file");
+
+    if (eh->e_shnum == 0)
+      bad_elf(fname, "no section headers");
+    if (eh->e_shentsize != sizeof(Elf32_Shdr)
+        || (uint64_t) eh->e_shoff + (uint64_t) eh->e_shnum * sizeof(Elf32_Shdr) > size)
+      bad_elf(fname, "section headers lie outside the file");
+    if (eh->e_shstrndx >= eh->e_shnum)
+      bad_elf(fname, "bad section name table index");
+
+    const Elf32_Shdr* sh = (const Elf32_Shdr*) (elf + eh->e_shoff);
+    for (int i=0; i<eh->e_shnum; i++)
+    {
+      if (sh[i].sh_type == 8) // SHT_NOBITS
+        continue;
+      if ((uint64_t) sh[i].sh_offset + sh[i].sh_size > size)
+        bad_elf(fname, "section lies outside the file");
+    }
+
+    // Names are looked up in shstrtab, so it must be NUL terminated
+    const Elf32_Shdr& names = sh[eh->e_shstrndx];
+    if (names.sh_size == 0 || elf[names.sh_offset + names.sh_size - 1] != 0)
+      bad_elf(fname, "bad section name table");
+  }
+
+  static void bad_elf(const char* fname, const char* why)
+  {
+    printf("Couldn't load %s: %s!\n", fname, why);
+    exit(1);
+  }
+
+  static bool is_loadable(const Elf32_Shdr& sh)
+  {
+    return sh.sh_type == 1 && (sh.sh_flags & 2); // SHT_PROGBITS, SHF_ALLOC
+  }
+
+  static void read_symbols(const uint8_t* elf, std::map<std::string,addr_t>& symtab)
+  {
+    const Elf32_Ehdr* eh = (const Elf32_Ehdr*) elf;
+    const Elf32_Shdr* sh = (const Elf32_Shdr*) (elf + eh->e_shoff);
+    const char* shstrtab = (const char*) (elf + sh[eh->e_shstrndx].sh_offset);
+
+    uint32_t shstrtab_size = sh[eh->e_shstrndx].sh_size;
+
+    const char* strtab = NULL;
+    uint32_t strtab_size = 0;
+    const Elf32_Sym* syms = NULL;
+    int nsyms = 0;
+
+    // check_elf has bounded every section and terminated shstrtab
+    for (int i=0; i<eh->e_shnum; i++)
+    {
+      if (sh[i].sh_name >= shstrtab_size)
+        continue;
+      if (strcmp(shstrtab + sh[i].sh_name, ".strtab") == 0)
+      {
+        strtab = (const char*) (elf + sh[i].sh_offset);
+        strtab_size = sh[i].sh_size;
+      }
+      else if (sh[i].sh_type == 2 && !syms) // SHT_SYMTAB
+      {
+        syms = (const Elf32_Sym*) (elf + sh[i].sh_offset);
+        nsyms = sh[i].sh_size / sizeof(Elf32_Sym);
+      }
+    }
+
+    if (strtab && syms)
+    {
+      for (int i=0; i<nsyms; i++)
+      {
+        uint32_t name = syms[i].st_name;
+        if (syms[i].st_shndx == 0 || name >= strtab_size)
+          continue;
+        // A name running off the end of strtab is cut there
+        symtab[std::string(strtab + name, strnlen(strtab + name, strtab_size - name))] = syms[i].st_value;
+      }
+    }
+  }
 };
 
 #endif // __ELFLOADER_H
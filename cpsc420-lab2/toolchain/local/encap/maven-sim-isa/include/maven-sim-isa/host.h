@@ -101,6 +101,19 @@ extern bool vptrace;
     return value;
   }
 
+  // Keeps the compiler from moving memory accesses across it; x86 does
+  // not reorder stores with other stores or loads with other loads.
+  static inline void compiler_barrier()
+  {
+    __asm__ __volatile__ ("" : : : "memory");
+  }
+
+  #define HAS_ATOMIC_AND
+  static inline void atomic_and(int* ptr, int value)
+  {
+    __asm__ __volatile__ ("lock andl %0, (%1)" : : "r"(value),"r"(ptr) : "memory");
+  }
+
   static inline void unlock(int* ptr)
   {
     *ptr = 0;
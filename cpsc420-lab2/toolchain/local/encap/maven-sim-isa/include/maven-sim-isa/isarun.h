@@ -0,0 +1,783 @@
+//========================================================================
+// isarun.h : Command line front end for maven-isa-run
+//========================================================================
+// isarun_main() is maven-isa-run's main. It takes the options below off
+// the command line and passes the rest to appserver_t::test, which
+// parses its own options, loads the program and services its syscalls.
+// The run goes through isarun_htif_t, an htif_mavenfs_t whose
+// run_to_tohost steps the cores with simulator_t::step_cycle, so these
+// options can act between cycles:
+//
+//  --run-back-to <cycle>     When the program exits or faults, wind the
+//                            run back to <cycle> and dump every core's
+//                            state there (see snapshot.h)
+//  --snapshot-interval <n>   Cycles between snapshots (default 100000)
+//  --snapshots <n>           Snapshots to keep (default 16)
+//  --checkpoint-at <cycle>   Save a checkpoint when the run reaches
+//                            <cycle> (see checkpoint.h); with --blocks,
+//                            at the end of the block which reaches it
+//  --checkpoint-file <file>  Where to save it (default maven.ckpt)
+//  --checkpoint-restore <file>
+//                            Start from a checkpoint saved by a run of
+//                            the same program with the same arguments
+//  --pvfb-array              With -R stack or -R stack+, keep the
+//                            fragments in the fixed-size stacks of
+//                            maven-PVFBArray.h instead of std::lists
+//  --decode-cache            Run scalar CP instructions from a per-core
+//                            cache of decoded instructions instead of
+//                            through MavenProcessor::execute (see
+//                            decodecache.h)
+//  --blocks                  Run them from per-core translated basic
+//                            blocks instead (see maven-BlockEngine.h)
+//  --fuse                    As --blocks, and run the idioms of
+//                            mips32-Fusion.h in hot blocks as single
+//                            fused operations
+//  --vp-lanes                Run unmasked integer vector commands and
+//                            one-element word vector loads and stores
+//                            through the SIMD kernels of maven-VPLanes.h;
+//                            implies --decode-cache unless --blocks
+//  --sysproxy                Service read, write, open, close, lseek,
+//                            fstat and BATCH in run_to_tohost through
+//                            sysproxy.h instead of returning them to the
+//                            appserver, which does not know BATCH. The
+//                            file calls then use sysproxy's descriptor
+//                            table, which starts with stdin, stdout and
+//                            stderr. Cannot be combined with --parallel
+//                            or --simpoint-*
+//  --parallel <quantum>      With more than one core, run each core on
+//                            its own host thread in epochs of <quantum>
+//                            cycles (see simulator_parallel.h). Cannot
+//                            be combined with --run-back-to,
+//                            --checkpoint-at, --decode-cache, --blocks,
+//                            --fuse or --vp-lanes: the cores step
+//                            through MavenProcessor::execute
+//  --trace-bin <prefix>      Write a binary trace of every instruction
+//                            each core runs to <prefix>.<core>.trace
+//                            (see tracewriter.h). Cores step one
+//                            instruction at a time, so --blocks has no
+//                            effect. Cannot be combined with --parallel,
+//                            --run-back-to or --simpoint-*
+//  --watch <lo>:<hi>         Count the loads and stores each line of
+//                            [lo, hi) sees (see memwatch.h); may be
+//                            given more than once. With --stats the
+//                            dump ends with the lines' heatmap. Turns on
+//                            --decode-cache, whose instruction fetches
+//                            are not counted
+//  --watch-line <shift>      Watched line size, log2 bytes (default 6)
+//  --watch-log <file>        Also log every watched access, with the pc
+//                            of the instruction that made it, to <file>.
+//                            --watch and its options cannot be combined
+//                            with --parallel or --simpoint-*
+//  --simpoint-profile <file> Profile the run for sampled simulation (see
+//                            simpoint.h) and write its simulation points
+//                            to <file> when the program exits
+//  --simpoint-checkpoint <file>
+//                            Read the points from <file> and save a
+//                            checkpoint for each, as <file>.<interval>.ckpt
+//  --simpoint-replay <file>  Replay each point from its checkpoint, print
+//                            the estimated CPI and end the run
+//  --simpoint-interval <n>   Instructions per interval when profiling
+//                            (default 10000000)
+//  --simpoint-warmup <n>     Unmeasured instructions run before each
+//                            point when replaying (default 1000000)
+//
+// The three --simpoint passes run the same program with the same
+// arguments, in order. Checkpointing and replay take the interval and
+// warmup the profile wrote to the points file. Like --parallel, they
+// step through MavenProcessor::execute and cannot be combined with
+// --run-back-to, --checkpoint-at or --parallel. Replay measures every
+// point in one process: before each one it restores the state the load
+// left, saved to <file>.load.ckpt, and then the point's checkpoint. It
+// exits once the last point is measured, so the program does not run
+// to its own exit and --stats has nothing to dump.
+//
+// After the dump an exit is replayed forward again, so the appserver
+// still services it and the exit code is unchanged. A fault ends the
+// run with run_to_tohost's PANIC message, as it does without the option.
+//
+// The appserver loads the program, reads syscall arguments and writes
+// syscall results through isarun_memif_t. Its virtual read and write
+// calls go to memif_mavenfs_t's read_bulk and write_bulk, so a buffer
+// moves with one Memory::read_block or write_block instead of a word at
+// a time, and write tracking sees the stores.
+// With --stats the dump also has each core's performance counters and,
+// with --decode-cache, how many times each core's cache was filled or,
+// with --blocks, how many blocks each core translated and, with --fuse,
+// how many instructions it ran fused.
+
+#ifndef __ISARUN_H
+#define __ISARUN_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "simulator.h"
+#include "simulator_parallel.h"
+#include "simpoint.h"
+#include "snapshot.h"
+#include "checkpoint.h"
+#include "htif_mavenfs.h"
+#include "memif_mavenfs.h"
+#include "appserver.h"
+#include "sysproxy.h"
+#include "syscfg.h"
+#include "maven-PVFBArray.h"
+
+//------------------------------------------------------------------------
+// isarun_memif_t
+//------------------------------------------------------------------------
+
+class isarun_memif_t : public memif_mavenfs_t
+{
+public:
+  isarun_memif_t(simulator_t& _sim)
+    : memif_mavenfs_t(_sim)
+  {
+  }
+
+  memif_t::error read(uint32_t addr, uint32_t len, uint8_t* bytes)
+  {
+    return read_bulk(addr, len, bytes);
+  }
+
+  memif_t::error write(uint32_t addr, uint32_t len, const uint8_t* bytes)
+  {
+    return write_bulk(addr, len, bytes);
+  }
+
+  memif_t::error read_uint8(uint32_t addr, uint8_t* word)   { return read_word(addr, word); }
+  memif_t::error read_int8(uint32_t addr, int8_t* word)     { return read_word(addr, word); }
+  memif_t::error read_uint16(uint32_t addr, uint16_t* word) { return read_word(addr, word); }
+  memif_t::error read_int16(uint32_t addr, int16_t* word)   { return read_word(addr, word); }
+  memif_t::error read_uint32(uint32_t addr, uint32_t* word) { return read_word(addr, word); }
+  memif_t::error read_int32(uint32_t addr, int32_t* word)   { return read_word(addr, word); }
+  memif_t::error read_uint64(uint32_t addr, uint64_t* word) { return read_word(addr, word); }
+  memif_t::error read_int64(uint32_t addr, int64_t* word)   { return read_word(addr, word); }
+
+  memif_t::error write_uint8(uint32_t addr, uint8_t word)   { return write_word(addr, word); }
+  memif_t::error write_int8(uint32_t addr, int8_t word)     { return write_word(addr, word); }
+  memif_t::error write_uint16(uint32_t addr, uint16_t word) { return write_word(addr, word); }
+  memif_t::error write_int16(uint32_t addr, int16_t word)   { return write_word(addr, word); }
+  memif_t::error write_uint32(uint32_t addr, uint32_t word) { return write_word(addr, word); }
+  memif_t::error write_int32(uint32_t addr, int32_t word)   { return write_word(addr, word); }
+  memif_t::error write_uint64(uint32_t addr, uint64_t word) { return write_word(addr, word); }
+  memif_t::error write_int64(uint32_t addr, int64_t word)   { return write_word(addr, word); }
+
+private:
+  template <typename T>
+  memif_t::error read_word(uint32_t addr, T* word)
+  {
+    if (addr & (sizeof(T)-1))
+      return memif_t::Misaligned;
+    return read_bulk(addr, sizeof(T), (uint8_t*) word);
+  }
+
+  template <typename T>
+  memif_t::error write_word(uint32_t addr, T word)
+  {
+    if (addr & (sizeof(T)-1))
+      return memif_t::Misaligned;
+    return write_bulk(addr, sizeof(T), (const uint8_t*) &word);
+  }
+};
+
+//------------------------------------------------------------------------
+// isarun_htif_t
+//------------------------------------------------------------------------
+
+class isarun_htif_t : public htif_mavenfs_t
+{
+public:
+  isarun_htif_t(simulator_t& _sim)
+    : htif_mavenfs_t(_sim)
+    , sim(_sim)
+    , memif(_sim)
+    , run_back_target(-1)
+    , snapshot_interval(100000)
+    , nsnapshots(16)
+    , ring(NULL)
+    , checkpoint_cycle(-1)
+    , checkpoint_file("maven.ckpt")
+    , restore_file(NULL)
+    , started(false)
+    , pvfb_array(false)
+    , quantum(0)
+    , parallel(NULL)
+    , simpoint_mode(SIMPOINT_OFF)
+    , simpoint_file(NULL)
+    , simpoint_interval(10000000)
+    , simpoint_warmup(1000000)
+    , simpoint(NULL)
+    , simpoint_idx(0)
+    , trace_prefix(NULL)
+    , tracer(NULL)
+    , watch_line(6)
+    , watch_log(NULL)
+    , watch(NULL)
+    , watch_fp(NULL)
+    , use_proxy(false)
+    , proxy_next_fd(3)
+    , proxy(memif, proxy_fds, proxy_next_fd)
+  {
+    for (int fd=0; fd<3; fd++)
+      proxy_fds[fd] = fd;
+  }
+
+  ~isarun_htif_t()
+  {
+    delete ring;
+    delete parallel;
+    delete simpoint;
+    delete tracer;
+    if (watch)
+    {
+      sim.mem.detach_watch();
+      delete watch;
+    }
+    if (watch_fp)
+      fclose(watch_fp);
+    for (int i=0; sim.procs && i<sim.nproc; i++)
+      MavenPerfCounters::forget(&sim.procs[i]->cp.state);
+  }
+
+  // Take one of the options above which has no value. Returns false if
+  // opt is not one.
+  bool parse_flag(const char* opt)
+  {
+    if (strcmp(opt, "--pvfb-array") == 0)
+      pvfb_array = true;
+    else if (strcmp(opt, "--decode-cache") == 0)
+      step_cache.set_decode(true);
+    else if (strcmp(opt, "--blocks") == 0)
+      step_cache.set_blocks(true);
+    else if (strcmp(opt, "--fuse") == 0)
+    {
+      step_cache.set_blocks(true);
+      step_cache.set_fusion(true);
+    }
+    else if (strcmp(opt, "--vp-lanes") == 0)
+      step_cache.set_lanes(true);
+    else if (strcmp(opt, "--sysproxy") == 0)
+      use_proxy = true;
+    else
+      return false;
+    return true;
+  }
+
+  // Take one of the options above. Returns false if opt is not one.
+  bool parse_option(const char* opt, const char* val)
+  {
+    if (strcmp(opt, "--run-back-to") == 0)
+      run_back_target = strtoll(val, NULL, 0);
+    else if (strcmp(opt, "--snapshot-interval") == 0)
+      snapshot_interval = strtoll(val, NULL, 0);
+    else if (strcmp(opt, "--snapshots") == 0)
+      nsnapshots = atoi(val);
+    else if (strcmp(opt, "--checkpoint-at") == 0)
+      checkpoint_cycle = strtoll(val, NULL, 0);
+    else if (strcmp(opt, "--checkpoint-file") == 0)
+      checkpoint_file = val;
+    else if (strcmp(opt, "--checkpoint-restore") == 0)
+      restore_file = val;
+    else if (strcmp(opt, "--parallel") == 0)
+      quantum = atoi(val) > 0 ? atoi(val) : -1;
+    else if (strcmp(opt, "--trace-bin") == 0)
+      trace_prefix = val;
+    else if (strcmp(opt, "--watch") == 0)
+      add_watch(val);
+    else if (strcmp(opt, "--watch-line") == 0)
+      watch_line = atoi(val) >= 1 && atoi(val) <= 31 ? atoi(val) : -1;
+    else if (strcmp(opt, "--watch-log") == 0)
+      watch_log = val;
+    else if (strcmp(opt, "--simpoint-profile") == 0)
+      set_simpoint(SIMPOINT_PROFILE, val);
+    else if (strcmp(opt, "--simpoint-checkpoint") == 0)
+      set_simpoint(SIMPOINT_CHECKPOINT, val);
+    else if (strcmp(opt, "--simpoint-replay") == 0)
+      set_simpoint(SIMPOINT_REPLAY, val);
+    else if (strcmp(opt, "--simpoint-interval") == 0)
+      simpoint_interval = strtoll(val, NULL, 0);
+    else if (strcmp(opt, "--simpoint-warmup") == 0)
+      simpoint_warmup = strtoll(val, NULL, 0);
+    else
+      return false;
+
+    if (snapshot_interval < 1 || nsnapshots < 1 || quantum < 0
+        || simpoint_interval < 1 || simpoint_warmup < 0 || watch_line < 0)
+    {
+      printf("%s must be at least 1!\n", opt);
+      exit(-1);
+    }
+    return true;
+  }
+
+  memif_t& lmem()
+  {
+    return memif;
+  }
+
+  // The appserver calls this after set_num_cores, with reconvergence 1
+  // for -R stack and 2 for -R stack+
+  void set_impl_flags(int reconvergence, bool density, bool scoreboard, bool bc, bool vxudebug)
+  {
+    htif_mavenfs_t::set_impl_flags(reconvergence, density, scoreboard, bc, vxudebug);
+    if (!pvfb_array || (reconvergence != 1 && reconvergence != 2))
+      return;
+
+    for (int i=0; i<sim.nproc; i++)
+    {
+      MavenVPArray& vparray = sim.procs[i]->vparray;
+      delete vparray.pvfb;
+      if (reconvergence == 2)
+        vparray.pvfb = new MavenPVFBArrayStack_plus();
+      else
+        vparray.pvfb = new MavenPVFBArrayStack();
+    }
+  }
+
+  // The appserver calls this for --stats
+  void dumpstats(FILE* logfile, double seconds = 0.0)
+  {
+    htif_mavenfs_t::dumpstats(logfile, seconds);
+    sim.dump_perf_counters(logfile);
+    step_cache.dump(logfile);
+    sim.dump_memory_heatmap(logfile);
+  }
+
+  int run_to_tohost(int orig_tohost)
+  {
+    if (sim.procs == NULL)
+      return htif_mavenfs_t::run_to_tohost(orig_tohost);
+
+    // The first call comes just after the ELF and arguments are loaded
+    if (!started)
+    {
+      started = true;
+      if (restore_file)
+        checkpoint_t::restore(sim, restore_file);
+      if (quantum > 0 && (run_back_target >= 0 || checkpoint_cycle >= 0))
+      {
+        printf("--parallel cannot be combined with --run-back-to or --checkpoint-at!\n");
+        exit(-1);
+      }
+      if (quantum > 0 && step_cache.enabled())
+      {
+        printf("--parallel cannot be combined with --decode-cache, --blocks, --fuse or --vp-lanes!\n");
+        exit(-1);
+      }
+      if (simpoint_mode != SIMPOINT_OFF
+          && (quantum > 0 || run_back_target >= 0 || checkpoint_cycle >= 0))
+      {
+        printf("--simpoint-* cannot be combined with --parallel, --run-back-to or --checkpoint-at!\n");
+        exit(-1);
+      }
+      if (trace_prefix)
+      {
+        if (quantum > 0 || run_back_target >= 0 || simpoint_mode != SIMPOINT_OFF)
+        {
+          printf("--trace-bin cannot be combined with --parallel, --run-back-to or --simpoint-*!\n");
+          exit(-1);
+        }
+        tracer = new trace_writer_t(trace_prefix, sim.nproc);
+        step_cache.set_trace(tracer);
+      }
+      if (!watch_ranges.empty())
+        start_watch();
+      if (use_proxy && (quantum > 0 || simpoint_mode != SIMPOINT_OFF))
+      {
+        printf("--sysproxy cannot be combined with --parallel or --simpoint-*!\n");
+        exit(-1);
+      }
+      if (checkpoint_cycle >= 0)
+        sim.mem.arm_dirty_tracking();
+    }
+
+    if (quantum > 0 && sim.nproc > 1)
+      return run_parallel(orig_tohost);
+
+    if (simpoint_mode != SIMPOINT_OFF)
+      return run_simpoint(orig_tohost);
+
+    // A snapshot after every syscall keeps each interval syscall free
+    if (run_back_target >= 0)
+    {
+      if (!ring)
+        ring = new snapshot_ring_t(sim, snapshot_interval, nsnapshots);
+      ring->take();
+    }
+
+    int core = -1;
+    for (;;)
+    {
+      while (tohost() == orig_tohost)
+      {
+        if ((core = sim.step_cycle(&step_cache)) >= 0)
+          break;
+        if (ring)
+          ring->tick();
+        if (checkpoint_cycle >= 0 && sim.cycle >= checkpoint_cycle)
+          save_checkpoint();
+      }
+
+      if (core >= 0 || !use_proxy || !proxy_syscall())
+        break;
+      if (ring)
+        ring->take();
+    }
+
+    if (core >= 0)
+    {
+      sim.print_panic(core);
+      if (ring)
+        run_back();
+      delete tracer; // drains the trace up to the fault
+      exit(-1);
+    }
+
+    if (ring && syscall_number() == MAVEN_SYSCFG_SYSCALL_EXIT)
+    {
+      // Stepping on from the target reaches the same exit again
+      if (run_back())
+        while (tohost() == orig_tohost && sim.step_cycle(&step_cache) < 0)
+          ;
+    }
+
+    return tohost();
+  }
+
+private:
+  typedef sysproxy_t<isarun_memif_t> proxy_t;
+
+  // Take a --watch range, lo:hi
+  void add_watch(const char* val)
+  {
+    char* end;
+    MemoryWatch::range_t r;
+    r.lo = strtoul(val, &end, 0);
+    if (*end != ':')
+      r.hi = 0;
+    else
+      r.hi = strtoul(end+1, &end, 0);
+    if (*end != '\0' || r.hi <= r.lo)
+    {
+      printf("Bad --watch range %s, expected <lo>:<hi>!\n", val);
+      exit(-1);
+    }
+    watch_ranges.push_back(r);
+  }
+
+  void start_watch()
+  {
+    if (quantum > 0 || simpoint_mode != SIMPOINT_OFF)
+    {
+      printf("--watch cannot be combined with --parallel or --simpoint-*!\n");
+      exit(-1);
+    }
+
+    watch = new MemoryWatch(watch_line);
+    if (watch_log)
+    {
+      watch_fp = fopen(watch_log, "w");
+      if (!watch_fp)
+      {
+        printf("Couldn't open %s!\n", watch_log);
+        exit(-1);
+      }
+      watch->set_log(watch_fp);
+    }
+    for (size_t i=0; i<watch_ranges.size(); i++)
+      watch->add_range(watch_ranges[i].lo, watch_ranges[i].hi, watch_log != NULL);
+    sim.mem.attach_watch(watch);
+    step_cache.set_watch(watch);
+
+    // MavenCP::fetch is in the processor objects, which are not built
+    // from these headers, and may count a fetch from a watched line as
+    // a load. The decode cache fetches with fetch_uint32 instead.
+    step_cache.set_decode(true);
+  }
+
+  // Service the pending syscall through the proxy, answering it in the
+  // magic memory as the appserver does. Returns false, leaving it
+  // pending, if it is not one the proxy handles.
+  bool proxy_syscall()
+  {
+    uint32_t magic = sim.magicmemaddr;
+
+    proxy_t::request_t req;
+    req.id = syscall_number();
+    for (int i=0; i<3; i++)
+      req.arg[i] = sim.mem.read_mem_int32(magic + 0x10 + 4*i);
+
+    if (req.id == MAVEN_SYSCFG_SYSCALL_BATCH)
+    {
+      errno = 0;
+      int n = proxy.batch(req.arg[0], req.arg[1]);
+      req.result = n < 0 ? errno : n;
+      req.error_flag = n < 0;
+    }
+    else if (!proxy.service(req))
+      return false;
+
+    memif.write_int32(magic, 0);
+    memif.write_int32(magic + 0x1c, req.error_flag);
+    memif.write_int32(magic + 8, req.result);
+    set_fromhost(1);
+    return true;
+  }
+
+  enum
+  {
+    SIMPOINT_OFF,
+    SIMPOINT_PROFILE,
+    SIMPOINT_CHECKPOINT,
+    SIMPOINT_REPLAY,
+  };
+
+  void set_simpoint(int mode, const char* file)
+  {
+    if (simpoint_mode != SIMPOINT_OFF)
+    {
+      printf("Only one of --simpoint-profile, --simpoint-checkpoint and --simpoint-replay can be given!\n");
+      exit(-1);
+    }
+    simpoint_mode = mode;
+    simpoint_file = file;
+  }
+
+  int run_simpoint(int orig_tohost)
+  {
+    // The first call comes just after the load
+    if (!simpoint)
+    {
+      simpoint = new simpoint_t(sim, simpoint_interval, simpoint_warmup);
+      if (simpoint_mode != SIMPOINT_PROFILE)
+        simpoint->read_points(simpoint_file);
+      if (simpoint_mode == SIMPOINT_REPLAY)
+      {
+        if (simpoint->points.empty())
+        {
+          printf("No simulation points in %s!\n", simpoint_file);
+          exit(-1);
+        }
+        checkpoint_t::save(sim, load_checkpoint_name());
+        replay_begin();
+        orig_tohost = tohost();
+      }
+    }
+
+    int ret;
+    if (simpoint_mode == SIMPOINT_PROFILE)
+      ret = simpoint->profile_to_tohost(orig_tohost);
+    else if (simpoint_mode == SIMPOINT_CHECKPOINT)
+      ret = simpoint->checkpoint_to_tohost(orig_tohost, simpoint_file);
+    else
+      ret = replay_to_tohost(orig_tohost);
+
+    if (simpoint->faulted() >= 0)
+    {
+      sim.print_panic(simpoint->faulted());
+      exit(-1);
+    }
+
+    if (simpoint_mode == SIMPOINT_PROFILE && ret != orig_tohost
+        && syscall_number() == MAVEN_SYSCFG_SYSCALL_EXIT)
+    {
+      simpoint->cluster();
+      simpoint->write_points(simpoint_file);
+      printf("Wrote %d simulation points to %s\n",
+             (int) simpoint->points.size(), simpoint_file);
+    }
+    return ret;
+  }
+
+  // Measure points until one stops for a syscall, which goes back to
+  // the appserver. A point cut short by the program's exit is measured
+  // over what it ran.
+  int replay_to_tohost(int orig_tohost)
+  {
+    for (;;)
+    {
+      int ret = simpoint->replay_to_tohost(orig_tohost);
+      if (simpoint->faulted() >= 0)
+        return ret;
+      if (!simpoint->replay_done() && (ret == orig_tohost
+          || syscall_number() != MAVEN_SYSCFG_SYSCALL_EXIT))
+        return ret;
+
+      simpoint->replay_end();
+      if (++simpoint_idx == (int) simpoint->points.size())
+      {
+        simpoint->report(stdout);
+        exit(0);
+      }
+      replay_begin();
+      orig_tohost = tohost();
+    }
+  }
+
+  void replay_begin()
+  {
+    // A full checkpoint clears the pages the last point wrote
+    checkpoint_t::restore(sim, load_checkpoint_name());
+    simpoint->replay_begin(simpoint_idx, simpoint_file);
+  }
+
+  const char* load_checkpoint_name()
+  {
+    snprintf(load_name, sizeof(load_name), "%s.load.ckpt", simpoint_file);
+    return load_name;
+  }
+
+  int run_parallel(int orig_tohost)
+  {
+    if (!parallel)
+      parallel = new parallel_runner_t(sim, quantum);
+
+    int ret = parallel->run_to_tohost(orig_tohost);
+    if (parallel->faulted() >= 0)
+    {
+      sim.print_panic(parallel->faulted());
+      exit(-1);
+    }
+    return ret;
+  }
+
+  void save_checkpoint()
+  {
+    checkpoint_t::save(sim, checkpoint_file);
+    sim.mem.disarm_dirty_tracking();
+    printf("Saved checkpoint %s at cycle %lld\n", checkpoint_file, sim.cycle);
+    checkpoint_cycle = -1;
+  }
+
+  // Wind back to run_back_target and dump the cores there. Returns
+  // false, leaving the simulator where it was, if that is not possible.
+  bool run_back()
+  {
+    if (run_back_target >= sim.cycle)
+    {
+      printf("Cannot run back to cycle %lld, the run ended at cycle %lld\n",
+             run_back_target, sim.cycle);
+      return false;
+    }
+    if (run_back_target < ring->earliest_cycle())
+    {
+      printf("Cannot run back to cycle %lld, the oldest snapshot is at cycle %lld\n",
+             run_back_target, ring->earliest_cycle());
+      return false;
+    }
+
+    // The newest snapshot is past the last syscall, so the replay from
+    // any older one stops before reaching it
+    ring->run_back_to(run_back_target);
+
+    printf("Ran back to cycle %lld\n", sim.cycle);
+    for (int i=0; i<sim.nproc; i++)
+    {
+      printf("core %d:\n", i);
+      sim.procs[i]->cp.dump_state();
+    }
+    return true;
+  }
+
+  int tohost()
+  {
+    return sim.mem.read_mem_int32(sim.magicmemaddr);
+  }
+
+  int syscall_number()
+  {
+    return sim.mem.read_mem_int32(sim.magicmemaddr + 8);
+  }
+
+  simulator_t& sim;
+  isarun_memif_t memif;
+  MavenStepCache step_cache;
+
+  long long run_back_target;
+  long long snapshot_interval;
+  int nsnapshots;
+  snapshot_ring_t* ring;
+
+  long long checkpoint_cycle;
+  const char* checkpoint_file;
+  const char* restore_file;
+  bool started;
+
+  bool pvfb_array;
+
+  int quantum; // --parallel's, 0 without it
+  parallel_runner_t* parallel;
+
+  int simpoint_mode;
+  const char* simpoint_file;
+  long long simpoint_interval;
+  long long simpoint_warmup;
+  simpoint_t* simpoint;
+  int simpoint_idx; // point being replayed
+  char load_name[1024];
+
+  const char* trace_prefix;
+  trace_writer_t* tracer;
+
+  std::vector<MemoryWatch::range_t> watch_ranges;
+  int watch_line;
+  const char* watch_log;
+  MemoryWatch* watch;
+  FILE* watch_fp;
+
+  bool use_proxy;
+  std::map<int,int> proxy_fds;
+  int proxy_next_fd;
+  proxy_t proxy;
+};
+
+//------------------------------------------------------------------------
+// isarun_main
+//------------------------------------------------------------------------
+
+inline int isarun_main(int argc, char* argv[], char* envp[])
+{
+  simulator_t sim;
+  isarun_htif_t htif(sim);
+
+  // appserver_t::test's options which take a value, so that value is
+  // not mistaken for the program
+  static const char* const appserver_opts[] =
+    { "--nprocs", "--nregs", "-d", "-R", "--trace-file", "--stats-file", NULL };
+
+  std::vector<char*> args;
+  args.push_back(argv[0]);
+
+  int i = 1;
+  for (; i<argc && argv[i][0] == '-'; i++)
+  {
+    if (htif.parse_flag(argv[i]))
+      continue;
+    if (i+1 < argc && htif.parse_option(argv[i], argv[i+1]))
+    {
+      i++;
+      continue;
+    }
+
+    args.push_back(argv[i]);
+    for (int j=0; appserver_opts[j]; j++)
+    {
+      if (strcmp(argv[i], appserver_opts[j]) == 0 && i+1 < argc)
+      {
+        args.push_back(argv[++i]);
+        break;
+      }
+    }
+  }
+  for (; i<argc; i++)
+    args.push_back(argv[i]);
+  args.push_back(NULL);
+
+  appserver_t app(htif);
+  return app.test(args.size()-1, &args[0], envp);
+}
+
+#endif // __ISARUN_H
@@ -0,0 +1,448 @@
+//========================================================================
+// maven-BlockEngine.h : Basic-block execution for simulator_t::step_core
+//========================================================================
+
+#ifndef __MAVENBLOCKENGINE_H
+#define __MAVENBLOCKENGINE_H
+
+#include <string.h>
+#include <map>
+
+#include "mips32-ISA.h"
+#include "maven-ISA.h"
+#include "maven-PerfCounters.h"
+#include "decodecache.h"
+#include "mips32-Fusion.h"
+
+//------------------------------------------------------------------------
+// Block classification
+//------------------------------------------------------------------------
+// A block runs on through straight-line instructions, ends after the
+// delay slot of a branch or jump, and ends right after anything else:
+// stores, so that the run loop sees a write to tohost before the next
+// instruction, and the instructions which trap, nullify, touch cop0 or
+// drive the VP array.
+
+enum
+{
+  MAVEN_BLOCK_STRAIGHT,
+  MAVEN_BLOCK_BRANCH,
+  MAVEN_BLOCK_END,
+};
+
+inline int maven_block_class(uint32_t bits)
+{
+  uint32_t opcode = bits >> 26;
+  uint32_t rs     = (bits >> 21) & 0x1f;
+  uint32_t rt     = (bits >> 16) & 0x1f;
+  uint32_t func   = bits & 0x3f;
+
+  switch (opcode)
+  {
+    case MIPS32_J:
+    case MIPS32_JAL:
+    case MIPS32_BEQ:
+    case MIPS32_BNE:
+    case MIPS32_BLEZ:
+    case MIPS32_BGTZ:
+      return MAVEN_BLOCK_BRANCH;
+
+    case MIPS32_SPECIAL:
+      if (func == MIPS32_SPECIAL_JR || func == MIPS32_SPECIAL_JALR)
+        return MAVEN_BLOCK_BRANCH;
+      if (func == MIPS32_SPECIAL_SYSCALL || func == MIPS32_SPECIAL_BREAK
+          || func == MIPS32_SPECIAL_SYNC
+          || (func >= MIPS32_SPECIAL_TGE && func <= MIPS32_SPECIAL_TNE))
+        return MAVEN_BLOCK_END;
+      return MAVEN_BLOCK_STRAIGHT;
+
+    case MIPS32_REGIMM:
+      if (rt == MIPS32_REGIMM_BLTZ || rt == MIPS32_REGIMM_BGEZ
+          || rt == MIPS32_REGIMM_BLTZAL || rt == MIPS32_REGIMM_BGEZAL)
+        return MAVEN_BLOCK_BRANCH;
+      return MAVEN_BLOCK_END;
+
+    case MIPS32_COP1:
+      if (rs == MIPS32_COP1_BC1)
+        return (rt & 0x2) ? MAVEN_BLOCK_END : MAVEN_BLOCK_BRANCH;
+      return MAVEN_BLOCK_STRAIGHT;
+
+    case MIPS32_ADDI:
+    case MIPS32_ADDIU:
+    case MIPS32_SLTI:
+    case MIPS32_SLTIU:
+    case MIPS32_ANDI:
+    case MIPS32_ORI:
+    case MIPS32_XORI:
+    case MIPS32_LUI:
+    case MIPS32_SPECIAL2:
+    case MIPS32_LB:
+    case MIPS32_LH:
+    case MIPS32_LWL:
+    case MIPS32_LW:
+    case MIPS32_LBU:
+    case MIPS32_LHU:
+    case MIPS32_LWR:
+    case MIPS32_LWC1:
+    case MIPS32_LDC1:
+      return MAVEN_BLOCK_STRAIGHT;
+
+    default:
+      return MAVEN_BLOCK_END;
+  }
+}
+
+//------------------------------------------------------------------------
+// Block engine
+//------------------------------------------------------------------------
+// Translates the code from a pc into a block of decoded instructions
+// (MavenDecodeCache::entry_t, with the handler the dispatch tables
+// resolve for MavenCP::execute, so blocks and the interpreter run the
+// same mips32_* and maven_* execute functions). Each block links to the
+// first two blocks that followed it, so loops and calls go from block
+// to block without a lookup.
+//
+// run() executes from the core's current pc, resuming where the last
+// call stopped if that was inside a block. It stops at the end of a
+// block, after max instructions, when control leaves the straight line
+// (a branch taken after its delay slot), or when the next instruction
+// is one MavenDecodeCache::can_step turns away. Each instruction
+// retires as in MavenDecodeCache::step, with its microarch fields
+// cleared first and counted in perf.
+//
+// As in the decode cache, instructions are fetched with
+// Memory::fetch_uint32 and each block is tagged with the code
+// generations of the (at most two) pages it was translated from. run()
+// checks the tags of the block it runs, which covers every store since
+// the block last ran, as a store ends a block. A block with a stale tag
+// whose words have changed is translated again in place, so links to
+// it stay good; otherwise it only takes the new tags. The engine binds
+// to the Memory of the first core it runs, and must not outlive it.
+//
+// With fusion on, a block entered HOT_RUNS times is scanned for the
+// idioms in mips32-Fusion.h, and run() executes each one it finds as a
+// group, through the block's own handlers, provided the whole group
+// fits within max. A group still counts as its full length in the
+// return value and in g_cop0_count, so cycle counts are unchanged.
+//
+// With lanes on, instructions are resolved as in the decode cache with
+// lanes on.
+
+class MavenBlockEngine
+{
+public:
+  typedef MavenDecodeCache::entry_t entry_t;
+  typedef MIPS32FusedGroup<MavenCPInstruction, MavenCPState> group_t;
+
+  enum
+  {
+    MAX_INSTS    = 32,
+    FAST_ENTRIES = 1024,
+    HOT_RUNS     = 64,
+  };
+
+  struct block_t
+  {
+    addr_t start;
+    int ninsts;
+    uint32_t gen[2];           // code generations of its first and last pages
+    block_t* link[2];
+    uint32_t runs;             // times entered at its start
+    group_t* groups;           // per instruction once fused, else NULL
+    entry_t insts[MAX_INSTS];
+  };
+
+  MavenBlockEngine()
+    : gens(NULL)
+    , cur(NULL)
+    , idx(0)
+    , fusion(false)
+    , lanes(false)
+    , nblocks(0)
+    , ngroups(0)
+    , nfused(0)
+  {
+    memset(fast, 0, sizeof(fast));
+  }
+
+  ~MavenBlockEngine()
+  {
+    flush();
+  }
+
+  void set_fusion(bool val)
+  {
+    fusion = val;
+  }
+
+  void set_lanes(bool val)
+  {
+    lanes = val;
+  }
+
+  // Returns the number of instructions executed, at least one
+  int run(MavenCP& cp, int max, MavenPerfCounters* perf)
+  {
+    MavenCPState& state = cp.state;
+    block_t* b = enter(cp, state.pc);
+    while (__builtin_expect(stale(b), 0))
+    {
+      refresh(cp, b);
+      if (idx >= b->ninsts) // translated again, and shorter
+      {
+        cur = NULL;
+        b = enter(cp, state.pc);
+      }
+    }
+    int i = idx;
+    int n = 0;
+
+    while (n < max)
+    {
+      entry_t& e = b->insts[i];
+      int len = (b->groups && b->groups[i].len > 1 && n + b->groups[i].len <= max)
+              ? b->groups[i].len : 1;
+
+      if (len > 1)
+      {
+        mips32_fuse_execute(b->groups[i], state, perf);
+        maven::g_cop0_count += len;
+        nfused += len;
+        n += len;
+        i += len;
+        if (i == b->ninsts)
+          break;
+        continue;
+      }
+
+      state.alu = 0;
+      state.inst_branch = false;
+      state.inst_jump = false;
+      state.branch = false;
+      e.execute(&e.inst, &state);
+      maven::g_cop0_count++;
+      if (perf)
+        perf->retire(state);
+      n++;
+      i++;
+
+      if (state.runstate != MavenCPState::RUNNING)
+      {
+        cur = NULL;
+        return n;
+      }
+
+      if (!state.branch)
+      {
+        state.pc = state.npc;
+        state.npc += 4;
+      }
+
+      if (i == b->ninsts)
+        break;
+      if (state.pc != e.pc + 4 || !MavenDecodeCache::can_step(state))
+      {
+        cur = NULL;
+        return n;
+      }
+    }
+
+    cur = b;
+    idx = i;
+    return n;
+  }
+
+  uint64_t get_blocks() { return nblocks; }
+  uint64_t get_fused_groups() { return ngroups; }
+  uint64_t get_fused_insts() { return nfused; }
+
+private:
+  // The block and index to run pc from: the rest of the current block,
+  // a linked successor once it is done, or else the block starting at pc
+  block_t* enter(MavenCP& cp, addr_t pc)
+  {
+    if (cur && idx < cur->ninsts && pc == cur->start + 4*idx)
+      return cur;
+
+    block_t* b = NULL;
+    if (cur && idx == cur->ninsts)
+    {
+      if (cur->link[0] && cur->link[0]->start == pc)
+        b = cur->link[0];
+      else if (cur->link[1] && cur->link[1]->start == pc)
+        b = cur->link[1];
+      else
+      {
+        b = find(cp, pc);
+        if (!cur->link[0])
+          cur->link[0] = b;
+        else if (!cur->link[1])
+          cur->link[1] = b;
+      }
+    }
+    else
+      b = find(cp, pc);
+
+    cur = b;
+    idx = 0;
+    if (fusion && !b->groups && ++b->runs == HOT_RUNS)
+      fuse(b);
+    return b;
+  }
+
+  static addr_t first_page(block_t* b)
+  {
+    return b->start >> Memory::PAGE_SHIFT;
+  }
+
+  static addr_t last_page(block_t* b)
+  {
+    return b->insts[b->ninsts-1].pc >> Memory::PAGE_SHIFT;
+  }
+
+  // Whether code may have been stored to on b's pages since it was
+  // translated or refreshed
+  bool stale(block_t* b)
+  {
+    return b->gen[0] != gens[first_page(b)] || b->gen[1] != gens[last_page(b)];
+  }
+
+  // Mark b's pages as code and take their current generations
+  void tag(MavenCP& cp, block_t* b)
+  {
+    if (!gens)
+      gens = cp.mem.code_generations();
+    cp.mem.mark_code(first_page(b));
+    cp.mem.mark_code(last_page(b));
+    b->gen[0] = gens[first_page(b)];
+    b->gen[1] = gens[last_page(b)];
+  }
+
+  // Bring a stale block up to date, translating it again if any of its
+  // words have changed. Links to and from it are checked against the
+  // start pc when followed, so they stay.
+  void refresh(MavenCP& cp, block_t* b)
+  {
+    for (int j=0; j<b->ninsts; j++)
+    {
+      if (cp.mem.fetch_uint32(b->insts[j].pc) != b->insts[j].inst.get_bits())
+      {
+        delete [] b->groups;
+        b->groups = NULL;
+        b->runs = 0;
+        fill(cp, b);
+        return;
+      }
+    }
+    tag(cp, b);
+  }
+
+  void fuse(block_t* b)
+  {
+    b->groups = new group_t[MAX_INSTS];
+    for (int i=0; i<b->ninsts; i++)
+      b->groups[i].len = 0;
+
+    for (int i=0; i<b->ninsts; )
+    {
+      group_t::op_t ops[3];
+      int n = b->ninsts - i < 3 ? b->ninsts - i : 3;
+      for (int j=0; j<n; j++)
+      {
+        ops[j].inst = &b->insts[i+j].inst;
+        ops[j].execute = b->insts[i+j].execute;
+      }
+
+      if (mips32_fuse_match(ops, n, &b->groups[i]))
+      {
+        ngroups++;
+        i += b->groups[i].len;
+      }
+      else
+        i++;
+    }
+  }
+
+  block_t* find(MavenCP& cp, addr_t pc)
+  {
+    block_t*& slot = fast[(pc >> 2) & (FAST_ENTRIES-1)];
+    if (slot && slot->start == pc)
+      return slot;
+
+    block_t*& b = blocks[pc];
+    if (!b)
+      b = translate(cp, pc);
+    slot = b;
+    return b;
+  }
+
+  block_t* translate(MavenCP& cp, addr_t pc)
+  {
+    block_t* b = new block_t;
+    b->start = pc;
+    b->ninsts = 0;
+    b->link[0] = NULL;
+    b->link[1] = NULL;
+    b->runs = 0;
+    b->groups = NULL;
+    nblocks++;
+    fill(cp, b);
+    return b;
+  }
+
+  // Decode b's instructions from b->start and tag it. A block is at
+  // most MAX_INSTS words, so it touches at most two pages.
+  void fill(MavenCP& cp, block_t* b)
+  {
+    addr_t pc = b->start;
+    b->ninsts = 0;
+
+    bool delay_slot = false;
+    while (b->ninsts < MAX_INSTS && pc < MAVEN_SYSCFG_MEMORY_SIZE)
+    {
+      entry_t& e = b->insts[b->ninsts++];
+      e.pc = pc;
+      e.inst.set_bits(cp.mem.fetch_uint32(pc));
+      e.execute = MavenDecodeCache::resolve(cp, &e.inst, lanes);
+      pc += 4;
+
+      if (delay_slot)
+        break;
+      int cls = maven_block_class(e.inst.get_bits());
+      if (cls == MAVEN_BLOCK_END)
+        break;
+      delay_slot = (cls == MAVEN_BLOCK_BRANCH);
+    }
+    tag(cp, b);
+  }
+
+  void flush()
+  {
+    std::map<addr_t, block_t*>::iterator it;
+    for (it = blocks.begin(); it != blocks.end(); ++it)
+    {
+      delete [] it->second->groups;
+      delete it->second;
+    }
+    blocks.clear();
+    memset(fast, 0, sizeof(fast));
+    cur = NULL;
+    idx = 0;
+  }
+
+  std::map<addr_t, block_t*> blocks;
+  block_t* fast[FAST_ENTRIES];
+  const uint32_t* gens; // the Memory's code generations, NULL until bound
+
+  block_t* cur; // block the last run stopped in, or NULL
+  int idx;      // where in cur it stopped
+
+  bool fusion;
+  bool lanes;
+
+  uint64_t nblocks;
+  uint64_t ngroups; // fused groups built
+  uint64_t nfused;  // instructions executed in fused groups
+};
+
+#endif // __MAVENBLOCKENGINE_H
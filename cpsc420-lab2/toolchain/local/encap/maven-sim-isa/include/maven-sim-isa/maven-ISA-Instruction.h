@@ -5,6 +5,7 @@
 #include "syscfg.h"
 #include "maven-Processor.h"
 #include "maven-global.h"
+#include "maven-PerfCounters.h"
 
 //------------------------------------------------------------------------
 // Note from cbatten
@@ -62,6 +63,16 @@ struct maven_mfc0
     else if ( inst->get_rd() == MAVEN_SYSCFG_REGDEF_COP0_TID_MASK )
       proc->write_register( inst->get_rt(), *proc->tid_mask_ptr );
 
+    // Performance counters
+    else if ( inst->get_rd() == MAVEN_SYSCFG_REGDEF_COP0_PERF_CTRL )
+      proc->write_register( inst->get_rt(), MavenPerfCounters::of(*proc).read_ctrl() );
+    else if ( inst->get_rd() == MAVEN_SYSCFG_REGDEF_COP0_PERF_SEL )
+      proc->write_register( inst->get_rt(), MavenPerfCounters::of(*proc).select );
+    else if ( inst->get_rd() == MAVEN_SYSCFG_REGDEF_COP0_PERF_VAL )
+      proc->write_register( inst->get_rt(), MavenPerfCounters::of(*proc).read_selected() );
+    else if ( inst->get_rd() == MAVEN_SYSCFG_REGDEF_COP0_PERF_VAL_HI )
+      proc->write_register( inst->get_rt(), (MavenPerfCounters::of(*proc).read_selected() >> 32) );
+
     else {
       proc->raise_exception( StateType::EXCEPTION_RESERVED_INSTRUCTION );
     }
@@ -92,8 +103,15 @@ struct maven_mtc0
     else if ( inst->get_rd() == MAVEN_SYSCFG_REGDEF_COP0_TID_STOP )
     {
       if (proc->proc_id != 0)
-        *proc->tid_mask_ptr &= ~(1 << proc->proc_id); 
+        atomic_and(proc->tid_mask_ptr, ~(1 << proc->proc_id));
     }
+
+    // Performance counters
+    else if ( inst->get_rd() == MAVEN_SYSCFG_REGDEF_COP0_PERF_CTRL )
+      MavenPerfCounters::of(*proc).write_ctrl( proc->read_register( inst->get_rt() ) );
+    else if ( inst->get_rd() == MAVEN_SYSCFG_REGDEF_COP0_PERF_SEL )
+      MavenPerfCounters::of(*proc).select = proc->read_register( inst->get_rt() );
+
     else {
       proc->raise_exception( StateType::EXCEPTION_RESERVED_INSTRUCTION );
     }
@@ -150,13 +168,17 @@ struct maven_stop
 // As with the sync.*.v and sync.*.cv the new sync.l instruction really
 // doesn't need to do anything because we always execute instructions in
 // order, memory operations are instantaneous and atomic, and we execute
-// VPs to completion before executing the next CP command.
+// VPs to completion before executing the next CP command. The one
+// exception is when cores run on separate host threads, where it has to
+// order this core's memory operations against the other threads.
 
 template <typename InstructionType, typename StateType>
 struct maven_sync_l
 {
   static void execute(InstructionType* inst, StateType* proc)
-  { }
+  {
+    proc->mem.fence();
+  }
   static void disassemble(InstructionType* inst, StateType* proc)
   {
     sprintf(proc->disassemble_string, "sync.l");
@@ -171,17 +193,14 @@ struct maven_amo_add
     addr_t addr = proc->read_register(inst->get_rs());
     int32_t temp;
 
-    if (addr & 0x3)
-    {
-      proc->raise_exception(StateType::EXCEPTION_ADDR_MISALIGNED_LOAD);
-    }
-    else
+    proc->mem.begin_amo();
+    if (mem_load(proc, addr, temp))
     {
-      temp = proc->mem.read_mem_int32(addr);
-      proc->mem.write_mem_uint32( addr, 
+      mem_store<uint32_t>( proc, addr,
         temp + proc->read_register(inst->get_rt()) );
       proc->write_register(inst->get_rd(), temp);
     }
+    proc->mem.end_amo();
   }
   static void disassemble(InstructionType* inst, StateType* proc)
   {
@@ -200,17 +219,14 @@ struct maven_amo_and
     addr_t addr = proc->read_register(inst->get_rs());
     int32_t temp;
 
-    if (addr & 0x3)
-    {
-      proc->raise_exception(StateType::EXCEPTION_ADDR_MISALIGNED_LOAD);
-    }
-    else
+    proc->mem.begin_amo();
+    if (mem_load(proc, addr, temp))
     {
-      temp = proc->mem.read_mem_int32(addr);
-      proc->mem.write_mem_uint32( addr, 
+      mem_store<uint32_t>( proc, addr,
         temp & proc->read_register(inst->get_rt()) );
       proc->write_register(inst->get_rd(), temp);
     }
+    proc->mem.end_amo();
   }
   static void disassemble(InstructionType* inst, StateType* proc)
   {
@@ -229,17 +245,14 @@ struct maven_amo_or
     addr_t addr = proc->read_register(inst->get_rs());
     int32_t temp;
 
-    if (addr & 0x3)
-    {
-      proc->raise_exception(StateType::EXCEPTION_ADDR_MISALIGNED_LOAD);
-    }
-    else
+    proc->mem.begin_amo();
+    if (mem_load(proc, addr, temp))
     {
-      temp = proc->mem.read_mem_int32(addr);
-      proc->mem.write_mem_uint32( addr, 
+      mem_store<uint32_t>( proc, addr,
         temp | proc->read_register(inst->get_rt()) );
       proc->write_register(inst->get_rd(), temp);
     }
+    proc->mem.end_amo();
   }
   static void disassemble(InstructionType* inst, StateType* proc)
   {
@@ -1527,7 +1540,10 @@ struct maven_amo_vv
     int r_mask   = inst->get_msk();
     int cmd_code = inst->get_cmd();
 
+    // The whole command is one critical section, like a scalar AMO
+    proc->mem.begin_amo();
     proc->vparray.amo_vv(r_vdst, r_vaddr, r_vsrc, r_mask, cmd_code);
+    proc->mem.end_amo();
   }
   static void disassemble(InstructionType* inst, StateType* proc)
   {
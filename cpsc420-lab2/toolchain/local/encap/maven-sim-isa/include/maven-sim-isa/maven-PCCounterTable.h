@@ -0,0 +1,185 @@
+#ifndef __MAVENPCCOUNTERTABLE_H
+#define __MAVENPCCOUNTERTABLE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+#include "types.h"
+
+//------------------------------------------------------------------------
+// Per-PC counter table
+//------------------------------------------------------------------------
+// A flat open-addressed hash from pc to a 32-bit count, for statistics
+// that are bumped on the simulation hot path. Counting an existing pc
+// is one multiply-shift and, almost always, one probe; nothing is
+// allocated except when the table passes half full and doubles, which
+// with the default capacity only happens in programs with thousands of
+// distinct branch pcs.
+//
+// operator[], begin()/end() and the first/second entry fields follow
+// std::map, so code written as `counts[pc]++` or as a loop over a map
+// iterator carries over with only the iterator type renamed. Like the
+// map, iteration is in pc order: begin() takes a sorted copy of the
+// entries, so counts bumped during a loop show up in the next one.
+
+class MavenPCCounterTable
+{
+public:
+  struct entry_t
+  {
+    uint32_t first;  // pc
+    uint32_t second; // count
+  };
+
+  typedef std::vector<entry_t>::const_iterator iterator;
+  typedef std::vector<entry_t>::const_iterator const_iterator;
+
+  enum
+  {
+    EMPTY = 0xffffffff, // never a valid (word aligned) pc
+  };
+
+  MavenPCCounterTable(int capacity = 1024)
+    : table(NULL)
+  {
+    int n = 16;
+    while (n < 2*capacity)
+      n <<= 1;
+    alloc(n);
+  }
+
+  ~MavenPCCounterTable()
+  {
+    delete [] table;
+  }
+
+  uint32_t& operator[](uint32_t pc)
+  {
+    uint32_t i = hash(pc);
+    while (table[i].first != pc)
+    {
+      if (table[i].first == EMPTY)
+      {
+        if (2*(count+1) > mask+1)
+        {
+          grow();
+          return (*this)[pc];
+        }
+        table[i].first = pc;
+        table[i].second = 0;
+        count++;
+        break;
+      }
+      i = (i+1) & mask;
+    }
+    return table[i].second;
+  }
+
+  uint32_t get(uint32_t pc) const
+  {
+    for (uint32_t i=hash(pc); table[i].first != EMPTY; i=(i+1)&mask)
+      if (table[i].first == pc)
+        return table[i].second;
+    return 0;
+  }
+
+  size_t size() const
+  {
+    return count;
+  }
+
+  bool empty() const
+  {
+    return count == 0;
+  }
+
+  iterator begin() const
+  {
+    sorted(rows);
+    return rows.begin();
+  }
+
+  iterator end() const
+  {
+    return rows.end();
+  }
+
+  void clear()
+  {
+    memset(table, 0xff, (mask+1) * sizeof(entry_t));
+    count = 0;
+  }
+
+  // All entries in pc order
+  void sorted(std::vector<entry_t>& out) const
+  {
+    out.clear();
+    out.reserve(count);
+    for (uint32_t i=0; i<=mask; i++)
+      if (table[i].first != EMPTY)
+        out.push_back(table[i]);
+    std::sort(out.begin(), out.end(), pc_less);
+  }
+
+  // One "pc,count" row per entry, in pc order, under a header row
+  void write_csv(FILE* fp, const char* header) const
+  {
+    fprintf(fp, "%s\n", header);
+    for (iterator it=begin(); it!=end(); it++)
+      fprintf(fp, "0x%08x,%u\n", it->first, it->second);
+  }
+
+private:
+  // Copying would share the table
+  MavenPCCounterTable(const MavenPCCounterTable&);
+  MavenPCCounterTable& operator=(const MavenPCCounterTable&);
+
+  uint32_t hash(uint32_t pc) const
+  {
+    return ((pc >> 2) * 0x9e3779b1u) >> shift;
+  }
+
+  static bool pc_less(const entry_t& a, const entry_t& b)
+  {
+    return a.first < b.first;
+  }
+
+  void alloc(uint32_t n)
+  {
+    table = new entry_t [n];
+    mask = n - 1;
+    shift = 32;
+    while (n > 1)
+    {
+      n >>= 1;
+      shift--;
+    }
+    clear();
+  }
+
+  void grow()
+  {
+    entry_t* old = table;
+    uint32_t old_size = mask + 1;
+
+    alloc(2 * old_size);
+    for (uint32_t i=0; i<old_size; i++)
+      if (old[i].first != EMPTY)
+        (*this)[old[i].first] = old[i].second;
+
+    delete [] old;
+  }
+
+  entry_t* table;
+  uint32_t mask;
+  int shift; // keeps the top log2(size) bits of the hash product
+  uint32_t count;
+
+  // pc ordered copy behind begin()/end()
+  mutable std::vector<entry_t> rows;
+};
+
+#endif // __MAVENPCCOUNTERTABLE_H
@@ -0,0 +1,321 @@
+#ifndef __MAVENPVFBARRAY_H
+#define __MAVENPVFBARRAY_H
+
+#include <assert.h>
+#include <stdio.h>
+#include "maven-PVFB.h"
+
+//------------------------------------------------------------------------
+// Allocation-free PVFB stacks
+//------------------------------------------------------------------------
+// Drop-in alternatives to MavenPVFBStack and MavenPVFBStack_plus which
+// keep their fragments in fixed arrays rather than std::lists, so a
+// divergent branch never touches the heap. Fragments hold disjoint,
+// nonempty VP masks, so there are never more than MAVEN_SYSCFG_VLEN_MAX
+// of them and each stack is an array of that many entries. Entries only
+// come and go at the top, so the pointers member_pc hands out stay
+// valid until that fragment is popped, just as with the list.
+//
+// member_pc is a lookup in a small open-addressed table from pc to
+// fragment instead of a walk over the list. insert_frags merges a new
+// fragment into any waiting fragment at the same pc, so each pc is
+// normally in the table once. pushfront does not merge; if it adds a
+// second fragment at a pc, the table points at the newest one and pops
+// fall back to a scan until the duplicate is gone.
+
+class MavenPVFBPCIndex
+{
+public:
+  enum
+  {
+    SIZE = 4 * MAVEN_SYSCFG_VLEN_MAX, // keeps the table at most 1/4 full
+    MASK = SIZE - 1,
+  };
+
+  MavenPVFBPCIndex()
+  {
+    for (int i=0; i<SIZE; i++)
+      table[i].frag = NULL;
+  }
+
+  MavenVPFrag* lookup(uint32_t pc)
+  {
+    for (int i=hash(pc); table[i].frag != NULL; i=(i+1)&MASK)
+      if (table[i].pc == pc)
+        return table[i].frag;
+    return NULL;
+  }
+
+  // Maps pc to frag, replacing any existing mapping
+  void insert(uint32_t pc, MavenVPFrag* frag)
+  {
+    int i = hash(pc);
+    while (table[i].frag != NULL && table[i].pc != pc)
+      i = (i+1) & MASK;
+    table[i].pc = pc;
+    table[i].frag = frag;
+  }
+
+  // Removes the mapping for pc if it points at frag. Later entries in
+  // the probe run are shifted back so lookups never need tombstones.
+  void remove(uint32_t pc, MavenVPFrag* frag)
+  {
+    int i = hash(pc);
+    while (table[i].frag != NULL && table[i].pc != pc)
+      i = (i+1) & MASK;
+    if (table[i].frag != frag)
+      return;
+
+    int j = i;
+    while (true)
+    {
+      table[i].frag = NULL;
+      int home;
+      do
+      {
+        j = (j+1) & MASK;
+        if (table[j].frag == NULL)
+          return;
+        home = hash(table[j].pc);
+      } while (i <= j ? (i < home && home <= j) : (i < home || home <= j));
+      table[i] = table[j];
+      i = j;
+    }
+  }
+
+//private:
+  struct entry_t
+  {
+    uint32_t pc;
+    MavenVPFrag* frag;
+  };
+
+  static int hash(uint32_t pc)
+  {
+    return (((pc >> 2) * 0x9e3779b1u) >> 16) & MASK;
+  }
+
+  entry_t table[SIZE];
+};
+
+//------------------------------------------------------------------------
+// Bounded fragment stack
+//------------------------------------------------------------------------
+
+class MavenPVFBArrayStack : public MavenPVFB
+{
+public:
+  MavenPVFBArrayStack()
+    : top(0)
+    , dups(0)
+  {
+  }
+
+  // flag unused in base stack impl
+  void insert_frags(uint32_t /* flag */, const MavenVPFrag& frag0, const MavenVPFrag& frag1)
+  {
+    insert(frag0);
+    insert(frag1);
+  }
+
+  void insert(const MavenVPFrag& frag)
+  {
+    if (frag.mask == 0)
+      return;
+
+    MavenVPFrag* waiting = index.lookup(frag.pc);
+    if (waiting)
+    {
+      waiting->mask |= frag.mask;
+      waiting->size += frag.size;
+      return;
+    }
+
+    pushfront(frag);
+  }
+
+  void pushfront(const MavenVPFrag& frag)
+  {
+    assert( top < MAVEN_SYSCFG_VLEN_MAX );
+    if (index.lookup(frag.pc))
+      dups++;
+    fragments[top] = frag;
+    index.insert(frag.pc, &fragments[top]);
+    top++;
+  }
+
+  const MavenVPFrag pop()
+  {
+    assert( top > 0 );
+    top--;
+    MavenVPFrag frag = fragments[top];
+    unindex(frag.pc, &fragments[top]);
+    return frag;
+  }
+
+  bool empty()
+  {
+    return top == 0;
+  }
+
+  MavenVPFrag* member_pc(uint32_t pc)
+  {
+    return index.lookup(pc);
+  }
+
+  void dump()
+  {
+    printf("pvfb stack:");
+    for (int i=top-1; i>=0; i--)
+      printf(" [pc=%08x mask=%08x]", fragments[i].pc, fragments[i].mask);
+    printf("\n");
+  }
+
+//private:
+  // Drops the index entry for a popped fragment, repointing it at an
+  // older fragment with the same pc if pushfront left one behind
+  void unindex(uint32_t pc, MavenVPFrag* frag)
+  {
+    index.remove(pc, frag);
+    if (dups == 0)
+      return;
+
+    for (int i=top-1; i>=0; i--)
+      if (fragments[i].pc == pc)
+      {
+        dups--;
+        index.insert(pc, &fragments[i]);
+        return;
+      }
+  }
+
+  MavenVPFrag fragments[MAVEN_SYSCFG_VLEN_MAX];
+  int top;
+  MavenPVFBPCIndex index;
+  int dups; // fragments sharing a pc with an older one
+};
+
+//------------------------------------------------------------------------
+// Bounded multiple stack array for loop structures
+//------------------------------------------------------------------------
+// Same policy as MavenPVFBStack_plus: a fragment produced by a backwards
+// branch (its pc is at or before the branch pc passed as flag) goes on
+// the next stack, everything else on the current one, and the current
+// stack is emptied before switching.
+
+class MavenPVFBArrayStack_plus : public MavenPVFB
+{
+public:
+  MavenPVFBArrayStack_plus()
+    : curr_stack(0)
+    , dups(0)
+  {
+    top[0] = top[1] = 0;
+  }
+
+  // flag is used to determine how to push fragments onto stack
+  // flag = pc
+  void insert_frags(uint32_t flag, const MavenVPFrag& frag0, const MavenVPFrag& frag1)
+  {
+    insert(frag0, frag0.pc <= flag);
+    insert(frag1, frag1.pc <= flag);
+  }
+
+  void insert(const MavenVPFrag& frag, bool insert_next)
+  {
+    if (frag.mask == 0)
+      return;
+
+    MavenVPFrag* waiting = index.lookup(frag.pc);
+    if (waiting)
+    {
+      waiting->mask |= frag.mask;
+      waiting->size += frag.size;
+      return;
+    }
+
+    push(insert_next ? 1 - curr_stack : curr_stack, frag);
+  }
+
+  void pushfront(const MavenVPFrag& frag)
+  {
+    push(curr_stack, frag);
+  }
+
+  const MavenVPFrag pop()
+  {
+    if (top[curr_stack] == 0)
+      curr_stack = 1 - curr_stack;
+
+    int s = curr_stack;
+    assert( top[s] > 0 );
+    top[s]--;
+    MavenVPFrag frag = fragments[s][top[s]];
+    unindex(frag.pc, &fragments[s][top[s]]);
+    return frag;
+  }
+
+  bool empty()
+  {
+    return top[0] == 0 && top[1] == 0;
+  }
+
+  MavenVPFrag* member_pc(uint32_t pc)
+  {
+    return index.lookup(pc);
+  }
+
+  void dump()
+  {
+    for (int s=0; s<NUM_STACKS; s++)
+    {
+      printf("pvfb stack %d%s:", s, s == curr_stack ? " (current)" : "");
+      for (int i=top[s]-1; i>=0; i--)
+        printf(" [pc=%08x mask=%08x]", fragments[s][i].pc, fragments[s][i].mask);
+      printf("\n");
+    }
+  }
+
+//private:
+  static const int NUM_STACKS = 2;
+
+  void push(int s, const MavenVPFrag& frag)
+  {
+    assert( top[s] < MAVEN_SYSCFG_VLEN_MAX );
+    if (index.lookup(frag.pc))
+      dups++;
+    fragments[s][top[s]] = frag;
+    index.insert(frag.pc, &fragments[s][top[s]]);
+    top[s]++;
+  }
+
+  void unindex(uint32_t pc, MavenVPFrag* frag)
+  {
+    index.remove(pc, frag);
+    if (dups == 0)
+      return;
+
+    // The popped fragment may have been the older of a pair, in which
+    // case the index already points at the survivor
+    for (int s=0; s<NUM_STACKS; s++)
+      for (int i=top[s]-1; i>=0; i--)
+        if (fragments[s][i].pc == pc)
+        {
+          dups--;
+          if (!index.lookup(pc))
+            index.insert(pc, &fragments[s][i]);
+          return;
+        }
+  }
+
+  MavenVPFrag fragments[NUM_STACKS][MAVEN_SYSCFG_VLEN_MAX];
+  int top[NUM_STACKS];
+
+  // stack for the current loop
+  int curr_stack;
+
+  MavenPVFBPCIndex index;
+  int dups; // fragments sharing a pc with an older one
+};
+
+#endif // __MAVENPVFBARRAY
@@ -0,0 +1,196 @@
+#ifndef __MAVENPERFCOUNTERS_H
+#define __MAVENPERFCOUNTERS_H
+
+#include <stdio.h>
+#include <string.h>
+#include <map>
+
+#include "types.h"
+#include "syscfg.h"
+
+//------------------------------------------------------------------------
+// Per-core performance counters
+//------------------------------------------------------------------------
+// A block of 64-bit event counters in each control processor. Every
+// retired CP instruction bumps the retired count, the counter for its
+// ALU_* class (processor.h; loads and stores are the ALU_LD and ALU_ST
+// classes), and the branch counters. Counting is branch-free: the
+// enable bit is added in, and the class is used as an index, so leaving
+// the counters on costs a handful of adds per instruction.
+//
+// Target code reaches the counters through cop0:
+//
+//   mtc0 PERF_CTRL  bit 0 enables counting, writing bit 1 clears them
+//   mtc0 PERF_SEL   picks the counter PERF_VAL/PERF_VAL_HI read
+//   mfc0 PERF_VAL   low 32 bits of the selected counter
+//   mfc0 PERF_VAL_HI high 32 bits of the selected counter
+//
+// Counter numbers are the enum below; the class counters are
+// PERF_CLASS + ALU_*, with PERF_CLASS + 0 counting instructions that
+// set no class. PERF_VP_FRAGS is bumped by whoever launches VP
+// fragments, through add().
+//
+// The counters are kept beside MavenCPState rather than in it, since
+// the prebuilt processor objects fix its layout. of() finds a core's
+// block, creating it on first use. A slot per proc_id remembers the
+// last state looked up, so the lookup on the per-instruction path is a
+// single compare.
+
+class MavenPerfCounters
+{
+public:
+  enum
+  {
+    PERF_INSTRET     = 0,
+    PERF_CLASS       = 1,
+    NUM_CLASSES      = 16,
+    PERF_BRANCHES    = PERF_CLASS + NUM_CLASSES, // conditional branches
+    PERF_BR_TAKEN,                               // ... which were taken
+    PERF_JUMPS,                                  // other control transfers
+    PERF_VP_FRAGS,                               // VP fragments launched
+    NUM_COUNTERS,
+  };
+
+  enum
+  {
+    CTRL_ENABLE = 0x1,
+    CTRL_CLEAR  = 0x2,
+  };
+
+  MavenPerfCounters()
+    : enabled(1)
+    , select(0)
+  {
+    clear();
+  }
+
+  void clear()
+  {
+    memset(count, 0, sizeof(count));
+  }
+
+  // Call after each instruction, with the microarch fields the
+  // instruction set (they must be cleared before it executes).
+  template <typename StateType>
+  void retire(const StateType& state)
+  {
+    uint64_t en = enabled;
+    uint64_t cond = state.inst_branch;
+    uint64_t taken = state.branch;
+
+    count[PERF_INSTRET] += en;
+    count[PERF_CLASS + (state.alu & (NUM_CLASSES-1))] += en;
+    count[PERF_BRANCHES] += en & cond;
+    count[PERF_BR_TAKEN] += en & cond & taken;
+    count[PERF_JUMPS] += en & ~cond & taken;
+  }
+
+  void add(int idx, uint64_t n)
+  {
+    count[idx] += enabled * n;
+  }
+
+  //----------------------------------------------------------------------
+  // Per-core lookup
+  //----------------------------------------------------------------------
+
+  template <typename StateType>
+  static MavenPerfCounters& of(const StateType& state)
+  {
+    slot_t& s = slots()[state.proc_id & (MAVEN_SYSCFG_MAX_PROCS-1)];
+    if (__builtin_expect(s.owner == &state, 1))
+      return *s.perf;
+
+    MavenPerfCounters*& p = blocks()[&state];
+    if (!p)
+      p = new MavenPerfCounters;
+    s.owner = &state;
+    s.perf = p;
+    return *p;
+  }
+
+  // Drop the block of a core that is going away, so a core later built
+  // at the same address starts from zero
+  static void forget(const void* owner)
+  {
+    std::map<const void*, MavenPerfCounters*>::iterator it = blocks().find(owner);
+    if (it == blocks().end())
+      return;
+    for (int i=0; i<MAVEN_SYSCFG_MAX_PROCS; i++)
+      if (slots()[i].owner == owner)
+        slots()[i].owner = NULL;
+    delete it->second;
+    blocks().erase(it);
+  }
+
+  //----------------------------------------------------------------------
+  // cop0 interface
+  //----------------------------------------------------------------------
+
+  void write_ctrl(uint32_t val)
+  {
+    if (val & CTRL_CLEAR)
+      clear();
+    enabled = val & CTRL_ENABLE;
+  }
+
+  uint32_t read_ctrl()
+  {
+    return enabled;
+  }
+
+  uint64_t read_selected()
+  {
+    return select < NUM_COUNTERS ? count[select] : 0;
+  }
+
+  //----------------------------------------------------------------------
+  // Reporting
+  //----------------------------------------------------------------------
+
+  void dump(FILE* fp, int core)
+  {
+    static const char* class_names[NUM_CLASSES] =
+    {
+      "other", "int", "idivrem", "imul", "faddsub", "fdiv", "fmul",
+      "fsqrt", "ld", "st", "vld", "vst", "class12", "class13",
+      "class14", "class15",
+    };
+
+    fprintf(fp, "core%d.perf.instret %llu\n", core, (unsigned long long) count[PERF_INSTRET]);
+    for (int i=0; i<NUM_CLASSES; i++)
+      if (count[PERF_CLASS+i])
+        fprintf(fp, "core%d.perf.class.%s %llu\n", core, class_names[i],
+                (unsigned long long) count[PERF_CLASS+i]);
+    fprintf(fp, "core%d.perf.branches %llu\n", core, (unsigned long long) count[PERF_BRANCHES]);
+    fprintf(fp, "core%d.perf.branches_taken %llu\n", core, (unsigned long long) count[PERF_BR_TAKEN]);
+    fprintf(fp, "core%d.perf.jumps %llu\n", core, (unsigned long long) count[PERF_JUMPS]);
+    fprintf(fp, "core%d.perf.vp_frags %llu\n", core, (unsigned long long) count[PERF_VP_FRAGS]);
+  }
+
+//private:
+  uint64_t count[NUM_COUNTERS];
+  uint64_t enabled; // 0 or 1, added into the counters
+  uint32_t select;
+
+private:
+  struct slot_t
+  {
+    const void* owner;
+    MavenPerfCounters* perf;
+  };
+
+  static slot_t* slots()
+  {
+    static slot_t s[MAVEN_SYSCFG_MAX_PROCS];
+    return s;
+  }
+
+  static std::map<const void*, MavenPerfCounters*>& blocks()
+  {
+    static std::map<const void*, MavenPerfCounters*> b;
+    return b;
+  }
+};
+
+#endif // __MAVENPERFCOUNTERS_H
@@ -9,11 +9,14 @@
 #include "maven-PVFBQueue.h"
 #include "maven-PVFBStack.h"
 #include "maven-PVFBStack-plus.h"
+#include "maven-PVFBArray.h"
 #include "maven-VPFrag.h"
 #include "maven-ScoreBoard.h"
+#include "maven-PCCounterTable.h"
 #include "stdio.h"
 
 #include <map>
+#include <string>
 
 class MavenVPArray;
 
@@ -28,6 +31,29 @@ public:
 
   void process (FILE* logfile);
 
+  // Histograms as CSV, one table per file: fragment size against
+  // cycles in <prefix>-vl.csv, pc against number of splits in
+  // <prefix>-splits.csv. Returns false if either file can't be opened.
+  bool write_csv (const char* prefix)
+  {
+    std::string base(prefix);
+
+    FILE* fp = fopen((base + "-vl.csv").c_str(), "w");
+    if (!fp)
+      return false;
+    fprintf(fp, "active_vps,cycles\n");
+    for (int i=0; i<=MAVEN_SYSCFG_VLEN_MAX; i++)
+      fprintf(fp, "%d,%u\n", i, vl_freq[i]);
+    fclose(fp);
+
+    fp = fopen((base + "-splits.csv").c_str(), "w");
+    if (!fp)
+      return false;
+    splits.write_csv(fp, "pc,splits");
+    fclose(fp);
+    return true;
+  }
+
   DivergenceData(MavenVPArray& _vparray);
 
 // private:
@@ -47,7 +73,7 @@ public:
 
   // track frequency each pc causes a fragment split
   uint32_t split_total;
-  std::map<uint32_t, uint32_t> splits; // <pc> : number times split
+  MavenPCCounterTable splits; // <pc> : number times split
 };
 
 //------------------------------------------------------------------------
@@ -0,0 +1,428 @@
+//========================================================================
+// maven-VPLanes.h : SIMD kernels for unmasked integer VP commands
+//========================================================================
+// The VP array runs a vector arithmetic, load or store command by
+// walking every VP and doing one lane's worth of work against that VP's
+// own MavenVPState. When the command is unmasked every lane does the
+// same thing, so MavenVPLanes instead gathers the source register of
+// every lane into a row, runs one SIMD kernel over the whole row (SSE2,
+// or AVX2 when the compiler targets it) and scatters the destination
+// row back. Unit-stride word loads and stores move a whole row to or
+// from memory in one block copy.
+//
+// The kernels are reached through the maven_lanes_* handlers below,
+// which the decode cache and the block engine put in place of the
+// dispatch table's handler when maven_lanes_handler() recognizes the
+// instruction word. A handler that declines calls the same MavenVPArray
+// routine the table's handler would, so the per-VP loop stays the
+// reference. That covers masked commands, stats or vxudebug runs,
+// writes to r0, registers past the vcfg count, and ops with no kernel
+// such as div/rem, mulhi and the float ops. The kernels only use
+// integer operations whose results are fully defined, so the two paths
+// agree bit for bit.
+//
+// This is not a structure-of-arrays register file. The rows only live
+// for one command, and every command pays a gather of its sources and a
+// scatter of its result across the per-VP MavenVPState, which stays the
+// register file because the VP fragments in the prebuilt MavenVP
+// objects read and write it directly. Float commands are not covered:
+// they round and raise flags through softfloat per VP, and keep the
+// per-VP path.
+
+#ifndef __MAVENVPLANES_H
+#define __MAVENVPLANES_H
+
+#include <emmintrin.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "types.h"
+#include "syscfg.h"
+#include "memory.h"
+#include "processor.h"
+#include "maven-ISA.h"
+
+class MavenVPLanes
+{
+public:
+  enum
+  {
+    LANES = MAVEN_SYSCFG_VLEN_MAX,
+  };
+
+  // Kernel selectors
+  enum op_t
+  {
+    OP_NONE,
+    OP_ADD,
+    OP_SUB,
+    OP_MUL,
+    OP_SLL,
+    OP_SRL,
+    OP_SRA,
+    OP_AND,
+    OP_OR,
+    OP_XOR,
+    OP_NOR,
+  };
+
+  //----------------------------------------------------------------------
+  // Entry points
+  //----------------------------------------------------------------------
+  // Each returns false when the command needs the per-VP routine.
+  // VPArrayType is anything with MavenVPArray's vp, vl and stats_en, so
+  // the kernels can be exercised without a full VP array.
+
+  // vd = vs1 op vs2
+  template <typename VPArrayType>
+  bool arith_vv(VPArrayType& va, int r_vdst, int r_vsrc1, int r_vsrc2, int r_mask, int cmd_code)
+  {
+    op_t op = vv_op(cmd_code);
+    if (op == OP_NONE || r_mask != 0 || !usable(va, r_vdst)
+        || !in_range(va, r_vsrc1) || !in_range(va, r_vsrc2))
+      return false;
+
+    gather(va, r_vsrc1, R[ROW_A]);
+    gather(va, r_vsrc2, R[ROW_B]);
+    kernel(op, R[ROW_D], R[ROW_A], R[ROW_B], va.vl);
+    scatter(va, r_vdst, R[ROW_D]);
+    return true;
+  }
+
+  // vd = vs op rs (.vs), or vd = rs op vs (.sv)
+  template <typename VPArrayType>
+  bool arith_vs(VPArrayType& va, int r_vdst, reg_t sdata, int r_vsrc, int r_mask, int cmd_code)
+  {
+    bool swap = false;
+    op_t op = vs_op(cmd_code, swap);
+    if (op == OP_NONE || r_mask != 0 || !usable(va, r_vdst) || !in_range(va, r_vsrc))
+      return false;
+
+    gather(va, r_vsrc, R[ROW_A]);
+    if (!swap && (op == OP_SLL || op == OP_SRL || op == OP_SRA))
+      kernel_shift_uniform(op, R[ROW_D], R[ROW_A], sdata & 0x1f, va.vl);
+    else
+    {
+      fill(R[ROW_B], sdata, va.vl);
+      if (swap)
+        kernel(op, R[ROW_D], R[ROW_B], R[ROW_A], va.vl);
+      else
+        kernel(op, R[ROW_D], R[ROW_A], R[ROW_B], va.vl);
+    }
+    scatter(va, r_vdst, R[ROW_D]);
+    return true;
+  }
+
+  // lw.v / lwst.v with one element per VP
+  template <typename VPArrayType>
+  bool vload_w(VPArrayType& va, Memory& mem, addr_t addr, int rv, int stride)
+  {
+    if (!word_access_ok(va.vl, addr, stride) || !usable(va, rv))
+      return false;
+
+    if (stride == 4)
+      mem.read_block(addr, va.vl*4, (uint8_t*) R[ROW_D]);
+    else
+      for (int i=0; i<va.vl; i++)
+        R[ROW_D][i] = mem.read_mem_uint32(addr + i*stride);
+
+    scatter(va, rv, R[ROW_D]);
+    return true;
+  }
+
+  // sw.v / swst.v with one element per VP
+  template <typename VPArrayType>
+  bool vstore_w(VPArrayType& va, Memory& mem, addr_t addr, int rv, int stride)
+  {
+    if (!word_access_ok(va.vl, addr, stride) || va.stats_en || va.vl <= 0
+        || !in_range(va, rv))
+      return false;
+
+    gather(va, rv, R[ROW_A]);
+
+    if (stride == 4)
+      mem.write_block(addr, va.vl*4, (const uint8_t*) R[ROW_A]);
+    else
+      for (int i=0; i<va.vl; i++)
+        mem.write_mem_uint32(addr + i*stride, R[ROW_A][i]);
+
+    return true;
+  }
+
+  //----------------------------------------------------------------------
+  // Kernels
+  //----------------------------------------------------------------------
+  // Rows are LANES long and 32-byte aligned, so every kernel rounds n up
+  // to a whole vector and may touch lanes past vl.
+
+  static void kernel(op_t op, reg_t* d, const reg_t* a, const reg_t* b, int n)
+  {
+#ifdef __AVX2__
+#define LANE_LOOP(expr)                                                 \
+    for (int i=0; i<n; i+=8)                                            \
+    {                                                                   \
+      __m256i x = _mm256_load_si256((const __m256i*) &a[i]);            \
+      __m256i y = _mm256_load_si256((const __m256i*) &b[i]);            \
+      _mm256_store_si256((__m256i*) &d[i], expr);                       \
+    }
+
+    __m256i m = _mm256_set1_epi32(0x1f);
+    switch (op)
+    {
+      case OP_ADD: LANE_LOOP(_mm256_add_epi32(x, y)); break;
+      case OP_SUB: LANE_LOOP(_mm256_sub_epi32(x, y)); break;
+      case OP_MUL: LANE_LOOP(_mm256_mullo_epi32(x, y)); break;
+      case OP_SLL: LANE_LOOP(_mm256_sllv_epi32(x, _mm256_and_si256(y, m))); break;
+      case OP_SRL: LANE_LOOP(_mm256_srlv_epi32(x, _mm256_and_si256(y, m))); break;
+      case OP_SRA: LANE_LOOP(_mm256_srav_epi32(x, _mm256_and_si256(y, m))); break;
+      case OP_AND: LANE_LOOP(_mm256_and_si256(x, y)); break;
+      case OP_OR:  LANE_LOOP(_mm256_or_si256(x, y)); break;
+      case OP_XOR: LANE_LOOP(_mm256_xor_si256(x, y)); break;
+      case OP_NOR: LANE_LOOP(_mm256_xor_si256(_mm256_or_si256(x, y), _mm256_set1_epi32(-1))); break;
+      default: break;
+    }
+#else
+#define LANE_LOOP(expr)                                                 \
+    for (int i=0; i<n; i+=4)                                            \
+    {                                                                   \
+      __m128i x = _mm_load_si128((const __m128i*) &a[i]);               \
+      __m128i y = _mm_load_si128((const __m128i*) &b[i]);               \
+      _mm_store_si128((__m128i*) &d[i], expr);                          \
+    }
+
+    // SSE2 has no 32-bit multiply-low or per-lane shifts
+    switch (op)
+    {
+      case OP_ADD: LANE_LOOP(_mm_add_epi32(x, y)); break;
+      case OP_SUB: LANE_LOOP(_mm_sub_epi32(x, y)); break;
+      case OP_AND: LANE_LOOP(_mm_and_si128(x, y)); break;
+      case OP_OR:  LANE_LOOP(_mm_or_si128(x, y)); break;
+      case OP_XOR: LANE_LOOP(_mm_xor_si128(x, y)); break;
+      case OP_NOR: LANE_LOOP(_mm_xor_si128(_mm_or_si128(x, y), _mm_set1_epi32(-1))); break;
+      case OP_MUL: for (int i=0; i<n; i++) d[i] = a[i] * b[i]; break;
+      case OP_SLL: for (int i=0; i<n; i++) d[i] = a[i] << (b[i] & 0x1f); break;
+      case OP_SRL: for (int i=0; i<n; i++) d[i] = a[i] >> (b[i] & 0x1f); break;
+      case OP_SRA: for (int i=0; i<n; i++) d[i] = (int32_t) a[i] >> (b[i] & 0x1f); break;
+      default: break;
+    }
+#endif
+#undef LANE_LOOP
+  }
+
+  // Shift every lane by the same amount, which SSE2 can do directly
+  static void kernel_shift_uniform(op_t op, reg_t* d, const reg_t* a, int shamt, int n)
+  {
+    __m128i count = _mm_cvtsi32_si128(shamt);
+    for (int i=0; i<n; i+=4)
+    {
+      __m128i x = _mm_load_si128((const __m128i*) &a[i]);
+      __m128i r;
+      switch (op)
+      {
+        case OP_SLL: r = _mm_sll_epi32(x, count); break;
+        case OP_SRL: r = _mm_srl_epi32(x, count); break;
+        default:     r = _mm_sra_epi32(x, count); break;
+      }
+      _mm_store_si128((__m128i*) &d[i], r);
+    }
+  }
+
+  static op_t vv_op(int cmd_code)
+  {
+    switch (cmd_code)
+    {
+      case MAVEN_CP_COP2_ADDU_VV: return OP_ADD;
+      case MAVEN_CP_COP2_SUBU_VV: return OP_SUB;
+      case MAVEN_CP_COP2_MUL_VV:  return OP_MUL;
+      case MAVEN_CP_COP2_SLL_VV:  return OP_SLL;
+      case MAVEN_CP_COP2_SRL_VV:  return OP_SRL;
+      case MAVEN_CP_COP2_SRA_VV:  return OP_SRA;
+      case MAVEN_CP_COP2_AND_VV:  return OP_AND;
+      case MAVEN_CP_COP2_OR_VV:   return OP_OR;
+      case MAVEN_CP_COP2_XOR_VV:  return OP_XOR;
+      case MAVEN_CP_COP2_NOR_VV:  return OP_NOR;
+      default:                    return OP_NONE;
+    }
+  }
+
+  // Sets swap for the .sv forms, where the scalar is the left operand
+  static op_t vs_op(int cmd_code, bool& swap)
+  {
+    swap = false;
+    switch (cmd_code)
+    {
+      case MAVEN_CP_COP2_ADDU_VS: return OP_ADD;
+      case MAVEN_CP_COP2_SUBU_VS: return OP_SUB;
+      case MAVEN_CP_COP2_MUL_VS:  return OP_MUL;
+      case MAVEN_CP_COP2_SLL_VS:  return OP_SLL;
+      case MAVEN_CP_COP2_SRL_VS:  return OP_SRL;
+      case MAVEN_CP_COP2_SRA_VS:  return OP_SRA;
+      case MAVEN_CP_COP2_AND_VS:  return OP_AND;
+      case MAVEN_CP_COP2_OR_VS:   return OP_OR;
+      case MAVEN_CP_COP2_XOR_VS:  return OP_XOR;
+      case MAVEN_CP_COP2_NOR_VS:  return OP_NOR;
+      case MAVEN_CP_COP2_SUBU_SV: swap = true; return OP_SUB;
+      case MAVEN_CP_COP2_SLL_SV:  swap = true; return OP_SLL;
+      case MAVEN_CP_COP2_SRL_SV:  swap = true; return OP_SRL;
+      case MAVEN_CP_COP2_SRA_SV:  swap = true; return OP_SRA;
+      default:                    return OP_NONE;
+    }
+  }
+
+private:
+  enum
+  {
+    ROW_D,
+    ROW_A,
+    ROW_B,
+    NUM_ROWS,
+  };
+
+  // Registers past the count set by vcfg are left to the general path
+  template <typename VPArrayType>
+  bool in_range(VPArrayType& va, int r)
+  {
+    return r < va.vp[0]->state.m_nregs;
+  }
+
+  // Writes to r0 are left to the general path too
+  template <typename VPArrayType>
+  bool usable(VPArrayType& va, int r_vdst)
+  {
+    return !va.stats_en && va.vl > 0 && r_vdst != 0 && in_range(va, r_vdst)
+      && !va.vp[0]->state.vxudebug;
+  }
+
+  bool word_access_ok(int vl, addr_t addr, int stride)
+  {
+    if ((addr & 0x3) || stride <= 0 || (stride & 0x3))
+      return false;
+    uint64_t last = (uint64_t) addr + (uint64_t) (vl-1) * stride + 4;
+    return last <= MAVEN_SYSCFG_MEMORY_SIZE;
+  }
+
+  template <typename VPArrayType>
+  void gather(VPArrayType& va, int r, reg_t* row)
+  {
+    for (int i=0; i<va.vl; i++)
+      row[i] = va.vp[i]->state.R[r];
+  }
+
+  template <typename VPArrayType>
+  void scatter(VPArrayType& va, int r, const reg_t* row)
+  {
+    for (int i=0; i<va.vl; i++)
+      va.vp[i]->state.R[r] = row[i];
+  }
+
+  static void fill(reg_t* row, reg_t val, int n)
+  {
+    for (int i=0; i<n; i++)
+      row[i] = val;
+  }
+
+  reg_t R[NUM_ROWS][LANES] __attribute__((aligned(32)));
+};
+
+//------------------------------------------------------------------------
+// Lane handlers
+//------------------------------------------------------------------------
+// Stand-ins for maven_arith_vv, maven_arith_vs, maven_arith_sv,
+// maven_vload and maven_vstore (maven-ISA-Instruction.h) for the forms
+// maven_lanes_handler() picks out. Each falls back to the MavenVPArray
+// call the original handler makes, and sets the same microarch fields.
+
+template <typename InstructionType, typename StateType>
+inline void maven_lanes_arith_vv(InstructionType* inst, StateType* proc)
+{
+  MavenVPLanes lanes;
+  if (!lanes.arith_vv(proc->vparray, inst->get_rd(), inst->get_rs(), inst->get_rt(),
+                      inst->get_msk(), inst->get_cmd()))
+    proc->vparray.arith_vv(inst->get_rd(), inst->get_rs(), inst->get_rt(),
+                           inst->get_msk(), inst->get_cmd());
+}
+
+// .vs and .sv both go through MavenVPArray::arith_vs
+template <typename InstructionType, typename StateType>
+inline void maven_lanes_arith_vs(InstructionType* inst, StateType* proc)
+{
+  MavenVPLanes lanes;
+  reg_t sdata = proc->read_register(inst->get_rs());
+  if (!lanes.arith_vs(proc->vparray, inst->get_rd(), sdata, inst->get_rt(),
+                      inst->get_msk(), inst->get_cmd()))
+    proc->vparray.arith_vs(inst->get_rd(), sdata, inst->get_rt(),
+                           inst->get_msk(), inst->get_cmd());
+}
+
+template <typename InstructionType, typename StateType>
+inline void maven_lanes_vload_w(InstructionType* inst, StateType* proc)
+{
+  MavenVPLanes lanes;
+  addr_t addr = proc->read_register(inst->get_rt());
+  int stride = 4;
+  if (inst->get_opcode() == MAVEN_CP_VLOAD_ST)
+    stride = proc->read_register(inst->get_rs());
+
+  if (!lanes.vload_w(proc->vparray, proc->mem, addr, inst->get_rv(), stride))
+    proc->vparray.vload(addr, inst->get_rv(), stride, 1, MavenVPArray::WORD_T);
+
+  proc->alu = ALU_VLD;
+  proc->rd = inst->get_rv();
+  proc->b_rd = true;
+}
+
+template <typename InstructionType, typename StateType>
+inline void maven_lanes_vstore_w(InstructionType* inst, StateType* proc)
+{
+  MavenVPLanes lanes;
+  addr_t addr = proc->read_register(inst->get_rt());
+  int stride = 4;
+  if (inst->get_opcode() == MAVEN_CP_VSTORE_ST)
+    stride = proc->read_register(inst->get_rs());
+
+  if (!lanes.vstore_w(proc->vparray, proc->mem, addr, inst->get_rv(), stride))
+    proc->vparray.vstore(addr, inst->get_rv(), stride, 1, MavenVPArray::WORD_T);
+
+  proc->alu = ALU_VST;
+  proc->rt = inst->get_rv();
+  proc->b_rt = true;
+}
+
+// The lane handler for a CP instruction word, or NULL if it has none:
+// the COP2 integer commands with a kernel, and lw.v, lwst.v, sw.v and
+// swst.v with one element per VP.
+inline void (*maven_lanes_handler(uint32_t bits))(MavenCPInstruction*, MavenCPState*)
+{
+  uint32_t opcode = bits >> 26;
+  uint32_t cmd    = bits & 0xff;
+  uint32_t n      = bits & 0x1f;
+  uint32_t s      = (bits >> 5) & 0x3;
+  uint32_t u      = (bits >> 7) & 0x1;
+  bool swap;
+
+  switch (opcode)
+  {
+    case MAVEN_CP_COP2:
+      if (MavenVPLanes::vv_op(cmd) != MavenVPLanes::OP_NONE)
+        return &maven_lanes_arith_vv<MavenCPInstruction, MavenCPState>;
+      if (MavenVPLanes::vs_op(cmd, swap) != MavenVPLanes::OP_NONE)
+        return &maven_lanes_arith_vs<MavenCPInstruction, MavenCPState>;
+      return NULL;
+
+    case MAVEN_CP_VLOAD:
+    case MAVEN_CP_VLOAD_ST:
+      if (s == 0 && n == 0)
+        return &maven_lanes_vload_w<MavenCPInstruction, MavenCPState>;
+      return NULL;
+
+    case MAVEN_CP_VSTORE:
+    case MAVEN_CP_VSTORE_ST:
+      if (u == 1 && s == 0 && n == 0)
+        return &maven_lanes_vstore_w<MavenCPInstruction, MavenCPState>;
+      return NULL;
+  }
+  return NULL;
+}
+
+#endif // __MAVENVPLANES_H
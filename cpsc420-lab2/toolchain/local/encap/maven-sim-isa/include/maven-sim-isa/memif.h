@@ -30,6 +30,9 @@ support 64-bit memory spaces.
 
 #include <stdexcept>
 #include <stdint.h>
+#include <errno.h>
+#include <unistd.h>
+#include <vector>
 
 class memif_t
 {
@@ -76,6 +79,75 @@ public:
 
     virtual error read_int64(uint32_t addr, int64_t* word) = 0;
     virtual error write_int64(uint32_t addr, int64_t word) = 0;
+
+    // Bulk transfers, for loaders and the syscall proxy to use in place
+    // of per-word calls for anything larger than a word. Like read_fd and
+    // write_fd below they are not virtual: these versions fall back to
+    // read/write, and a memif with a host backing store hides them with
+    // versions that check the range once and copy contiguous host runs.
+    // Callers that want those take the memif type as a template
+    // parameter.
+    error read_bulk(uint32_t addr, uint32_t len, uint8_t* bytes)
+    {
+        return read(addr, len, bytes);
+    }
+
+    error write_bulk(uint32_t addr, uint32_t len, const uint8_t* bytes)
+    {
+        return write(addr, len, bytes);
+    }
+
+    // Host pointer to the longest contiguous run of target memory at
+    // addr, up to len bytes, with its length in *run. Valid until the
+    // next call into this memif. Memory systems without a host backing
+    // store return NULL, and callers then use read_bulk/write_bulk.
+    uint8_t* span(uint32_t, uint32_t, bool, uint32_t*)
+    {
+        return NULL;
+    }
+
+    // n aligned 32-bit words, with the alignment checked once
+    error read_words(uint32_t addr, uint32_t n, uint32_t* words)
+    {
+        if (addr & 0x3)
+            return Misaligned;
+        return read_bulk(addr, 4*n, (uint8_t*) words);
+    }
+
+    error write_words(uint32_t addr, uint32_t n, const uint32_t* words)
+    {
+        if (addr & 0x3)
+            return Misaligned;
+        return write_bulk(addr, 4*n, (const uint8_t*) words);
+    }
+
+    // Transfer between a host file descriptor and target memory, with
+    // read(2)/write(2) semantics, or pread/pwrite when offset >= 0.
+    // Returns the byte count, or -1 with errno set. These bounce through
+    // a host buffer; a memif with a host backing store hides them with
+    // versions that transfer in place.
+    ssize_t read_fd(int fd, uint32_t addr, uint32_t len, off_t offset = -1)
+    {
+        std::vector<uint8_t> buf(len + 1); // never empty, so &buf[0] is valid
+        ssize_t r = offset < 0 ? ::read(fd, &buf[0], len) : ::pread(fd, &buf[0], len, offset);
+        if (r > 0 && write_bulk(addr, r, &buf[0]) != OK)
+        {
+            errno = EFAULT;
+            return -1;
+        }
+        return r;
+    }
+
+    ssize_t write_fd(int fd, uint32_t addr, uint32_t len, off_t offset = -1)
+    {
+        std::vector<uint8_t> buf(len + 1); // never empty, so &buf[0] is valid
+        if (len > 0 && read_bulk(addr, len, &buf[0]) != OK)
+        {
+            errno = EFAULT;
+            return -1;
+        }
+        return offset < 0 ? ::write(fd, &buf[0], len) : ::pwrite(fd, &buf[0], len, offset);
+    }
 };
 
 class memif_null_t : public memif_t {
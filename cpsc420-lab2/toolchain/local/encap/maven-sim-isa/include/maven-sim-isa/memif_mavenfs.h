@@ -67,7 +67,50 @@ public:
     memif_t::error read_int64(uint32_t addr, int64_t* word);
     memif_t::error write_int64(uint32_t addr, int64_t word);
 
+    // Straight between the caller and the simulator's memory. These and
+    // the calls below hide the generic versions in memif_t.
+    memif_t::error read_bulk(uint32_t addr, uint32_t len, uint8_t* bytes)
+    {
+        if (!in_range(addr, len))
+            return memif_t::Invalid;
+        sim.mem.read_block(addr, len, bytes);
+        return memif_t::OK;
+    }
+
+    memif_t::error write_bulk(uint32_t addr, uint32_t len, const uint8_t* bytes)
+    {
+        if (!in_range(addr, len))
+            return memif_t::Invalid;
+        sim.mem.write_block(addr, len, bytes);
+        return memif_t::OK;
+    }
+
+    // Target memory is contiguous, so a span always covers all of len
+    uint8_t* span(uint32_t addr, uint32_t len, bool for_write, uint32_t* run)
+    {
+        if (len == 0 || !in_range(addr, len))
+            return NULL;
+        *run = len;
+        return sim.mem.span(addr, len, for_write);
+    }
+
+    // Straight between the fd and the simulator's memory
+    ssize_t read_fd(int fd, uint32_t addr, uint32_t len, off_t offset = -1)
+    {
+        return sim.mem.fd_read(fd, addr, len, offset);
+    }
+
+    ssize_t write_fd(int fd, uint32_t addr, uint32_t len, off_t offset = -1)
+    {
+        return sim.mem.fd_write(fd, addr, len, offset);
+    }
+
 private:
+    static bool in_range(uint32_t addr, uint32_t len)
+    {
+        return Memory::in_range(addr, len);
+    }
+
     simulator_t& sim;
 };
 
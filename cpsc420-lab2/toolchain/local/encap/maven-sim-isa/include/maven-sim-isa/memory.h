@@ -3,15 +3,113 @@
 
 #include "host.h"
 #include "syscfg.h"
+#include "memwatch.h"
 #include <assert.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <map>
+#include <vector>
 
 //BUG the below statement does not work on
-//Mac OS X 10.5 Core 2 Duo. 
+//Mac OS X 10.5 Core 2 Duo.
 // NTOH* do not work
 
+//------------------------------------------------------------------------
+// Checked builds
+//------------------------------------------------------------------------
+// The ISA templates reach memory through Memory::load and store (and the
+// mem_load/mem_store wrappers at the end of this file). Misaligned
+// accesses always raise EXCEPTION_ADDR_MISALIGNED_*, as the architecture
+// requires. An access past the end of target memory also raises one when
+// MAVEN_MEMORY_CHECKED is set; otherwise the address is masked into
+// memory and the check costs nothing. Checking defaults to on unless
+// NDEBUG is defined.
+//
+// The ISA templates are instantiated by the processor objects, which are
+// not part of this package: lib/ holds only libappsvr, libcommon and
+// libsft, and bin/maven-isa-run is not installed. None of this takes
+// effect until the processor library and maven-isa-run are rebuilt
+// against these headers.
+
+#ifndef MAVEN_MEMORY_CHECKED
+#ifdef NDEBUG
+#define MAVEN_MEMORY_CHECKED 0
+#else
+#define MAVEN_MEMORY_CHECKED 1
+#endif
+#endif
+
+//------------------------------------------------------------------------
+// Memory
+//------------------------------------------------------------------------
+// Target memory is one flat MAVEN_SYSCFG_MEMORY_SIZE byte array. The
+// allocation is large enough that the host C library maps it straight
+// from the kernel, so host pages are only committed once they are
+// touched, and reads of untouched pages all see the kernel's shared zero
+// page. A sparse page table would only add a lookup to every access.
+// Memory itself is a single pointer: the prebuilt simulator objects
+// embed it in simulator_t, so its layout must not change.
+//
+// The optional features below (watchpoints, snapshot write tracking,
+// dirty tracking, code tracking and concurrent mode) keep their state
+// in an ext_t, which a feature creates when it attaches and frees when
+// the last feature detaches. The ext_ts live in a map from Memory
+// address, which is guarded by a lock and has no limit on its size;
+// each host thread caches its last lookup until the next attach or
+// detach. While no Memory anywhere has a feature attached which traps
+// loads (or stores), every load (or store) is a plain host access after
+// a single test of a global counter. Only watchpoints trap loads.
+// Otherwise an access looks up its own Memory's ext_t, and only if that
+// Memory has such a feature does it check the flags byte of each
+// target page it touches:
+//
+//  - PAGE_WATCH  : reads and writes are reported to the MemoryWatch
+//                  (memwatch.h);
+//  - PAGE_TRACK  : the first store copies the page into the snapshot
+//                  undo log (snapshot.h) and clears the flag;
+//  - PAGE_CLEAN  : the first store sets PAGE_DIRTY and clears the flag,
+//                  so checkpoints (checkpoint.h) can save only the
+//                  pages stored to since the program was loaded;
+//  - PAGE_CODE   : the first store bumps the page's code generation
+//                  and clears the flag, so the decode caches
+//                  (decodecache.h, maven-BlockEngine.h) can tell that
+//                  an instruction they decoded from it may have changed.
+//
+// Instruction fetches go through fetch_uint32, which traps nothing.
+//
+// Flags are updated with atomic host operations. Attach and detach
+// features only while no core is running.
+
 class Memory
 {
 public:
+  enum
+  {
+    PAGE_SHIFT = 12,
+    PAGE_SIZE  = 1 << PAGE_SHIFT,
+    PAGE_MASK  = PAGE_SIZE - 1,
+    NUM_PAGES  = MAVEN_SYSCFG_MEMORY_SIZE >> PAGE_SHIFT,
+  };
+
+  enum
+  {
+    ADDR_MASK = MAVEN_SYSCFG_MEMORY_SIZE - 1, // memory size is a power of two
+  };
+
+  // Page flags
+  enum
+  {
+    PAGE_WATCH = 0x01, // overlaps a MemoryWatch range
+    PAGE_TRACK = 0x02, // save a pre-image on the next store (snapshots)
+    PAGE_CLEAN = 0x04, // mark dirty on the next store (checkpoints)
+    PAGE_DIRTY = 0x08, // stored to since arm_dirty_tracking
+    PAGE_CODE  = 0x10, // bump the code generation on the next store
+
+    PAGE_WRITE_TRAP_MASK = PAGE_WATCH | PAGE_TRACK | PAGE_CLEAN | PAGE_CODE,
+    PAGE_READ_TRAP_MASK  = PAGE_WATCH,
+  };
+
   Memory()
   {
     mem = new uint8_t [MAVEN_SYSCFG_MEMORY_SIZE];
@@ -19,94 +117,685 @@ public:
 
   ~Memory()
   {
+    drop_ext();
     delete [] mem;
   }
 
+  //----------------------------------------------------------------------
+  // Word accessors
+  //----------------------------------------------------------------------
+
   int8_t read_mem_int8(addr_t addr)
   {
     //printf("read_mem_int8: %08x\n", addr);
     assert( addr < MAVEN_SYSCFG_MEMORY_SIZE );
-    return (int8_t)mem[addr];
+    return read<int8_t>(addr);
   }
 
   uint8_t read_mem_uint8(addr_t addr)
   {
     //printf("read_mem_uint8: %08x\n", addr);
     assert( addr < MAVEN_SYSCFG_MEMORY_SIZE );
-    return (uint8_t)mem[addr];
+    return read<uint8_t>(addr);
   }
 
   int16_t read_mem_int16(addr_t addr)
   {
     //printf("read_mem_int16: %08x\n", addr);
-//    int16_t temp = NTOHS( *((int16_t*) &mem[addr]) );
     assert( addr < MAVEN_SYSCFG_MEMORY_SIZE );
-    int16_t temp = ( *((int16_t*) &mem[addr]) );
-    return temp;
+    return read<int16_t>(addr);
   }
 
   uint16_t read_mem_uint16(addr_t addr)
   {
     //printf("read_mem_uint16: %08x\n", addr);
-//    uint16_t temp = NTOHS( (*(uint16_t*) &mem[addr]) );
     assert( addr < MAVEN_SYSCFG_MEMORY_SIZE );
-    uint16_t temp = ( (*(uint16_t*) &mem[addr]) );
-    return temp;
+    return read<uint16_t>(addr);
   }
 
   int32_t read_mem_int32(addr_t addr)
   {
     //printf("read_mem_int32: %08x\n", addr);
-//    int32_t temp = NTOHL( *((int32_t*) &mem[addr]) );
     assert( addr < MAVEN_SYSCFG_MEMORY_SIZE );
-    int32_t temp = ( *((int32_t*) &mem[addr]) );
-    return temp;
+    return read<int32_t>(addr);
   }
 
   uint32_t read_mem_uint32(addr_t addr)
   {
     //printf("read_mem_uint32: %08x\n", addr);
-    //BUG the below statement does not work on
-    //Mac OS X 10.5 Core 2 Duo. 
-//    uint32_t temp = NTOHL( *((uint32_t*) &mem[addr]) );
     assert( addr < MAVEN_SYSCFG_MEMORY_SIZE );
-    uint32_t temp = ( *((uint32_t*) &mem[addr]) );
-    return temp;
+    return read<uint32_t>(addr);
   }
 
   void write_mem_uint8(addr_t addr, uint8_t val)
   {
     //printf("write_mem_uint8: %08x\n", addr);
     assert( addr < MAVEN_SYSCFG_MEMORY_SIZE );
-    //if ( addr == 0 )
-    //  printf("warning : writing to address zero\n");
-    mem[addr] = val;
+    write<uint8_t>(addr, val);
   }
 
   void write_mem_uint16(addr_t addr, uint16_t val)
   {
     //printf("write_mem_uint16: %08x\n", addr);
-//    uint16_t temp = HTONS(val);
     assert( addr < MAVEN_SYSCFG_MEMORY_SIZE );
-    //if ( addr == 0 )
-    //  printf("warning : writing to address zero\n");
-    uint16_t temp = (val);
-    *((uint16_t*) &mem[addr]) = temp;
+    write<uint16_t>(addr, val);
   }
 
   void write_mem_uint32(addr_t addr, uint32_t val)
   {
     //printf("write_mem_uint32: %08x\n", addr);
-//    uint32_t temp = HTONL(val);
     assert( addr < MAVEN_SYSCFG_MEMORY_SIZE );
-    //if ( addr == 0 )
-    //  printf("warning : writing to address zero\n");
-    uint32_t temp = (val);
-    *((uint32_t*) &mem[addr]) = temp;
+    write<uint32_t>(addr, val);
+  }
+
+  // An instruction fetch: a plain host load, never reported to a
+  // MemoryWatch or any other feature. The address wraps at the end of
+  // memory.
+  uint32_t fetch_uint32(addr_t addr) const
+  {
+    return *((const uint32_t*) &mem[addr & ADDR_MASK]);
+  }
+
+  //----------------------------------------------------------------------
+  // Typed accessors
+  //----------------------------------------------------------------------
+  // Return false, without touching memory or val, for a misaligned
+  // address or, when Checked, one whose access would run past the end
+  // of memory. Unchecked accesses wrap at the end of memory.
+
+  template <typename T, bool Checked>
+  bool load(addr_t addr, T& val)
+  {
+    if (!access_ok<T, Checked>(addr))
+      return false;
+    val = read<T>(addr & ADDR_MASK);
+    return true;
+  }
+
+  template <typename T, bool Checked>
+  bool store(addr_t addr, T val)
+  {
+    if (!access_ok<T, Checked>(addr))
+      return false;
+    write<T>(addr & ADDR_MASK, val);
+    return true;
+  }
+
+  //----------------------------------------------------------------------
+  // Block accessors
+  //----------------------------------------------------------------------
+  // The range must lie inside target memory.
+
+  void read_block(addr_t addr, uint32_t len, uint8_t* bytes)
+  {
+    assert( in_range(addr, len) );
+    if (ext_t* e = trapping_ext(false))
+      trap(e, addr, len, false);
+    memcpy(bytes, &mem[addr], len);
+  }
+
+  void write_block(addr_t addr, uint32_t len, const uint8_t* bytes)
+  {
+    assert( in_range(addr, len) );
+    if (ext_t* e = trapping_ext(true))
+      trap(e, addr, len, true);
+    memcpy(&mem[addr], bytes, len);
+  }
+
+  // Host pointer to len bytes of target memory at addr, for a caller
+  // that copies into or out of it directly. Accesses through it are
+  // reported as one read (or write) of the whole range.
+  uint8_t* span(addr_t addr, uint32_t len, bool for_write)
+  {
+    assert( in_range(addr, len) );
+    if (ext_t* e = trapping_ext(for_write))
+      trap(e, addr, len, for_write);
+    return &mem[addr];
+  }
+
+  static bool in_range(addr_t addr, uint32_t len)
+  {
+    return addr < MAVEN_SYSCFG_MEMORY_SIZE && len <= MAVEN_SYSCFG_MEMORY_SIZE - addr;
+  }
+
+  //----------------------------------------------------------------------
+  // Host file I/O
+  //----------------------------------------------------------------------
+  // Move bytes between a host file descriptor and target memory without
+  // a bounce buffer. A negative offset uses and advances the file
+  // position like read(2) and write(2); otherwise the transfer is a
+  // pread/pwrite at offset. Returns the byte count, or -1 with errno
+  // set. A range outside target memory fails with EFAULT.
+
+  ssize_t fd_read(int fd, addr_t addr, uint32_t len, off_t offset = -1)
+  {
+    if (!in_range(addr, len))
+    {
+      errno = EFAULT;
+      return -1;
+    }
+    uint8_t* p = span(addr, len, true);
+    return offset < 0 ? ::read(fd, p, len) : ::pread(fd, p, len, offset);
+  }
+
+  ssize_t fd_write(int fd, addr_t addr, uint32_t len, off_t offset = -1)
+  {
+    if (!in_range(addr, len))
+    {
+      errno = EFAULT;
+      return -1;
+    }
+    uint8_t* p = span(addr, len, false);
+    return offset < 0 ? ::write(fd, p, len) : ::pwrite(fd, p, len, offset);
+  }
+
+  //----------------------------------------------------------------------
+  // Host threads
+  //----------------------------------------------------------------------
+  // While several host threads share this Memory, set_concurrent(true)
+  // makes begin_amo/end_amo serialise the read-modify-write instructions
+  // and fence a host memory barrier.
+
+  void set_concurrent(bool val)
+  {
+    ext_t* e = find_ext();
+    if (val && !(e && e->concurrent))
+      attach_ext(0)->concurrent = true;
+    else if (!val && e && e->concurrent)
+    {
+      e->concurrent = false;
+      detach_ext(0);
+    }
+  }
+
+  void begin_amo()
+  {
+    ext_t* e = concurrent_ext();
+    if (e)
+      lock(&e->amo_lock);
+  }
+
+  void end_amo()
+  {
+    ext_t* e = concurrent_ext();
+    if (e)
+      unlock(&e->amo_lock);
+  }
+
+  void fence()
+  {
+    if (concurrent_ext())
+      __sync_synchronize();
+  }
+
+  //----------------------------------------------------------------------
+  // Watchpoints
+  //----------------------------------------------------------------------
+
+  // Start reporting accesses to the ranges of w. The caller keeps
+  // ownership of w; attach again after adding ranges to it.
+  void attach_watch(MemoryWatch* w)
+  {
+    ext_t* e = find_ext();
+    if (!(e && e->watch))
+      e = attach_ext(TRAP_LOADS | TRAP_STORES);
+    e->watch = w;
+    const std::vector<MemoryWatch::range_t>& ranges = w->get_ranges();
+    for (size_t i=0; i<ranges.size(); i++)
+    {
+      if (ranges[i].hi <= ranges[i].lo)
+        continue;
+      uint32_t last = (ranges[i].hi - 1) >> PAGE_SHIFT;
+      for (uint32_t vpn = ranges[i].lo >> PAGE_SHIFT; vpn <= last && vpn < NUM_PAGES; vpn++)
+        set_page_flags(e, vpn, PAGE_WATCH);
+    }
+  }
+
+  void detach_watch()
+  {
+    ext_t* e = find_ext();
+    if (!(e && e->watch))
+      return;
+    clear_page_flags(e, PAGE_WATCH);
+    e->watch = NULL;
+    detach_ext(TRAP_LOADS | TRAP_STORES);
+  }
+
+  MemoryWatch* get_watch()
+  {
+    ext_t* e = find_ext();
+    return e ? e->watch : NULL;
+  }
+
+  //----------------------------------------------------------------------
+  // Write tracking
+  //----------------------------------------------------------------------
+  // After arm_write_tracking, the first store to each page appends the
+  // page's current contents to log. Arming again starts a new log. Not
+  // for use with set_concurrent.
+
+  struct page_image_t
+  {
+    uint32_t vpn;
+    uint8_t* data; // new[]'d copy owned by the log
+  };
+
+  void arm_write_tracking(std::vector<page_image_t>* log)
+  {
+    ext_t* e = find_ext();
+    if (!(e && e->undo))
+      e = attach_ext(TRAP_STORES);
+    e->undo = log;
+    for (int i=0; i<NUM_PAGES; i++)
+      e->page_flags[i] |= PAGE_TRACK;
+  }
+
+  void disarm_write_tracking()
+  {
+    ext_t* e = find_ext();
+    if (!(e && e->undo))
+      return;
+    clear_page_flags(e, PAGE_TRACK);
+    e->undo = NULL;
+    detach_ext(TRAP_STORES);
+  }
+
+  // Put back a page image, without logging it again
+  void restore_page(const page_image_t& img)
+  {
+    memcpy(&mem[img.vpn << PAGE_SHIFT], img.data, PAGE_SIZE);
+    code_stored(img.vpn);
+  }
+
+  //----------------------------------------------------------------------
+  // Dirty tracking
+  //----------------------------------------------------------------------
+  // After arm_dirty_tracking, page_dirty says whether a page has been
+  // stored to since. Arming again starts over. Only the first store to
+  // each page is trapped for this, but while armed every access pays
+  // for the flags check, so arm it only when a checkpoint will be saved.
+
+  void arm_dirty_tracking()
+  {
+    ext_t* e = find_ext();
+    if (!(e && e->dirty_tracking))
+      e = attach_ext(TRAP_STORES);
+    e->dirty_tracking = true;
+    for (int i=0; i<NUM_PAGES; i++)
+      e->page_flags[i] = (e->page_flags[i] & ~PAGE_DIRTY) | PAGE_CLEAN;
+  }
+
+  void disarm_dirty_tracking()
+  {
+    ext_t* e = find_ext();
+    if (!(e && e->dirty_tracking))
+      return;
+    clear_page_flags(e, PAGE_CLEAN | PAGE_DIRTY);
+    e->dirty_tracking = false;
+    detach_ext(TRAP_STORES);
+  }
+
+  bool dirty_tracking_armed() const
+  {
+    ext_t* e = find_ext();
+    return e && e->dirty_tracking;
+  }
+
+  bool page_dirty(uint32_t vpn) const
+  {
+    ext_t* e = find_ext();
+    return e && (e->page_flags[vpn] & PAGE_DIRTY);
+  }
+
+  //----------------------------------------------------------------------
+  // Code tracking
+  //----------------------------------------------------------------------
+  // code_generations returns a counter for each page, which the first
+  // store to a page after mark_code bumps. A cache of decoded
+  // instructions marks each page it decodes from and tags what it
+  // decoded with the page's counter, and the tag goes stale once the
+  // page is stored to. The counters stay until the Memory is destroyed,
+  // so a cache must not outlive it. Code tracking traps stores only.
+
+  const uint32_t* code_generations()
+  {
+    ext_t* e = find_ext();
+    if (!(e && e->code_gen))
+    {
+      e = attach_ext(TRAP_STORES);
+      e->code_gen = new uint32_t [NUM_PAGES]();
+    }
+    return e->code_gen;
+  }
+
+  void mark_code(uint32_t vpn)
+  {
+    ext_t* e = find_ext();
+    if (e && e->code_gen && !(e->page_flags[vpn] & PAGE_CODE))
+      set_page_flags(e, vpn, PAGE_CODE);
+  }
+
+  // For a caller which changed a page through mem directly
+  void code_stored(uint32_t vpn)
+  {
+    ext_t* e = find_ext();
+    if (e && (e->page_flags[vpn] & PAGE_CODE))
+      code_stored(e, vpn);
   }
 
 //private:
   uint8_t* mem;
+
+private:
+  //----------------------------------------------------------------------
+  // Extension state
+  //----------------------------------------------------------------------
+
+  // What an attached feature traps
+  enum
+  {
+    TRAP_LOADS  = 0x1,
+    TRAP_STORES = 0x2,
+  };
+
+  struct ext_t
+  {
+    uint8_t page_flags[NUM_PAGES];
+    int users;         // attached features
+    int load_traps;    // attached features which trap loads
+    int store_traps;   // attached features which trap stores
+    bool concurrent;
+    int amo_lock;
+    MemoryWatch* watch;
+    std::vector<page_image_t>* undo;
+    bool dirty_tracking;
+    uint32_t* code_gen; // new[]'d per-page counters, NULL until code tracking
+  };
+
+  typedef std::map<const Memory*, ext_t*> ext_map_t;
+
+  // The last lookup made by this host thread. It is good while
+  // ext_generation has not moved on since.
+  struct ext_cache_t
+  {
+    const Memory* owner;
+    ext_t* ext;
+    unsigned generation;
+  };
+
+  // Shared by every translation unit, like any static in an inline
+  // function. ext_map is only touched with ext_lock held.
+  static ext_map_t& ext_map()
+  {
+    static ext_map_t map;
+    return map;
+  }
+
+  // ext_map().size(), for a lookup which need not take the lock when
+  // nothing is attached
+  static int& ext_map_size()
+  {
+    static int size;
+    return size;
+  }
+
+  static int& ext_lock()
+  {
+    static int l;
+    return l;
+  }
+
+  // Bumped by every attach and detach
+  static unsigned& ext_generation()
+  {
+    static unsigned generation = 1;
+    return generation;
+  }
+
+  static ext_cache_t& ext_cache()
+  {
+    static __thread ext_cache_t cache;
+    return cache;
+  }
+
+  // Memories with a feature attached which traps loads (or stores).
+  // While it is zero no load (or store) looks any further.
+  static int& trap_count(bool is_write)
+  {
+    static int counts[2];
+    return counts[is_write];
+  }
+
+  ext_t* find_ext() const
+  {
+    if (__atomic_load_n(&ext_map_size(), __ATOMIC_ACQUIRE) == 0)
+      return NULL;
+
+    ext_cache_t& c = ext_cache();
+    unsigned generation = __atomic_load_n(&ext_generation(), __ATOMIC_ACQUIRE);
+    if (c.owner == this && c.generation == generation)
+      return c.ext;
+
+    lock(&ext_lock());
+    ext_map_t::iterator it = ext_map().find(this);
+    ext_t* e = it == ext_map().end() ? NULL : it->second;
+    unlock(&ext_lock());
+
+    c.owner = this;
+    c.ext = e;
+    c.generation = generation;
+    return e;
+  }
+
+  // This Memory's ext_t if it has a feature attached which traps
+  // stores, or loads if !is_write
+  ext_t* trapping_ext(bool is_write) const
+  {
+    if (__builtin_expect(__atomic_load_n(&trap_count(is_write), __ATOMIC_RELAXED) == 0, 1))
+      return NULL;
+    ext_t* e = find_ext();
+    return e && (is_write ? e->store_traps : e->load_traps) ? e : NULL;
+  }
+
+  ext_t* concurrent_ext() const
+  {
+    ext_t* e = find_ext();
+    return e && e->concurrent ? e : NULL;
+  }
+
+  ext_t* attach_ext(int traps)
+  {
+    lock(&ext_lock());
+    ext_t*& e = ext_map()[this];
+    if (!e)
+    {
+      e = new ext_t;
+      memset(e->page_flags, 0, NUM_PAGES);
+      e->users = 0;
+      e->load_traps = 0;
+      e->store_traps = 0;
+      e->concurrent = false;
+      e->amo_lock = 0;
+      e->watch = NULL;
+      e->undo = NULL;
+      e->dirty_tracking = false;
+      e->code_gen = NULL;
+      __atomic_store_n(&ext_map_size(), (int) ext_map().size(), __ATOMIC_RELEASE);
+    }
+    e->users++;
+    if ((traps & TRAP_LOADS) && e->load_traps++ == 0)
+      __atomic_add_fetch(&trap_count(false), 1, __ATOMIC_RELEASE);
+    if ((traps & TRAP_STORES) && e->store_traps++ == 0)
+      __atomic_add_fetch(&trap_count(true), 1, __ATOMIC_RELEASE);
+    ext_t* result = e;
+    __atomic_add_fetch(&ext_generation(), 1, __ATOMIC_RELEASE);
+    unlock(&ext_lock());
+    return result;
+  }
+
+  void detach_ext(int traps)
+  {
+    lock(&ext_lock());
+    ext_map_t::iterator it = ext_map().find(this);
+    if (it != ext_map().end())
+    {
+      ext_t* e = it->second;
+      if ((traps & TRAP_LOADS) && --e->load_traps == 0)
+        __atomic_sub_fetch(&trap_count(false), 1, __ATOMIC_RELEASE);
+      if ((traps & TRAP_STORES) && --e->store_traps == 0)
+        __atomic_sub_fetch(&trap_count(true), 1, __ATOMIC_RELEASE);
+      if (--e->users == 0)
+      {
+        delete [] e->code_gen;
+        delete e;
+        ext_map().erase(it);
+        __atomic_store_n(&ext_map_size(), (int) ext_map().size(), __ATOMIC_RELEASE);
+      }
+      __atomic_add_fetch(&ext_generation(), 1, __ATOMIC_RELEASE);
+    }
+    unlock(&ext_lock());
+  }
+
+  // Free the ext_t of a Memory going away with features still attached,
+  // so that a later Memory at the same address does not inherit it
+  void drop_ext()
+  {
+    if (!find_ext())
+      return;
+    lock(&ext_lock());
+    ext_map_t::iterator it = ext_map().find(this);
+    if (it != ext_map().end())
+    {
+      ext_t* e = it->second;
+      if (e->load_traps)
+        __atomic_sub_fetch(&trap_count(false), 1, __ATOMIC_RELEASE);
+      if (e->store_traps)
+        __atomic_sub_fetch(&trap_count(true), 1, __ATOMIC_RELEASE);
+      delete [] e->code_gen;
+      delete e;
+      ext_map().erase(it);
+      __atomic_store_n(&ext_map_size(), (int) ext_map().size(), __ATOMIC_RELEASE);
+      __atomic_add_fetch(&ext_generation(), 1, __ATOMIC_RELEASE);
+    }
+    unlock(&ext_lock());
+  }
+
+  static void set_page_flags(ext_t* e, uint32_t vpn, uint8_t flags)
+  {
+    __sync_fetch_and_or(&e->page_flags[vpn], flags);
+  }
+
+  static void clear_page_flags(ext_t* e, uint8_t flags)
+  {
+    for (int i=0; i<NUM_PAGES; i++)
+      __sync_fetch_and_and(&e->page_flags[i], (uint8_t) ~flags);
+  }
+
+  //----------------------------------------------------------------------
+  // Traps
+  //----------------------------------------------------------------------
+
+  // Act on the flags of every page in [addr, addr+len), ahead of the
+  // access itself
+  void trap(ext_t* e, addr_t addr, uint32_t len, bool is_write)
+  {
+    if (len == 0)
+      return;
+
+    uint8_t mask = is_write ? PAGE_WRITE_TRAP_MASK : PAGE_READ_TRAP_MASK;
+    uint32_t last = (addr + len - 1) >> PAGE_SHIFT;
+    if (last >= NUM_PAGES)
+      last = NUM_PAGES - 1;
+
+    bool watched = false;
+    for (uint32_t vpn = addr >> PAGE_SHIFT; vpn <= last; vpn++)
+    {
+      uint8_t flags = e->page_flags[vpn];
+      if (!(flags & mask))
+        continue;
+      watched |= (flags & PAGE_WATCH) != 0;
+      if (!is_write)
+        continue;
+
+      if ((flags & PAGE_TRACK) && e->undo)
+        save_preimage(e, vpn);
+      if (flags & PAGE_CLEAN)
+      {
+        set_page_flags(e, vpn, PAGE_DIRTY);
+        __sync_fetch_and_and(&e->page_flags[vpn], (uint8_t) ~PAGE_CLEAN);
+      }
+      if (flags & PAGE_CODE)
+        code_stored(e, vpn);
+    }
+
+    if (watched && e->watch)
+      e->watch->access(addr, len, is_write);
+  }
+
+  static void code_stored(ext_t* e, uint32_t vpn)
+  {
+    __sync_fetch_and_and(&e->page_flags[vpn], (uint8_t) ~PAGE_CODE);
+    __atomic_add_fetch(&e->code_gen[vpn], 1, __ATOMIC_RELEASE);
+  }
+
+  void save_preimage(ext_t* e, uint32_t vpn)
+  {
+    __sync_fetch_and_and(&e->page_flags[vpn], (uint8_t) ~PAGE_TRACK);
+
+    page_image_t img;
+    img.vpn = vpn;
+    img.data = new uint8_t [PAGE_SIZE];
+    memcpy(img.data, &mem[vpn << PAGE_SHIFT], PAGE_SIZE);
+    e->undo->push_back(img);
+  }
+
+  template <typename T, bool Checked>
+  static bool access_ok(addr_t addr)
+  {
+    if (addr & (sizeof(T) - 1))
+      return false;
+    return !Checked || addr <= MAVEN_SYSCFG_MEMORY_SIZE - sizeof(T);
+  }
+
+  template <typename T>
+  T read(addr_t addr)
+  {
+    if (ext_t* e = trapping_ext(false))
+      trap(e, addr, sizeof(T), false);
+    return *((T*) &mem[addr]);
+  }
+
+  template <typename T>
+  void write(addr_t addr, T val)
+  {
+    if (ext_t* e = trapping_ext(true))
+      trap(e, addr, sizeof(T), true);
+    *((T*) &mem[addr]) = val;
+  }
 };
 
+//------------------------------------------------------------------------
+// ISA memory accesses
+//------------------------------------------------------------------------
+// Load or store through proc->mem, raising the misaligned load or store
+// exception on a fault. Return false if the instruction faulted.
+
+template <typename T, typename StateType>
+inline bool mem_load(StateType* proc, addr_t addr, T& val)
+{
+  if (proc->mem.template load<T, MAVEN_MEMORY_CHECKED>(addr, val))
+    return true;
+  proc->raise_exception(StateType::EXCEPTION_ADDR_MISALIGNED_LOAD);
+  return false;
+}
+
+template <typename T, typename StateType>
+inline bool mem_store(StateType* proc, addr_t addr, T val)
+{
+  if (proc->mem.template store<T, MAVEN_MEMORY_CHECKED>(addr, val))
+    return true;
+  proc->raise_exception(StateType::EXCEPTION_ADDR_MISALIGNED_STORE);
+  return false;
+}
+
 #endif // __MEMORY_H
@@ -0,0 +1,165 @@
+#ifndef __MEMWATCH_H
+#define __MEMWATCH_H
+
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+
+#include "types.h"
+#include "maven-PCCounterTable.h"
+
+//------------------------------------------------------------------------
+// Memory watchpoints
+//------------------------------------------------------------------------
+// Counts target loads and stores to watched address ranges. Accesses
+// are counted per line, where a line is 1 << line_shift bytes: 64 B
+// lines by default, or 4 KB pages with a line_shift of 12. Each range
+// can also log every access with the pc that made it.
+//
+// Memory::attach_watch marks every page that overlaps a range with
+// PAGE_WATCH, and every access touching such a page is reported to
+// access(): loads and stores, block copies, spans handed out to the
+// memif and host file transfers. A block or file transfer arrives as a
+// single access covering its whole range. Instruction fetches through
+// Memory::fetch_uint32, which the decode cache, the block engine and
+// the trace writer use, are not. With nothing attached, the only cost
+// is the test of Memory's trap counters.
+//
+// The pc comes from set_pc_source, which a simulation loop points at
+// the running core's pc. Counting is not thread safe, so use it with
+// the serial loop only. maven-isa-run sets up a watch with --watch
+// (see isarun.h), and simulator_t::step_core keeps the pc source on
+// the core it steps.
+
+class MemoryWatch
+{
+public:
+  struct range_t
+  {
+    addr_t lo;  // first watched byte
+    addr_t hi;  // one past the last
+    bool log;
+  };
+
+  MemoryWatch(int _line_shift = 6)
+    : line_shift(_line_shift)
+    , pc_src(NULL)
+    , log_fp(NULL)
+  {
+  }
+
+  void add_range(addr_t lo, addr_t hi, bool log = false)
+  {
+    range_t r = { lo, hi, log };
+    ranges.push_back(r);
+  }
+
+  void set_pc_source(const reg_t* pc)
+  {
+    pc_src = pc;
+  }
+
+  // Destination for the access log of ranges added with log set
+  void set_log(FILE* fp)
+  {
+    log_fp = fp;
+  }
+
+  // Called by Memory for every access to a watched page. Every line
+  // of [addr, addr+size) that lies in some range is counted once, and
+  // the access is logged once if any range it overlaps has log set.
+  void access(addr_t addr, uint32_t size, bool is_write)
+  {
+    uint64_t end = (uint64_t) addr + size;
+
+    // Only the lines between the first and last watched byte touched
+    // need looking at, which matters for large block transfers
+    uint64_t lo = end, hi = addr;
+    bool log = false;
+    for (size_t i=0; i<ranges.size(); i++)
+    {
+      if (!overlaps(ranges[i], addr, end))
+        continue;
+      lo = std::min(lo, std::max((uint64_t) addr, (uint64_t) ranges[i].lo));
+      hi = std::max(hi, std::min(end, (uint64_t) ranges[i].hi));
+      log |= ranges[i].log;
+    }
+    if (lo >= hi)
+      return;
+
+    uint64_t line_size = 1u << line_shift;
+    for (uint64_t line = lo & ~(line_size - 1); line < hi; line += line_size)
+    {
+      uint64_t a = std::max(line, lo), b = std::min(line + line_size, hi);
+      if (!find(a, b))
+        continue;
+      if (is_write)
+        writes[line]++;
+      else
+        reads[line]++;
+    }
+
+    if (log && log_fp)
+      fprintf(log_fp, "%08x %c %08x %u\n", pc_src ? *pc_src : 0,
+              is_write ? 'W' : 'R', addr, size);
+  }
+
+  //----------------------------------------------------------------------
+  // Reporting
+  //----------------------------------------------------------------------
+
+  // One "line,reads,writes" row per touched line, in address order
+  void write_heatmap(FILE* fp) const
+  {
+    std::vector<MavenPCCounterTable::entry_t> rd, wr;
+    reads.sorted(rd);
+    writes.sorted(wr);
+
+    fprintf(fp, "line,reads,writes\n");
+    size_t i = 0, j = 0;
+    while (i < rd.size() || j < wr.size())
+    {
+      addr_t line;
+      uint32_t nr = 0, nw = 0;
+      if (j == wr.size() || (i < rd.size() && rd[i].first <= wr[j].first))
+        line = rd[i].first;
+      else
+        line = wr[j].first;
+      if (i < rd.size() && rd[i].first == line)
+        nr = rd[i++].second;
+      if (j < wr.size() && wr[j].first == line)
+        nw = wr[j++].second;
+      fprintf(fp, "0x%08x,%u,%u\n", line, nr, nw);
+    }
+  }
+
+  const std::vector<range_t>& get_ranges() const
+  {
+    return ranges;
+  }
+
+private:
+  static bool overlaps(const range_t& r, uint64_t lo, uint64_t hi)
+  {
+    return lo < r.hi && r.lo < hi;
+  }
+
+  // First range overlapping [lo, hi)
+  const range_t* find(uint64_t lo, uint64_t hi) const
+  {
+    for (size_t i=0; i<ranges.size(); i++)
+      if (overlaps(ranges[i], lo, hi))
+        return &ranges[i];
+    return NULL;
+  }
+
+  int line_shift;
+  std::vector<range_t> ranges;
+  MavenPCCounterTable reads;
+  MavenPCCounterTable writes;
+
+  const reg_t* pc_src;
+  FILE* log_fp;
+};
+
+#endif // __MEMWATCH_H
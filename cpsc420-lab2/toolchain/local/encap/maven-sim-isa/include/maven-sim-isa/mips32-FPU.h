@@ -6,6 +6,7 @@
 
 #include "types.h"
 #include "softfloat.h"
+#include "mips32-FastFP.h"
 
 class MIPS32FPUState
 {
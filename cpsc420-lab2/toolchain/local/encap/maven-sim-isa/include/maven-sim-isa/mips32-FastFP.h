@@ -0,0 +1,374 @@
+//========================================================================
+// mips32-FastFP.h : Host fast path for the softfloat routines
+//========================================================================
+// Drop-in replacements for the softfloat entry points used by the COP1
+// instructions. When fast FP is enabled and softfloat is rounding to
+// nearest, the operation runs on the host FPU instead. The IEEE flags
+// softfloat would have raised are worked out from the operands and the
+// result, and or'd into float_exception_flags, so the caller's
+// handle_exceptions() behaves the same either way.
+//
+// The flags are derived rather than read back from MXCSR, because
+// ldmxcsr/stmxcsr around every operation cost more than softfloat
+// itself:
+//  - inexact uses an error-free check: TwoSum for add/sub, and an exact
+//    residual for mul/div/sqrt (computed in double for single-precision
+//    operands, or with fma() for double);
+//  - overflow is an infinite result from finite operands;
+//  - divide-by-zero is a finite nonzero value divided by zero.
+//
+// Everything else goes back to softfloat:
+//  - a NaN result (every invalid operation, and any NaN operand, since
+//    the two disagree on NaN propagation);
+//  - a tiny inexact result (the underflow corner);
+//  - double-precision operands so small the exact residual itself could
+//    underflow;
+//  - out-of-range float to int conversions.
+//
+// The host must be rounding to nearest without flush-to-zero, which
+// mips32_fastfp_enable() checks once.
+
+#ifndef __MIPS32FASTFP_H
+#define __MIPS32FASTFP_H
+
+#include <float.h>
+#include <math.h>
+#include <string.h>
+#include <xmmintrin.h>
+#include <emmintrin.h>
+
+#include "softfloat.h"
+
+inline bool& mips32_fastfp_enabled()
+{
+  static bool enabled = false;
+  return enabled;
+}
+
+// Returns whether fast FP is now on; it stays off if the host MXCSR is
+// not in the default round-to-nearest, no flush-to-zero state.
+inline bool mips32_fastfp_enable(bool val)
+{
+  unsigned int csr = _mm_getcsr();
+  bool host_ok = (csr & 0xe040) == 0; // RC, FTZ, DAZ
+  mips32_fastfp_enabled() = val && host_ok;
+  return mips32_fastfp_enabled();
+}
+
+//------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------
+
+inline bool fastfp_ok()
+{
+  return mips32_fastfp_enabled() && float_rounding_mode == float_round_nearest_even;
+}
+
+inline float fastfp_f(float32 a)   { float f; memcpy(&f, &a, 4); return f; }
+inline double fastfp_d(float64 a)  { double d; memcpy(&d, &a, 8); return d; }
+inline float32 fastfp_f32(float f) { float32 a; memcpy(&a, &f, 4); return a; }
+inline float64 fastfp_f64(double d){ float64 a; memcpy(&a, &d, 8); return a; }
+
+// Flags for an infinite result. False if softfloat must decide.
+inline bool fastfp_inf_flags(bool operands_finite)
+{
+  if (operands_finite)
+    float_exception_flags |= float_flag_overflow | float_flag_inexact;
+  return true;
+}
+
+// Flags for a finite result. False if softfloat must decide.
+template <typename T>
+inline bool fastfp_finite_flags(T r, T min_normal, bool inexact)
+{
+  if (!inexact)
+    return true;
+  if (r > -min_normal && r < min_normal)
+    return false;
+  float_exception_flags |= float_flag_inexact;
+  return true;
+}
+
+// Exact error of a+b, valid when a+b did not overflow
+template <typename T>
+inline T fastfp_two_sum_err(T a, T b, T s)
+{
+  T bb = s - a;
+  return (a - (s - bb)) + (b - bb);
+}
+
+// Below this the residual of a double op may be lost to underflow
+#define FASTFP_D_TINY 2.2250738585072014e-292
+
+//------------------------------------------------------------------------
+// Single precision
+//------------------------------------------------------------------------
+
+inline float32 fastfp_float32_add(float32 a, float32 b)
+{
+  if (fastfp_ok())
+  {
+    float x = fastfp_f(a), y = fastfp_f(b), r = x + y;
+    if (isinf(r))
+    {
+      if (fastfp_inf_flags(!isinf(x) && !isinf(y)))
+        return fastfp_f32(r);
+    }
+    else if (r == r && fastfp_finite_flags(r, FLT_MIN, fastfp_two_sum_err(x, y, r) != 0.0f))
+      return fastfp_f32(r);
+  }
+  return float32_add(a, b);
+}
+
+inline float32 fastfp_float32_sub(float32 a, float32 b)
+{
+  if (fastfp_ok())
+  {
+    float x = fastfp_f(a), y = -fastfp_f(b), r = x + y;
+    if (isinf(r))
+    {
+      if (fastfp_inf_flags(!isinf(x) && !isinf(y)))
+        return fastfp_f32(r);
+    }
+    else if (r == r && fastfp_finite_flags(r, FLT_MIN, fastfp_two_sum_err(x, y, r) != 0.0f))
+      return fastfp_f32(r);
+  }
+  return float32_sub(a, b);
+}
+
+inline float32 fastfp_float32_mul(float32 a, float32 b)
+{
+  if (fastfp_ok())
+  {
+    float x = fastfp_f(a), y = fastfp_f(b);
+    double p = (double) x * (double) y; // exact
+    float r = (float) p;
+    if (isinf(r))
+    {
+      if (fastfp_inf_flags(!isinf(x) && !isinf(y)))
+        return fastfp_f32(r);
+    }
+    else if (r == r && fastfp_finite_flags(r, FLT_MIN, (double) r != p))
+      return fastfp_f32(r);
+  }
+  return float32_mul(a, b);
+}
+
+inline float32 fastfp_float32_div(float32 a, float32 b)
+{
+  if (fastfp_ok())
+  {
+    float x = fastfp_f(a), y = fastfp_f(b), r = x / y;
+    if (isinf(r))
+    {
+      if (y == 0.0f && !isinf(x))
+      {
+        float_exception_flags |= float_flag_divbyzero;
+        return fastfp_f32(r);
+      }
+      if (fastfp_inf_flags(!isinf(x)))
+        return fastfp_f32(r);
+    }
+    else if (r == r && !isinf(y)
+             && fastfp_finite_flags(r, FLT_MIN, (double) r * (double) y != (double) x))
+      return fastfp_f32(r);
+  }
+  return float32_div(a, b);
+}
+
+inline float32 fastfp_float32_sqrt(float32 a)
+{
+  if (fastfp_ok())
+  {
+    float x = fastfp_f(a);
+    float r = _mm_cvtss_f32(_mm_sqrt_ss(_mm_set_ss(x)));
+    if (isinf(r))
+      return fastfp_f32(r);
+    if (r == r && fastfp_finite_flags(r, FLT_MIN, (double) r * (double) r != (double) x))
+      return fastfp_f32(r);
+  }
+  return float32_sqrt(a);
+}
+
+//------------------------------------------------------------------------
+// Double precision
+//------------------------------------------------------------------------
+
+inline float64 fastfp_float64_add(float64 a, float64 b)
+{
+  if (fastfp_ok())
+  {
+    double x = fastfp_d(a), y = fastfp_d(b), r = x + y;
+    if (isinf(r))
+    {
+      if (fastfp_inf_flags(!isinf(x) && !isinf(y)))
+        return fastfp_f64(r);
+    }
+    else if (r == r && fastfp_finite_flags(r, DBL_MIN, fastfp_two_sum_err(x, y, r) != 0.0))
+      return fastfp_f64(r);
+  }
+  return float64_add(a, b);
+}
+
+inline float64 fastfp_float64_sub(float64 a, float64 b)
+{
+  if (fastfp_ok())
+  {
+    double x = fastfp_d(a), y = -fastfp_d(b), r = x + y;
+    if (isinf(r))
+    {
+      if (fastfp_inf_flags(!isinf(x) && !isinf(y)))
+        return fastfp_f64(r);
+    }
+    else if (r == r && fastfp_finite_flags(r, DBL_MIN, fastfp_two_sum_err(x, y, r) != 0.0))
+      return fastfp_f64(r);
+  }
+  return float64_sub(a, b);
+}
+
+inline float64 fastfp_float64_mul(float64 a, float64 b)
+{
+  if (fastfp_ok())
+  {
+    double x = fastfp_d(a), y = fastfp_d(b), r = x * y;
+    if (isinf(r))
+    {
+      if (fastfp_inf_flags(!isinf(x) && !isinf(y)))
+        return fastfp_f64(r);
+    }
+    else if (r == r && fabs(r) >= FASTFP_D_TINY
+             && fastfp_finite_flags(r, DBL_MIN, fma(x, y, -r) != 0.0))
+      return fastfp_f64(r);
+    else if (r == 0.0 && (x == 0.0 || y == 0.0))
+      return fastfp_f64(r);
+  }
+  return float64_mul(a, b);
+}
+
+inline float64 fastfp_float64_div(float64 a, float64 b)
+{
+  if (fastfp_ok())
+  {
+    double x = fastfp_d(a), y = fastfp_d(b), r = x / y;
+    if (isinf(r))
+    {
+      if (y == 0.0 && !isinf(x))
+      {
+        float_exception_flags |= float_flag_divbyzero;
+        return fastfp_f64(r);
+      }
+      if (fastfp_inf_flags(!isinf(x)))
+        return fastfp_f64(r);
+    }
+    else if (r == r && !isinf(y) && fabs(x) >= FASTFP_D_TINY && fabs(r) >= FASTFP_D_TINY
+             && fastfp_finite_flags(r, DBL_MIN, fma(r, y, -x) != 0.0))
+      return fastfp_f64(r);
+    else if (x == 0.0 && y != 0.0 && y == y)
+      return fastfp_f64(r);
+  }
+  return float64_div(a, b);
+}
+
+inline float64 fastfp_float64_sqrt(float64 a)
+{
+  if (fastfp_ok())
+  {
+    double x = fastfp_d(a);
+    __m128d v = _mm_set_sd(x);
+    double r = _mm_cvtsd_f64(_mm_sqrt_sd(v, v));
+    if (isinf(r) || r == 0.0)
+      return fastfp_f64(r);
+    if (r == r && x >= FASTFP_D_TINY
+        && fastfp_finite_flags(r, DBL_MIN, fma(r, r, -x) != 0.0))
+      return fastfp_f64(r);
+  }
+  return float64_sqrt(a);
+}
+
+//------------------------------------------------------------------------
+// Conversions
+//------------------------------------------------------------------------
+
+inline float64 fastfp_float32_to_float64(float32 a)
+{
+  if (fastfp_ok())
+  {
+    float x = fastfp_f(a);
+    if (x == x || isinf(x))
+      return fastfp_f64((double) x);
+  }
+  return float32_to_float64(a);
+}
+
+inline float32 fastfp_float64_to_float32(float64 a)
+{
+  if (fastfp_ok())
+  {
+    double x = fastfp_d(a);
+    float r = (float) x;
+    if (isinf(r))
+    {
+      if (fastfp_inf_flags(!isinf(x)))
+        return fastfp_f32(r);
+    }
+    else if (r == r && fastfp_finite_flags(r, FLT_MIN, (double) r != x))
+      return fastfp_f32(r);
+  }
+  return float64_to_float32(a);
+}
+
+inline float32 fastfp_int32_to_float32(int32 a)
+{
+  if (fastfp_ok())
+  {
+    float r = (float) a;
+    if ((double) r != (double) a)
+      float_exception_flags |= float_flag_inexact;
+    return fastfp_f32(r);
+  }
+  return int32_to_float32(a);
+}
+
+// Exact, so there is nothing for the host to gain
+inline float64 fastfp_int32_to_float64(int32 a)
+{
+  return int32_to_float64(a);
+}
+
+// Out-of-range and NaN inputs go to softfloat, which returns the MIPS
+// saturated values rather than the x86 0x80000000
+inline int32 fastfp_float32_to_int32(float32 a)
+{
+  if (fastfp_ok())
+  {
+    float x = fastfp_f(a);
+    if (x >= -2147483648.0f && x < 2147483648.0f)
+    {
+      int32 r = _mm_cvtss_si32(_mm_set_ss(x));
+      if ((double) r != (double) x)
+        float_exception_flags |= float_flag_inexact;
+      return r;
+    }
+  }
+  return float32_to_int32(a);
+}
+
+inline int32 fastfp_float64_to_int32(float64 a)
+{
+  if (fastfp_ok())
+  {
+    double x = fastfp_d(a);
+    if (x > -2147483648.5 && x < 2147483647.5)
+    {
+      int32 r = _mm_cvtsd_si32(_mm_set_sd(x));
+      if ((double) r != x)
+        float_exception_flags |= float_flag_inexact;
+      return r;
+    }
+  }
+  return float64_to_int32(a);
+}
+
+#undef FASTFP_D_TINY
+
+#endif // __MIPS32FASTFP_H
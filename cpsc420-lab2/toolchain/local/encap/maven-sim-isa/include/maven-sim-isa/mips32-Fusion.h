@@ -0,0 +1,180 @@
+//========================================================================
+// mips32-Fusion.h : Superinstructions for the block engine
+//========================================================================
+
+#ifndef __MIPS32FUSION_H
+#define __MIPS32FUSION_H
+
+#include "mips32-ISA.h"
+#include "processor.h"
+
+//------------------------------------------------------------------------
+// Superinstructions
+//------------------------------------------------------------------------
+// Short runs of simple integer instructions which compilers emit back to
+// back, run as one group instead of one trip each round the block
+// engine's loop:
+//
+//   lui  rt, hi;  ori  rt, rt, lo          load a 32-bit constant
+//   alu  rX, ...; bne/beq rX, ...          loop tail or compare and branch
+//   alu; alu rX, ...; bne/beq rX, ...      eg. addiu i; slt t, i, n; bne t
+//
+// where alu is any of the ops in the enum below. The branch has to read
+// the register written just before it, so only these idioms are matched
+// rather than any pair which happens to be adjacent. None of the ops
+// can raise an exception, so a group always retires every instruction
+// in it, and the engine skips its per-instruction checks of runstate,
+// pc and can_step within a group.
+//
+// A group is built from the decoded instructions and the execute
+// handlers the dispatch tables resolved them to (the mips32_* execute
+// functions), and mips32_fuse_execute calls those handlers in turn, so
+// the architectural and microarch state each one sets, and what perf
+// sees of it, are exactly the interpreter's.
+
+enum
+{
+  MIPS32_FUSE_NONE,
+  MIPS32_FUSE_LUI,
+  MIPS32_FUSE_ORI,
+  MIPS32_FUSE_ADDIU,
+  MIPS32_FUSE_SLTI,
+  MIPS32_FUSE_SLTIU,
+  MIPS32_FUSE_ADDU,
+  MIPS32_FUSE_SUBU,
+  MIPS32_FUSE_SLT,
+  MIPS32_FUSE_SLTU,
+  MIPS32_FUSE_BEQ,
+  MIPS32_FUSE_BNE,
+};
+
+template <typename InstructionType, typename StateType>
+struct MIPS32FusedGroup
+{
+  typedef void (*ExecuteFunction)(InstructionType*, StateType*);
+
+  struct op_t
+  {
+    InstructionType* inst;
+    ExecuteFunction execute;
+  };
+
+  uint8_t len; // instructions covered, 0 if no group starts here
+  op_t ops[3];
+};
+
+inline int mips32_fuse_op(uint32_t bits)
+{
+  uint32_t opcode = bits >> 26;
+  uint32_t func   = bits & 0x3f;
+
+  switch (opcode)
+  {
+    case MIPS32_LUI:   return MIPS32_FUSE_LUI;
+    case MIPS32_ORI:   return MIPS32_FUSE_ORI;
+    case MIPS32_ADDIU: return MIPS32_FUSE_ADDIU;
+    case MIPS32_SLTI:  return MIPS32_FUSE_SLTI;
+    case MIPS32_SLTIU: return MIPS32_FUSE_SLTIU;
+    case MIPS32_BEQ:   return MIPS32_FUSE_BEQ;
+    case MIPS32_BNE:   return MIPS32_FUSE_BNE;
+
+    case MIPS32_SPECIAL:
+      switch (func)
+      {
+        case MIPS32_SPECIAL_ADDU: return MIPS32_FUSE_ADDU;
+        case MIPS32_SPECIAL_SUBU: return MIPS32_FUSE_SUBU;
+        case MIPS32_SPECIAL_SLT:  return MIPS32_FUSE_SLT;
+        case MIPS32_SPECIAL_SLTU: return MIPS32_FUSE_SLTU;
+      }
+      return MIPS32_FUSE_NONE;
+  }
+  return MIPS32_FUSE_NONE;
+}
+
+inline bool mips32_fuse_is_alu(int op)
+{
+  return op >= MIPS32_FUSE_LUI && op <= MIPS32_FUSE_SLTU;
+}
+
+inline bool mips32_fuse_is_branch(int op)
+{
+  return op == MIPS32_FUSE_BEQ || op == MIPS32_FUSE_BNE;
+}
+
+// The register an ALU op writes
+inline uint32_t mips32_fuse_dest(int op, uint32_t bits)
+{
+  return op >= MIPS32_FUSE_ADDU ? (bits >> 11) & 0x1f : (bits >> 16) & 0x1f;
+}
+
+// Match a group in the n (at most 3) decoded instructions at ops.
+// Returns false if none of the idioms start here.
+template <typename InstructionType, typename StateType>
+inline bool mips32_fuse_match(const typename MIPS32FusedGroup<InstructionType, StateType>::op_t* ops,
+                              int n, MIPS32FusedGroup<InstructionType, StateType>* g)
+{
+  int op[3];
+  uint32_t rs[3], rt[3], rd[3];
+  for (int i=0; i<3; i++)
+  {
+    uint32_t bits = i < n ? ops[i].inst->get_bits() : 0;
+    op[i] = i < n ? mips32_fuse_op(bits) : MIPS32_FUSE_NONE;
+    rs[i] = (bits >> 21) & 0x1f;
+    rt[i] = (bits >> 16) & 0x1f;
+    rd[i] = mips32_fuse_dest(op[i], bits);
+  }
+
+  if (!mips32_fuse_is_alu(op[0]))
+    return false;
+
+  // alu; branch
+  if (mips32_fuse_is_branch(op[1]))
+  {
+    if (rd[0] == 0 || (rs[1] != rd[0] && rt[1] != rd[0]))
+      return false;
+    g->len = 2;
+  }
+
+  // alu; alu; branch
+  else if (mips32_fuse_is_alu(op[1]) && mips32_fuse_is_branch(op[2])
+           && rd[1] != 0 && (rs[2] == rd[1] || rt[2] == rd[1]))
+    g->len = 3;
+
+  // lui; ori
+  else if (op[0] == MIPS32_FUSE_LUI && op[1] == MIPS32_FUSE_ORI && rs[1] == rt[0])
+    g->len = 2;
+
+  else
+    return false;
+
+  for (int i=0; i<g->len; i++)
+    g->ops[i] = ops[i];
+  return true;
+}
+
+// Execute the group g, whose first instruction is the next to run, and
+// retire its instructions in perf (which may be NULL). Each instruction
+// runs as in MavenBlockEngine::run: microarch fields cleared, handler,
+// retire, then on to npc unless it branched.
+template <typename InstructionType, typename StateType, typename PerfType>
+inline void mips32_fuse_execute(const MIPS32FusedGroup<InstructionType, StateType>& g,
+                                StateType& state, PerfType* perf)
+{
+  for (int i=0; i<g.len; i++)
+  {
+    state.alu = 0;
+    state.inst_branch = false;
+    state.inst_jump = false;
+    state.branch = false;
+    g.ops[i].execute(g.ops[i].inst, &state);
+    if (perf)
+      perf->retire(state);
+    if (!state.branch)
+    {
+      state.pc = state.npc;
+      state.npc += 4;
+    }
+  }
+}
+
+#endif // __MIPS32FUSION_H
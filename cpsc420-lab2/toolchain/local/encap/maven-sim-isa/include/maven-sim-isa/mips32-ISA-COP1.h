@@ -9,7 +9,7 @@ inline void help_convert_float32_to_w(int fs, int fd, int8 rmode, StateType* pro
   if (!proc->fpu.set_rounding_mode(rmode)) return;
 
   float32 f = proc->read_register_s(fs);
-  int32 i = float32_to_int32(f);
+  int32 i = fastfp_float32_to_int32(f);
 
   int8 allowed = float_flag_inexact | float_flag_invalid;
   if (!proc->fpu.handle_exceptions(allowed))
@@ -85,7 +85,7 @@ inline void help_convert_float64_to_w(int fs, int fd, int8 rmode, StateType* pro
   }
 
   float64 f = proc->read_register_d(fs);
-  int32 i = float64_to_int32(f);
+  int32 i = fastfp_float64_to_int32(f);
 
   int8 allowed = float_flag_inexact | float_flag_invalid;
   if (!proc->fpu.handle_exceptions(allowed))
@@ -502,7 +502,7 @@ struct mips32_add_s
 
     float32 f1 = proc->read_register_s(inst->get_fs());
     float32 f2 = proc->read_register_s(inst->get_ft());
-    float32 f = float32_add(f1, f2);
+    float32 f = fastfp_float32_add(f1, f2);
 
     int8 allowed = float_flag_inexact | float_flag_underflow | float_flag_overflow | float_flag_invalid;
     if (!proc->fpu.handle_exceptions(allowed))
@@ -540,7 +540,7 @@ struct mips32_sub_s
 
     float32 f1 = proc->read_register_s(inst->get_fs());
     float32 f2 = proc->read_register_s(inst->get_ft());
-    float32 f = float32_sub(f1, f2);
+    float32 f = fastfp_float32_sub(f1, f2);
 
     int8 allowed = float_flag_inexact | float_flag_underflow | float_flag_overflow | float_flag_invalid;
     if (!proc->fpu.handle_exceptions(allowed))
@@ -578,7 +578,7 @@ struct mips32_mul_s
 
     float32 f1 = proc->read_register_s(inst->get_fs());
     float32 f2 = proc->read_register_s(inst->get_ft());
-    float32 f = float32_mul(f1, f2);
+    float32 f = fastfp_float32_mul(f1, f2);
 
     int8 allowed = float_flag_inexact | float_flag_underflow | float_flag_overflow | float_flag_invalid;
     if (!proc->fpu.handle_exceptions(allowed))
@@ -616,7 +616,7 @@ struct mips32_div_s
 
     float32 f1 = proc->read_register_s(inst->get_fs());
     float32 f2 = proc->read_register_s(inst->get_ft());
-    float32 f = float32_div(f1, f2);
+    float32 f = fastfp_float32_div(f1, f2);
 
     int8 allowed = float_flag_inexact | float_flag_underflow | float_flag_overflow | float_flag_divbyzero | float_flag_invalid;
     if (!proc->fpu.handle_exceptions(allowed))
@@ -655,7 +655,7 @@ struct mips32_sqrt_s
       if (!proc->fpu.cleanup_state()) return;
 
       float32 f1 = proc->read_register_s(inst->get_fs());
-      float32 f = float32_sqrt(f1);
+      float32 f = fastfp_float32_sqrt(f1);
 
       int8 allowed = float_flag_inexact | float_flag_invalid;
       if (!proc->fpu.handle_exceptions(allowed))
@@ -965,7 +965,7 @@ struct mips32_cvt_d_s
       }
 
       float32 f1 = proc->read_register_s(inst->get_fs());
-      float64 f = float32_to_float64(f1);
+      float64 f = fastfp_float32_to_float64(f1);
 
       int8 allowed = float_flag_invalid;
       if (!proc->fpu.handle_exceptions(allowed))
@@ -999,7 +999,7 @@ struct mips32_cvt_w_s
       if (!proc->fpu.cleanup_state()) return;
 
       float32 f = proc->read_register_s(inst->get_fs());
-      int32 i = float32_to_int32(f);
+      int32 i = fastfp_float32_to_int32(f);
 
       int8 allowed = float_flag_inexact | float_flag_invalid;
       if (!proc->fpu.handle_exceptions(allowed))
@@ -1452,7 +1452,7 @@ struct mips32_add_d
 
     float64 f1 = proc->read_register_d(inst->get_fs());
     float64 f2 = proc->read_register_d(inst->get_ft());
-    float64 f = float64_add(f1, f2);
+    float64 f = fastfp_float64_add(f1, f2);
 
     int8 allowed = float_flag_inexact | float_flag_underflow | float_flag_overflow | float_flag_invalid;
     if (!proc->fpu.handle_exceptions(allowed))
@@ -1496,7 +1496,7 @@ struct mips32_sub_d
 
     float64 f1 = proc->read_register_d(inst->get_fs());
     float64 f2 = proc->read_register_d(inst->get_ft());
-    float64 f = float64_sub(f1, f2);
+    float64 f = fastfp_float64_sub(f1, f2);
 
     int8 allowed = float_flag_inexact | float_flag_underflow | float_flag_overflow | float_flag_invalid;
     if (!proc->fpu.handle_exceptions(allowed))
@@ -1540,7 +1540,7 @@ struct mips32_mul_d
 
     float64 f1 = proc->read_register_d(inst->get_fs());
     float64 f2 = proc->read_register_d(inst->get_ft());
-    float64 f = float64_mul(f1, f2);
+    float64 f = fastfp_float64_mul(f1, f2);
 
     int8 allowed = float_flag_inexact | float_flag_underflow | float_flag_overflow | float_flag_invalid;
     if (!proc->fpu.handle_exceptions(allowed))
@@ -1584,7 +1584,7 @@ struct mips32_div_d
 
     float64 f1 = proc->read_register_d(inst->get_fs());
     float64 f2 = proc->read_register_d(inst->get_ft());
-    float64 f = float64_div(f1, f2);
+    float64 f = fastfp_float64_div(f1, f2);
 
     int8 allowed = float_flag_inexact | float_flag_underflow | float_flag_overflow | float_flag_divbyzero | float_flag_invalid;
     if (!proc->fpu.handle_exceptions(allowed))
@@ -1624,7 +1624,7 @@ struct mips32_sqrt_d
       }
 
       float64 f1 = proc->read_register_d(inst->get_fs());
-      float64 f = float64_sqrt(f1);
+      float64 f = fastfp_float64_sqrt(f1);
 
       int8 allowed = float_flag_inexact | float_flag_invalid;
       if (!proc->fpu.handle_exceptions(allowed))
@@ -1997,7 +1997,7 @@ struct mips32_cvt_s_d
       }
 
       float64 f1 = proc->read_register_d(inst->get_fs());
-      float32 f = float64_to_float32(f1);
+      float32 f = fastfp_float64_to_float32(f1);
 
       int8 allowed = float_flag_inexact | float_flag_underflow | float_flag_overflow | float_flag_invalid;
       if (!proc->fpu.handle_exceptions(allowed))
@@ -2036,7 +2036,7 @@ struct mips32_cvt_w_d
       }
 
       float64 f = proc->read_register_d(inst->get_fs());
-      int32 i = float64_to_int32(f);
+      int32 i = fastfp_float64_to_int32(f);
 
       int8 allowed = float_flag_inexact | float_flag_invalid;
       if (!proc->fpu.handle_exceptions(allowed))
@@ -2475,7 +2475,7 @@ struct mips32_cvt_s_w
       if (!proc->fpu.cleanup_state()) return;
 
       int32 i = proc->read_register_w(inst->get_fs());
-      float32 f = int32_to_float32(i);
+      float32 f = fastfp_int32_to_float32(i);
 
       int8 allowed = float_flag_inexact;
       if (!proc->fpu.handle_exceptions(allowed))
@@ -2514,7 +2514,7 @@ struct mips32_cvt_d_w
       }
 
       int32 i = proc->read_register_w(inst->get_fs());
-      float64 f = int32_to_float64(i);
+      float64 f = fastfp_int32_to_float64(i);
 
       proc->write_register_d(inst->get_fd(), f);
     }
@@ -501,7 +501,9 @@ struct mips32_lb
   {
     addr_t addr = proc->read_register(inst->get_rs()) + (int16_t)inst->get_immediate();
 
-    proc->write_register(inst->get_rt(), proc->mem.read_mem_int8(addr));
+    int8_t val;
+    if (mem_load(proc, addr, val))
+      proc->write_register(inst->get_rt(), val);
 
     // microarch state
     proc->alu = ALU_LD;
@@ -526,14 +528,9 @@ struct mips32_lh
   {
     addr_t addr = proc->read_register(inst->get_rs()) + (int16_t)inst->get_immediate();
 
-    if (addr & 0x1)
-    {
-      proc->raise_exception(StateType::EXCEPTION_ADDR_MISALIGNED_LOAD);
-    }
-    else
-    {
-      proc->write_register(inst->get_rt(), proc->mem.read_mem_int16(addr));
-    }
+    int16_t val;
+    if (mem_load(proc, addr, val))
+      proc->write_register(inst->get_rt(), val);
 
     // microarch state
     proc->alu = ALU_LD;
@@ -558,7 +555,9 @@ struct mips32_lwl
   {
     addr_t addr = proc->read_register(inst->get_rs()) + (int16_t)inst->get_immediate();
     uint32_t rval = proc->read_register(inst->get_rt());
-    uint32_t mval = proc->mem.read_mem_uint32(addr & 0xFFFFFFFC);
+    uint32_t mval;
+    if (!mem_load(proc, addr & 0xFFFFFFFC, mval))
+      return;
     uint32_t mask = 0xFFFFFFFF;
 
     mask = mask << (8*(addr%4));
@@ -585,14 +584,9 @@ struct mips32_lw
   {
     addr_t addr = proc->read_register(inst->get_rs()) + (int16_t)inst->get_immediate();
 
-    if (addr & 0x3)
-    {
-      proc->raise_exception(StateType::EXCEPTION_ADDR_MISALIGNED_LOAD);
-    }
-    else
-    {
-      proc->write_register(inst->get_rt(), proc->mem.read_mem_int32(addr));
-    }
+    int32_t val;
+    if (mem_load(proc, addr, val))
+      proc->write_register(inst->get_rt(), val);
 
     // microarch state
     proc->alu = ALU_LD;
@@ -617,7 +611,9 @@ struct mips32_lbu
   {
     addr_t addr = proc->read_register(inst->get_rs()) + (int16_t)inst->get_immediate();
 
-    proc->write_register(inst->get_rt(), proc->mem.read_mem_uint8(addr));
+    uint8_t val;
+    if (mem_load(proc, addr, val))
+      proc->write_register(inst->get_rt(), val);
 
     // microarch state
     proc->alu = ALU_LD;
@@ -642,14 +638,9 @@ struct mips32_lhu
   {
     addr_t addr = proc->read_register(inst->get_rs()) + (int16_t)inst->get_immediate();
 
-    if (addr & 0x1)
-    {
-      proc->raise_exception(StateType::EXCEPTION_ADDR_MISALIGNED_LOAD);
-    }
-    else
-    {
-      proc->write_register(inst->get_rt(), proc->mem.read_mem_uint16(addr));
-    }
+    uint16_t val;
+    if (mem_load(proc, addr, val))
+      proc->write_register(inst->get_rt(), val);
 
     // microarch state
     proc->alu = ALU_LD;
@@ -674,7 +665,9 @@ struct mips32_lwr
   {
     addr_t addr = proc->read_register(inst->get_rs()) + (int16_t)inst->get_immediate();
     uint32_t rval = proc->read_register(inst->get_rt());
-    uint32_t mval = proc->mem.read_mem_uint32(addr & 0xFFFFFFFC);
+    uint32_t mval;
+    if (!mem_load(proc, addr & 0xFFFFFFFC, mval))
+      return;
     uint32_t mask = 0xFFFFFFFF;
  
     mask = mask >> (8*(3-(addr%4)));
@@ -701,7 +694,7 @@ struct mips32_sb
   {
     addr_t addr = proc->read_register(inst->get_rs()) + (int16_t)inst->get_immediate();
 
-    proc->mem.write_mem_uint8(addr, proc->read_register(inst->get_rt()));
+    mem_store<uint8_t>(proc, addr, proc->read_register(inst->get_rt()));
 
     // microarch state
     proc->alu = ALU_ST;
@@ -726,14 +719,7 @@ struct mips32_sh
   {
     addr_t addr = proc->read_register(inst->get_rs()) + (int16_t)inst->get_immediate();
 
-    if (addr & 0x1)
-    {
-      proc->raise_exception(StateType::EXCEPTION_ADDR_MISALIGNED_STORE);
-    }
-    else
-    {
-      proc->mem.write_mem_uint16(addr, proc->read_register(inst->get_rt()));
-    }
+    mem_store<uint16_t>(proc, addr, proc->read_register(inst->get_rt()));
 
     // microarch state
     proc->alu = ALU_ST;
@@ -758,7 +744,9 @@ struct mips32_swl
   {
     addr_t addr = proc->read_register(inst->get_rs()) + (int16_t)inst->get_immediate();
     uint32_t rval = proc->read_register(inst->get_rt());
-    uint32_t mval = proc->mem.read_mem_uint32(addr & 0xFFFFFFFC);
+    uint32_t mval;
+    if (!mem_load(proc, addr & 0xFFFFFFFC, mval))
+      return;
     uint32_t mask = 0xFFFFFFFF;
 
     mask = mask >> (8*(addr%4));
@@ -767,7 +755,7 @@ struct mips32_swl
     mval &= ~mask;
     mval |= rval;
 
-    proc->mem.write_mem_uint32(addr & 0xFFFFFFFC, mval);
+    mem_store(proc, addr & 0xFFFFFFFC, mval);
   }
   static void disassemble(InstructionType* inst, StateType* proc)
   {
@@ -785,14 +773,7 @@ struct mips32_sw
   {
     addr_t addr = proc->read_register(inst->get_rs()) + (int16_t)inst->get_immediate();
 
-    if (addr & 0x3)
-    {
-      proc->raise_exception(StateType::EXCEPTION_ADDR_MISALIGNED_STORE);
-    }
-    else
-    {
-      proc->mem.write_mem_uint32(addr, proc->read_register(inst->get_rt()));
-    }
+    mem_store<uint32_t>(proc, addr, proc->read_register(inst->get_rt()));
 
     // microarch state
     proc->alu = ALU_ST;
@@ -817,7 +798,9 @@ struct mips32_swr
   {
     addr_t addr = proc->read_register(inst->get_rs()) + (int16_t)inst->get_immediate();
     uint32_t rval = proc->read_register(inst->get_rt());
-    uint32_t mval = proc->mem.read_mem_uint32(addr & 0xFFFFFFFC);
+    uint32_t mval;
+    if (!mem_load(proc, addr & 0xFFFFFFFC, mval))
+      return;
     uint32_t mask = 0xFFFFFFFF;
 
     mask = mask << (8*(3-(addr%4)));
@@ -826,7 +809,7 @@ struct mips32_swr
     mval &= ~mask;
     mval |= rval;
 
-    proc->mem.write_mem_uint32(addr & 0xFFFFFFFC, mval);
+    mem_store(proc, addr & 0xFFFFFFFC, mval);
   }
   static void disassemble(InstructionType* inst, StateType* proc)
   {
@@ -876,14 +859,9 @@ struct mips32_lwc1
   {
     addr_t addr = proc->read_register(inst->get_rs()) + (int16_t)inst->get_immediate();
 
-    if (addr & 0x3)
-    {
-      proc->raise_exception(StateType::EXCEPTION_ADDR_MISALIGNED_LOAD);
-    }
-    else
-    {
-      proc->write_register(inst->get_ft(), proc->mem.read_mem_int32(addr));
-    }
+    int32_t val;
+    if (mem_load(proc, addr, val))
+      proc->write_register(inst->get_ft(), val);
   }
   static void disassemble(InstructionType* inst, StateType* proc)
   {
@@ -933,14 +911,15 @@ struct mips32_ldc1
   {
     addr_t addr = proc->read_register(inst->get_rs()) + (int16_t)inst->get_immediate();
 
-    if ((addr & 0x7) || (inst->get_ft() & 0x1))
+    uint64_t val;
+    if (inst->get_ft() & 0x1)
     {
       proc->raise_exception(StateType::EXCEPTION_ADDR_MISALIGNED_LOAD);
     }
-    else
+    else if (mem_load(proc, addr, val))
     {
-      proc->write_register(inst->get_ft(), proc->mem.read_mem_int32(addr+4));
-      proc->write_register(inst->get_ft()+1, proc->mem.read_mem_int32(addr));
+      proc->write_register(inst->get_ft(), val >> 32);
+      proc->write_register(inst->get_ft()+1, (uint32_t) val);
     }
   }
   static void disassemble(InstructionType* inst, StateType* proc)
@@ -991,14 +970,7 @@ struct mips32_swc1
   {
     addr_t addr = proc->read_register(inst->get_rs()) + (int16_t)inst->get_immediate();
 
-    if (addr & 0x3)
-    {
-      proc->raise_exception(StateType::EXCEPTION_ADDR_MISALIGNED_STORE);
-    }
-    else
-    {
-      proc->mem.write_mem_uint32(addr, proc->read_register(inst->get_ft()));
-    }
+    mem_store<uint32_t>(proc, addr, proc->read_register(inst->get_ft()));
   }
   static void disassemble(InstructionType* inst, StateType* proc)
   {
@@ -1032,14 +1004,15 @@ struct mips32_sdc1
   {
     addr_t addr = proc->read_register(inst->get_rs()) + (int16_t)inst->get_immediate();
 
-    if ((addr & 0x7) || (inst->get_ft() & 0x1))
+    if (inst->get_ft() & 0x1)
     {
       proc->raise_exception(StateType::EXCEPTION_ADDR_MISALIGNED_STORE);
     }
     else
     {
-      proc->mem.write_mem_uint32(addr, proc->read_register(inst->get_ft()+1));
-      proc->mem.write_mem_uint32(addr+4, proc->read_register(inst->get_ft()));
+      uint64_t val = ((uint64_t) proc->read_register(inst->get_ft()) << 32)
+                   | proc->read_register(inst->get_ft()+1);
+      mem_store(proc, addr, val);
     }
   }
   static void disassemble(InstructionType* inst, StateType* proc)
@@ -40,6 +40,11 @@ public:
   {
     dispatch(DISPATCH_DISASSEMBLE, inst, proc);
   }
+
+  void (*lookup_execute(InstructionType* inst))(InstructionType*, StateType*)
+  {
+    return this->lookup(DISPATCH_EXECUTE, inst);
+  }
 };
 
 #endif // MIPSDT_H
@@ -87,6 +87,25 @@ public:
     func(inst, proc);
   }
 
+  // The function dispatch would call for inst, without calling it, for
+  // a caller that keeps it to call again later
+  SmartDispatchTableFunction lookup(int functionidx, InstructionType* inst)
+  {
+    unsigned int index = ((*inst)>>shift) & mask;
+    SmartDispatchTableFunction func = func_table[index*FunctionCount+functionidx];
+    SmartDispatchTable* prev = this;
+
+    while (!func)
+    {
+      SmartDispatchTable* next = prev->class_table[index];
+      index = ((*inst)>>next->shift) & (next->mask);
+      func = next->func_table[index*FunctionCount+functionidx];
+      prev = next;
+    }
+
+    return func;
+  }
+
 private:
   int shift;
   unsigned int mask;
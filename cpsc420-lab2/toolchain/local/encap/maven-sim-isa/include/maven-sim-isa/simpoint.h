@@ -0,0 +1,614 @@
+//========================================================================
+// simpoint.h : Sampled simulation driver
+//========================================================================
+// SimPoint-style sampling in three passes over the same program. Each
+// pass is driven by calling the matching *_to_tohost method in place of
+// simulator_t::run_to_tohost, so the appserver keeps servicing syscalls
+// between calls exactly as it does for a normal run. maven-isa-run
+// drives the passes with its --simpoint-* options (see isarun.h).
+//
+//  1. Profile. Fast-forward functionally and split the dynamic
+//     instruction stream into fixed-length intervals. Each interval gets
+//     a basic-block vector, already randomly projected down to DIMS
+//     dimensions: every block's entry pc hashes to a fixed random vector,
+//     and executing the block adds its length times that vector. The
+//     intervals are then clustered with k-means. The smallest k whose
+//     BIC score reaches 90% of the best is kept. Each cluster is
+//     weighted by the fraction of intervals in it, and up to `samples`
+//     of its intervals, drawn at random, become its simulation points.
+//     With samples = 1 the point is instead the interval closest to
+//     the centroid, as in SimPoint. Results go to a points file.
+//
+//  2. Checkpoint. Fast-forward again and save a checkpoint (see
+//     checkpoint.h) `warmup` instructions ahead of every simulation
+//     point. Only the pages stored to since the ELF was loaded are
+//     saved.
+//
+//  3. Replay. For each point, restore its checkpoint and turn stats_en
+//     on. Run the warmup instructions unmeasured, so the scoreboard and
+//     the VPs are in a steady state, then run one interval and record
+//     its CPI from g_stat_cycle_count.
+//
+// The estimate treats the clusters as strata: the weighted sum of each
+// cluster's mean CPI. Its error bound is a 95% interval from the sample
+// variance of the CPIs within each cluster, with the finite population
+// correction, so a cluster sampled in full adds nothing. A cluster with
+// a single point out of several intervals has no variance estimate, and
+// then no bound is reported.
+//
+// Instructions are counted across all active cores, so with several
+// cores an interval is a slice of the interleaved stream.
+
+#ifndef __SIMPOINT_H
+#define __SIMPOINT_H
+
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "simulator.h"
+#include "checkpoint.h"
+#include "maven-global.h"
+
+class simpoint_t
+{
+public:
+  enum
+  {
+    DIMS = 15,
+    KMEANS_ITERS = 100,
+  };
+
+  struct point_t
+  {
+    int interval;
+    int cluster;
+    int size;      // intervals in the cluster
+    double weight; // fraction of all intervals in the cluster
+    double cpi;
+  };
+
+  simpoint_t(simulator_t& _sim, long long _interval_len, long long _warmup_len,
+             int _max_k = 30, int _samples = 3)
+    : sim(_sim)
+    , interval_len(_interval_len)
+    , warmup_len(_warmup_len)
+    , max_k(_max_k)
+    , samples(_samples > 0 ? _samples : 1)
+    , nintervals(0)
+    , ninsts(0)
+    , interval_insts(0)
+    , next_point(0)
+    , replaying(-1)
+    , fault_core(-1)
+  {
+    for (int i=0; i<MAVEN_SYSCFG_MAX_PROCS; i++)
+    {
+      last_pc[i] = 0xffffffff;
+      block_pc[i] = 0;
+      block_len[i] = 0;
+    }
+    clear_vector();
+  }
+
+  //----------------------------------------------------------------------
+  // Pass 1: profile
+  //----------------------------------------------------------------------
+
+  int profile_to_tohost(int orig_tohost)
+  {
+    while (tohost() == orig_tohost && step_cycle(true))
+      ;
+    return tohost();
+  }
+
+  // Call once the program has exited. Chooses the simulation points.
+  void cluster()
+  {
+    flush_blocks();
+    if (interval_insts > 0)
+      end_interval();
+
+    int n = bbvs.size() / DIMS;
+    nintervals = n;
+    if (n == 0)
+      return;
+
+    int kmax = max_k < n ? max_k : n;
+    std::vector<double> bic(kmax+1);
+    std::vector< std::vector<int> > assigns(kmax+1);
+    std::vector< std::vector<double> > centroids(kmax+1);
+
+    for (int k=1; k<=kmax; k++)
+      bic[k] = kmeans(k, assigns[k], centroids[k]);
+
+    double lo = bic[1], hi = bic[1];
+    for (int k=2; k<=kmax; k++)
+    {
+      if (bic[k] < lo) lo = bic[k];
+      if (bic[k] > hi) hi = bic[k];
+    }
+
+    int k = 1;
+    while (k < kmax && bic[k] < lo + 0.9*(hi - lo))
+      k++;
+
+    points.clear();
+    int nclusters = 0;
+    uint32_t seed = 1;
+    for (int c=0; c<k; c++)
+    {
+      std::vector<int> members;
+      int closest = -1;
+      double closest_dist = 0.0;
+      for (int i=0; i<n; i++)
+      {
+        if (assigns[k][i] != c)
+          continue;
+        members.push_back(i);
+        double d = dist2(&bbvs[i*DIMS], &centroids[k][c*DIMS]);
+        if (closest < 0 || d < closest_dist)
+        {
+          closest = i;
+          closest_dist = d;
+        }
+      }
+      if (members.empty())
+        continue;
+
+      point_t p;
+      p.cluster = nclusters++;
+      p.size = members.size();
+      p.weight = (double) members.size() / n;
+      p.cpi = 0.0;
+
+      if (samples == 1)
+      {
+        p.interval = closest;
+        points.push_back(p);
+        continue;
+      }
+
+      // Partial Fisher-Yates shuffle for a sample without replacement
+      int m = samples < (int) members.size() ? samples : members.size();
+      for (int j=0; j<m; j++)
+      {
+        seed = seed * 1103515245u + 12345u;
+        int r = j + (seed >> 8) % (members.size() - j);
+        std::swap(members[j], members[r]);
+        p.interval = members[j];
+        points.push_back(p);
+      }
+    }
+  }
+
+  void write_points(const char* fname)
+  {
+    FILE* fp = fopen(fname, "w");
+    if (!fp)
+    {
+      printf("Couldn't open %s!\n", fname);
+      exit(-1);
+    }
+    fprintf(fp, "# interval_len %lld warmup %lld intervals %d\n",
+            interval_len, warmup_len, nintervals);
+    for (size_t i=0; i<points.size(); i++)
+      fprintf(fp, "%d %d %d %f\n", points[i].interval, points[i].cluster,
+              points[i].size, points[i].weight);
+    fclose(fp);
+  }
+
+  void read_points(const char* fname)
+  {
+    FILE* fp = fopen(fname, "r");
+    if (!fp || fscanf(fp, "# interval_len %lld warmup %lld intervals %d\n",
+                      &interval_len, &warmup_len, &nintervals) != 3)
+    {
+      printf("Couldn't read simulation points from %s!\n", fname);
+      exit(-1);
+    }
+
+    point_t p;
+    p.cpi = 0.0;
+    points.clear();
+    while (fscanf(fp, "%d %d %d %lf\n", &p.interval, &p.cluster, &p.size, &p.weight) == 4)
+      points.push_back(p);
+    fclose(fp);
+
+    // The checkpoint pass walks the points in program order
+    for (size_t i=1; i<points.size(); i++)
+      for (size_t j=i; j>0 && points[j-1].interval > points[j].interval; j--)
+        std::swap(points[j-1], points[j]);
+  }
+
+  //----------------------------------------------------------------------
+  // Pass 2: checkpoint
+  //----------------------------------------------------------------------
+  // Checkpoints are named <prefix>.<interval>.ckpt. Each is taken
+  // warmup instructions before its interval starts, or at the start of
+  // the program for an interval closer to it than that.
+
+  int checkpoint_to_tohost(int orig_tohost, const char* prefix)
+  {
+    // The first call comes just after the load
+    if (!sim.mem.dirty_tracking_armed())
+      sim.mem.arm_dirty_tracking();
+
+    while (tohost() == orig_tohost)
+    {
+      // With several cores a cycle retires several instructions, so the
+      // checkpoint lands on the first cycle boundary at or past the start
+      if (next_point < (int) points.size()
+          && ninsts >= checkpoint_start(points[next_point]))
+      {
+        checkpoint_t::save(sim, checkpoint_name(prefix, points[next_point].interval));
+        next_point++;
+      }
+
+      if (!step_cycle(false))
+        break;
+    }
+    return tohost();
+  }
+
+  //----------------------------------------------------------------------
+  // Pass 3: replay
+  //----------------------------------------------------------------------
+  // For each point: configure a fresh simulator and load the ELF, then
+  // replay_begin, drive replay_to_tohost until replay_done, replay_end.
+
+  void replay_begin(int idx, const char* prefix)
+  {
+    checkpoint_t::restore(sim, checkpoint_name(prefix, points[idx].interval));
+
+    for (int i=0; i<sim.nproc; i++)
+    {
+      sim.procs[i]->cp.state.stats_en = true;
+      sim.procs[i]->vparray.stats_en = true;
+    }
+
+    replaying = idx;
+    ninsts = 0;
+    warmup_left = points[idx].interval * interval_len - checkpoint_start(points[idx]);
+    start_cycles = maven::g_stat_cycle_count;
+  }
+
+  int replay_to_tohost(int orig_tohost)
+  {
+    while (tohost() == orig_tohost && !replay_done() && step_cycle(false))
+      ;
+    return tohost();
+  }
+
+  bool replay_done()
+  {
+    return ninsts >= warmup_left + interval_len;
+  }
+
+  // The core which faulted and stopped the last *_to_tohost call early,
+  // or -1. A caller should report it with simulator_t::print_panic.
+  int faulted()
+  {
+    return fault_core;
+  }
+
+  void replay_end()
+  {
+    if (ninsts > warmup_left)
+      points[replaying].cpi = (double) (maven::g_stat_cycle_count - start_cycles) / (ninsts - warmup_left);
+    replaying = -1;
+  }
+
+  // Stratified CPI estimate and its 95% bound
+  void report(FILE* fp)
+  {
+    int nclusters = 0;
+    for (size_t i=0; i<points.size(); i++)
+      if (points[i].cluster >= nclusters)
+        nclusters = points[i].cluster + 1;
+
+    std::vector<double> sum(nclusters), sum2(nclusters), weight(nclusters);
+    std::vector<int> nsamples(nclusters), size(nclusters);
+    for (size_t i=0; i<points.size(); i++)
+    {
+      const point_t& p = points[i];
+      sum[p.cluster] += p.cpi;
+      sum2[p.cluster] += p.cpi * p.cpi;
+      nsamples[p.cluster]++;
+      size[p.cluster] = p.size;
+      weight[p.cluster] = p.weight;
+    }
+
+    double cpi = 0.0, wsum = 0.0, var = 0.0;
+    int unbounded = -1;
+    for (int c=0; c<nclusters; c++)
+    {
+      int m = nsamples[c];
+      if (m == 0)
+        continue;
+      double mean = sum[c] / m;
+      cpi += weight[c] * mean;
+      wsum += weight[c];
+
+      if (m == size[c])
+        continue;
+      if (m < 2)
+      {
+        unbounded = c;
+        continue;
+      }
+      double s2 = (sum2[c] - m * mean * mean) / (m - 1);
+      if (s2 < 0.0)
+        s2 = 0.0;
+      var += weight[c] * weight[c] * (1.0 - (double) m / size[c]) * s2 / m;
+    }
+    if (wsum > 0.0)
+    {
+      cpi /= wsum;
+      var /= wsum * wsum;
+    }
+    double bound = 1.96 * sqrt(var);
+
+    fprintf(fp, "--------------------------------------------------\n");
+    fprintf(fp, " simpoints: %d intervals of %lld instructions, %lld warmup\n",
+            nintervals, interval_len, warmup_len);
+    for (size_t i=0; i<points.size(); i++)
+      fprintf(fp, "  interval %8d  cluster %3d  weight %6.4f  cpi %8.4f\n",
+              points[i].interval, points[i].cluster, points[i].weight, points[i].cpi);
+    if (unbounded >= 0)
+      fprintf(fp, " estimated cpi: %.4f (no bound, cluster %d has one sample)\n",
+              cpi, unbounded);
+    else
+      fprintf(fp, " estimated cpi: %.4f +/- %.4f (%.1f%%)\n",
+              cpi, bound, cpi > 0.0 ? 100.0*bound/cpi : 0.0);
+  }
+
+  std::vector<point_t> points;
+
+private:
+  //----------------------------------------------------------------------
+  // Stepping
+  //----------------------------------------------------------------------
+  // One cycle of simulator_t::step_cycle, plus instruction counting
+  // and, when profiling, block tracking.
+
+  int tohost()
+  {
+    return sim.mem.read_mem_int32(sim.magicmemaddr);
+  }
+
+  // Returns false, leaving the core in fault_core, if a core faulted
+  bool step_cycle(bool profiling)
+  {
+    sim.cycle++;
+    for (int i=0; i<sim.nproc; i++)
+    {
+      if (!(sim.tid_mask & (1 << i)))
+        continue;
+
+      addr_t pc = sim.procs[i]->cp.state.pc;
+
+      bool ok = sim.step_core(i);
+      ninsts++;
+
+      // Measurement starts once the warmup is done
+      if (replaying >= 0 && ninsts == warmup_left)
+        start_cycles = maven::g_stat_cycle_count;
+
+      if (profiling)
+      {
+        // A pc which does not follow the last one starts a new block
+        if (pc != last_pc[i] + 4)
+        {
+          add_block(block_pc[i], block_len[i]);
+          block_pc[i] = pc;
+          block_len[i] = 0;
+        }
+        block_len[i]++;
+        last_pc[i] = pc;
+
+        if (++interval_insts == interval_len)
+        {
+          flush_blocks();
+          end_interval();
+        }
+      }
+
+      if (!ok)
+      {
+        fault_core = i;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  //----------------------------------------------------------------------
+  // Basic-block vectors
+  //----------------------------------------------------------------------
+
+  // Fixed pseudo-random projection of block pc onto dimension d, in
+  // [-1,1). The same pc always maps to the same vector.
+  static double project(addr_t pc, int d)
+  {
+    uint32_t h = pc * 0x9e3779b1u + d * 0x85ebca6bu;
+    h ^= h >> 15; h *= 0x2c1b3c6du;
+    h ^= h >> 12; h *= 0x297a2d39u;
+    h ^= h >> 15;
+    return (double) h / 2147483648.0 - 1.0;
+  }
+
+  void add_block(addr_t pc, int len)
+  {
+    if (len == 0)
+      return;
+    for (int d=0; d<DIMS; d++)
+      vector[d] += len * project(pc, d);
+  }
+
+  void flush_blocks()
+  {
+    for (int i=0; i<sim.nproc; i++)
+    {
+      add_block(block_pc[i], block_len[i]);
+      block_len[i] = 0;
+    }
+  }
+
+  void end_interval()
+  {
+    for (int d=0; d<DIMS; d++)
+      bbvs.push_back(vector[d] / interval_insts);
+    interval_insts = 0;
+    clear_vector();
+  }
+
+  void clear_vector()
+  {
+    for (int d=0; d<DIMS; d++)
+      vector[d] = 0.0;
+  }
+
+  //----------------------------------------------------------------------
+  // Clustering
+  //----------------------------------------------------------------------
+
+  static double dist2(const double* a, const double* b)
+  {
+    double s = 0.0;
+    for (int d=0; d<DIMS; d++)
+      s += (a[d] - b[d]) * (a[d] - b[d]);
+    return s;
+  }
+
+  // k-means with furthest-first seeding. Returns the BIC of the result
+  // under a spherical Gaussian model (Pelleg and Moore's X-means form).
+  double kmeans(int k, std::vector<int>& assign, std::vector<double>& c)
+  {
+    int n = bbvs.size() / DIMS;
+    assign.assign(n, 0);
+    c.assign(k*DIMS, 0.0);
+
+    std::vector<double> mind(n);
+    for (int d=0; d<DIMS; d++)
+      c[d] = bbvs[d];
+    for (int i=0; i<n; i++)
+      mind[i] = dist2(&bbvs[i*DIMS], &c[0]);
+    for (int j=1; j<k; j++)
+    {
+      int far = 0;
+      for (int i=1; i<n; i++)
+        if (mind[i] > mind[far])
+          far = i;
+      for (int d=0; d<DIMS; d++)
+        c[j*DIMS+d] = bbvs[far*DIMS+d];
+      for (int i=0; i<n; i++)
+      {
+        double dd = dist2(&bbvs[i*DIMS], &c[j*DIMS]);
+        if (dd < mind[i])
+          mind[i] = dd;
+      }
+    }
+
+    std::vector<int> size(k);
+    for (int iter=0; iter<KMEANS_ITERS; iter++)
+    {
+      bool changed = false;
+      for (int i=0; i<n; i++)
+      {
+        int best = 0;
+        double bestd = dist2(&bbvs[i*DIMS], &c[0]);
+        for (int j=1; j<k; j++)
+        {
+          double dd = dist2(&bbvs[i*DIMS], &c[j*DIMS]);
+          if (dd < bestd)
+          {
+            best = j;
+            bestd = dd;
+          }
+        }
+        if (assign[i] != best || iter == 0)
+          changed = true;
+        assign[i] = best;
+      }
+      if (!changed)
+        break;
+
+      c.assign(k*DIMS, 0.0);
+      size.assign(k, 0);
+      for (int i=0; i<n; i++)
+      {
+        size[assign[i]]++;
+        for (int d=0; d<DIMS; d++)
+          c[assign[i]*DIMS+d] += bbvs[i*DIMS+d];
+      }
+      for (int j=0; j<k; j++)
+        for (int d=0; d<DIMS; d++)
+          c[j*DIMS+d] = size[j] ? c[j*DIMS+d] / size[j] : 0.0;
+    }
+
+    size.assign(k, 0);
+    double sse = 0.0;
+    for (int i=0; i<n; i++)
+    {
+      size[assign[i]]++;
+      sse += dist2(&bbvs[i*DIMS], &c[assign[i]*DIMS]);
+    }
+
+    if (n <= k)
+      return 0.0;
+    double var = sse / (DIMS * (double) (n - k));
+    if (var < 1e-12)
+      var = 1e-12;
+
+    double ll = 0.0;
+    for (int j=0; j<k; j++)
+    {
+      if (size[j] == 0)
+        continue;
+      double r = size[j];
+      ll += r * log(r) - r * log((double) n) - r * DIMS / 2.0 * log(2.0 * M_PI * var)
+          - DIMS * (r - 1) / 2.0;
+    }
+    double params = (k - 1) + DIMS * k + 1;
+    return ll - params / 2.0 * log((double) n);
+  }
+
+  long long checkpoint_start(const point_t& p)
+  {
+    long long start = p.interval * interval_len - warmup_len;
+    return start > 0 ? start : 0;
+  }
+
+  const char* checkpoint_name(const char* prefix, int interval)
+  {
+    snprintf(name_buf, sizeof(name_buf), "%s.%d.ckpt", prefix, interval);
+    return name_buf;
+  }
+
+  simulator_t& sim;
+  long long interval_len;
+  long long warmup_len;
+  int max_k;
+  int samples;
+  int nintervals; // in the profiled run
+
+  long long ninsts;
+  long long interval_insts;
+  addr_t last_pc[MAVEN_SYSCFG_MAX_PROCS];
+  addr_t block_pc[MAVEN_SYSCFG_MAX_PROCS];
+  int block_len[MAVEN_SYSCFG_MAX_PROCS];
+  double vector[DIMS];
+  std::vector<double> bbvs; // DIMS values per interval
+
+  int next_point;
+  int replaying;
+  int fault_core;
+  long long warmup_left;
+  long long start_cycles;
+  char name_buf[1024];
+};
+
+#endif // __SIMPOINT_H
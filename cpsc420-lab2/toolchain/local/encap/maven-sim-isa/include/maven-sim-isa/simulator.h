@@ -1,10 +1,13 @@
 #ifndef __SIMULATOR_H
 #define __SIMULATOR_H
 
+#include <stdio.h>
 #include <vector>
 
 #include "types.h"
 #include "processor.h"
+#include "maven-PerfCounters.h"
+#include "stepcache.h"
 
 class simulator_t
 {
@@ -24,9 +27,123 @@ public:
   void set_logfile(FILE* logfile);
   uint32_t get_cycle();
   
+  // One cycle of the serial loop in run_to_tohost: step every core in
+  // tid_mask once, restarting any that stopped on a syscall at ebase.
+  // Returns the first core which stopped on any other exception, or -1.
+  // Unlike run_to_tohost this does not exit on a fault, so a caller can
+  // report it or wind back from it first. sc, if given, keeps the cores'
+  // decode caches and block engines (stepcache.h) from one cycle to the
+  // next. A core with a block engine which is the only one in tid_mask
+  // may run on to the end of its block; cycle then counts one cycle for
+  // each instruction, as if step_cycle had been called for each.
+  int step_cycle(MavenStepCache* sc = NULL)
+  {
+    cycle++;
+    for (int i=0; i<nproc; i++)
+    {
+      if (!(tid_mask & (1 << i)))
+        continue;
+
+      int n = 1;
+      bool ok = step_core(i, sc, runs_alone(i) ? (int) MavenBlockEngine::MAX_INSTS : 1, &n);
+      cycle += n - 1;
+      if (!ok)
+        return i;
+    }
+    return -1;
+  }
+
+  // Execute an instruction on core i and count it in the core's
+  // performance counters. Returns false if it faulted. The microarch
+  // fields are cleared first so the counters only see what this
+  // instruction set. With a decode cache for the core, an instruction
+  // it can run skips MavenProcessor::execute. With a block engine, up to
+  // max instructions run from it, and ninsts, if given, is set to the
+  // number executed. The core's counters are looked up once and kept
+  // in sc, if given. A core with a trace in sc runs one instruction at
+  // a time and records it there. A watch in sc gets the core's pc.
+  bool step_core(int i, MavenStepCache* sc = NULL, int max = 1, int* ninsts = NULL)
+  {
+    MavenCPState& state = procs[i]->cp.state;
+    MavenStepCache::core_t* c = sc ? &sc->core(i) : NULL;
+    int n = 1;
+
+    if (sc && sc->get_watch())
+      sc->get_watch()->set_pc_source(&state.pc);
+
+    MavenPerfCounters* perf = c ? c->perf : NULL;
+    if (__builtin_expect(!perf, 0))
+    {
+      perf = &MavenPerfCounters::of(state);
+      if (c)
+        c->perf = perf;
+    }
+
+    trace_core_t* trace = c ? c->trace : NULL;
+    if (c && c->blocks && !trace && MavenDecodeCache::can_step(state))
+      n = c->blocks->run(procs[i]->cp, max, perf);
+    else
+    {
+      if (trace)
+        trace->before(state, procs[i]->cp.mem.fetch_uint32(state.pc));
+      state.alu = 0;
+      state.inst_branch = false;
+      state.inst_jump = false;
+      if (c && c->dcache && MavenDecodeCache::can_step(state))
+        c->dcache->step(procs[i]->cp);
+      else
+        procs[i]->execute();
+      perf->retire(state);
+      if (trace)
+        trace->after(state);
+    }
+    if (ninsts)
+      *ninsts = n;
+
+    if (state.runstate != MavenCPState::RUNNING)
+    {
+      if (state.exception != MavenCPState::EXCEPTION_SYSCALL)
+        return false;
+      state.runstate = MavenCPState::RUNNING;
+      state.exception = 0;
+      state.pc = state.ebase;
+      state.npc = state.ebase + 4;
+    }
+    return true;
+  }
+
+  // Whether core i is the only core in tid_mask
+  bool runs_alone(int i)
+  {
+    int cores = nproc < 32 ? (1 << nproc) - 1 : ~0;
+    return (tid_mask & cores) == (1 << i);
+  }
+
+  // run_to_tohost's message for a core which faulted
+  void print_panic(int i)
+  {
+    MavenCPState& state = procs[i]->cp.state;
+    printf("PANIC!! exception occured! cause=%d pc=%08x npc=%08x\n",
+           state.exception, state.pc, state.npc);
+  }
+
   // simulator's dumpstats
   void dumpstats(FILE* logfile, double seconds = 0.0);
 
+  // per-core performance counters, for dumpstats
+  void dump_perf_counters(FILE* logfile)
+  {
+    for (int i=0; i<nproc; i++)
+      MavenPerfCounters::of(procs[i]->cp.state).dump(logfile, i);
+  }
+
+  // watchpoint access counts, for dumpstats
+  void dump_memory_heatmap(FILE* logfile)
+  {
+    if (mem.get_watch())
+      mem.get_watch()->write_heatmap(logfile);
+  }
+
 //private:
   MavenProcessor** procs;
   int nproc;
@@ -0,0 +1,214 @@
+//========================================================================
+// simulator_parallel.h : Run simulated cores on separate host threads
+//========================================================================
+// An opt-in replacement for simulator_t::run_to_tohost which gives each
+// simulated core its own host thread. Time advances in epochs of
+// `quantum` simulated cycles. Within an epoch every active core executes
+// up to quantum instructions without synchronising with the others. All
+// threads then meet at a barrier, where the runner folds the per-core
+// counts into simulator_t::cycle and maven::g_cop0_count and checks for
+// errors.
+//
+// Shared state is handled as follows:
+//
+//  - Memory is switched to concurrent mode for the duration of the run
+//    (see Memory::set_concurrent). The scalar AMO instructions and the
+//    vector amo commands take the memory's AMO lock, and sync.l becomes
+//    a host fence. Page flag updates are atomic host operations.
+//
+//  - tid_mask is sampled once per epoch. A core whose bit is clear sits
+//    the epoch out, and a core which clears its own bit (TID_STOP) stops
+//    at once. mtc0 updates the mask with atomic host operations.
+//
+//  - Each worker counts the instructions its core retires in its own
+//    worker_t. At every barrier the runner publishes the sum, plus
+//    maven::g_cop0_count's value at the start of the run, to
+//    g_cop0_count. Within an epoch a core reading the count register
+//    may therefore see a value up to one quantum stale. The decode
+//    cache and block engine bump g_cop0_count themselves, so isarun
+//    rejects them with --parallel. MavenProcessor::execute, which the
+//    workers call, lives in the processor sources outside this tree;
+//    if it bumps g_cop0_count too, that plain increment races between
+//    workers until those sources are rebuilt to count atomically. Its
+//    value is overwritten at the next barrier either way.
+//
+//  - tohost is polled by every thread after every instruction. The
+//    first thread to see it change ends the epoch early for everyone.
+//
+// The run is not deterministic at any quantum. Within an epoch the
+// cores run at the same time, so the order in which their accesses to
+// shared memory land is up to the host, while the serial loop always
+// steps core 0 first, then core 1, and so on. A quantum of 1 only
+// bounds how far apart the cores' instruction counts can drift. Larger
+// quanta trade timing fidelity between cores for host scaling.
+
+#ifndef __SIMULATOR_PARALLEL_H
+#define __SIMULATOR_PARALLEL_H
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "simulator.h"
+#include "maven-global.h"
+
+class parallel_runner_t
+{
+public:
+  parallel_runner_t(simulator_t& _sim, int _quantum)
+    : sim(_sim)
+    , quantum(_quantum)
+    , error_core(-1)
+  {
+    assert( quantum > 0 );
+  }
+
+  int run_to_tohost(int orig_tohost)
+  {
+    if (sim.procs == NULL)
+    {
+      printf("You must call simulator_t::set_num_cores before simulator_t::run_to_tohost()!");
+      exit(-1);
+    }
+
+    int nproc = sim.nproc;
+    tohost = (volatile int32_t*) &sim.mem.mem[sim.magicmemaddr];
+    if (*tohost != orig_tohost)
+      return *tohost;
+
+    sim.mem.set_concurrent(true);
+    quit = false;
+    stop = 0;
+    error_core = -1;
+    count_base = maven::g_cop0_count;
+    total_retired = 0;
+
+    pthread_barrier_init(&epoch_start, NULL, nproc+1);
+    pthread_barrier_init(&epoch_end, NULL, nproc+1);
+
+    // Create every core's counters here, as the lookup is not thread
+    // safe the first time
+    for (int i=0; i<nproc; i++)
+      MavenPerfCounters::of(sim.procs[i]->cp.state);
+
+    worker_t* workers = new worker_t [nproc];
+    for (int i=0; i<nproc; i++)
+    {
+      workers[i].runner = this;
+      workers[i].core = i;
+      pthread_create(&workers[i].thread, NULL, &worker_entry, &workers[i]);
+    }
+
+    while (true)
+    {
+      active_mask = sim.tid_mask;
+      pthread_barrier_wait(&epoch_start);
+      pthread_barrier_wait(&epoch_end);
+
+      long long longest = 0;
+      for (int i=0; i<nproc; i++)
+      {
+        total_retired += workers[i].retired;
+        if (workers[i].retired > longest)
+          longest = workers[i].retired;
+      }
+      sim.cycle += longest;
+      maven::g_cop0_count = count_base + total_retired;
+
+      if (error_core >= 0 || *tohost != orig_tohost)
+        break;
+    }
+
+    quit = true;
+    pthread_barrier_wait(&epoch_start);
+    for (int i=0; i<nproc; i++)
+      pthread_join(workers[i].thread, NULL);
+    delete [] workers;
+
+    pthread_barrier_destroy(&epoch_start);
+    pthread_barrier_destroy(&epoch_end);
+    sim.mem.set_concurrent(false);
+
+    return *tohost;
+  }
+
+  // The core which faulted and ended the last run_to_tohost early, or
+  // -1. A caller should report it with simulator_t::print_panic.
+  int faulted()
+  {
+    return error_core;
+  }
+
+private:
+  struct worker_t
+  {
+    parallel_runner_t* runner;
+    int core;
+    pthread_t thread;
+    long long retired;
+  };
+
+  static void* worker_entry(void* arg)
+  {
+    worker_t* w = (worker_t*) arg;
+    w->runner->worker(w);
+    return NULL;
+  }
+
+  void worker(worker_t* w)
+  {
+    int bit = 1 << w->core;
+    int orig_tohost = *tohost;
+
+    while (true)
+    {
+      pthread_barrier_wait(&epoch_start);
+      if (quit)
+        break;
+
+      w->retired = 0;
+      if (active_mask & bit)
+      {
+        for (int n=0; n<quantum && !stop; n++)
+        {
+          if (!(*(volatile int*) &sim.tid_mask & bit))
+            break;
+
+          bool ok = sim.step_core(w->core);
+          w->retired++;
+          if (!ok)
+          {
+            error_core = w->core;
+            stop = 1;
+            break;
+          }
+
+          if (*tohost != orig_tohost)
+          {
+            stop = 1;
+            break;
+          }
+        }
+      }
+
+      pthread_barrier_wait(&epoch_end);
+    }
+  }
+
+  simulator_t& sim;
+  int quantum;
+
+  volatile int32_t* tohost;
+  volatile bool quit;
+  volatile int stop;
+  volatile int error_core;
+  int active_mask;
+
+  long long count_base;
+  long long total_retired;
+
+  pthread_barrier_t epoch_start;
+  pthread_barrier_t epoch_end;
+};
+
+#endif // __SIMULATOR_PARALLEL_H
@@ -0,0 +1,164 @@
+//========================================================================
+// snapshot.h : In-process snapshots for stepping a simulation backwards
+//========================================================================
+// snapshot_ring_t keeps a bounded ring of recent snapshots of a
+// simulator_t so a run can be wound back to an earlier cycle and
+// replayed from there, rather than rerun from the start.
+//
+// A snapshot has two parts:
+//  - the register and counter state, in checkpoint_t's format
+//    (save_state), which is a few KB per core;
+//  - an undo log of the memory pages stored to after the snapshot.
+// Taking a snapshot arms Memory write tracking. The first store to a
+// page afterwards copies the page into the newest snapshot's undo log,
+// and later stores to it run at full speed. So a snapshot costs one
+// page copy per page the program writes in that interval, and nothing
+// for pages it only reads.
+//
+// run_back_to(N) finds the newest snapshot at or before cycle N. It
+// plays the undo logs back from the newest to that snapshot, reloads
+// the register state, and steps the serial loop forward to cycle N.
+// The ISA simulator is deterministic between syscalls, so the replay
+// reaches exactly the state the original run had at cycle N. Replay
+// stops short, returning false, if the target faults or raises tohost,
+// since the appserver's side of a syscall cannot be replayed. Take a
+// snapshot after servicing each syscall so every interval is syscall
+// free.
+//
+// Like checkpoints, snapshots are taken between cycles with every VP
+// run to completion; only the serial loop is supported.
+
+#ifndef __SNAPSHOT_H
+#define __SNAPSHOT_H
+
+#include <deque>
+#include <vector>
+
+#include "simulator.h"
+#include "checkpoint.h"
+
+class snapshot_ring_t
+{
+public:
+  snapshot_ring_t(simulator_t& _sim, long long _interval, int _capacity)
+    : sim(_sim)
+    , interval(_interval)
+    , capacity(_capacity)
+    , next_cycle(0)
+  {
+  }
+
+  ~snapshot_ring_t()
+  {
+    sim.mem.disarm_write_tracking();
+    while (!snaps.empty())
+      drop_oldest();
+  }
+
+  // Call once per cycle of the serial loop
+  void tick()
+  {
+    if (sim.cycle >= next_cycle)
+      take();
+  }
+
+  void take()
+  {
+    if ((int) snaps.size() == capacity)
+      drop_oldest();
+
+    snapshot_t* s = new snapshot_t;
+    s->cycle = sim.cycle;
+    checkpoint_t::save_state(sim, s->state);
+    snaps.push_back(s);
+
+    sim.mem.arm_write_tracking(&s->undo);
+    next_cycle = sim.cycle + interval;
+  }
+
+  // Cycle of the oldest snapshot still held, or -1 if there are none
+  long long earliest_cycle()
+  {
+    return snaps.empty() ? -1 : snaps.front()->cycle;
+  }
+
+  // Wind back to cycle target. Returns false if no snapshot is old
+  // enough, or if the replay hit a syscall or a fault; in those cases
+  // the simulator is left at the cycle where it stopped.
+  bool run_back_to(long long target)
+  {
+    if (snaps.empty() || snaps.front()->cycle > target)
+      return false;
+
+    while (snaps.back()->cycle > target)
+    {
+      undo(snaps.back());
+      delete snaps.back();
+      snaps.pop_back();
+    }
+
+    snapshot_t* s = snaps.back();
+    undo(s);
+    checkpoint_t::restore_state(sim, s->state);
+
+    sim.mem.arm_write_tracking(&s->undo);
+    next_cycle = sim.cycle + interval;
+
+    int orig_tohost = tohost();
+    while (sim.cycle < target)
+    {
+      if (sim.step_cycle() >= 0 || tohost() != orig_tohost)
+        return false;
+      tick();
+    }
+    return true;
+  }
+
+  int size()
+  {
+    return snaps.size();
+  }
+
+private:
+  struct snapshot_t
+  {
+    long long cycle;
+    std::vector<uint8_t> state;
+    std::vector<Memory::page_image_t> undo;
+  };
+
+  // Put back every page stored to since s was taken
+  void undo(snapshot_t* s)
+  {
+    for (size_t i=0; i<s->undo.size(); i++)
+    {
+      sim.mem.restore_page(s->undo[i]);
+      delete [] s->undo[i].data;
+    }
+    s->undo.clear();
+  }
+
+  // The oldest snapshot's log is only needed to go back past it
+  void drop_oldest()
+  {
+    snapshot_t* s = snaps.front();
+    for (size_t i=0; i<s->undo.size(); i++)
+      delete [] s->undo[i].data;
+    delete s;
+    snaps.pop_front();
+  }
+
+  int tohost()
+  {
+    return sim.mem.read_mem_int32(sim.magicmemaddr);
+  }
+
+  simulator_t& sim;
+  long long interval;
+  int capacity;
+  long long next_cycle;
+
+  std::deque<snapshot_t*> snaps;
+};
+
+#endif // __SNAPSHOT_H
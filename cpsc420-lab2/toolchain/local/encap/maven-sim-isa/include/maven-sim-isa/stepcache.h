@@ -0,0 +1,165 @@
+//========================================================================
+// stepcache.h : Per-core state simulator_t::step_core keeps between steps
+//========================================================================
+
+#ifndef __STEPCACHE_H
+#define __STEPCACHE_H
+
+#include <stdio.h>
+#include <vector>
+
+#include "decodecache.h"
+#include "maven-BlockEngine.h"
+#include "tracewriter.h"
+
+//------------------------------------------------------------------------
+// Step cache
+//------------------------------------------------------------------------
+// What simulator_t::step_core keeps for each core from one step to the
+// next. simulator_t has no room for it, since the prebuilt objects fix
+// its layout, so the run loop owns one and passes it to step_cycle.
+// Per-core state is created on a core's first step. With blocks on, a
+// core runs from its block engine (maven-BlockEngine.h); otherwise from
+// its decode cache (decodecache.h) if decoding or lanes are on. Each core also
+// keeps a pointer to its performance counters, so the step after the
+// first does not go through MavenPerfCounters::of. With a trace writer
+// (tracewriter.h), each core steps one instruction at a time, outside
+// its block engine, and records it in its trace. With a MemoryWatch
+// (memwatch.h), each step points it at the stepping core's pc.
+
+class MavenStepCache
+{
+public:
+  struct core_t
+  {
+    MavenDecodeCache* dcache; // NULL unless decoding is on
+    MavenBlockEngine* blocks; // NULL unless blocks are on
+    MavenPerfCounters* perf;  // NULL until the core's first step
+    trace_core_t* trace;      // NULL unless tracing
+  };
+
+  MavenStepCache()
+    : decode(false)
+    , use_blocks(false)
+    , fusion(false)
+    , lanes(false)
+    , tracer(NULL)
+    , watch(NULL)
+  {
+  }
+
+  ~MavenStepCache()
+  {
+    for (size_t i=0; i<cores.size(); i++)
+    {
+      delete cores[i].dcache;
+      delete cores[i].blocks;
+    }
+  }
+
+  // Give each core a decode cache. Call before the first step.
+  void set_decode(bool val)
+  {
+    decode = val;
+  }
+
+  // Give each core a block engine. Call before the first step.
+  void set_blocks(bool val)
+  {
+    use_blocks = val;
+  }
+
+  // Fuse idioms in hot blocks (mips32-Fusion.h). Only has an effect
+  // with blocks on. Call before the first step.
+  void set_fusion(bool val)
+  {
+    fusion = val;
+  }
+
+  // Run unmasked vector commands through the lane kernels of
+  // maven-VPLanes.h. Gives each core a decode cache if blocks are off.
+  // Call before the first step.
+  void set_lanes(bool val)
+  {
+    lanes = val;
+  }
+
+  // Record every core's instructions in w, which must have a stream
+  // for each core and outlive the cache. Call before the first step.
+  void set_trace(trace_writer_t* w)
+  {
+    tracer = w;
+  }
+
+  // Attribute accesses w sees to the core being stepped. Call before
+  // the first step.
+  void set_watch(MemoryWatch* w)
+  {
+    watch = w;
+  }
+
+  MemoryWatch* get_watch()
+  {
+    return watch;
+  }
+
+  // True if any core will step through a decode cache or block engine
+  bool enabled()
+  {
+    return decode || use_blocks || lanes;
+  }
+
+  core_t& core(int i)
+  {
+    if (__builtin_expect((size_t) i >= cores.size(), 0))
+      grow(i+1);
+    return cores[i];
+  }
+
+  void dump(FILE* fp)
+  {
+    for (size_t i=0; i<cores.size(); i++)
+    {
+      if (cores[i].dcache)
+        fprintf(fp, "core%d.decode.fills %llu\n", (int) i,
+                (unsigned long long) cores[i].dcache->get_fills());
+      if (cores[i].blocks)
+        fprintf(fp, "core%d.blocks.translated %llu\n", (int) i,
+                (unsigned long long) cores[i].blocks->get_blocks());
+      if (cores[i].blocks && fusion)
+        fprintf(fp, "core%d.blocks.fused_insts %llu\n", (int) i,
+                (unsigned long long) cores[i].blocks->get_fused_insts());
+    }
+  }
+
+private:
+  void grow(size_t n)
+  {
+    size_t old = cores.size();
+    cores.resize(n);
+    for (size_t i=old; i<n; i++)
+    {
+      cores[i].dcache = (decode || lanes) && !use_blocks ? new MavenDecodeCache : NULL;
+      cores[i].blocks = use_blocks ? new MavenBlockEngine : NULL;
+      cores[i].perf = NULL;
+      cores[i].trace = tracer ? &tracer->core(i) : NULL;
+      if (cores[i].dcache)
+        cores[i].dcache->set_lanes(lanes);
+      if (cores[i].blocks)
+      {
+        cores[i].blocks->set_fusion(fusion);
+        cores[i].blocks->set_lanes(lanes);
+      }
+    }
+  }
+
+  bool decode;
+  bool use_blocks;
+  bool fusion;
+  bool lanes;
+  trace_writer_t* tracer;
+  MemoryWatch* watch;
+  std::vector<core_t> cores;
+};
+
+#endif // __STEPCACHE_H
@@ -50,6 +50,9 @@
 
 #define MAVEN_SYSCFG_SYSCALL_YIELD                       4007
 
+// Services an array of syscall requests in one trap (see sysproxy.h)
+#define MAVEN_SYSCFG_SYSCALL_BATCH                       4008
+
 //------------------------------------------------------------------------
 // Coprocessor 0 Control Registers
 //------------------------------------------------------------------------
@@ -63,6 +66,12 @@
 #define MAVEN_SYSCFG_REGDEF_COP0_TID_STOP  19
 #define MAVEN_SYSCFG_REGDEF_COP0_STATS_EN  21
 
+// Performance counters (see maven-PerfCounters.h)
+#define MAVEN_SYSCFG_REGDEF_COP0_PERF_CTRL   22
+#define MAVEN_SYSCFG_REGDEF_COP0_PERF_SEL    23
+#define MAVEN_SYSCFG_REGDEF_COP0_PERF_VAL    24
+#define MAVEN_SYSCFG_REGDEF_COP0_PERF_VAL_HI 26
+
 //------------------------------------------------------------------------
 // Maven minimum and maximum vector length
 //------------------------------------------------------------------------
@@ -0,0 +1,259 @@
+//========================================================================
+// sysproxy.h : Zero-copy and batched file system calls
+//========================================================================
+// Target file I/O serviced here moves between host files and target
+// memory through the memif's read_fd/write_fd. sysproxy_t is a template
+// over the memif type, so with memif_mavenfs_t those are a read/write
+// straight into the simulator's memory rather than a copy through a
+// sysargs_t buffer, without adding virtuals to memif_t. Any other memif
+// gets the bouncing versions in memif_t. The same goes for the bulk
+// transfers and spans used for request records, stat buffers and paths.
+//
+// A target can also hand over several requests at once with the BATCH
+// system call: a0 is the address of an array of request records and a1
+// the number of records. Each record is six target words
+//
+//   id, arg0, arg1, arg2, result, error_flag
+//
+// (maven_syscall_req_t in the target's machine/syscall.h). The requests
+// run in order. result and error_flag are written back with the same
+// meaning as v0 and a3 of a single system call: on failure error_flag
+// is 1 and result is the errno. The BATCH call itself returns the number
+// of records serviced. So a program reading several files or chunks
+// pays for one tohost round trip instead of one per request.
+//
+// Only the file calls can be batched. Anything else, including a nested
+// BATCH, fails with ENOSYS so the appserver keeps sole control of exit
+// and the maven specific calls.
+//
+// maven-isa-run services syscalls through a sysproxy_t with --sysproxy
+// (see isarun.h). The prebuilt appserver does not use one.
+
+#ifndef __SYSPROXY_H
+#define __SYSPROXY_H
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <map>
+
+#include "memif.h"
+#include "sysargs.h"
+#include "syscfg.h"
+
+template <class memif_type = memif_t>
+class sysproxy_t
+{
+public:
+    enum
+    {
+        REQ_WORDS = 6,
+        REQ_SIZE  = 4*REQ_WORDS,
+        MAX_PATH  = 1024,
+    };
+
+    struct request_t
+    {
+        int32_t id;
+        int32_t arg[3];
+        int32_t result;
+        int32_t error_flag;
+    };
+
+    // fdmap maps target file descriptors to host ones and next_fd is the
+    // next target descriptor to hand out; both belong to the appserver.
+    sysproxy_t(memif_type& _mem, std::map<int,int>& _fdmap, int& _next_fd)
+        : mem(_mem), fdmap(_fdmap), next_fd(_next_fd)
+    {
+    }
+
+    // Service one request. Returns false, leaving req untouched, when
+    // id is not a call this proxy handles.
+    bool service(request_t& req)
+    {
+        errno = 0;
+        long ret;
+        switch (req.id)
+        {
+            case MAVEN_SYSCFG_SYSCALL_READ:  ret = sys_read(req.arg[0], req.arg[1], req.arg[2]); break;
+            case MAVEN_SYSCFG_SYSCALL_WRITE: ret = sys_write(req.arg[0], req.arg[1], req.arg[2]); break;
+            case MAVEN_SYSCFG_SYSCALL_OPEN:  ret = sys_open(req.arg[0], req.arg[1], req.arg[2]); break;
+            case MAVEN_SYSCFG_SYSCALL_CLOSE: ret = sys_close(req.arg[0]); break;
+            case MAVEN_SYSCFG_SYSCALL_LSEEK: ret = sys_lseek(req.arg[0], req.arg[1], req.arg[2]); break;
+            case MAVEN_SYSCFG_SYSCALL_FSTAT: ret = sys_fstat(req.arg[0], req.arg[1]); break;
+            default: return false;
+        }
+
+        if (ret < 0)
+        {
+            req.result = errno ? errno : EIO;
+            req.error_flag = 1;
+        }
+        else
+        {
+            req.result = ret;
+            req.error_flag = 0;
+        }
+        return true;
+    }
+
+    // Service count request records starting at target address addr.
+    // Returns the number serviced, or -1 with errno set if the array
+    // itself is unreadable.
+    int batch(uint32_t addr, uint32_t count)
+    {
+        for (uint32_t i = 0; i < count; i++, addr += REQ_SIZE)
+        {
+            uint32_t w[REQ_WORDS];
+            if ((addr & 0x3) || mem.read_bulk(addr, REQ_SIZE, (uint8_t*) w) != memif_t::OK)
+            {
+                errno = EFAULT;
+                return i > 0 ? (int) i : -1;
+            }
+
+            request_t req;
+            req.id = w[0];
+            req.arg[0] = w[1];
+            req.arg[1] = w[2];
+            req.arg[2] = w[3];
+            if (!service(req))
+            {
+                req.result = ENOSYS;
+                req.error_flag = 1;
+            }
+
+            w[4] = req.result;
+            w[5] = req.error_flag;
+            mem.write_bulk(addr + 16, 8, (const uint8_t*) &w[4]);
+        }
+        return count;
+    }
+
+private:
+    int host_fd(int fd)
+    {
+        std::map<int,int>::iterator it = fdmap.find(fd);
+        if (it == fdmap.end())
+        {
+            errno = EBADF;
+            return -1;
+        }
+        return it->second;
+    }
+
+    long sys_read(int fd, uint32_t buf, uint32_t len)
+    {
+        int hfd = host_fd(fd);
+        return hfd < 0 ? -1 : mem.read_fd(hfd, buf, len);
+    }
+
+    long sys_write(int fd, uint32_t buf, uint32_t len)
+    {
+        int hfd = host_fd(fd);
+        return hfd < 0 ? -1 : mem.write_fd(hfd, buf, len);
+    }
+
+    long sys_open(uint32_t path_addr, int flags, int mode)
+    {
+        char path[MAX_PATH];
+        if (!read_string(path_addr, path, MAX_PATH))
+            return -1;
+
+        int hfd = open(path, sysargs_t::convert_flag(flags), mode);
+        if (hfd < 0)
+            return -1;
+
+        int fd = next_fd++;
+        fdmap[fd] = hfd;
+        return fd;
+    }
+
+    long sys_close(int fd)
+    {
+        int hfd = host_fd(fd);
+        if (hfd < 0)
+            return -1;
+
+        // Leave the host's stdin/stdout/stderr open
+        fdmap.erase(fd);
+        return hfd > 2 ? close(hfd) : 0;
+    }
+
+    long sys_lseek(int fd, int offset, int whence)
+    {
+        int hfd = host_fd(fd);
+        return hfd < 0 ? -1 : lseek(hfd, offset, whence);
+    }
+
+    long sys_fstat(int fd, uint32_t buf)
+    {
+        int hfd = host_fd(fd);
+        struct stat st;
+        if (hfd < 0 || fstat(hfd, &st) < 0)
+            return -1;
+
+        struct solaris_stat sst;
+        memset(&sst, 0, sizeof(sst));
+        sst.st_dev     = st.st_dev;
+        sst.st_ino     = st.st_ino;
+        sst.st_mode    = st.st_mode;
+        sst.st_nlink   = st.st_nlink;
+        sst.st_uid     = st.st_uid;
+        sst.st_gid     = st.st_gid;
+        sst.st_rdev    = st.st_rdev;
+        sst.st_size    = st.st_size;
+        sst._st_atime  = st.st_atime;
+        sst._st_mtime  = st.st_mtime;
+        sst._st_ctime  = st.st_ctime;
+        sst.st_blksize = st.st_blksize;
+        sst.st_blocks  = st.st_blocks;
+
+        if (mem.write_bulk(buf, sizeof(sst), (const uint8_t*) &sst) != memif_t::OK)
+        {
+            errno = EFAULT;
+            return -1;
+        }
+        return 0;
+    }
+
+    // Copy a NUL-terminated target string a span at a time, or a byte
+    // at a time where the memif has no spans
+    bool read_string(uint32_t addr, char* buf, uint32_t size)
+    {
+        uint32_t i = 0;
+        while (i < size)
+        {
+            uint32_t run;
+            const uint8_t* p = mem.span(addr + i, size - i, false, &run);
+            if (!p)
+            {
+                if (mem.read_uint8(addr + i, (uint8_t*) &buf[i]) != memif_t::OK)
+                {
+                    errno = EFAULT;
+                    return false;
+                }
+                if (buf[i++] == 0)
+                    return true;
+                continue;
+            }
+
+            const uint8_t* nul = (const uint8_t*) memchr(p, 0, run);
+            uint32_t n = nul ? nul - p + 1 : run;
+            memcpy(buf + i, p, n);
+            i += n;
+            if (nul)
+                return true;
+        }
+
+        errno = ENAMETOOLONG;
+        return false;
+    }
+
+    memif_type& mem;
+    std::map<int,int>& fdmap;
+    int& next_fd;
+};
+
+#endif // __SYSPROXY_H
@@ -0,0 +1,436 @@
+//========================================================================
+// tracewriter.h : Binary instruction traces
+//========================================================================
+// A compact binary alternative to the text trace() output. Each traced
+// core owns a trace_core_t. Its producer side runs on the simulation
+// thread and does the following per instruction:
+//  - snapshots the integer and FP register files before the instruction;
+//  - afterwards, builds a fixed-size trace_record_t holding the pc, the
+//    instruction bits, the first register written, the memory address
+//    and data for loads and stores, and the branch outcome;
+//  - pushes the record into a single-producer single-consumer ring.
+//
+// One trace_writer_t thread drains every core's ring. It delta and
+// varint encodes the records and writes them to <prefix>.<core>.trace
+// through a large stdio buffer, so neither compression nor I/O runs on
+// the simulation thread. A full ring makes the producer wait rather
+// than drop records.
+//
+// Encoding, per record:
+//   flags byte
+//   pc     zigzag varint, delta from the previous pc + 4
+//   bits   4 bytes
+//   reg    1 byte index (0-31 GPR, 32-63 FPR) + varint value   if REG
+//   addr   zigzag varint, delta from the previous address       if MEM
+//   data   varint                                                if MEM
+//
+// trace_reader_t decodes a file back into records.
+//
+// maven-isa-run writes traces with --trace-bin (see isarun.h), through
+// MavenStepCache::set_trace and simulator_t::step_core.
+
+#ifndef __TRACEWRITER_H
+#define __TRACEWRITER_H
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "types.h"
+#include "host.h"
+
+//------------------------------------------------------------------------
+// Trace record
+//------------------------------------------------------------------------
+
+struct trace_record_t
+{
+  enum
+  {
+    REG    = 0x01, // reg/reg_val valid
+    LOAD   = 0x02, // addr/data valid, data is the loaded value
+    STORE  = 0x04, // addr/data valid, data is the stored value
+    BRANCH = 0x08, // control transfer instruction
+    TAKEN  = 0x10, // ... which was taken
+  };
+
+  uint32_t pc;
+  uint32_t bits;
+  uint32_t reg_val;
+  uint32_t addr;
+  uint32_t data;
+  uint8_t flags;
+  uint8_t reg;
+};
+
+//------------------------------------------------------------------------
+// Per-core producer
+//------------------------------------------------------------------------
+
+class trace_core_t
+{
+public:
+  enum
+  {
+    RING_ENTRIES = 1 << 16,
+    RING_MASK = RING_ENTRIES - 1,
+  };
+
+  trace_core_t()
+    : head(0)
+    , tail(0)
+  {
+    ring = new trace_record_t [RING_ENTRIES];
+  }
+
+  ~trace_core_t()
+  {
+    delete [] ring;
+  }
+
+  // Call with the state about to execute the instruction `bits`.
+  template <typename StateType>
+  void before(StateType& state, uint32_t bits)
+  {
+    memcpy(saved_R, state.R, sizeof(saved_R));
+    memcpy(saved_F, state.fpu.R, sizeof(saved_F));
+    cur.pc = state.pc;
+    cur.bits = bits;
+    cur.flags = 0;
+
+    // Loads and stores are opcodes 0x20-0x3f, stores with bit 3 set;
+    // lwc1/ldc1/swc1/sdc1 move FP registers. cache and pref are skipped.
+    uint32_t op = bits >> 26;
+    if (op >= 0x20 && op != 0x2f && op != 0x33)
+    {
+      int base = (bits >> 21) & 0x1f;
+      mem_rt = (bits >> 16) & 0x1f;
+      mem_fp = op >= 0x30 && (op & 0x3) == 0x1;
+      cur.addr = state.R[base] + (int16_t) bits;
+      if (op & 0x08)
+      {
+        cur.flags = trace_record_t::STORE;
+        cur.data = mem_fp ? state.fpu.R[mem_rt] : state.R[mem_rt];
+      }
+      else
+        cur.flags = trace_record_t::LOAD;
+    }
+  }
+
+  // Call once the instruction has executed.
+  template <typename StateType>
+  void after(StateType& state)
+  {
+    for (int i=1; i<32; i++)
+      if (state.R[i] != saved_R[i])
+      {
+        cur.flags |= trace_record_t::REG;
+        cur.reg = i;
+        cur.reg_val = state.R[i];
+        break;
+      }
+
+    if (!(cur.flags & trace_record_t::REG))
+      for (int i=0; i<32; i++)
+        if (state.fpu.R[i] != saved_F[i])
+        {
+          cur.flags |= trace_record_t::REG;
+          cur.reg = 32 + i;
+          cur.reg_val = state.fpu.R[i];
+          break;
+        }
+
+    if (cur.flags & trace_record_t::LOAD)
+      cur.data = mem_fp ? state.fpu.R[mem_rt] : state.R[mem_rt];
+
+    // branch is only set by a taken one; the microarch fields, cleared
+    // before each step, mark the rest
+    if (state.branch || state.inst_branch || state.inst_jump)
+    {
+      cur.flags |= trace_record_t::BRANCH;
+      if (state.branch && state.npc != cur.pc + 8)
+        cur.flags |= trace_record_t::TAKEN;
+    }
+
+    push(cur);
+  }
+
+  void push(const trace_record_t& rec)
+  {
+    uint32_t h = head;
+    while (h - *(volatile uint32_t*) &tail == RING_ENTRIES)
+      sched_yield();
+    ring[h & RING_MASK] = rec;
+    compiler_barrier();
+    *(volatile uint32_t*) &head = h + 1;
+  }
+
+  // Consumer side; returns false when the ring is empty
+  bool pop(trace_record_t& rec)
+  {
+    uint32_t t = tail;
+    if (t == *(volatile uint32_t*) &head)
+      return false;
+    rec = ring[t & RING_MASK];
+    compiler_barrier();
+    *(volatile uint32_t*) &tail = t + 1;
+    return true;
+  }
+
+//private:
+  trace_record_t* ring;
+  uint32_t head;
+  char pad[60]; // keep producer and consumer indices on separate lines
+  uint32_t tail;
+
+  trace_record_t cur;
+  int mem_rt;
+  bool mem_fp;
+  reg_t saved_R[32];
+  reg_t saved_F[32];
+};
+
+//------------------------------------------------------------------------
+// Encoder state shared by the writer and reader
+//------------------------------------------------------------------------
+
+struct trace_codec_t
+{
+  trace_codec_t() : last_pc(0xfffffffc), last_addr(0) {}
+
+  static uint32_t zigzag(int32_t v)   { return (v << 1) ^ (v >> 31); }
+  static int32_t unzigzag(uint32_t v) { return (v >> 1) ^ -(int32_t)(v & 1); }
+
+  uint32_t last_pc;
+  uint32_t last_addr;
+};
+
+//------------------------------------------------------------------------
+// Background writer
+//------------------------------------------------------------------------
+
+class trace_writer_t
+{
+public:
+  trace_writer_t(const char* prefix, int ncores)
+    : running(true)
+  {
+    for (int i=0; i<ncores; i++)
+    {
+      char name[1024];
+      snprintf(name, sizeof(name), "%s.%d.trace", prefix, i);
+
+      stream_t* s = new stream_t;
+      s->fp = fopen(name, "wb");
+      if (!s->fp)
+      {
+        printf("Couldn't open trace %s!\n", name);
+        exit(-1);
+      }
+      setvbuf(s->fp, NULL, _IOFBF, 1 << 20);
+      fwrite("MVTR", 1, 4, s->fp);
+      streams.push_back(s);
+    }
+
+    pthread_create(&thread, NULL, &drain_entry, this);
+  }
+
+  // Stops the drain thread once every ring is empty, then closes files
+  ~trace_writer_t()
+  {
+    *(volatile bool*) &running = false;
+    pthread_join(thread, NULL);
+
+    for (size_t i=0; i<streams.size(); i++)
+    {
+      fclose(streams[i]->fp);
+      delete streams[i];
+    }
+  }
+
+  trace_core_t& core(int i)
+  {
+    return streams[i]->ring;
+  }
+
+private:
+  struct stream_t
+  {
+    trace_core_t ring;
+    trace_codec_t codec;
+    FILE* fp;
+  };
+
+  static void* drain_entry(void* arg)
+  {
+    ((trace_writer_t*) arg)->drain();
+    return NULL;
+  }
+
+  void drain()
+  {
+    while (true)
+    {
+      bool stopping = !*(volatile bool*) &running;
+      int n = 0;
+
+      for (size_t i=0; i<streams.size(); i++)
+      {
+        trace_record_t rec;
+        while (streams[i]->ring.pop(rec))
+        {
+          encode(*streams[i], rec);
+          n++;
+        }
+      }
+
+      if (n == 0)
+      {
+        if (stopping)
+          break;
+        sched_yield();
+      }
+    }
+  }
+
+  static void put_varint(uint8_t*& p, uint32_t v)
+  {
+    while (v >= 0x80)
+    {
+      *p++ = v | 0x80;
+      v >>= 7;
+    }
+    *p++ = v;
+  }
+
+  void encode(stream_t& s, const trace_record_t& rec)
+  {
+    uint8_t buf[32];
+    uint8_t* p = buf;
+
+    *p++ = rec.flags;
+    put_varint(p, trace_codec_t::zigzag(rec.pc - (s.codec.last_pc + 4)));
+    s.codec.last_pc = rec.pc;
+    memcpy(p, &rec.bits, 4);
+    p += 4;
+
+    if (rec.flags & trace_record_t::REG)
+    {
+      *p++ = rec.reg;
+      put_varint(p, rec.reg_val);
+    }
+
+    if (rec.flags & (trace_record_t::LOAD | trace_record_t::STORE))
+    {
+      put_varint(p, trace_codec_t::zigzag(rec.addr - s.codec.last_addr));
+      s.codec.last_addr = rec.addr;
+      put_varint(p, rec.data);
+    }
+
+    fwrite(buf, 1, p - buf, s.fp);
+  }
+
+  std::vector<stream_t*> streams;
+  pthread_t thread;
+  bool running;
+};
+
+//------------------------------------------------------------------------
+// Reader
+//------------------------------------------------------------------------
+
+class trace_reader_t
+{
+public:
+  trace_reader_t(const char* fname)
+    : is_bad(false)
+  {
+    char magic[4];
+    fp = fopen(fname, "rb");
+    if (!fp || fread(magic, 1, 4, fp) != 4 || memcmp(magic, "MVTR", 4))
+    {
+      printf("Couldn't read trace %s!\n", fname);
+      exit(-1);
+    }
+  }
+
+  ~trace_reader_t()
+  {
+    fclose(fp);
+  }
+
+  // Returns false at the end of the trace. A file that ends partway
+  // through a record, or holds a malformed varint, also returns false
+  // and sets bad().
+  bool next(trace_record_t& rec)
+  {
+    int c = getc(fp);
+    if (c == EOF)
+      return false;
+
+    memset(&rec, 0, sizeof(rec));
+    rec.flags = c;
+
+    uint32_t v;
+    if (!get_varint(v))
+      return fail();
+    rec.pc = codec.last_pc + 4 + trace_codec_t::unzigzag(v);
+    codec.last_pc = rec.pc;
+    if (fread(&rec.bits, 1, 4, fp) != 4)
+      return fail();
+
+    if (rec.flags & trace_record_t::REG)
+    {
+      if ((c = getc(fp)) == EOF || !get_varint(rec.reg_val))
+        return fail();
+      rec.reg = c;
+    }
+
+    if (rec.flags & (trace_record_t::LOAD | trace_record_t::STORE))
+    {
+      if (!get_varint(v) || !get_varint(rec.data))
+        return fail();
+      rec.addr = codec.last_addr + trace_codec_t::unzigzag(v);
+      codec.last_addr = rec.addr;
+    }
+
+    return true;
+  }
+
+  bool bad()
+  {
+    return is_bad;
+  }
+
+private:
+  bool fail()
+  {
+    is_bad = true;
+    return false;
+  }
+
+  // A 32-bit value takes at most five bytes
+  bool get_varint(uint32_t& v)
+  {
+    v = 0;
+    for (int shift = 0; shift < 35; shift += 7)
+    {
+      int c = getc(fp);
+      if (c == EOF)
+        return false;
+      v |= (uint32_t) (c & 0x7f) << shift;
+      if (!(c & 0x80))
+        return true;
+    }
+    return false;
+  }
+
+  FILE* fp;
+  trace_codec_t codec;
+  bool is_bad;
+};
+
+#endif // __TRACEWRITER_H
@@ -0,0 +1,320 @@
+//========================================================================
+// maven-PVFBArray.t.cc : Check and time the fixed-size PVFB stacks
+//========================================================================
+// Drives MavenPVFBArrayStack and MavenPVFBArrayStack_plus with the same
+// random divergence pattern as std::list models of the MavenPVFBStack
+// and MavenPVFBStack_plus policies, checks that every pop returns the
+// same fragment, then times both sides on the same pattern.
+//
+// The pattern is what the vector unit does with a divergent VP array:
+// pop a fragment, branch it at some pc with a random taken mask over
+// its lanes (backwards some of the time, which stack+ treats as a
+// loop), and push the two halves back with insert_frags. Now and then
+// the fragment is pushed straight back with pushfront instead, possibly
+// next to another fragment at the same pc.
+//
+// Build and run from this directory with 'make check', or by hand with:
+//
+//   g++ -O2 -I../include/maven-sim-isa -o maven-PVFBArray-test
+//       maven-PVFBArray.t.cc
+//   ./maven-PVFBArray-test [rounds]
+//
+// Exits non-zero after printing the first mismatch.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <list>
+
+#include "maven-PVFBArray.h"
+
+//------------------------------------------------------------------------
+// Reference models
+//------------------------------------------------------------------------
+// The same policies over std::lists, front of the list as the top
+
+class ListStack : public MavenPVFB
+{
+public:
+  void insert_frags(uint32_t /* flag */, const MavenVPFrag& frag0, const MavenVPFrag& frag1)
+  {
+    insert(frag0);
+    insert(frag1);
+  }
+
+  void insert(const MavenVPFrag& frag)
+  {
+    if (frag.mask == 0)
+      return;
+
+    MavenVPFrag* waiting = member_pc(frag.pc);
+    if (waiting)
+    {
+      waiting->mask |= frag.mask;
+      waiting->size += frag.size;
+      return;
+    }
+
+    fragments.push_front(frag);
+  }
+
+  void pushfront(const MavenVPFrag& frag)
+  {
+    fragments.push_front(frag);
+  }
+
+  const MavenVPFrag pop()
+  {
+    MavenVPFrag frag = fragments.front();
+    fragments.pop_front();
+    return frag;
+  }
+
+  bool empty()
+  {
+    return fragments.empty();
+  }
+
+  MavenVPFrag* member_pc(uint32_t pc)
+  {
+    for (std::list<MavenVPFrag>::iterator it=fragments.begin(); it!=fragments.end(); ++it)
+      if (it->pc == pc)
+        return &*it;
+    return NULL;
+  }
+
+  void dump() {}
+
+  std::list<MavenVPFrag> fragments;
+};
+
+class ListStack_plus : public MavenPVFB
+{
+public:
+  ListStack_plus()
+    : curr_stack(0)
+  {
+  }
+
+  void insert_frags(uint32_t flag, const MavenVPFrag& frag0, const MavenVPFrag& frag1)
+  {
+    insert(frag0, frag0.pc <= flag);
+    insert(frag1, frag1.pc <= flag);
+  }
+
+  void insert(const MavenVPFrag& frag, bool insert_next)
+  {
+    if (frag.mask == 0)
+      return;
+
+    MavenVPFrag* waiting = member_pc(frag.pc);
+    if (waiting)
+    {
+      waiting->mask |= frag.mask;
+      waiting->size += frag.size;
+      return;
+    }
+
+    fragments[insert_next ? 1 - curr_stack : curr_stack].push_front(frag);
+  }
+
+  void pushfront(const MavenVPFrag& frag)
+  {
+    fragments[curr_stack].push_front(frag);
+  }
+
+  const MavenVPFrag pop()
+  {
+    if (fragments[curr_stack].empty())
+      curr_stack = 1 - curr_stack;
+
+    MavenVPFrag frag = fragments[curr_stack].front();
+    fragments[curr_stack].pop_front();
+    return frag;
+  }
+
+  bool empty()
+  {
+    return fragments[0].empty() && fragments[1].empty();
+  }
+
+  // Newest first, current stack first, as the array index answers
+  MavenVPFrag* member_pc(uint32_t pc)
+  {
+    for (int i=0; i<2; i++)
+    {
+      std::list<MavenVPFrag>& l = fragments[i == 0 ? curr_stack : 1 - curr_stack];
+      for (std::list<MavenVPFrag>::iterator it=l.begin(); it!=l.end(); ++it)
+        if (it->pc == pc)
+          return &*it;
+    }
+    return NULL;
+  }
+
+  void dump() {}
+
+  std::list<MavenVPFrag> fragments[2];
+  int curr_stack;
+};
+
+//------------------------------------------------------------------------
+// Divergence pattern
+//------------------------------------------------------------------------
+
+static uint32_t rand32(uint64_t& x)
+{
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  return x >> 32;
+}
+
+static int popcount(uint32_t x)
+{
+  int n = 0;
+  for (; x; x &= x-1)
+    n++;
+  return n;
+}
+
+static MavenVPFrag make_frag(uint32_t pc, uint32_t mask)
+{
+  MavenVPFrag frag;
+  frag.pc = pc;
+  frag.mask = mask;
+  frag.size = popcount(mask);
+  return frag;
+}
+
+// One round: start all 32 VPs at pc 0x1000 and run until the PVFB is
+// empty or a fixed number of steps pass, then drain it. Returns a
+// checksum of the fragments popped, or stops at the first mismatch when
+// a reference is given.
+static uint64_t run_round(MavenPVFB& pvfb, MavenPVFB* ref, uint64_t seed, bool& ok)
+{
+  const int STEPS = 64;
+  const uint32_t VPS = 32;
+  uint64_t x = seed;
+  uint64_t sum = 0;
+
+  MavenVPFrag start = make_frag(0x1000, 0xffffffff);
+  pvfb.pushfront(start);
+  if (ref)
+    ref->pushfront(start);
+
+  for (int step=0; !pvfb.empty(); step++)
+  {
+    MavenVPFrag frag = pvfb.pop();
+    sum = sum * 31 + frag.pc * 7 + frag.mask;
+
+    if (ref)
+    {
+      MavenVPFrag expect = ref->pop();
+      if (frag.pc != expect.pc || frag.mask != expect.mask || frag.size != expect.size)
+      {
+        printf("FAIL seed %llu step %d: popped pc=%08x mask=%08x size=%d, expected pc=%08x mask=%08x size=%d\n",
+               (unsigned long long) seed, step, frag.pc, frag.mask, frag.size,
+               expect.pc, expect.mask, expect.size);
+        ok = false;
+        return sum;
+      }
+    }
+
+    if (step >= STEPS)
+      continue;
+
+    uint32_t r = rand32(x);
+    uint32_t branch_pc = frag.pc + 4 * (1 + (r & 15));
+
+    if ((r >> 4) % 8 == 0)
+    {
+      // Push it back as is, maybe at a pc another fragment waits at
+      MavenVPFrag again = frag;
+      if ((r >> 7) & 1)
+        again.pc = 0x1000 + 4 * ((r >> 8) % VPS);
+      pvfb.pushfront(again);
+      if (ref)
+        ref->pushfront(again);
+      continue;
+    }
+
+    uint32_t taken = frag.mask & rand32(x);
+    uint32_t target = (r >> 8) & 1
+      ? frag.pc - 4 * ((r >> 9) & 7)        // backwards, a loop
+      : branch_pc + 4 * (1 + ((r >> 9) & 7));
+
+    MavenVPFrag frag0 = make_frag(target, taken);
+    MavenVPFrag frag1 = make_frag(branch_pc + 4, frag.mask & ~taken);
+    pvfb.insert_frags(branch_pc, frag0, frag1);
+    if (ref)
+      ref->insert_frags(branch_pc, frag0, frag1);
+  }
+
+  if (ref && !ref->empty())
+  {
+    printf("FAIL seed %llu: the reference has fragments left\n", (unsigned long long) seed);
+    ok = false;
+  }
+  return sum;
+}
+
+//------------------------------------------------------------------------
+// Main
+//------------------------------------------------------------------------
+
+static double now()
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+template <typename T>
+static double time_rounds(int rounds, uint64_t& sum)
+{
+  bool ok = true;
+  double start = now();
+  for (int i=0; i<rounds; i++)
+  {
+    T pvfb;
+    sum += run_round(pvfb, NULL, i + 1, ok);
+  }
+  return now() - start;
+}
+
+template <typename T, typename R>
+static bool check_and_time(const char* name, int rounds)
+{
+  bool ok = true;
+  for (int i=0; i<rounds && ok; i++)
+  {
+    T pvfb;
+    R ref;
+    run_round(pvfb, &ref, i + 1, ok);
+  }
+  if (!ok)
+    return false;
+
+  uint64_t array_sum = 0, list_sum = 0;
+  double array_time = time_rounds<T>(rounds, array_sum);
+  double list_time  = time_rounds<R>(rounds, list_sum);
+  if (array_sum != list_sum)
+  {
+    printf("FAIL %s: the timed runs popped different fragments\n", name);
+    return false;
+  }
+
+  printf("%-6s %d rounds: array %.3fs, list %.3fs (%.2fx)\n",
+         name, rounds, array_time, list_time, list_time / array_time);
+  return true;
+}
+
+int main(int argc, char* argv[])
+{
+  int rounds = argc > 1 ? atoi(argv[1]) : 200000;
+
+  bool ok = check_and_time<MavenPVFBArrayStack, ListStack>("stack", rounds);
+  ok = check_and_time<MavenPVFBArrayStack_plus, ListStack_plus>("stack+", rounds) && ok;
+  return !ok;
+}
@@ -0,0 +1,321 @@
+//========================================================================
+// memif.t.cc : Check and time the memif bulk and fd transfers
+//========================================================================
+// Moves a multi-megabyte buffer into and out of a Memory three ways and
+// checks that all three leave the same bytes behind:
+//
+//  - a byte at a time through the virtual write_uint8/read_uint8 calls,
+//    which is what the prebuilt memif_mavenfs_t::read and write do for
+//    every transfer the appserver and sysargs make;
+//  - through write_bulk/read_bulk on a memif that hides them with
+//    Memory::write_block/read_block, as memif_mavenfs_t does, called
+//    through a template parameter the way sysproxy.h calls them;
+//  - through write_bulk/read_bulk on the base memif_t type, which is
+//    what a virtual read or write on isarun_memif_t ends up calling.
+//
+// It then moves the same buffer between a temporary file and the
+// Memory with read_fd/write_fd, once with memif_t's versions, which
+// bounce through a host buffer, and once with the in-place versions,
+// and times all of it.
+//
+// memif_mavenfs_t itself needs a simulator_t, whose constructor is in
+// the prebuilt simulator object along with everything it pulls in, so
+// the test uses a memif over a bare Memory with the same transfers.
+//
+// Build and run from this directory with 'make check', or by hand with:
+//
+//   g++ -O2 -I../include/maven-sim-isa -o memif-test memif.t.cc
+//   ./memif-test [megabytes]
+//
+// Exits non-zero after printing the first mismatch.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <vector>
+
+#include "memif.h"
+#include "memory.h"
+
+//------------------------------------------------------------------------
+// Memifs
+//------------------------------------------------------------------------
+
+// Byte-at-a-time transfers, like the prebuilt memif_mavenfs_t
+class word_memif_t : public memif_t
+{
+public:
+  word_memif_t(Memory& _mem)
+    : mem(_mem)
+  {
+  }
+
+  error read(uint32_t addr, uint32_t len, uint8_t* bytes)
+  {
+    for (uint32_t i=0; i<len; i++)
+    {
+      error e = read_uint8(addr+i, &bytes[i]);
+      if (e != OK)
+        return e;
+    }
+    return OK;
+  }
+
+  error write(uint32_t addr, uint32_t len, const uint8_t* bytes)
+  {
+    for (uint32_t i=0; i<len; i++)
+    {
+      error e = write_uint8(addr+i, bytes[i]);
+      if (e != OK)
+        return e;
+    }
+    return OK;
+  }
+
+  error read_uint8(uint32_t addr, uint8_t* word)   { return read_word(addr, word); }
+  error read_int8(uint32_t addr, int8_t* word)     { return read_word(addr, word); }
+  error read_uint16(uint32_t addr, uint16_t* word) { return read_word(addr, word); }
+  error read_int16(uint32_t addr, int16_t* word)   { return read_word(addr, word); }
+  error read_uint32(uint32_t addr, uint32_t* word) { return read_word(addr, word); }
+  error read_int32(uint32_t addr, int32_t* word)   { return read_word(addr, word); }
+  error read_uint64(uint32_t addr, uint64_t* word) { return read_word(addr, word); }
+  error read_int64(uint32_t addr, int64_t* word)   { return read_word(addr, word); }
+
+  error write_uint8(uint32_t addr, uint8_t word)   { return write_word(addr, word); }
+  error write_int8(uint32_t addr, int8_t word)     { return write_word(addr, word); }
+  error write_uint16(uint32_t addr, uint16_t word) { return write_word(addr, word); }
+  error write_int16(uint32_t addr, int16_t word)   { return write_word(addr, word); }
+  error write_uint32(uint32_t addr, uint32_t word) { return write_word(addr, word); }
+  error write_int32(uint32_t addr, int32_t word)   { return write_word(addr, word); }
+  error write_uint64(uint32_t addr, uint64_t word) { return write_word(addr, word); }
+  error write_int64(uint32_t addr, int64_t word)   { return write_word(addr, word); }
+
+protected:
+  Memory& mem;
+
+private:
+  template <typename T>
+  error read_word(uint32_t addr, T* word)
+  {
+    if (addr & (sizeof(T)-1))
+      return Misaligned;
+    if (!Memory::in_range(addr, sizeof(T)))
+      return Invalid;
+    mem.read_block(addr, sizeof(T), (uint8_t*) word);
+    return OK;
+  }
+
+  template <typename T>
+  error write_word(uint32_t addr, T word)
+  {
+    if (addr & (sizeof(T)-1))
+      return Misaligned;
+    if (!Memory::in_range(addr, sizeof(T)))
+      return Invalid;
+    mem.write_block(addr, sizeof(T), (const uint8_t*) &word);
+    return OK;
+  }
+};
+
+// The bulk and fd transfers memif_mavenfs_t hides memif_t's with, and
+// read and write routed to them like isarun_memif_t's
+class block_memif_t : public word_memif_t
+{
+public:
+  block_memif_t(Memory& _mem)
+    : word_memif_t(_mem)
+  {
+  }
+
+  error read(uint32_t addr, uint32_t len, uint8_t* bytes)
+  {
+    return read_bulk(addr, len, bytes);
+  }
+
+  error write(uint32_t addr, uint32_t len, const uint8_t* bytes)
+  {
+    return write_bulk(addr, len, bytes);
+  }
+
+  error read_bulk(uint32_t addr, uint32_t len, uint8_t* bytes)
+  {
+    if (!Memory::in_range(addr, len))
+      return Invalid;
+    mem.read_block(addr, len, bytes);
+    return OK;
+  }
+
+  error write_bulk(uint32_t addr, uint32_t len, const uint8_t* bytes)
+  {
+    if (!Memory::in_range(addr, len))
+      return Invalid;
+    mem.write_block(addr, len, bytes);
+    return OK;
+  }
+
+  ssize_t read_fd(int fd, uint32_t addr, uint32_t len, off_t offset = -1)
+  {
+    return mem.fd_read(fd, addr, len, offset);
+  }
+
+  ssize_t write_fd(int fd, uint32_t addr, uint32_t len, off_t offset = -1)
+  {
+    return mem.fd_write(fd, addr, len, offset);
+  }
+};
+
+//------------------------------------------------------------------------
+// Transfers
+//------------------------------------------------------------------------
+
+static const uint32_t BASE = 0x00100000;
+
+template <class memif_type>
+static bool copy_in(memif_type& m, const std::vector<uint8_t>& buf)
+{
+  return m.write_bulk(BASE, buf.size(), &buf[0]) == memif_t::OK;
+}
+
+template <class memif_type>
+static bool copy_out(memif_type& m, std::vector<uint8_t>& buf)
+{
+  return m.read_bulk(BASE, buf.size(), &buf[0]) == memif_t::OK;
+}
+
+template <class memif_type>
+static bool file_in(memif_type& m, int fd, uint32_t len)
+{
+  return m.read_fd(fd, BASE, len, 0) == (ssize_t) len;
+}
+
+template <class memif_type>
+static bool file_out(memif_type& m, int fd, uint32_t len)
+{
+  return m.write_fd(fd, BASE, len, 0) == (ssize_t) len;
+}
+
+//------------------------------------------------------------------------
+// Main
+//------------------------------------------------------------------------
+
+static double now()
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+static int failures = 0;
+
+static void check(bool ok, const char* what)
+{
+  if (!ok && failures++ == 0)
+    printf("FAILED: %s\n", what);
+}
+
+static void report(const char* what, uint32_t len, double t)
+{
+  printf("%-28s %8.3f ms %9.1f MB/s\n", what, t*1e3, len / t / (1 << 20));
+}
+
+int main(int argc, char** argv)
+{
+  int mb = argc > 1 ? atoi(argv[1]) : 16;
+  if (mb < 1 || (uint32_t) mb > (MAVEN_SYSCFG_MEMORY_SIZE - BASE) >> 20)
+  {
+    printf("megabytes must be between 1 and %d\n",
+           (int) ((MAVEN_SYSCFG_MEMORY_SIZE - BASE) >> 20));
+    return 1;
+  }
+  uint32_t len = (uint32_t) mb << 20;
+
+  std::vector<uint8_t> pattern(len), out(len);
+  uint32_t x = 0x12345678;
+  for (uint32_t i=0; i<len; i++)
+  {
+    x = x*1103515245 + 12345;
+    pattern[i] = x >> 24;
+  }
+
+  Memory mem;
+  word_memif_t words(mem);
+  block_memif_t blocks(mem);
+  memif_t& base = blocks;
+  double t;
+
+  // Bulk transfers
+
+  memset(mem.mem + BASE, 0, len);
+  t = now();
+  check(words.write(BASE, len, &pattern[0]) == memif_t::OK, "word write");
+  report("write, byte at a time", len, now() - t);
+  check(memcmp(mem.mem + BASE, &pattern[0], len) == 0, "word write contents");
+
+  t = now();
+  check(words.read(BASE, len, &out[0]) == memif_t::OK, "word read");
+  report("read, byte at a time", len, now() - t);
+  check(out == pattern, "word read contents");
+
+  memset(mem.mem + BASE, 0, len);
+  t = now();
+  check(copy_in(blocks, pattern), "write_bulk");
+  report("write_bulk", len, now() - t);
+  check(memcmp(mem.mem + BASE, &pattern[0], len) == 0, "write_bulk contents");
+
+  out.assign(len, 0);
+  t = now();
+  check(copy_out(blocks, out), "read_bulk");
+  report("read_bulk", len, now() - t);
+  check(out == pattern, "read_bulk contents");
+
+  memset(mem.mem + BASE, 0, len);
+  t = now();
+  check(base.write(BASE, len, &pattern[0]) == memif_t::OK, "virtual write");
+  report("write through memif_t", len, now() - t);
+  check(memcmp(mem.mem + BASE, &pattern[0], len) == 0, "virtual write contents");
+
+  // File transfers
+
+  char fname[] = "/tmp/memif-test-XXXXXX";
+  int fd = mkstemp(fname);
+  if (fd < 0)
+  {
+    printf("Couldn't create %s!\n", fname);
+    return 1;
+  }
+  unlink(fname);
+
+  check(write(fd, &pattern[0], len) == (ssize_t) len, "temporary file");
+
+  memset(mem.mem + BASE, 0, len);
+  t = now();
+  check(file_in(base, fd, len), "memif_t read_fd");
+  report("read_fd, bounce buffer", len, now() - t);
+  check(memcmp(mem.mem + BASE, &pattern[0], len) == 0, "memif_t read_fd contents");
+
+  memset(mem.mem + BASE, 0, len);
+  t = now();
+  check(file_in(blocks, fd, len), "read_fd");
+  report("read_fd, in place", len, now() - t);
+  check(memcmp(mem.mem + BASE, &pattern[0], len) == 0, "read_fd contents");
+
+  check(ftruncate(fd, 0) == 0, "truncate");
+  t = now();
+  check(file_out(base, fd, len), "memif_t write_fd");
+  report("write_fd, bounce buffer", len, now() - t);
+
+  check(ftruncate(fd, 0) == 0, "truncate");
+  t = now();
+  check(file_out(blocks, fd, len), "write_fd");
+  report("write_fd, in place", len, now() - t);
+
+  out.assign(len, 0);
+  check(pread(fd, &out[0], len, 0) == (ssize_t) len && out == pattern, "write_fd contents");
+  close(fd);
+
+  printf("%d MB, %d failures\n", mb, failures);
+  return failures != 0;
+}
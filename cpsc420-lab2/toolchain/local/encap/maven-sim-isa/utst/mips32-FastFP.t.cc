@@ -0,0 +1,284 @@
+//========================================================================
+// mips32-FastFP.t.cc : Differential test of the fast FP path
+//========================================================================
+// Runs every fastfp_* entry point (mips32-FastFP.h) and the softfloat
+// routine it stands in for on the same operands, in every rounding
+// mode, and checks that the two agree on the result bits and on the
+// exception flags raised. Operands are the special values (zeros,
+// infinities, NaNs, subnormals, the normal and integer limits and their
+// neighbours) paired with each other, plus random bit patterns and
+// random values with exponents near each other so that add and sub see
+// cancellation.
+//
+// Build and run from this directory with 'make check', or by hand with:
+//
+//   g++ -O2 -I../include/maven-sim-isa -L../lib/maven-sim-isa -no-pie
+//       -o mips32-FastFP-test mips32-FastFP.t.cc -lsft
+//   ./mips32-FastFP-test [random-cases]
+//
+// libsft.a is not position independent, hence -no-pie.
+//
+// Exits non-zero after printing the first few mismatches of each
+// operation.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "mips32-FastFP.h"
+
+//------------------------------------------------------------------------
+// Operands
+//------------------------------------------------------------------------
+
+static uint32_t rand32()
+{
+  static uint64_t x = 0x9e3779b97f4a7c15ull;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  return x >> 32;
+}
+
+static uint64_t rand64()
+{
+  return ((uint64_t) rand32() << 32) | rand32();
+}
+
+static std::vector<float32> special32()
+{
+  static const float32 base[] =
+  {
+    0x00000000, // 0
+    0x00000001, // smallest subnormal
+    0x007fffff, // largest subnormal
+    0x00800000, // FLT_MIN
+    0x00800001,
+    0x3f800000, // 1
+    0x3f800001,
+    0x3fffffff,
+    0x40000000, // 2
+    0x4b000000, // 2^23
+    0x4effffff, // just below 2^31
+    0x4f000000, // 2^31
+    0x7f7fffff, // FLT_MAX
+    0x7f800000, // inf
+    0x7f800001, // signalling NaN
+    0x7fc00000, // quiet NaN
+    0x7fffffff, // softfloat's default NaN
+  };
+
+  std::vector<float32> v;
+  for (size_t i=0; i<sizeof(base)/sizeof(base[0]); i++)
+  {
+    v.push_back(base[i]);
+    v.push_back(base[i] | 0x80000000);
+  }
+  return v;
+}
+
+static std::vector<float64> special64()
+{
+  static const float64 base[] =
+  {
+    0x0000000000000000ull, // 0
+    0x0000000000000001ull, // smallest subnormal
+    0x000fffffffffffffull, // largest subnormal
+    0x0010000000000000ull, // DBL_MIN
+    0x0010000000000001ull,
+    0x0370000000000000ull, // near the tiny-residual cutoff
+    0x3ff0000000000000ull, // 1
+    0x3ff0000000000001ull,
+    0x3fffffffffffffffull,
+    0x4000000000000000ull, // 2
+    0x41dfffffffc00000ull, // 2^31 - 1
+    0x41dfffffffe00000ull, // 2^31 - 0.5
+    0x41e0000000000000ull, // 2^31
+    0x7fefffffffffffffull, // DBL_MAX
+    0x7ff0000000000000ull, // inf
+    0x7ff0000000000001ull, // signalling NaN
+    0x7ff8000000000000ull, // quiet NaN
+    0x7fffffffffffffffull, // softfloat's default NaN
+  };
+
+  std::vector<float64> v;
+  for (size_t i=0; i<sizeof(base)/sizeof(base[0]); i++)
+  {
+    v.push_back(base[i]);
+    v.push_back(base[i] | 0x8000000000000000ull);
+  }
+  return v;
+}
+
+// Random bits half the time, otherwise a random value whose exponent
+// is within a few of `near`, so sums cancel and products stay finite
+static float32 random32(float32 near)
+{
+  if (rand32() & 1)
+    return rand32();
+  uint32_t exp = ((near >> 23) & 0xff) + (rand32() % 9) - 4;
+  return (rand32() & 0x807fffff) | ((exp & 0xff) << 23);
+}
+
+static float64 random64(float64 near)
+{
+  if (rand32() & 1)
+    return rand64();
+  uint64_t exp = ((near >> 52) & 0x7ff) + (rand32() % 9) - 4;
+  return (rand64() & 0x800fffffffffffffull) | ((exp & 0x7ff) << 52);
+}
+
+//------------------------------------------------------------------------
+// Checking
+//------------------------------------------------------------------------
+
+static const int rounding_modes[] =
+{
+  float_round_nearest_even,
+  float_round_to_zero,
+  float_round_up,
+  float_round_down,
+};
+
+static int nchecks = 0;
+static int nfailures = 0;
+
+template <typename R>
+static void report(const char* op, int mode, uint64_t a, uint64_t b,
+                   R fast, int fast_flags, R soft, int soft_flags, int& shown)
+{
+  nfailures++;
+  if (shown++ >= 5)
+    return;
+  printf("FAIL %s mode %d a=%016llx b=%016llx: fast %016llx flags %02x, softfloat %016llx flags %02x\n",
+         op, mode, (unsigned long long) a, (unsigned long long) b,
+         (unsigned long long) fast, fast_flags, (unsigned long long) soft, soft_flags);
+}
+
+// Either result may be any NaN, since MIPS only looks at the flags then
+template <typename R>
+static bool same_result(R x, R y, R exp_mask, R frac_mask)
+{
+  bool x_nan = (x & exp_mask) == exp_mask && (x & frac_mask);
+  bool y_nan = (y & exp_mask) == exp_mask && (y & frac_mask);
+  return x_nan ? y_nan : x == y;
+}
+
+#define CHECK_OP(name, R, EXP, FRAC, fast_call, soft_call, a, b, shown)    \
+  do {                                                                    \
+    for (int m=0; m<4; m++)                                               \
+    {                                                                     \
+      float_rounding_mode = rounding_modes[m];                            \
+      float_exception_flags = 0;                                          \
+      R fast = fast_call;                                                 \
+      int fast_flags = float_exception_flags;                             \
+      float_exception_flags = 0;                                          \
+      R soft = soft_call;                                                 \
+      int soft_flags = float_exception_flags;                             \
+      nchecks++;                                                          \
+      if (!same_result<R>(fast, soft, EXP, FRAC) || fast_flags != soft_flags) \
+        report(name, m, a, b, fast, fast_flags, soft, soft_flags, shown); \
+    }                                                                     \
+  } while (0)
+
+#define CHECK32(name, fast_call, soft_call, a, b, shown) \
+  CHECK_OP(name, float32, 0x7f800000u, 0x007fffffu, fast_call, soft_call, a, b, shown)
+
+#define CHECK64(name, fast_call, soft_call, a, b, shown) \
+  CHECK_OP(name, float64, 0x7ff0000000000000ull, 0x000fffffffffffffull, fast_call, soft_call, a, b, shown)
+
+// Integer results compare exactly
+#define CHECKINT(name, fast_call, soft_call, a, shown) \
+  CHECK_OP(name, uint32_t, 0u, 0u, (uint32_t) fast_call, (uint32_t) soft_call, a, 0, shown)
+
+struct shown_t
+{
+  shown_t() { memset(this, 0, sizeof(*this)); }
+  int add32, sub32, mul32, div32, sqrt32;
+  int add64, sub64, mul64, div64, sqrt64;
+  int cvt_s_d, cvt_d_s, cvt_s_w, cvt_d_w, cvt_w_s, cvt_w_d;
+};
+
+static shown_t shown;
+
+static void check32(float32 a, float32 b)
+{
+  CHECK32("add.s", fastfp_float32_add(a, b), float32_add(a, b), a, b, shown.add32);
+  CHECK32("sub.s", fastfp_float32_sub(a, b), float32_sub(a, b), a, b, shown.sub32);
+  CHECK32("mul.s", fastfp_float32_mul(a, b), float32_mul(a, b), a, b, shown.mul32);
+  CHECK32("div.s", fastfp_float32_div(a, b), float32_div(a, b), a, b, shown.div32);
+}
+
+static void check64(float64 a, float64 b)
+{
+  CHECK64("add.d", fastfp_float64_add(a, b), float64_add(a, b), a, b, shown.add64);
+  CHECK64("sub.d", fastfp_float64_sub(a, b), float64_sub(a, b), a, b, shown.sub64);
+  CHECK64("mul.d", fastfp_float64_mul(a, b), float64_mul(a, b), a, b, shown.mul64);
+  CHECK64("div.d", fastfp_float64_div(a, b), float64_div(a, b), a, b, shown.div64);
+}
+
+static void check_unary32(float32 a)
+{
+  CHECK32("sqrt.s", fastfp_float32_sqrt(a), float32_sqrt(a), a, 0, shown.sqrt32);
+  CHECK64("cvt.d.s", fastfp_float32_to_float64(a), float32_to_float64(a), a, 0, shown.cvt_d_s);
+  CHECKINT("cvt.w.s", fastfp_float32_to_int32(a), float32_to_int32(a), a, shown.cvt_w_s);
+  CHECK32("cvt.s.w", fastfp_int32_to_float32(a), int32_to_float32(a), a, 0, shown.cvt_s_w);
+  CHECK64("cvt.d.w", fastfp_int32_to_float64(a), int32_to_float64(a), a, 0, shown.cvt_d_w);
+}
+
+static void check_unary64(float64 a)
+{
+  CHECK64("sqrt.d", fastfp_float64_sqrt(a), float64_sqrt(a), a, 0, shown.sqrt64);
+  CHECK32("cvt.s.d", fastfp_float64_to_float32(a), float64_to_float32(a), a, 0, shown.cvt_s_d);
+  CHECKINT("cvt.w.d", fastfp_float64_to_int32(a), float64_to_int32(a), a, shown.cvt_w_d);
+}
+
+//------------------------------------------------------------------------
+// Main
+//------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+  int nrandom = argc > 1 ? atoi(argv[1]) : 1000000;
+
+  if (!mips32_fastfp_enable(true))
+  {
+    printf("The host FPU is not in its default mode, so fast FP stays off\n");
+    return 1;
+  }
+
+  std::vector<float32> s32 = special32();
+  std::vector<float64> s64 = special64();
+
+  for (size_t i=0; i<s32.size(); i++)
+  {
+    check_unary32(s32[i]);
+    for (size_t j=0; j<s32.size(); j++)
+      check32(s32[i], s32[j]);
+  }
+
+  for (size_t i=0; i<s64.size(); i++)
+  {
+    check_unary64(s64[i]);
+    for (size_t j=0; j<s64.size(); j++)
+      check64(s64[i], s64[j]);
+  }
+
+  for (int n=0; n<nrandom; n++)
+  {
+    float32 a32 = rand32();
+    float32 b32 = random32(a32);
+    check32(a32, b32);
+    check_unary32(a32);
+
+    float64 a64 = rand64();
+    float64 b64 = random64(a64);
+    check64(a64, b64);
+    check_unary64(a64);
+  }
+
+  printf("%d checks, %d failures\n", nchecks, nfailures);
+  return nfailures != 0;
+}
@@ -49,6 +49,36 @@ static inline void maven_set_cop0_stats_enable( bool value )
             :: "r"(value), "i"(MAVEN_SYSCFG_REGDEF_COP0_STATS_EN) );
 }
 
+//------------------------------------------------------------------------
+// maven_set_cop0_perf_ctrl( unsigned int value )
+//------------------------------------------------------------------------
+// Writes the performance counter control register: bit 0 enables
+// counting and setting bit 1 clears every counter
+
+static inline void maven_set_cop0_perf_ctrl( unsigned int value )
+{
+  __asm__ __volatile__ ( "mtc0 %0, $%1"
+            :: "r"(value), "i"(MAVEN_SYSCFG_REGDEF_COP0_PERF_CTRL) );
+}
+
+//------------------------------------------------------------------------
+// maven_get_cop0_perf_counter( unsigned int idx )
+//------------------------------------------------------------------------
+// Return the 64b value of performance counter idx
+
+static inline unsigned long long maven_get_cop0_perf_counter( unsigned int idx )
+{
+  unsigned int lo, hi;
+  __asm__ __volatile__ ( "mtc0 %2, $%3\n\t"
+            "mfc0 %0, $%4\n\t"
+            "mfc0 %1, $%5"
+            : "=&r"(lo), "=&r"(hi)
+            : "r"(idx), "i"(MAVEN_SYSCFG_REGDEF_COP0_PERF_SEL),
+              "i"(MAVEN_SYSCFG_REGDEF_COP0_PERF_VAL),
+              "i"(MAVEN_SYSCFG_REGDEF_COP0_PERF_VAL_HI) );
+  return ((unsigned long long) hi << 32) | lo;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -100,3 +100,39 @@
   res_   = res_ ## _;                                                   \
   eflag_ = eflag_ ## _;                                                 \
 
+//------------------------------------------------------------------------
+// maven_syscall_req_t
+//------------------------------------------------------------------------
+// One entry of a batched system call. Fill in id and the arguments for
+// each request, then make a single BATCH system call with the array
+// address and the request count:
+//
+//  maven_syscall_req_t reqs[2] = {
+//    { MAVEN_SYSCFG_SYSCALL_READ, fd0, (int) buf0, len0 },
+//    { MAVEN_SYSCFG_SYSCALL_READ, fd1, (int) buf1, len1 },
+//  };
+//  int addr = (int) reqs, count = 2;
+//  int done, error_flag;
+//  MAVEN_SYSCALL_ARG2( BATCH, done, error_flag, addr, count );
+//
+// The host services the requests in order and writes result and
+// error_flag back into each one, with the same meaning as the v0 and a3
+// values of a single system call. Only read, write, open, close, lseek
+// and fstat may be batched; anything else fails with ENOSYS.
+
+#ifndef MAVEN_SYSCALL_REQ_T
+#define MAVEN_SYSCALL_REQ_T
+
+typedef struct
+{
+  int id;
+  int arg0;
+  int arg1;
+  int arg2;
+  int result;
+  int error_flag;
+}
+maven_syscall_req_t;
+
+#endif
+
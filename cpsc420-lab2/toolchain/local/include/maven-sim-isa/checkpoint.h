@@ -0,0 +1 @@
+../../encap/maven-sim-isa/include/maven-sim-isa/checkpoint.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../encap/maven-sim-isa/include/maven-sim-isa/decodecache.h
\ No newline at end of file
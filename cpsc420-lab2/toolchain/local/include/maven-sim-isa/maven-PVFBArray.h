@@ -0,0 +1 @@
+../../encap/maven-sim-isa/include/maven-sim-isa/maven-PVFBArray.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../encap/maven-sim-isa/include/maven-sim-isa/maven-VPLanes.h
\ No newline at end of file
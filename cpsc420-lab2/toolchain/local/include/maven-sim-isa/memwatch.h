@@ -0,0 +1 @@
+../../encap/maven-sim-isa/include/maven-sim-isa/memwatch.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../encap/maven-sim-isa/include/maven-sim-isa/mips32-Fusion.h
\ No newline at end of file
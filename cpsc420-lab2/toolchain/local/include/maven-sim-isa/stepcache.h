@@ -0,0 +1 @@
+../../encap/maven-sim-isa/include/maven-sim-isa/stepcache.h
\ No newline at end of file
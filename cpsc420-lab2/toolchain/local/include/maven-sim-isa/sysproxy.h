@@ -0,0 +1 @@
+../../encap/maven-sim-isa/include/maven-sim-isa/sysproxy.h
\ No newline at end of file
@@ -0,0 +1,238 @@
+//========================================================================
+// Pipelined Radix-4 Booth Multiplier
+//========================================================================
+// Signed 32x32 -> 64 bit multiplier, split across three register stages
+// so a new product can start every cycle:
+//
+//  - Stage 0 : radix-4 Booth encode the multiplier into 16 partial
+//              products plus a row of negation bits, then reduce the 17
+//              rows to 8 with two levels of carry-save adders
+//  - Stage 1 : reduce the 8 rows to a sum and a carry row with four
+//              more levels of carry-save adders (Wallace tree)
+//  - Stage 2 : add the sum and carry rows
+//
+// A negative partial product is formed by inverting the shifted
+// multiplicand; the +1 which completes the two's complement is added in
+// through the negation row instead of with a carry chain per row.
+
+`ifndef IMULDIV_INT_MUL_BOOTH_V
+`define IMULDIV_INT_MUL_BOOTH_V
+
+//------------------------------------------------------------------------
+// Carry-save adder: reduce three rows to a sum and a carry row
+//------------------------------------------------------------------------
+
+module imuldiv_IntMulBoothCsa
+(
+  input  [63:0] in0,
+  input  [63:0] in1,
+  input  [63:0] in2,
+  output [63:0] sum,
+  output [63:0] carry
+);
+
+  assign sum   = in0 ^ in1 ^ in2;
+  assign carry = ( ( in0 & in1 ) | ( in0 & in2 ) | ( in1 & in2 ) ) << 1;
+
+endmodule
+
+//------------------------------------------------------------------------
+// Booth multiplier
+//------------------------------------------------------------------------
+
+module imuldiv_IntMulBooth
+(
+  input         clk,
+  input         en1,     // Advance stage 1 registers
+  input         en,      // Advance stage 2 and 3 registers
+  input  [31:0] a,       // Multiplicand
+  input  [31:0] b,       // Multiplier
+  output [63:0] product  // a * b, three cycles later
+);
+
+  //----------------------------------------------------------------------
+  // Stage 0: Booth encoding and partial products
+  //----------------------------------------------------------------------
+
+  wire [63:0] a_ext  = { {32{a[31]}}, a };
+  wire [32:0] b_ext  = { b, 1'b0 };
+
+  wire [63:0] pp [16:0];
+  wire [31:0] neg_row;
+
+  genvar i;
+  generate
+  for( i = 0; i < 16; i = i + 1)
+  begin: booth
+
+    // Each group of three multiplier bits selects 0, +-a or +-2a
+
+    wire [2:0] grp = b_ext[2*i+2:2*i];
+
+    wire one = ( grp[1] ^ grp[0] );
+    wire two = ( grp == 3'b011 ) || ( grp == 3'b100 );
+    wire neg = grp[2] && ( grp != 3'b111 );
+
+    wire [63:0] mag
+      = one ? a_ext
+      : two ? a_ext << 1
+      :       64'b0;
+
+    assign pp[i] = ( neg ? ~mag : mag ) << (2*i);
+
+    assign neg_row[2*i]   = neg;
+    assign neg_row[2*i+1] = 1'b0;
+
+  end
+  endgenerate
+
+  assign pp[16] = { 32'b0, neg_row };
+
+  // Reduce 17 rows to 12
+
+  wire [63:0] l1 [11:0];
+
+  generate
+  for( i = 0; i < 5; i = i + 1)
+  begin: csa_l1
+    imuldiv_IntMulBoothCsa csa
+    (
+      .in0   (pp[3*i]),
+      .in1   (pp[3*i+1]),
+      .in2   (pp[3*i+2]),
+      .sum   (l1[2*i]),
+      .carry (l1[2*i+1])
+    );
+  end
+  endgenerate
+
+  assign l1[10] = pp[15];
+  assign l1[11] = pp[16];
+
+  // Reduce 12 rows to 8
+
+  wire [63:0] l2 [7:0];
+
+  generate
+  for( i = 0; i < 4; i = i + 1)
+  begin: csa_l2
+    imuldiv_IntMulBoothCsa csa
+    (
+      .in0   (l1[3*i]),
+      .in1   (l1[3*i+1]),
+      .in2   (l1[3*i+2]),
+      .sum   (l2[2*i]),
+      .carry (l2[2*i+1])
+    );
+  end
+  endgenerate
+
+  //----------------------------------------------------------------------
+  // Stage 1: Wallace tree
+  //----------------------------------------------------------------------
+
+  reg [63:0] rows1_reg [7:0];
+
+  generate
+  for( i = 0; i < 8; i = i + 1)
+  begin: rows1
+    always @ ( posedge clk ) begin
+      if ( en1 )
+        rows1_reg[i] <= l2[i];
+    end
+  end
+  endgenerate
+
+  // Reduce 8 rows to 6
+
+  wire [63:0] l3 [5:0];
+
+  generate
+  for( i = 0; i < 2; i = i + 1)
+  begin: csa_l3
+    imuldiv_IntMulBoothCsa csa
+    (
+      .in0   (rows1_reg[3*i]),
+      .in1   (rows1_reg[3*i+1]),
+      .in2   (rows1_reg[3*i+2]),
+      .sum   (l3[2*i]),
+      .carry (l3[2*i+1])
+    );
+  end
+  endgenerate
+
+  assign l3[4] = rows1_reg[6];
+  assign l3[5] = rows1_reg[7];
+
+  // Reduce 6 rows to 4
+
+  wire [63:0] l4 [3:0];
+
+  generate
+  for( i = 0; i < 2; i = i + 1)
+  begin: csa_l4
+    imuldiv_IntMulBoothCsa csa
+    (
+      .in0   (l3[3*i]),
+      .in1   (l3[3*i+1]),
+      .in2   (l3[3*i+2]),
+      .sum   (l4[2*i]),
+      .carry (l4[2*i+1])
+    );
+  end
+  endgenerate
+
+  // Reduce 4 rows to 3, then to 2
+
+  wire [63:0] l5_sum;
+  wire [63:0] l5_carry;
+
+  imuldiv_IntMulBoothCsa csa_l5
+  (
+    .in0   (l4[0]),
+    .in1   (l4[1]),
+    .in2   (l4[2]),
+    .sum   (l5_sum),
+    .carry (l5_carry)
+  );
+
+  wire [63:0] l6_sum;
+  wire [63:0] l6_carry;
+
+  imuldiv_IntMulBoothCsa csa_l6
+  (
+    .in0   (l5_sum),
+    .in1   (l5_carry),
+    .in2   (l4[3]),
+    .sum   (l6_sum),
+    .carry (l6_carry)
+  );
+
+  //----------------------------------------------------------------------
+  // Stage 2: Final addition
+  //----------------------------------------------------------------------
+
+  reg [63:0] sum2_reg;
+  reg [63:0] carry2_reg;
+
+  always @ ( posedge clk ) begin
+    if ( en ) begin
+      sum2_reg   <= l6_sum;
+      carry2_reg <= l6_carry;
+    end
+  end
+
+  reg [63:0] product3_reg;
+
+  always @ ( posedge clk ) begin
+    if ( en ) begin
+      product3_reg <= sum2_reg + carry2_reg;
+    end
+  end
+
+  assign product = product3_reg;
+
+endmodule
+
+`endif
+
@@ -1,11 +1,17 @@
 //========================================================================
-// Functional Pipelined Mul/Div Unit
+// Pipelined Mul/Div Unit
 //========================================================================
+// Multiplies go through a radix-4 Booth / Wallace tree multiplier which
+// is pipelined across the three stages after the input registers.
+// Divides and remainders go through a separate divider alongside it
+// with the same latency, so a divide never holds up the multiplier and
+// a multiply can start every cycle.
 
 `ifndef PARC_PIPE_MULDIV_ITERATIVE_V
 `define PARC_PIPE_MULDIV_ITERATIVE_V
 
 `include "imuldiv-MulDivReqMsg.v"
+`include "imuldiv-IntMulBooth.v"
 
 module parc_CoreDpathPipeMulDiv
 (
@@ -54,10 +60,26 @@ module parc_CoreDpathPipeMulDiv
 
 
   //----------------------------------------------------------------------
-  // Functional Computation
+  // Multiplier
   //----------------------------------------------------------------------
 
-  // Sign of mul and div
+  wire [63:0] product3;
+
+  imuldiv_IntMulBooth mul
+  (
+    .clk     (clk),
+    .en1     (!stall && !stall_mult1),
+    .en      (!stall),
+    .a       (a_reg),
+    .b       (b_reg),
+    .product (product3)
+  );
+
+  //----------------------------------------------------------------------
+  // Divider
+  //----------------------------------------------------------------------
+
+  // Sign of div
 
   wire sign = ( a_reg[31] ^ b_reg[31] );
 
@@ -75,16 +97,9 @@ module parc_CoreDpathPipeMulDiv
 
   // Signed computation
 
-  wire [63:0] product_raw   = a_unsign * b_unsign;
   wire [31:0] quotient_raw  = a_unsign / b_unsign;
   wire [31:0] remainder_raw = a_unsign % b_unsign;
 
-  // Signed Product
-
-  wire [63:0] product
-    = ( sign ) ? ( ~product_raw + 1'b1 )
-               : product_raw;
-
   // Signed Quotient
 
   wire [31:0] quotient
@@ -99,21 +114,23 @@ module parc_CoreDpathPipeMulDiv
 
   // Result mux
 
-  wire [63:0] result0
-    = ( fn_reg == `IMULDIV_MULDIVREQ_MSG_FUNC_MUL  ) ? product
-    : ( fn_reg == `IMULDIV_MULDIVREQ_MSG_FUNC_DIV  ) ? { remainder, quotient }
+  wire [63:0] div_result0
+    = ( fn_reg == `IMULDIV_MULDIVREQ_MSG_FUNC_DIV  ) ? { remainder, quotient }
     : ( fn_reg == `IMULDIV_MULDIVREQ_MSG_FUNC_DIVU ) ? { remainderu, quotientu }
     : ( fn_reg == `IMULDIV_MULDIVREQ_MSG_FUNC_REM  ) ? { remainder, quotient }
     : ( fn_reg == `IMULDIV_MULDIVREQ_MSG_FUNC_REMU ) ? { remainderu, quotientu }
     :                                                  32'bx;
 
   //----------------------------------------------------------------------
-  // Dummy Pipeline Stages
+  // Divider Pipeline Stages
   //----------------------------------------------------------------------
 
-  reg [63:0] result1_reg;
-  reg [63:0] result2_reg;
-  reg [63:0] result3_reg;
+  reg [63:0] div_result1_reg;
+  reg [63:0] div_result2_reg;
+  reg [63:0] div_result3_reg;
+  reg  [2:0] fn1_reg;
+  reg  [2:0] fn2_reg;
+  reg  [2:0] fn3_reg;
   reg        val1_reg;
   reg        val2_reg;
   reg        val3_reg;
@@ -122,20 +139,25 @@ module parc_CoreDpathPipeMulDiv
     if ( !reset ) begin
       if ( !stall ) begin
         if (!stall_mult1) begin
-          result1_reg <= result0;
+          div_result1_reg <= div_result0;
+          fn1_reg         <= fn_reg;
         end
-        result2_reg <= result1_reg;
-        result3_reg <= result2_reg;
-        val1_reg    <= val0_reg;
-        val2_reg    <= val1_reg;
-        val3_reg    <= val2_reg;
+        div_result2_reg <= div_result1_reg;
+        div_result3_reg <= div_result2_reg;
+        fn2_reg         <= fn1_reg;
+        fn3_reg         <= fn2_reg;
+        val1_reg        <= val0_reg;
+        val2_reg        <= val1_reg;
+        val3_reg        <= val2_reg;
       end
     end
   end
 
   // Set response data
 
-  assign muldivresp_msg_result = result3_reg;
+  assign muldivresp_msg_result
+    = ( fn3_reg == `IMULDIV_MULDIVREQ_MSG_FUNC_MUL ) ? product3
+    :                                                 div_result3_reg;
 
   // Set response valid
 
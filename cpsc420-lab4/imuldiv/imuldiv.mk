@@ -8,6 +8,7 @@ imuldiv_srcs = \
   imuldiv-DivReqMsg.v \
   imuldiv-MulDivReqMsg.v \
   imuldiv-IntMulIterative.v \
+  imuldiv-IntMulBooth.v \
   imuldiv-IntDivIterative.v \
   imuldiv-IntMulDivIterative.v \
   imuldiv-IntMulDivIterativeCombined.v \
@@ -51,7 +51,7 @@ module parc_Core
   wire [31:0] dmemreq_msg_data;
   wire [31:0] dmemresp_msg_data;
 
-  wire  [1:0] pc_mux_sel_Phl;
+  wire  [2:0] pc_mux_sel_Phl;
   wire  [1:0] op0_byp_mux_sel_Dhl;
   wire  [1:0] op0_mux_sel_Dhl;
   wire  [1:0] op1_byp_mux_sel_Dhl;
@@ -71,6 +71,12 @@ module parc_Core
   wire        wb_mux_sel_Mhl;
   wire        rf_wen_Whl;
   wire  [4:0] rf_waddr_Whl;
+  wire        bp_update_val_Xhl;
+  wire        bp_update_taken_Xhl;
+  wire        bp_update_jump_Xhl;
+  wire        ras_push_Fhl;
+  wire        ras_pop_Fhl;
+  wire        ras_repair_Xhl;
   wire        stall_Fhl;
   wire        stall_Dhl;
   wire        stall_Xhl;
@@ -80,6 +86,8 @@ module parc_Core
   wire        branch_cond_eq_Xhl;
   wire        branch_cond_zero_Xhl;
   wire        branch_cond_neg_Xhl;
+  wire        pred_taken_Fhl;
+  wire        ras_targ_match_Dhl;
   wire [31:0] proc2cop_data_Whl;
 
   //----------------------------------------------------------------------
@@ -170,6 +178,12 @@ module parc_Core
     .wb_mux_sel_Mhl         (wb_mux_sel_Mhl),
     .rf_wen_out_Whl         (rf_wen_Whl),
     .rf_waddr_Whl           (rf_waddr_Whl),
+    .bp_update_val_Xhl      (bp_update_val_Xhl),
+    .bp_update_taken_Xhl    (bp_update_taken_Xhl),
+    .bp_update_jump_Xhl     (bp_update_jump_Xhl),
+    .ras_push_Fhl           (ras_push_Fhl),
+    .ras_pop_Fhl            (ras_pop_Fhl),
+    .ras_repair_Xhl         (ras_repair_Xhl),
     .stall_Fhl              (stall_Fhl),
     .stall_Dhl              (stall_Dhl),
     .stall_Xhl              (stall_Xhl),
@@ -181,6 +195,8 @@ module parc_Core
     .branch_cond_eq_Xhl     (branch_cond_eq_Xhl),
     .branch_cond_zero_Xhl   (branch_cond_zero_Xhl),
     .branch_cond_neg_Xhl    (branch_cond_neg_Xhl),
+    .pred_taken_Fhl         (pred_taken_Fhl),
+    .ras_targ_match_Dhl     (ras_targ_match_Dhl),
     .proc2cop_data_Whl      (proc2cop_data_Whl),
 
     // CP0 Status
@@ -229,6 +245,12 @@ module parc_Core
     .wb_mux_sel_Mhl          (wb_mux_sel_Mhl),
     .rf_wen_Whl              (rf_wen_Whl),
     .rf_waddr_Whl            (rf_waddr_Whl),
+    .bp_update_val_Xhl       (bp_update_val_Xhl),
+    .bp_update_taken_Xhl     (bp_update_taken_Xhl),
+    .bp_update_jump_Xhl      (bp_update_jump_Xhl),
+    .ras_push_Fhl            (ras_push_Fhl),
+    .ras_pop_Fhl             (ras_pop_Fhl),
+    .ras_repair_Xhl          (ras_repair_Xhl),
     .stall_Fhl               (stall_Fhl),
     .stall_Dhl               (stall_Dhl),
     .stall_Xhl               (stall_Xhl),
@@ -240,6 +262,8 @@ module parc_Core
     .branch_cond_eq_Xhl      (branch_cond_eq_Xhl),
     .branch_cond_zero_Xhl    (branch_cond_zero_Xhl),
     .branch_cond_neg_Xhl     (branch_cond_neg_Xhl),
+    .pred_taken_Fhl          (pred_taken_Fhl),
+    .ras_targ_match_Dhl      (ras_targ_match_Dhl),
     .proc2cop_data_Whl       (proc2cop_data_Whl)
   );
 
@@ -28,7 +28,7 @@ module parc_CoreCtrl
 
   // Controls Signals (ctrl->dpath)
 
-  output  [1:0] pc_mux_sel_Phl,
+  output  [2:0] pc_mux_sel_Phl,
   output  [1:0] op0_byp_mux_sel_Dhl,
   output  [1:0] op0_mux_sel_Dhl,
   output  [1:0] op1_byp_mux_sel_Dhl,
@@ -48,6 +48,12 @@ module parc_CoreCtrl
   output        wb_mux_sel_Mhl,
   output        rf_wen_out_Whl,
   output  [4:0] rf_waddr_Whl,
+  output        bp_update_val_Xhl,
+  output        bp_update_taken_Xhl,
+  output        bp_update_jump_Xhl,
+  output        ras_push_Fhl,
+  output        ras_pop_Fhl,
+  output        ras_repair_Xhl,
   output        stall_Fhl,
   output        stall_Dhl,
   output        stall_Xhl,
@@ -59,6 +65,8 @@ module parc_CoreCtrl
   input         branch_cond_eq_Xhl,
   input         branch_cond_zero_Xhl,
   input         branch_cond_neg_Xhl,
+  input         pred_taken_Fhl,
+  input         ras_targ_match_Dhl,
   input  [31:0] proc2cop_data_Whl,
 
   // CP0 Status
@@ -70,11 +78,19 @@ module parc_CoreCtrl
   // PC Stage: Instruction Memory Request
   //----------------------------------------------------------------------
 
-  // PC Mux Select
+  // PC Mux Select. A mispredicted branch in X redirects to its target
+  // or its fall-through, a jump in D the predictor missed to the jump
+  // target, and otherwise fetch follows the RAS for a return in F and
+  // the predictor for anything else.
+
+  wire pred_taken_Phl = ( inst_val_Fhl && pred_taken_Fhl );
+  wire ras_pred_Phl   = ( inst_val_Fhl && ras_ret_Fhl );
 
   assign pc_mux_sel_Phl
-    = brj_taken_Xhl    ? pm_b
+    = br_mispred_Xhl   ? ( any_br_taken_Xhl ? pm_b : pm_n )
     : brj_taken_Dhl    ? pc_mux_sel_Dhl
+    : ras_pred_Phl     ? pm_s
+    : pred_taken_Phl   ? pm_t
     :                    pm_p;
 
   // Only send a valid imem request if not stalled
@@ -124,12 +140,12 @@ module parc_CoreCtrl
 
   wire inst_val_Fhl = ( !bubble_Fhl && !squash_Fhl );
 
-  // Squash instruction in F stage if branch taken for a valid
-  // instruction or if there was an exception in X stage
+  // Squash instruction in F stage if a valid jump in D was not
+  // predicted or a valid branch in X was mispredicted
 
   wire squash_Fhl
     = ( inst_val_Dhl && brj_taken_Dhl )
-   || ( inst_val_Xhl && brj_taken_Xhl );
+   || ( inst_val_Xhl && br_mispred_Xhl );
 
   // Stall in F if D is stalled
 
@@ -169,11 +185,37 @@ module parc_CoreCtrl
     : ( imemresp_queue_val_Fhl )  ? imemresp_queue_reg_Fhl
     :                               32'bx;
 
+  //----------------------------------------------------------------------
+  // Return address stack
+  //----------------------------------------------------------------------
+
+  // Calls push and returns (jr $31) pop as they leave F
+
+  wire [31:0] ir_Fhl = imemresp_queue_mux_out_Fhl;
+
+  reg ras_call_Fhl;
+  reg ras_ret_Fhl;
+
+  always @ (*) begin
+    ras_call_Fhl = 1'b0;
+    ras_ret_Fhl  = 1'b0;
+    casez ( ir_Fhl )
+      `PARC_INST_MSG_JAL  : ras_call_Fhl = 1'b1;
+      `PARC_INST_MSG_JALR : ras_call_Fhl = 1'b1;
+      `PARC_INST_MSG_JR   : ras_ret_Fhl  = ( ir_Fhl[25:21] == 5'd31 );
+    endcase
+  end
+
+  assign ras_push_Fhl = ( inst_val_Fhl && !stall_Fhl && ras_call_Fhl );
+  assign ras_pop_Fhl  = ( inst_val_Fhl && !stall_Fhl && ras_ret_Fhl );
+
   //----------------------------------------------------------------------
   // D <- F
   //----------------------------------------------------------------------
 
   reg [31:0] ir_Dhl;
+  reg        pred_taken_Dhl;
+  reg        ras_ret_Dhl;
   reg        bubble_Dhl;
 
   always @ ( posedge clk ) begin
@@ -181,8 +223,10 @@ module parc_CoreCtrl
       bubble_Dhl <= 1'b1;
     end
     else if( !stall_Dhl ) begin
-      ir_Dhl     <= imemresp_queue_mux_out_Fhl;
-      bubble_Dhl <= bubble_next_Fhl;
+      ir_Dhl         <= imemresp_queue_mux_out_Fhl;
+      pred_taken_Dhl <= pred_taken_Fhl;
+      ras_ret_Dhl    <= ras_ret_Fhl;
+      bubble_Dhl     <= bubble_next_Fhl;
     end
   end
 
@@ -219,6 +263,9 @@ module parc_CoreCtrl
   localparam pm_b   = 2'd1;  // Use branch address
   localparam pm_j   = 2'd2;  // Use jump address
   localparam pm_r   = 2'd3;  // Use jump register
+  localparam pm_t   = 3'd4;  // Use predicted target
+  localparam pm_n   = 3'd5;  // Use fall-through of branch in X
+  localparam pm_s   = 3'd6;  // Use return address stack
 
   // Operand 0 Bypass Mux Select
 
@@ -427,13 +474,21 @@ module parc_CoreCtrl
 
   // Jump and Branch Controls
 
-  wire       brj_taken_Dhl = ( inst_val_Dhl && cs[`PARC_INST_MSG_J_EN] );
   wire [2:0] br_sel_Dhl    = cs[`PARC_INST_MSG_BR_SEL];
 
   // PC Mux Select
 
   wire [1:0] pc_mux_sel_Dhl = cs[`PARC_INST_MSG_PC_SEL];
 
+  // A direct jump the predictor already followed in F, or a return
+  // the RAS predicted correctly, needs no redirect; any other jump
+  // redirects from D
+
+  wire       jump_Dhl      = ( cs[`PARC_INST_MSG_J_EN] && ( pc_mux_sel_Dhl == pm_j ) );
+  wire       ras_hit_Dhl   = ( ras_ret_Dhl && ras_targ_match_Dhl );
+  wire       brj_taken_Dhl = ( inst_val_Dhl && cs[`PARC_INST_MSG_J_EN]
+                               && !( jump_Dhl && pred_taken_Dhl ) && !ras_hit_Dhl );
+
   // Operand Bypassing Logic
 
   wire [4:0] rs_addr_Dhl  = inst_rs_Dhl;
@@ -550,9 +605,9 @@ module parc_CoreCtrl
   // Squash and Stall Logic
   //----------------------------------------------------------------------
 
-  // Squash instruction in D if a valid branch in X is taken
+  // Squash instruction in D if a valid branch in X was mispredicted
 
-  wire squash_Dhl = ( inst_val_Xhl && brj_taken_Xhl );
+  wire squash_Dhl = ( inst_val_Xhl && br_mispred_Xhl );
 
   // Stall in D if muldiv unit is not ready and there is a valid request
 
@@ -595,6 +650,8 @@ module parc_CoreCtrl
 
   reg [31:0] ir_Xhl;
   reg  [2:0] br_sel_Xhl;
+  reg        jump_Xhl;
+  reg        pred_taken_Xhl;
   reg  [3:0] alu_fn_Xhl;
   reg        muldivreq_val_Xhl;
   reg  [2:0] muldivreq_msg_fn_Xhl;
@@ -622,6 +679,8 @@ module parc_CoreCtrl
     else if( !stall_Xhl ) begin
       ir_Xhl               <= ir_Dhl;
       br_sel_Xhl           <= br_sel_Dhl;
+      jump_Xhl             <= jump_Dhl;
+      pred_taken_Xhl       <= pred_taken_Dhl;
       alu_fn_Xhl           <= alu_fn_Dhl;
       muldivreq_val_Xhl    <= muldivreq_val_Dhl;
       muldivreq_msg_fn_Xhl <= muldivreq_msg_fn_Dhl;
@@ -688,7 +747,21 @@ module parc_CoreCtrl
    ||   bltz_taken_Xhl
    ||   bgez_taken_Xhl );
 
-  wire brj_taken_Xhl = ( inst_val_Xhl && any_br_taken_Xhl );
+  // A branch is mispredicted if it did not go the way F predicted
+
+  wire br_mispred_Xhl = ( inst_val_Xhl && ( br_sel_Xhl != br_none )
+                          && ( any_br_taken_Xhl != pred_taken_Xhl ) );
+
+  // Train the predictor once per branch or direct jump, as it leaves X
+
+  assign bp_update_val_Xhl
+    = ( inst_val_Xhl && !stall_Xhl && ( ( br_sel_Xhl != br_none ) || jump_Xhl ) );
+  assign bp_update_taken_Xhl = ( any_br_taken_Xhl || jump_Xhl );
+  assign bp_update_jump_Xhl  = jump_Xhl;
+
+  // Undo the RAS pushes and pops of the instructions being squashed
+
+  assign ras_repair_Xhl = br_mispred_Xhl;
 
   // Dummy Squash Signal
 
@@ -936,6 +1009,10 @@ module parc_CoreCtrl
 
   reg [31:0] num_inst    = 32'b0;
   reg [31:0] num_cycles  = 32'b0;
+  reg [31:0] num_br      = 32'b0;
+  reg [31:0] num_br_miss = 32'b0;
+  reg [31:0] num_ras_hit  = 32'b0;
+  reg [31:0] num_ras_miss = 32'b0;
   reg        stats_en    = 1'b0; // Used for enabling stats on asm tests
 
   always @( posedge clk ) begin
@@ -952,6 +1029,24 @@ module parc_CoreCtrl
           num_inst = num_inst + 1;
         end
 
+        // Count branches and direct jumps as they resolve, and those
+        // the predictor got wrong
+
+        if ( bp_update_val_Xhl ) begin
+          num_br = num_br + 1;
+          if ( bp_update_taken_Xhl != pred_taken_Xhl )
+            num_br_miss = num_br_miss + 1;
+        end
+
+        // Count returns as they leave D, and whether the RAS was right
+
+        if ( inst_val_Dhl && !stall_Dhl && ras_ret_Dhl ) begin
+          if ( ras_targ_match_Dhl )
+            num_ras_hit = num_ras_hit + 1;
+          else
+            num_ras_miss = num_ras_miss + 1;
+        end
+
       end
 
     end
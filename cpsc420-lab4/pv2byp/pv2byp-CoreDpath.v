@@ -9,6 +9,8 @@
 `include "pv2byp-InstMsg.v"
 `include "pv2byp-CoreDpathAlu.v"
 `include "pv2byp-CoreDpathRegfile.v"
+`include "pv2byp-CoreDpathBranchPred.v"
+`include "pv2byp-CoreDpathReturnStack.v"
 
 module parc_CoreDpath
 (
@@ -27,7 +29,7 @@ module parc_CoreDpath
 
   // Controls Signals (ctrl->dpath)
 
-  input   [1:0] pc_mux_sel_Phl,
+  input   [2:0] pc_mux_sel_Phl,
   input   [1:0] op0_byp_mux_sel_Dhl,
   input   [1:0] op0_mux_sel_Dhl,
   input   [1:0] op1_byp_mux_sel_Dhl,
@@ -47,6 +49,12 @@ module parc_CoreDpath
   input         wb_mux_sel_Mhl,
   input         rf_wen_Whl,
   input  [ 4:0] rf_waddr_Whl,
+  input         bp_update_val_Xhl,
+  input         bp_update_taken_Xhl,
+  input         bp_update_jump_Xhl,
+  input         ras_push_Fhl,
+  input         ras_pop_Fhl,
+  input         ras_repair_Xhl,
   input         stall_Fhl,
   input         stall_Dhl,
   input         stall_Xhl,
@@ -58,6 +66,8 @@ module parc_CoreDpath
   output        branch_cond_eq_Xhl,
   output        branch_cond_zero_Xhl,
   output        branch_cond_neg_Xhl,
+  output        pred_taken_Fhl,
+  output        ras_targ_match_Dhl,
   output [31:0] proc2cop_data_Whl
 );
 
@@ -71,6 +81,9 @@ module parc_CoreDpath
   wire [31:0] branch_targ_Phl;
   wire [31:0] jump_targ_Phl;
   wire [31:0] jumpreg_targ_Phl;
+  wire [31:0] pred_targ_Phl;
+  wire [31:0] fallthru_Phl;
+  wire [31:0] ras_targ_Phl;
   wire [31:0] pc_mux_out_Phl;
 
   wire [31:0] reset_vector = 32'h00080000;
@@ -81,12 +94,18 @@ module parc_CoreDpath
   assign branch_targ_Phl    = branch_targ_Xhl;
   assign jump_targ_Phl      = jump_targ_Dhl;
   assign jumpreg_targ_Phl   = jumpreg_targ_Dhl;
+  assign pred_targ_Phl      = pred_targ_Fhl;
+  assign fallthru_Phl       = pc_plus4_Xhl;
+  assign ras_targ_Phl       = ras_targ_Fhl;
 
   assign pc_mux_out_Phl
-    = ( pc_mux_sel_Phl == 2'd0 ) ? pc_plus4_Phl
-    : ( pc_mux_sel_Phl == 2'd1 ) ? branch_targ_Phl
-    : ( pc_mux_sel_Phl == 2'd2 ) ? jump_targ_Phl
-    : ( pc_mux_sel_Phl == 2'd3 ) ? jumpreg_targ_Phl
+    = ( pc_mux_sel_Phl == 3'd0 ) ? pc_plus4_Phl
+    : ( pc_mux_sel_Phl == 3'd1 ) ? branch_targ_Phl
+    : ( pc_mux_sel_Phl == 3'd2 ) ? jump_targ_Phl
+    : ( pc_mux_sel_Phl == 3'd3 ) ? jumpreg_targ_Phl
+    : ( pc_mux_sel_Phl == 3'd4 ) ? pred_targ_Phl
+    : ( pc_mux_sel_Phl == 3'd5 ) ? fallthru_Phl
+    : ( pc_mux_sel_Phl == 3'd6 ) ? ras_targ_Phl
     :                              32'bx;
 
   // Send out imem request early
@@ -120,17 +139,63 @@ module parc_CoreDpath
 
   assign pc_plus4_Fhl = pc_Fhl + 32'd4;
 
+  // Branch predictor, looked up with the fetch pc and updated with each
+  // branch or direct jump as it resolves in X
+
+  wire [31:0] pred_targ_Fhl;
+
+  parc_CoreDpathBranchPred bpred
+  (
+    .clk          (clk),
+    .reset        (reset),
+    .pc           (pc_Fhl),
+    .pred_taken   (pred_taken_Fhl),
+    .pred_targ    (pred_targ_Fhl),
+    .update_val   (bp_update_val_Xhl),
+    .update_pc    (pc_Xhl),
+    .update_taken (bp_update_taken_Xhl),
+    .update_targ  (bp_update_jump_Xhl ? jump_targ_Xhl : branch_targ_Xhl)
+  );
+
+  // Return address stack, pushed and popped by calls and returns in F
+  // and repaired from the checkpoint of a branch mispredicted in X
+
+  wire [31:0] ras_targ_Fhl;
+  wire  [2:0] ras_tos_Fhl;
+  wire [31:0] ras_top_Fhl;
+
+  parc_CoreDpathReturnStack ras
+  (
+    .clk        (clk),
+    .reset      (reset),
+    .push       (ras_push_Fhl),
+    .push_addr  (pc_plus4_Fhl),
+    .pop        (ras_pop_Fhl),
+    .top        (ras_targ_Fhl),
+    .ckpt_tos   (ras_tos_Fhl),
+    .ckpt_top   (ras_top_Fhl),
+    .repair     (ras_repair_Xhl),
+    .repair_tos (ras_tos_Xhl),
+    .repair_top (ras_top_Xhl)
+  );
+
   //----------------------------------------------------------------------
   // D <- F
   //----------------------------------------------------------------------
 
   reg [31:0] pc_Dhl;
   reg [31:0] pc_plus4_Dhl;
+  reg [31:0] ras_targ_Dhl;
+  reg  [2:0] ras_tos_Dhl;
+  reg [31:0] ras_top_Dhl;
 
   always @ (posedge clk) begin
     if( !stall_Dhl ) begin
       pc_Dhl       <= pc_Fhl;
       pc_plus4_Dhl <= pc_plus4_Fhl;
+      ras_targ_Dhl <= ras_targ_Fhl;
+      ras_tos_Dhl  <= ras_tos_Fhl;
+      ras_top_Dhl  <= ras_top_Fhl;
     end
   end
 
@@ -183,6 +248,10 @@ module parc_CoreDpath
 
   assign jumpreg_targ_Dhl  = op0_byp_mux_out_Dhl;
 
+  // Check a return against the target the RAS predicted in F
+
+  assign ras_targ_match_Dhl = ( jumpreg_targ_Dhl == ras_targ_Dhl );
+
   // Zero and sign extension immediate
 
   wire [31:0] imm_sext_Dhl = { {16{inst_imm_sign_Dhl}}, inst_imm_Dhl };
@@ -243,7 +312,11 @@ module parc_CoreDpath
   //----------------------------------------------------------------------
 
   reg [31:0] pc_Xhl;
+  reg [31:0] pc_plus4_Xhl;
   reg [31:0] branch_targ_Xhl;
+  reg [31:0] jump_targ_Xhl;
+  reg  [2:0] ras_tos_Xhl;
+  reg [31:0] ras_top_Xhl;
   reg [31:0] op0_mux_out_Xhl;
   reg [31:0] op1_mux_out_Xhl;
   reg [31:0] wdata_Xhl;
@@ -251,7 +324,11 @@ module parc_CoreDpath
   always @ (posedge clk) begin
     if( !stall_Xhl ) begin
       pc_Xhl          <= pc_Dhl;
+      pc_plus4_Xhl    <= pc_plus4_Dhl;
       branch_targ_Xhl <= branch_targ_Dhl;
+      jump_targ_Xhl   <= jump_targ_Dhl;
+      ras_tos_Xhl     <= ras_tos_Dhl;
+      ras_top_Xhl     <= ras_top_Dhl;
       op0_mux_out_Xhl <= op0_mux_out_Dhl;
       op1_mux_out_Xhl <= op1_mux_out_Dhl;
       wdata_Xhl       <= wdata_Dhl;
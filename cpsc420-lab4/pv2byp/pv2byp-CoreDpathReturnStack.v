@@ -0,0 +1,92 @@
+//=========================================================================
+// 5-Stage PARC Return Address Stack
+//=========================================================================
+// Predicts the target of jr $31. Fetch pushes pc+4 for every jal/jalr
+// and pops for every jr $31, following the popped address. The stack is
+// circular, so a call chain deeper than ENTRIES overwrites the oldest
+// return addresses rather than stalling.
+//
+// Since fetch updates the stack speculatively, each instruction carries
+// a checkpoint of the top of stack pointer and top entry as they are
+// after its own push or pop. When a branch is mispredicted, restoring
+// its checkpoint undoes every push and pop from the wrong path, except
+// that pushes may have overwritten entries below the top which a later
+// return will mispredict on.
+
+`ifndef PARC_CORE_DPATH_RETURNSTACK_V
+`define PARC_CORE_DPATH_RETURNSTACK_V
+
+module parc_CoreDpathReturnStack
+#(
+  parameter ENTRIES = 8,
+  parameter ADDR_SZ = 3
+)(
+  input                clk,
+  input                reset,
+
+  // Fetch (sample on rising clk edge)
+
+  input                push,
+  input  [31:0]        push_addr,
+  input                pop,
+
+  output [31:0]        top,       // Predicted return address
+  output [ADDR_SZ-1:0] ckpt_tos,  // State after this cycle's push or pop
+  output [31:0]        ckpt_top,
+
+  // Repair (sample on rising clk edge)
+
+  input                repair,
+  input  [ADDR_SZ-1:0] repair_tos,
+  input  [31:0]        repair_top
+);
+
+  reg [31:0]        stack [ENTRIES-1:0];
+  reg [ADDR_SZ-1:0] tos;
+
+  wire [ADDR_SZ-1:0] tos_push = tos + 1'b1;
+  wire [ADDR_SZ-1:0] tos_pop  = tos - 1'b1;
+
+  assign top = stack[tos];
+
+  assign ckpt_tos
+    = push ? tos_push
+    : pop  ? tos_pop
+    :        tos;
+
+  assign ckpt_top
+    = push ? push_addr
+    : pop  ? stack[tos_pop]
+    :        stack[tos];
+
+  always @(posedge clk) begin
+    if (reset)
+      tos <= {ADDR_SZ{1'b0}};
+    else if (repair)
+      tos <= repair_tos;
+    else
+      tos <= ckpt_tos;
+  end
+
+  // Entries start out zero, so a return with an empty stack predicts
+  // address 0 and is repaired in decode
+
+  genvar i;
+  generate
+  for( i = 0; i < ENTRIES; i = i + 1)
+  begin: ras_entry
+    always @(posedge clk) begin
+      if (reset)
+        stack[i] <= 32'b0;
+      else if ( repair && (i == repair_tos) )
+        stack[i] <= repair_top;
+      else if ( !repair && push && (i == tos_push) )
+        stack[i] <= push_addr;
+    end
+  end
+  endgenerate
+
+endmodule
+
+`endif
+
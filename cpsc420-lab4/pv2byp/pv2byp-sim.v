@@ -309,6 +309,7 @@ module parc_sim;
   //----------------------------------------------------------------------
 
   real ipc;
+  real br_acc;
 
   always @ ( * ) begin
     if ( !reset && ( status != 0 ) ) begin
@@ -321,6 +322,8 @@ module parc_sim;
 
       if ( verbose == 1'b1 ) begin
         ipc = proc.ctrl.num_inst/$itor(proc.ctrl.num_cycles);
+        br_acc = ( proc.ctrl.num_br == 0 ) ? 1.0
+               : 1.0 - proc.ctrl.num_br_miss/$itor(proc.ctrl.num_br);
 
         $display( "--------------------------------------------" );
         $display( " STATS                                      " );
@@ -330,6 +333,11 @@ module parc_sim;
         $display( " num_cycles = %d", proc.ctrl.num_cycles       );
         $display( " num_inst   = %d", proc.ctrl.num_inst         );
         $display( " ipc        = %f", ipc                        );
+        $display( " num_br     = %d", proc.ctrl.num_br           );
+        $display( " br_miss    = %d", proc.ctrl.num_br_miss      );
+        $display( " br_acc     = %f", br_acc                     );
+        $display( " ras_hit    = %d", proc.ctrl.num_ras_hit      );
+        $display( " ras_miss   = %d", proc.ctrl.num_ras_miss     );
       end
 
       #20 $finish;
@@ -11,6 +11,8 @@ pv2byp_srcs = \
   pv2byp-CoreDpath.v \
   pv2byp-CoreDpathRegfile.v \
   pv2byp-CoreDpathAlu.v \
+  pv2byp-CoreDpathBranchPred.v \
+  pv2byp-CoreDpathReturnStack.v \
   pv2byp-CoreCtrl.v \
   pv2byp-Core.v \
   pv2byp-InstMsg.v \
@@ -51,12 +51,12 @@ module parc_Core
   wire [31:0] dmemreq_msg_data;
   wire [31:0] dmemresp_msg_data;
 
-  wire  [1:0] pc_mux_sel_Phl;
+  wire  [2:0] pc_mux_sel_Phl;
+  wire  [5:0] rf_raddr0_Dhl;
+  wire  [5:0] rf_raddr1_Dhl;
   wire  [2:0] op0_byp_mux_sel_Dhl;
-  wire  [3:0] op0_byp_rob_slot_Dhl;
   wire  [1:0] op0_mux_sel_Dhl;
   wire  [2:0] op1_byp_mux_sel_Dhl;
-  wire  [3:0] op1_byp_rob_slot_Dhl;
   wire  [2:0] op1_mux_sel_Dhl;
   wire [31:0] inst_Dhl;
   wire  [3:0] alu_fn_Xhl;
@@ -66,17 +66,24 @@ module parc_Core
   wire        muldivresp_val;
   wire        muldivresp_rdy;
   wire        muldiv_mux_sel_X3hl;
+  wire        divresp_val;
+  wire        divresp_rdy;
+  wire        div_mux_sel;
   wire  [2:0] dmemresp_mux_sel_Mhl;
   wire        dmemresp_queue_en_Mhl;
   wire        dmemresp_queue_val_Mhl;
-  wire  [1:0] wb_mux_sel_Whl;
-  wire        rf_wen_Whl;
-  wire  [4:0] rf_waddr_Whl;
-  wire        rob_fill_wen_Whl;
-  wire [ 3:0] rob_fill_slot_Whl;
-  wire        rob_commit_wen_Chl;
-  wire [ 3:0] rob_commit_slot_Chl;
-  wire [ 4:0] rob_commit_waddr_Chl;
+  wire        rf_wen_W0hl;
+  wire  [5:0] rf_waddr_W0hl;
+  wire        rf_wen_W1hl;
+  wire  [5:0] rf_waddr_W1hl;
+  wire        rf_wen_W2hl;
+  wire  [5:0] rf_waddr_W2hl;
+  wire        bp_update_val_Xhl;
+  wire        bp_update_taken_Xhl;
+  wire        bp_update_jump_Xhl;
+  wire        ras_push_Fhl;
+  wire        ras_pop_Fhl;
+  wire        ras_repair_Xhl;
   wire        stall_Fhl;
   wire        stall_Dhl;
   wire        stall_Xhl;
@@ -86,6 +93,8 @@ module parc_Core
   wire        branch_cond_eq_Xhl;
   wire        branch_cond_zero_Xhl;
   wire        branch_cond_neg_Xhl;
+  wire        pred_taken_Fhl;
+  wire        ras_targ_match_Dhl;
   wire [31:0] proc2cop_data_Whl;
 
   //----------------------------------------------------------------------
@@ -157,11 +166,11 @@ module parc_Core
     // Controls Signals (ctrl->dpath)
 
     .pc_mux_sel_Phl         (pc_mux_sel_Phl),
+    .rf_raddr0_Dhl          (rf_raddr0_Dhl),
+    .rf_raddr1_Dhl          (rf_raddr1_Dhl),
     .op0_byp_mux_sel_Dhl    (op0_byp_mux_sel_Dhl),
-    .op0_byp_rob_slot_Dhl   (op0_byp_rob_slot_Dhl),
     .op0_mux_sel_Dhl        (op0_mux_sel_Dhl),
     .op1_byp_mux_sel_Dhl    (op1_byp_mux_sel_Dhl),
-    .op1_byp_rob_slot_Dhl   (op1_byp_rob_slot_Dhl),
     .op1_mux_sel_Dhl        (op1_mux_sel_Dhl),
     .inst_Dhl               (inst_Dhl),
     .alu_fn_Xhl             (alu_fn_Xhl),
@@ -171,17 +180,24 @@ module parc_Core
     .muldivresp_val         (muldivresp_val),
     .muldivresp_rdy         (muldivresp_rdy),
     .muldiv_mux_sel_X3hl    (muldiv_mux_sel_X3hl),
+    .divresp_val            (divresp_val),
+    .divresp_rdy            (divresp_rdy),
+    .div_mux_sel            (div_mux_sel),
     .dmemresp_mux_sel_Mhl   (dmemresp_mux_sel_Mhl),
     .dmemresp_queue_en_Mhl  (dmemresp_queue_en_Mhl),
     .dmemresp_queue_val_Mhl (dmemresp_queue_val_Mhl),
-    .wb_mux_sel_Whl         (wb_mux_sel_Whl),
-    .rf_wen_out_Whl         (rf_wen_Whl),
-    .rf_waddr_Whl           (rf_waddr_Whl),
-    .rob_fill_wen_Whl       (rob_fill_wen_Whl),
-    .rob_fill_slot_Whl      (rob_fill_slot_Whl),
-    .rob_commit_wen_Chl     (rob_commit_wen_Chl),
-    .rob_commit_slot_Chl    (rob_commit_slot_Chl),
-    .rob_commit_waddr_Chl   (rob_commit_waddr_Chl),
+    .rf_wen_out_W0hl        (rf_wen_W0hl),
+    .rf_waddr_W0hl          (rf_waddr_W0hl),
+    .rf_wen_out_W1hl        (rf_wen_W1hl),
+    .rf_waddr_W1hl          (rf_waddr_W1hl),
+    .rf_wen_out_W2hl        (rf_wen_W2hl),
+    .rf_waddr_W2hl          (rf_waddr_W2hl),
+    .bp_update_val_Xhl      (bp_update_val_Xhl),
+    .bp_update_taken_Xhl    (bp_update_taken_Xhl),
+    .bp_update_jump_Xhl     (bp_update_jump_Xhl),
+    .ras_push_Fhl           (ras_push_Fhl),
+    .ras_pop_Fhl            (ras_pop_Fhl),
+    .ras_repair_Xhl         (ras_repair_Xhl),
     .stall_Fhl              (stall_Fhl),
     .stall_Dhl              (stall_Dhl),
     .stall_Xhl              (stall_Xhl),
@@ -193,6 +209,8 @@ module parc_Core
     .branch_cond_eq_Xhl     (branch_cond_eq_Xhl),
     .branch_cond_zero_Xhl   (branch_cond_zero_Xhl),
     .branch_cond_neg_Xhl    (branch_cond_neg_Xhl),
+    .pred_taken_Fhl         (pred_taken_Fhl),
+    .ras_targ_match_Dhl     (ras_targ_match_Dhl),
     .proc2cop_data_Whl      (proc2cop_data_Whl),
 
     // CP0 Status
@@ -222,11 +240,11 @@ module parc_Core
     // Controls Signals (ctrl->dpath)
 
     .pc_mux_sel_Phl          (pc_mux_sel_Phl),
+    .rf_raddr0_Dhl           (rf_raddr0_Dhl),
+    .rf_raddr1_Dhl           (rf_raddr1_Dhl),
     .op0_byp_mux_sel_Dhl     (op0_byp_mux_sel_Dhl),
-    .op0_byp_rob_slot_Dhl    (op0_byp_rob_slot_Dhl),
     .op0_mux_sel_Dhl         (op0_mux_sel_Dhl),
     .op1_byp_mux_sel_Dhl     (op1_byp_mux_sel_Dhl),
-    .op1_byp_rob_slot_Dhl    (op1_byp_rob_slot_Dhl),
     .op1_mux_sel_Dhl         (op1_mux_sel_Dhl),
     .inst_Dhl                (inst_Dhl),
     .alu_fn_Xhl              (alu_fn_Xhl),
@@ -236,17 +254,24 @@ module parc_Core
     .muldivresp_val          (muldivresp_val),
     .muldivresp_rdy          (muldivresp_rdy),
     .muldiv_mux_sel_X3hl     (muldiv_mux_sel_X3hl),
+    .divresp_val             (divresp_val),
+    .divresp_rdy             (divresp_rdy),
+    .div_mux_sel             (div_mux_sel),
     .dmemresp_mux_sel_Mhl    (dmemresp_mux_sel_Mhl),
     .dmemresp_queue_en_Mhl   (dmemresp_queue_en_Mhl),
     .dmemresp_queue_val_Mhl  (dmemresp_queue_val_Mhl),
-    .wb_mux_sel_Whl          (wb_mux_sel_Whl),
-    .rf_wen_Whl              (rf_wen_Whl),
-    .rf_waddr_Whl            (rf_waddr_Whl),
-    .rob_fill_wen_Whl       (rob_fill_wen_Whl),
-    .rob_fill_slot_Whl      (rob_fill_slot_Whl),
-    .rob_commit_wen_Chl     (rob_commit_wen_Chl),
-    .rob_commit_slot_Chl    (rob_commit_slot_Chl),
-    .rob_commit_waddr_Chl   (rob_commit_waddr_Chl),
+    .rf_wen_W0hl             (rf_wen_W0hl),
+    .rf_waddr_W0hl           (rf_waddr_W0hl),
+    .rf_wen_W1hl             (rf_wen_W1hl),
+    .rf_waddr_W1hl           (rf_waddr_W1hl),
+    .rf_wen_W2hl             (rf_wen_W2hl),
+    .rf_waddr_W2hl           (rf_waddr_W2hl),
+    .bp_update_val_Xhl       (bp_update_val_Xhl),
+    .bp_update_taken_Xhl     (bp_update_taken_Xhl),
+    .bp_update_jump_Xhl      (bp_update_jump_Xhl),
+    .ras_push_Fhl            (ras_push_Fhl),
+    .ras_pop_Fhl             (ras_pop_Fhl),
+    .ras_repair_Xhl          (ras_repair_Xhl),
     .stall_Fhl               (stall_Fhl),
     .stall_Dhl               (stall_Dhl),
     .stall_Xhl               (stall_Xhl),
@@ -258,6 +283,8 @@ module parc_Core
     .branch_cond_eq_Xhl      (branch_cond_eq_Xhl),
     .branch_cond_zero_Xhl    (branch_cond_zero_Xhl),
     .branch_cond_neg_Xhl     (branch_cond_neg_Xhl),
+    .pred_taken_Fhl          (pred_taken_Fhl),
+    .ras_targ_match_Dhl      (ras_targ_match_Dhl),
     .proc2cop_data_Whl       (proc2cop_data_Whl)
   );
 
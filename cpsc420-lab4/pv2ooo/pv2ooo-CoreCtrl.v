@@ -8,6 +8,7 @@
 `include "pv2ooo-InstMsg.v"
 `include "pv2ooo-CoreScoreboard.v"
 `include "pv2ooo-CoreReorderBuffer.v"
+`include "pv2ooo-CoreRenameTable.v"
 
 module parc_CoreCtrl
 (
@@ -30,12 +31,12 @@ module parc_CoreCtrl
 
   // Controls Signals (ctrl->dpath)
 
-  output  [1:0] pc_mux_sel_Phl,
+  output  [2:0] pc_mux_sel_Phl,
+  output  [5:0] rf_raddr0_Dhl,
+  output  [5:0] rf_raddr1_Dhl,
   output  [2:0] op0_byp_mux_sel_Dhl,
-  output  [3:0] op0_byp_rob_slot_Dhl,
   output  [1:0] op0_mux_sel_Dhl,
   output  [2:0] op1_byp_mux_sel_Dhl,
-  output  [3:0] op1_byp_rob_slot_Dhl,
   output  [2:0] op1_mux_sel_Dhl,
   output [31:0] inst_Dhl,
   output  [3:0] alu_fn_Xhl,
@@ -45,17 +46,24 @@ module parc_CoreCtrl
   input         muldivresp_val,
   output        muldivresp_rdy,
   output        muldiv_mux_sel_X3hl,
+  input         divresp_val,
+  output        divresp_rdy,
+  output        div_mux_sel,
   output  [2:0] dmemresp_mux_sel_Mhl,
   output        dmemresp_queue_en_Mhl,
   output        dmemresp_queue_val_Mhl,
-  output  [1:0] wb_mux_sel_Whl,
-  output        rf_wen_out_Whl,
-  output  [4:0] rf_waddr_Whl,
-  output        rob_fill_wen_Whl,
-  output [ 3:0] rob_fill_slot_Whl,
-  output        rob_commit_wen_Chl,
-  output [ 3:0] rob_commit_slot_Chl,
-  output [ 4:0] rob_commit_waddr_Chl,
+  output        rf_wen_out_W0hl,
+  output  [5:0] rf_waddr_W0hl,
+  output        rf_wen_out_W1hl,
+  output  [5:0] rf_waddr_W1hl,
+  output        rf_wen_out_W2hl,
+  output  [5:0] rf_waddr_W2hl,
+  output        bp_update_val_Xhl,
+  output        bp_update_taken_Xhl,
+  output        bp_update_jump_Xhl,
+  output        ras_push_Fhl,
+  output        ras_pop_Fhl,
+  output        ras_repair_Xhl,
   output        stall_Fhl,
   output        stall_Dhl,
   output        stall_Xhl,
@@ -67,6 +75,8 @@ module parc_CoreCtrl
   input         branch_cond_eq_Xhl,
   input         branch_cond_zero_Xhl,
   input         branch_cond_neg_Xhl,
+  input         pred_taken_Fhl,
+  input         ras_targ_match_Dhl,
   input  [31:0] proc2cop_data_Whl,
 
   // CP0 Status
@@ -78,11 +88,19 @@ module parc_CoreCtrl
   // PC Stage: Instruction Memory Request
   //----------------------------------------------------------------------
 
-  // PC Mux Select
+  // PC Mux Select. A mispredicted branch in X redirects to its target
+  // or its fall-through, a jump in D the predictor missed to the jump
+  // target, and otherwise fetch follows the RAS for a return in F and
+  // the predictor for anything else.
+
+  wire pred_taken_Phl = ( inst_val_Fhl && pred_taken_Fhl );
+  wire ras_pred_Phl   = ( inst_val_Fhl && ras_ret_Fhl );
 
   assign pc_mux_sel_Phl
-    = brj_taken_Xhl    ? pm_b
+    = br_mispred_Xhl   ? ( any_br_taken_Xhl ? pm_b : pm_n )
     : brj_taken_Dhl    ? pc_mux_sel_Dhl
+    : ras_pred_Phl     ? pm_s
+    : pred_taken_Phl   ? pm_t
     :                    pm_p;
 
   // Only send a valid imem request if not stalled
@@ -132,12 +150,12 @@ module parc_CoreCtrl
 
   wire inst_val_Fhl = ( !bubble_Fhl && !squash_Fhl );
 
-  // Squash instruction in F stage if branch taken for a valid
-  // instruction or if there was an exception in X stage
+  // Squash instruction in F stage if a valid jump in D was not
+  // predicted or a valid branch in X was mispredicted
 
   wire squash_Fhl
     = ( inst_val_Dhl && brj_taken_Dhl )
-   || ( inst_val_Xhl && brj_taken_Xhl );
+   || ( inst_val_Xhl && br_mispred_Xhl );
 
   // Stall in F if D is stalled
 
@@ -177,11 +195,37 @@ module parc_CoreCtrl
     : ( imemresp_queue_val_Fhl )  ? imemresp_queue_reg_Fhl
     :                               32'bx;
 
+  //----------------------------------------------------------------------
+  // Return address stack
+  //----------------------------------------------------------------------
+
+  // Calls push and returns (jr $31) pop as they leave F
+
+  wire [31:0] ir_Fhl = imemresp_queue_mux_out_Fhl;
+
+  reg ras_call_Fhl;
+  reg ras_ret_Fhl;
+
+  always @ (*) begin
+    ras_call_Fhl = 1'b0;
+    ras_ret_Fhl  = 1'b0;
+    casez ( ir_Fhl )
+      `PARC_INST_MSG_JAL  : ras_call_Fhl = 1'b1;
+      `PARC_INST_MSG_JALR : ras_call_Fhl = 1'b1;
+      `PARC_INST_MSG_JR   : ras_ret_Fhl  = ( ir_Fhl[25:21] == 5'd31 );
+    endcase
+  end
+
+  assign ras_push_Fhl = ( inst_val_Fhl && !stall_Fhl && ras_call_Fhl );
+  assign ras_pop_Fhl  = ( inst_val_Fhl && !stall_Fhl && ras_ret_Fhl );
+
   //----------------------------------------------------------------------
   // D <- F
   //----------------------------------------------------------------------
 
   reg [31:0] ir_Dhl;
+  reg        pred_taken_Dhl;
+  reg        ras_ret_Dhl;
   reg        bubble_Dhl;
 
   always @ ( posedge clk ) begin
@@ -189,8 +233,10 @@ module parc_CoreCtrl
       bubble_Dhl <= 1'b1;
     end
     else if( !stall_Dhl ) begin
-      ir_Dhl     <= imemresp_queue_mux_out_Fhl;
-      bubble_Dhl <= bubble_next_Fhl;
+      ir_Dhl         <= imemresp_queue_mux_out_Fhl;
+      pred_taken_Dhl <= pred_taken_Fhl;
+      ras_ret_Dhl    <= ras_ret_Fhl;
+      bubble_Dhl     <= bubble_next_Fhl;
     end
   end
 
@@ -227,6 +273,9 @@ module parc_CoreCtrl
   localparam pm_b   = 2'd1;  // Use branch address
   localparam pm_j   = 2'd2;  // Use jump address
   localparam pm_r   = 2'd3;  // Use jump register
+  localparam pm_t   = 3'd4;  // Use predicted target
+  localparam pm_n   = 3'd5;  // Use fall-through of branch in X
+  localparam pm_s   = 3'd6;  // Use return address stack
 
   // Operand 0 Bypass Mux Select
 
@@ -437,13 +486,21 @@ module parc_CoreCtrl
 
   // Jump and Branch Controls
 
-  wire       brj_taken_Dhl = ( inst_val_Dhl && cs[`PARC_INST_MSG_J_EN] );
   wire [2:0] br_sel_Dhl    = cs[`PARC_INST_MSG_BR_SEL];
 
   // PC Mux Select
 
   wire [1:0] pc_mux_sel_Dhl = cs[`PARC_INST_MSG_PC_SEL];
 
+  // A direct jump the predictor already followed in F, or a return
+  // the RAS predicted correctly, needs no redirect; any other jump
+  // redirects from D
+
+  wire       jump_Dhl      = ( cs[`PARC_INST_MSG_J_EN] && ( pc_mux_sel_Dhl == pm_j ) );
+  wire       ras_hit_Dhl   = ( ras_ret_Dhl && ras_targ_match_Dhl );
+  wire       brj_taken_Dhl = ( inst_val_Dhl && cs[`PARC_INST_MSG_J_EN]
+                               && !( jump_Dhl && pred_taken_Dhl ) && !ras_hit_Dhl );
+
   // Operand Bypassing Logic
 
   wire       rs_en_Dhl    = cs[`PARC_INST_MSG_RS_EN];
@@ -454,6 +511,67 @@ module parc_CoreCtrl
   wire [4:0] rf_waddr_Dhl = cs[`PARC_INST_MSG_RF_WADDR];
   wire rf_wen_Dhl         = cs[`PARC_INST_MSG_RF_WEN];
 
+  // Register Renaming
+  //
+  // Sources are read from the physical registers the rename table maps
+  // them to, and a write to any register but r0 is given a new physical
+  // register. From here on the pipeline carries the physical register
+  // in rf_waddr_*.
+
+  wire       prf_wen_Dhl = rf_wen_Dhl && ( rf_waddr_Dhl != 5'd0 );
+  wire [5:0] prf_waddr_Dhl;
+  wire [5:0] prf_old_waddr_Dhl;
+  wire       rename_rdy_Dhl;
+
+  // Conditional branches save a checkpoint of the rename table, which
+  // a mispredicted branch restores as it resolves in X. Whatever was in
+  // D behind it is squashed before being renamed, so the restore finds
+  // the map as the branch left it; it is kept so that the rename path
+  // matches pv2spec, where younger instructions are renamed first.
+
+  wire       ckpt_save_Dhl = inst_val_Dhl && !stall_Dhl
+                          && ( br_sel_Dhl != br_none );
+  reg  [1:0] ckpt_idx_Dhl;
+
+  always @ ( posedge clk ) begin
+    if ( reset )
+      ckpt_idx_Dhl <= 2'd0;
+    else if ( ckpt_save_Dhl )
+      ckpt_idx_Dhl <= ckpt_idx_Dhl + 1'b1;
+  end
+
+  wire [4:0] rob_commit_areg_Chl;
+  wire [5:0] rob_commit_preg_Chl;
+  wire [5:0] rob_commit_old_preg_Chl;
+  wire       rob_commit_wen_Chl;
+
+  parc_CoreRenameTable rename
+  (
+    .clk              (clk),
+    .reset            (reset),
+
+    .src0_areg        (inst_rs_Dhl),
+    .src0_preg        (rf_raddr0_Dhl),
+    .src1_areg        (inst_rt_Dhl),
+    .src1_preg        (rf_raddr1_Dhl),
+
+    .rename_val       (inst_val_Dhl && !stall_Dhl && prf_wen_Dhl),
+    .rename_rdy       (rename_rdy_Dhl),
+    .rename_areg      (rf_waddr_Dhl),
+    .rename_preg      (prf_waddr_Dhl),
+    .rename_old_preg  (prf_old_waddr_Dhl),
+
+    .commit_val       (rob_commit_wen_Chl),
+    .commit_areg      (rob_commit_areg_Chl),
+    .commit_preg      (rob_commit_preg_Chl),
+    .commit_old_preg  (rob_commit_old_preg_Chl),
+
+    .ckpt_save        (ckpt_save_Dhl),
+    .ckpt_save_idx    (ckpt_idx_Dhl),
+    .ckpt_restore     (br_mispred_Xhl),
+    .ckpt_restore_idx (ckpt_idx_Xhl)
+  );
+
   // Operand Mux Select
 
   assign op0_mux_sel_Dhl = cs[`PARC_INST_MSG_OP0_SEL];
@@ -471,6 +589,11 @@ module parc_CoreCtrl
 
   wire muldivreq_val_Dhl = cs[`PARC_INST_MSG_MULDIV_EN];
 
+  // Divides and remainders go to the iterative divider
+
+  wire is_div_Dhl = muldivreq_val_Dhl
+                 && ( muldivreq_msg_fn_Dhl != md_mul );
+
   // Muldiv Mux Select
 
   wire muldiv_mux_sel_Dhl = cs[`PARC_INST_MSG_MULDIV_SEL];
@@ -518,69 +641,72 @@ module parc_CoreCtrl
   reg [2:0] inst_func_unit_Dhl;
   always @(*) begin
     inst_func_unit_Dhl =
+      is_div_Dhl                             ? 3'd4 :
       (cs[`PARC_INST_MSG_MULDIV_EN] != n)    ? 3'd3 :
       (cs[`PARC_INST_MSG_MEM_REQ]   != nr)   ? 3'd2 :
                                                3'd1;
   end
     
-  wire [4:0] stalls_combined = {
-    stall_Xhl,
-    stall_Mhl,
-    1'b0,
-    1'b0,
-    stall_Whl};
-
   wire       stall_sb_Dhl;
-  wire [1:0] wb_mux_sel_Whl;
+
+  // A divide's register is written back when the divider is done
+
+  wire       div_wb_val;
+  wire [5:0] div_wb_dst;
 
   wire [3:0] rob_fill_slot_Dhl;
+  wire       rob_req_rdy_Dhl;
 
-  wire [3:0] op0_byp_rob_slot_Dhl;
-  wire [3:0] op1_byp_rob_slot_Dhl;
+  // Decode can only issue with a ROB slot and a physical register free
+
+  wire       alloc_rdy_Dhl = rob_req_rdy_Dhl && rename_rdy_Dhl;
+
+  // Stall in D if a divide is waiting for the divider to be free
+
+  wire       stall_muldiv_Dhl = ( inst_val_Dhl && muldivreq_val_Dhl && !muldivreq_rdy );
 
   parc_CoreScoreboard scoreboard
   (
     .clk                 (clk),
     .reset               (reset),
-    .src0                (rs),
+    .src0                (rf_raddr0_Dhl),
     .src0_en             (rs_en_Dhl),
-    .src1                (rt),
+    .src1                (rf_raddr1_Dhl),
     .src1_en             (rt_en_Dhl),
-    .dst                 (rf_waddr_Dhl),
-    .dst_en              (rf_wen_Dhl),
+    .dst                 (prf_waddr_Dhl),
+    .dst_en              (prf_wen_Dhl),
     .latency             (inst_latency_Dhl),
     .func_unit           (inst_func_unit_Dhl), 
     .inst_val_Dhl        (inst_val_Dhl),
 
-    .rob_alloc_slot      (rob_fill_slot_Dhl),
-    .rob_commit_slot     (rob_commit_slot_Chl),
-    .rob_commit_wen      (rob_commit_wen_Chl),
+    .alloc_rdy           (alloc_rdy_Dhl && !stall_muldiv_Dhl),
 
-    .stalls              (stalls_combined),
+    .stall_Xhl           (stall_Xhl),
+    .stall_Mhl           (stall_Mhl),
 
-    .src0_byp_mux_sel    (op0_byp_mux_sel_Dhl),
-    .src0_byp_rob_slot   (op0_byp_rob_slot_Dhl),
+    .div_wb_val          (div_wb_val),
+    .div_wb_dst          (div_wb_dst),
 
+    .src0_byp_mux_sel    (op0_byp_mux_sel_Dhl),
     .src1_byp_mux_sel    (op1_byp_mux_sel_Dhl),
-    .src1_byp_rob_slot   (op1_byp_rob_slot_Dhl),
 
-    .stall_hazard        (stall_sb_Dhl),
-    .wb_mux_sel          (wb_mux_sel_Whl)
+    .stall_hazard        (stall_sb_Dhl)
   );
 
   //----------------------------------------------------------------------
   // Squash and Stall Logic
   //----------------------------------------------------------------------
 
-  // Squash instruction in D if a valid branch in X is taken
+  // Squash instruction in D if a valid branch in X was mispredicted
 
-  wire squash_Dhl = ( inst_val_Xhl && brj_taken_Xhl );
+  wire squash_Dhl = ( inst_val_Xhl && br_mispred_Xhl );
 
   // Aggregate Stall Signal
 
   assign stall_Dhl = ( stall_Xhl ||
                       (inst_val_Dhl && stall_sb_Dhl ) ||
-                      (inst_val_Dhl && !rob_req_rdy_Dhl));
+                      (inst_val_Dhl && !alloc_rdy_Dhl) ||
+                      stall_muldiv_Dhl );
 
   // Next bubble bit
 
@@ -595,6 +721,8 @@ module parc_CoreCtrl
 
   reg [31:0] ir_Xhl;
   reg  [2:0] br_sel_Xhl;
+  reg        jump_Xhl;
+  reg        pred_taken_Xhl;
   reg  [3:0] alu_fn_Xhl;
   reg        muldivreq_val_Xhl;
   reg        muldiv_mux_sel_Xhl;
@@ -606,8 +734,10 @@ module parc_CoreCtrl
   reg  [2:0] dmemresp_mux_sel_Xhl;
   reg        wb_mux_sel_Xhl;
   reg        rf_wen_Xhl;
-  reg  [4:0] rf_waddr_Xhl;
+  reg  [5:0] rf_waddr_Xhl;
   reg  [3:0] rob_fill_slot_Xhl;
+  reg  [2:0] func_unit_Xhl;
+  reg  [1:0] ckpt_idx_Xhl;
   reg        cp0_wen_Xhl;
   reg  [4:0] cp0_addr_Xhl;
 
@@ -622,6 +752,8 @@ module parc_CoreCtrl
     else if( !stall_Xhl ) begin
       ir_Xhl               <= ir_Dhl;
       br_sel_Xhl           <= br_sel_Dhl;
+      jump_Xhl             <= jump_Dhl;
+      pred_taken_Xhl       <= pred_taken_Dhl;
       alu_fn_Xhl           <= alu_fn_Dhl;
       muldivreq_val_Xhl    <= muldivreq_val_Dhl;
       muldiv_mux_sel_Xhl   <= muldiv_mux_sel_Dhl;
@@ -632,9 +764,11 @@ module parc_CoreCtrl
       dmemreq_val_Xhl      <= dmemreq_val_Dhl;
       dmemresp_mux_sel_Xhl <= dmemresp_mux_sel_Dhl;
       wb_mux_sel_Xhl       <= wb_mux_sel_Dhl;
-      rf_waddr_Xhl         <= rf_waddr_Dhl;
-      rf_wen_Xhl           <= rf_wen_Dhl;
+      rf_waddr_Xhl         <= prf_waddr_Dhl;
+      rf_wen_Xhl           <= prf_wen_Dhl;
       rob_fill_slot_Xhl    <= rob_fill_slot_Dhl;
+      func_unit_Xhl        <= inst_func_unit_Dhl;
+      ckpt_idx_Xhl         <= ckpt_idx_Dhl;
       cp0_wen_Xhl          <= cp0_wen_Dhl;
       cp0_addr_Xhl         <= cp0_addr_Dhl;
 
@@ -653,9 +787,31 @@ module parc_CoreCtrl
 
   // Muldiv request
 
-  assign muldivreq_val = muldivreq_val_Dhl && inst_val_Dhl;
+  // The muldiv input registers act as X, so they are only loaded when
+  // the request actually leaves D
+
+  assign muldivreq_val = muldivreq_val_Dhl && inst_val_Dhl && !stall_Dhl;
   assign muldivresp_rdy = 1'b1;
 
+  // A divide goes down the pipeline without writing back. Where its
+  // result goes is kept here until the divider is done.
+
+  reg [31:0] div_ir;
+  reg        div_rf_wen;
+  reg  [5:0] div_rf_waddr;
+  reg  [3:0] div_rob_fill_slot;
+  reg        div_mux_sel;
+
+  always @ ( posedge clk ) begin
+    if ( muldivreq_val && is_div_Dhl ) begin
+      div_ir            <= ir_Dhl;
+      div_rf_wen        <= prf_wen_Dhl;
+      div_rf_waddr      <= prf_waddr_Dhl;
+      div_rob_fill_slot <= rob_fill_slot_Dhl;
+      div_mux_sel       <= muldiv_mux_sel_Dhl;
+    end
+  end
+
   // Only send a valid dmem request if not stalled
 
   assign dmemreq_msg_rw  = dmemreq_msg_rw_Xhl;
@@ -688,7 +844,21 @@ module parc_CoreCtrl
    ||   bltz_taken_Xhl
    ||   bgez_taken_Xhl );
 
-  wire brj_taken_Xhl = ( inst_val_Xhl && any_br_taken_Xhl );
+  // A branch is mispredicted if it did not go the way F predicted
+
+  wire br_mispred_Xhl = ( inst_val_Xhl && ( br_sel_Xhl != br_none )
+                          && ( any_br_taken_Xhl != pred_taken_Xhl ) );
+
+  // Train the predictor once per branch or direct jump, as it leaves X
+
+  assign bp_update_val_Xhl
+    = ( inst_val_Xhl && !stall_Xhl && ( ( br_sel_Xhl != br_none ) || jump_Xhl ) );
+  assign bp_update_taken_Xhl = ( any_br_taken_Xhl || jump_Xhl );
+  assign bp_update_jump_Xhl  = jump_Xhl;
+
+  // Undo the RAS pushes and pops of the instructions being squashed
+
+  assign ras_repair_Xhl = br_mispred_Xhl;
 
   // Dummy Squash Signal
 
@@ -724,8 +894,9 @@ module parc_CoreCtrl
   reg        muldiv_mux_sel_Mhl;
   reg        wb_mux_sel_Mhl;
   reg        rf_wen_Mhl;
-  reg  [4:0] rf_waddr_Mhl;
+  reg  [5:0] rf_waddr_Mhl;
   reg  [3:0] rob_fill_slot_Mhl;
+  reg  [2:0] func_unit_Mhl;
   reg        cp0_wen_Mhl;
   reg  [4:0] cp0_addr_Mhl;
 
@@ -749,6 +920,7 @@ module parc_CoreCtrl
       rf_wen_Mhl           <= rf_wen_Xhl;
       rf_waddr_Mhl         <= rf_waddr_Xhl;
       rob_fill_slot_Mhl    <= rob_fill_slot_Xhl;
+      func_unit_Mhl        <= func_unit_Xhl;
       cp0_wen_Mhl          <= cp0_wen_Xhl;
       cp0_addr_Mhl         <= cp0_addr_Xhl;
 
@@ -800,8 +972,9 @@ module parc_CoreCtrl
   reg        dmemresp_queue_val_X2hl;
   reg        muldiv_mux_sel_X2hl;
   reg        rf_wen_X2hl;
-  reg  [4:0] rf_waddr_X2hl;
+  reg  [5:0] rf_waddr_X2hl;
   reg  [3:0] rob_fill_slot_X2hl;
+  reg  [2:0] func_unit_X2hl;
   reg        cp0_wen_X2hl;
   reg  [4:0] cp0_addr_X2hl;
   reg        bubble_X2hl;
@@ -819,13 +992,14 @@ module parc_CoreCtrl
 
   always @(posedge clk) begin
     if (reset)
-      bubble_Whl          <= bubble_next_Mhl;
+      bubble_X2hl         <= 1'b1;
     else if (!stall_X2hl) begin
       ir_X2hl             <= ir_Mhl;
       muldiv_mux_sel_X2hl <= muldiv_mux_sel_Mhl;
       rf_wen_X2hl         <= rf_wen_Mhl;
       rf_waddr_X2hl       <= rf_waddr_Mhl;
       rob_fill_slot_X2hl  <= rob_fill_slot_Mhl;
+      func_unit_X2hl      <= func_unit_Mhl;
       cp0_wen_X2hl        <= cp0_wen_Mhl;
       cp0_addr_X2hl       <= cp0_addr_Mhl;
       bubble_X2hl         <= bubble_next_Mhl;
@@ -840,8 +1014,9 @@ module parc_CoreCtrl
   reg        dmemresp_queue_val_X3hl;
   reg        muldiv_mux_sel_X3hl;
   reg        rf_wen_X3hl;
-  reg  [4:0] rf_waddr_X3hl;
+  reg  [5:0] rf_waddr_X3hl;
   reg  [3:0] rob_fill_slot_X3hl;
+  reg  [2:0] func_unit_X3hl;
   reg        cp0_wen_X3hl;
   reg  [4:0] cp0_addr_X3hl;
   reg        bubble_X3hl;
@@ -859,13 +1034,14 @@ module parc_CoreCtrl
 
   always @(posedge clk) begin
     if (reset)
-      bubble_Whl          <= bubble_next_X2hl;
+      bubble_X3hl         <= 1'b1;
     else if (!stall_X3hl) begin
       ir_X3hl             <= ir_X2hl;
       muldiv_mux_sel_X3hl <= muldiv_mux_sel_X2hl;
       rf_wen_X3hl         <= rf_wen_X2hl;
       rf_waddr_X3hl       <= rf_waddr_X2hl;
       rob_fill_slot_X3hl  <= rob_fill_slot_X2hl;
+      func_unit_X3hl      <= func_unit_X2hl;
       cp0_wen_X3hl        <= cp0_wen_X2hl;
       cp0_addr_X3hl       <= cp0_addr_X2hl;
       bubble_X3hl         <= bubble_next_X2hl;
@@ -875,60 +1051,78 @@ module parc_CoreCtrl
   //----------------------------------------------------------------------
   // W <- *
   //----------------------------------------------------------------------
+  // One writeback stage per functional unit: W0 takes ALU instructions
+  // from X, W1 memory instructions from M and W2 muldiv instructions
+  // from X3. Since they write the register file and fill the ROB
+  // through separate ports, two instructions of different latencies can
+  // write back in the same cycle without stalling D. A finished divide
+  // takes W2 in a cycle when no multiply is leaving X3.
+
+  reg [31:0] ir_W0hl;
+  reg        rf_wen_W0hl;
+  reg  [5:0] rf_waddr_W0hl;
+  reg  [3:0] rob_fill_slot_W0hl;
+  reg        cp0_wen_W0hl;
+  reg  [4:0] cp0_addr_W0hl;
+  reg        bubble_W0hl;
+
+  reg [31:0] ir_W1hl;
+  reg        rf_wen_W1hl;
+  reg  [5:0] rf_waddr_W1hl;
+  reg  [3:0] rob_fill_slot_W1hl;
+  reg        bubble_W1hl;
+
+  reg [31:0] ir_W2hl;
+  reg        rf_wen_W2hl;
+  reg  [5:0] rf_waddr_W2hl;
+  reg  [3:0] rob_fill_slot_W2hl;
+  reg        bubble_W2hl;
 
-  reg [31:0] ir_Whl;
   reg        dmemresp_queue_val_Mhl;
-  reg        rf_wen_Whl;
-  reg  [4:0] rf_waddr_Whl;
-  reg  [3:0] rob_fill_slot_Whl;
-  reg        cp0_wen_Whl;
-  reg  [4:0] cp0_addr_Whl;
 
-  reg        bubble_Whl;
+  assign divresp_rdy = !( !bubble_next_X3hl && ( func_unit_X3hl == `FUNC_UNIT_MUL ) );
+  wire   divresp_go  = divresp_val && divresp_rdy;
+
+  assign div_wb_val = divresp_go && div_rf_wen;
+  assign div_wb_dst = div_rf_waddr;
 
   // Pipeline Controls
 
   always @(posedge clk) begin
     if (reset) begin
-      bubble_Whl   <= 1'b1;
-    end else case(wb_mux_sel_Whl)
-    `FUNC_UNIT_ALU: begin
-      ir_Whl            <= ir_Xhl;
-      rf_wen_Whl        <= rf_wen_Xhl;
-      rf_waddr_Whl      <= rf_waddr_Xhl;
-      rob_fill_slot_Whl <= rob_fill_slot_Xhl;
-      cp0_wen_Whl       <= cp0_wen_Xhl;
-      cp0_addr_Whl      <= cp0_addr_Xhl;
-      bubble_Whl        <= bubble_next_Xhl;
-    end
-    `FUNC_UNIT_MEM: begin
-      ir_Whl            <= ir_Mhl;
-      rf_wen_Whl        <= rf_wen_Mhl;
-      rf_waddr_Whl      <= rf_waddr_Mhl;
-      rob_fill_slot_Whl <= rob_fill_slot_Mhl;
-      cp0_wen_Whl       <= cp0_wen_Mhl;
-      cp0_addr_Whl      <= cp0_addr_Mhl;
-      bubble_Whl        <= bubble_next_Mhl;
-    end
-    `FUNC_UNIT_MUL: begin
-      ir_Whl            <= ir_X3hl;
-      rf_wen_Whl        <= rf_wen_X3hl;
-      rf_waddr_Whl      <= rf_waddr_X3hl;
-      rob_fill_slot_Whl <= rob_fill_slot_X3hl;
-      cp0_wen_Whl       <= cp0_wen_X3hl;
-      cp0_addr_Whl      <= cp0_addr_X3hl;
-      bubble_Whl        <= bubble_next_X3hl;
-    end
-    default: begin
-      ir_Whl            <= 32'b0;
-      rf_wen_Whl        <= 1'b0;
-      rf_waddr_Whl      <= 5'b0;
-      rob_fill_slot_Whl <= 5'b0;
-      cp0_wen_Whl       <= 1'b0;
-      cp0_addr_Whl      <= 5'b0;
-      bubble_Whl        <= 1'b1;
+      bubble_W0hl <= 1'b1;
+      bubble_W1hl <= 1'b1;
+      bubble_W2hl <= 1'b1;
+    end else if ( !stall_Whl ) begin
+      ir_W0hl            <= ir_Xhl;
+      rf_wen_W0hl        <= rf_wen_Xhl;
+      rf_waddr_W0hl      <= rf_waddr_Xhl;
+      rob_fill_slot_W0hl <= rob_fill_slot_Xhl;
+      cp0_wen_W0hl       <= cp0_wen_Xhl;
+      cp0_addr_W0hl      <= cp0_addr_Xhl;
+      bubble_W0hl        <= bubble_next_Xhl || ( func_unit_Xhl != `FUNC_UNIT_ALU );
+
+      ir_W1hl            <= ir_Mhl;
+      rf_wen_W1hl        <= rf_wen_Mhl;
+      rf_waddr_W1hl      <= rf_waddr_Mhl;
+      rob_fill_slot_W1hl <= rob_fill_slot_Mhl;
+      bubble_W1hl        <= bubble_next_Mhl || ( func_unit_Mhl != `FUNC_UNIT_MEM );
+
+      if ( divresp_go ) begin
+        ir_W2hl            <= div_ir;
+        rf_wen_W2hl        <= div_rf_wen;
+        rf_waddr_W2hl      <= div_rf_waddr;
+        rob_fill_slot_W2hl <= div_rob_fill_slot;
+        bubble_W2hl        <= 1'b0;
+      end
+      else begin
+        ir_W2hl            <= ir_X3hl;
+        rf_wen_W2hl        <= rf_wen_X3hl;
+        rf_waddr_W2hl      <= rf_waddr_X3hl;
+        rob_fill_slot_W2hl <= rob_fill_slot_X3hl;
+        bubble_W2hl        <= bubble_next_X3hl || ( func_unit_X3hl != `FUNC_UNIT_MUL );
+      end
     end
-    endcase
     dmemresp_queue_val_Mhl <= dmemresp_queue_val_next_Mhl;
   end
 
@@ -936,33 +1130,30 @@ module parc_CoreCtrl
   // Writeback Stage
   //----------------------------------------------------------------------
 
-  // Is current stage valid?
+  // Dummy squash and stall signals
+
+  wire squash_Whl = 1'b0;
+  wire stall_Whl  = 1'b0;
 
-  wire inst_val_Whl = ( !bubble_Whl && !squash_Whl );
+  // Is each writeback port valid?
 
-  // Only set register file wen if stage is valid
+  wire inst_val_W0hl = ( !bubble_W0hl && !squash_Whl );
+  wire inst_val_W1hl = ( !bubble_W1hl && !squash_Whl );
+  wire inst_val_W2hl = ( !bubble_W2hl && !squash_Whl );
 
-  assign rf_wen_out_Whl = ( inst_val_Whl && !stall_Whl && rf_wen_Whl );
+  // Only set register file wen if the port is valid
 
-  // Dummy squahs and stall signals
+  assign rf_wen_out_W0hl = ( inst_val_W0hl && !stall_Whl && rf_wen_W0hl );
+  assign rf_wen_out_W1hl = ( inst_val_W1hl && !stall_Whl && rf_wen_W1hl );
+  assign rf_wen_out_W2hl = ( inst_val_W2hl && !stall_Whl && rf_wen_W2hl );
 
-  wire squash_Whl = 1'b0;
-  wire stall_Whl  = 1'b0;
-  
   //----------------------------------------------------------------------
   // Reorder Buffer
   //----------------------------------------------------------------------
 
-  wire rob_req_val_Dhl = inst_val_Dhl && !stall_Dhl && rf_wen_Dhl;
-  wire rob_fill_val = inst_val_Whl && rf_wen_Whl;
-
-  wire rob_req_rdy_Dhl;
-
-  wire       rob_fill_wen_Whl = inst_val_Whl && rf_wen_Whl;
+  wire rob_req_val_Dhl = inst_val_Dhl && !stall_Dhl && prf_wen_Dhl;
 
   wire [3:0] rob_commit_slot_Chl;
-  wire       rob_commit_wen_Chl;
-  wire [4:0] rob_commit_waddr_Chl;
 
   parc_CoreReorderBuffer rob
   (
@@ -970,25 +1161,41 @@ module parc_CoreCtrl
     .reset                     (reset),
     .rob_alloc_req_val         (rob_req_val_Dhl),
     .rob_alloc_req_rdy         (rob_req_rdy_Dhl),
-    .rob_alloc_req_preg        (rf_waddr_Dhl),
+    .rob_alloc_req_areg        (rf_waddr_Dhl),
+    .rob_alloc_req_preg        (prf_waddr_Dhl),
+    .rob_alloc_req_old_preg    (prf_old_waddr_Dhl),
     .rob_alloc_resp_slot       (rob_fill_slot_Dhl),
-    .rob_fill_val              (rob_fill_wen_Whl),
-    .rob_fill_slot             (rob_fill_slot_Whl),
+    .rob_fill0_val             (rf_wen_out_W0hl),
+    .rob_fill0_slot            (rob_fill_slot_W0hl),
+    .rob_fill1_val             (rf_wen_out_W1hl),
+    .rob_fill1_slot            (rob_fill_slot_W1hl),
+    .rob_fill2_val             (rf_wen_out_W2hl),
+    .rob_fill2_slot            (rob_fill_slot_W2hl),
     .rob_commit_slot           (rob_commit_slot_Chl),
     .rob_commit_wen            (rob_commit_wen_Chl),
-    .rob_commit_rf_waddr       (rob_commit_waddr_Chl)
+    .rob_commit_areg           (rob_commit_areg_Chl),
+    .rob_commit_preg           (rob_commit_preg_Chl),
+    .rob_commit_old_preg       (rob_commit_old_preg_Chl)
   );
 
   //----------------------------------------------------------------------
   // Debug registers for instruction disassembly
   //----------------------------------------------------------------------
 
-  reg [31:0] ir_debug;
-  reg        inst_val_debug;
+  reg [31:0] ir_debug0;
+  reg        inst_val_debug0;
+  reg [31:0] ir_debug1;
+  reg        inst_val_debug1;
+  reg [31:0] ir_debug2;
+  reg        inst_val_debug2;
 
   always @ ( posedge clk ) begin
-    ir_debug       <= ir_Whl;
-    inst_val_debug <= inst_val_Whl;
+    ir_debug0       <= ir_W0hl;
+    inst_val_debug0 <= inst_val_W0hl;
+    ir_debug1       <= ir_W1hl;
+    inst_val_debug1 <= inst_val_W1hl;
+    ir_debug2       <= ir_W2hl;
+    inst_val_debug2 <= inst_val_W2hl;
   end
 
   //----------------------------------------------------------------------
@@ -999,8 +1206,8 @@ module parc_CoreCtrl
   reg         cp0_stats;
 
   always @ ( posedge clk ) begin
-    if ( cp0_wen_Whl && inst_val_Whl ) begin
-      case ( cp0_addr_Whl )
+    if ( cp0_wen_W0hl && inst_val_W0hl ) begin
+      case ( cp0_addr_W0hl )
         5'd10 : cp0_stats  <= proc2cop_data_Whl[0];
         5'd21 : cp0_status <= proc2cop_data_Whl;
       endcase
@@ -1028,14 +1235,34 @@ module parc_CoreCtrl
     .msg ( ir_Mhl )
   );
 
-  parc_InstMsgDisasm inst_msg_disasm_W
+  parc_InstMsgDisasm inst_msg_disasm_W0
+  (
+    .msg ( ir_W0hl )
+  );
+
+  parc_InstMsgDisasm inst_msg_disasm_W1
   (
-    .msg ( ir_Whl )
+    .msg ( ir_W1hl )
   );
 
-  parc_InstMsgDisasm inst_msg_disasm_debug
+  parc_InstMsgDisasm inst_msg_disasm_W2
   (
-    .msg ( ir_debug )
+    .msg ( ir_W2hl )
+  );
+
+  parc_InstMsgDisasm inst_msg_disasm_debug0
+  (
+    .msg ( ir_debug0 )
+  );
+
+  parc_InstMsgDisasm inst_msg_disasm_debug1
+  (
+    .msg ( ir_debug1 )
+  );
+
+  parc_InstMsgDisasm inst_msg_disasm_debug2
+  (
+    .msg ( ir_debug2 )
   );
 
   `endif
@@ -1075,6 +1302,10 @@ module parc_CoreCtrl
 
   reg [31:0] num_inst    = 32'b0;
   reg [31:0] num_cycles  = 32'b0;
+  reg [31:0] num_br      = 32'b0;
+  reg [31:0] num_br_miss = 32'b0;
+  reg [31:0] num_ras_hit  = 32'b0;
+  reg [31:0] num_ras_miss = 32'b0;
   reg        stats_en    = 1'b0; // Used for enabling stats on asm tests
 
   always @( posedge clk ) begin
@@ -1091,6 +1322,24 @@ module parc_CoreCtrl
           num_inst = num_inst + 1;
         end
 
+        // Count branches and direct jumps as they resolve, and those
+        // the predictor got wrong
+
+        if ( bp_update_val_Xhl ) begin
+          num_br = num_br + 1;
+          if ( bp_update_taken_Xhl != pred_taken_Xhl )
+            num_br_miss = num_br_miss + 1;
+        end
+
+        // Count returns as they leave D, and whether the RAS was right
+
+        if ( inst_val_Dhl && !stall_Dhl && ras_ret_Dhl ) begin
+          if ( ras_targ_match_Dhl )
+            num_ras_hit = num_ras_hit + 1;
+          else
+            num_ras_miss = num_ras_miss + 1;
+        end
+
       end
 
     end
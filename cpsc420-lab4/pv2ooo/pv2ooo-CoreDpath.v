@@ -9,6 +9,8 @@
 `include "pv2ooo-InstMsg.v"
 `include "pv2ooo-CoreDpathAlu.v"
 `include "pv2ooo-CoreDpathRegfile.v"
+`include "pv2ooo-CoreDpathBranchPred.v"
+`include "pv2ooo-CoreDpathReturnStack.v"
 
 module parc_CoreDpath
 (
@@ -27,12 +29,12 @@ module parc_CoreDpath
 
   // Controls Signals (ctrl->dpath)
 
-  input   [1:0] pc_mux_sel_Phl,
+  input   [2:0] pc_mux_sel_Phl,
+  input   [5:0] rf_raddr0_Dhl,
+  input   [5:0] rf_raddr1_Dhl,
   input   [2:0] op0_byp_mux_sel_Dhl,
-  input   [3:0] op0_byp_rob_slot_Dhl,
   input   [1:0] op0_mux_sel_Dhl,
   input   [2:0] op1_byp_mux_sel_Dhl,
-  input   [3:0] op1_byp_rob_slot_Dhl,
   input   [2:0] op1_mux_sel_Dhl,
   input  [31:0] inst_Dhl,
   input   [3:0] alu_fn_Xhl,
@@ -42,29 +44,37 @@ module parc_CoreDpath
   output        muldivresp_val,
   input         muldivresp_rdy,
   input         muldiv_mux_sel_X3hl,
+  output        divresp_val,
+  input         divresp_rdy,
+  input         div_mux_sel,
   input   [2:0] dmemresp_mux_sel_Mhl,
   input         dmemresp_queue_en_Mhl,
   input         dmemresp_queue_val_Mhl,
-  input   [1:0] wb_mux_sel_Whl,
-  input         rf_wen_Whl,
-  input  [ 4:0] rf_waddr_Whl,
+  input         rf_wen_W0hl,
+  input  [ 5:0] rf_waddr_W0hl,
+  input         rf_wen_W1hl,
+  input  [ 5:0] rf_waddr_W1hl,
+  input         rf_wen_W2hl,
+  input  [ 5:0] rf_waddr_W2hl,
+  input         bp_update_val_Xhl,
+  input         bp_update_taken_Xhl,
+  input         bp_update_jump_Xhl,
+  input         ras_push_Fhl,
+  input         ras_pop_Fhl,
+  input         ras_repair_Xhl,
   input         stall_Fhl,
   input         stall_Dhl,
   input         stall_Xhl,
   input         stall_Mhl,
   input         stall_Whl,
 
-  input         rob_fill_wen_Whl,
-  input  [ 3:0] rob_fill_slot_Whl,
-  input         rob_commit_wen_Chl,
-  input  [ 3:0] rob_commit_slot_Chl,
-  input  [ 4:0] rob_commit_waddr_Chl,
-
   // Control Signals (dpath->ctrl)
 
   output        branch_cond_eq_Xhl,
   output        branch_cond_zero_Xhl,
   output        branch_cond_neg_Xhl,
+  output        pred_taken_Fhl,
+  output        ras_targ_match_Dhl,
   output [31:0] proc2cop_data_Whl
 );
 
@@ -78,6 +88,9 @@ module parc_CoreDpath
   wire [31:0] branch_targ_Phl;
   wire [31:0] jump_targ_Phl;
   wire [31:0] jumpreg_targ_Phl;
+  wire [31:0] pred_targ_Phl;
+  wire [31:0] fallthru_Phl;
+  wire [31:0] ras_targ_Phl;
   wire [31:0] pc_mux_out_Phl;
 
   wire [31:0] reset_vector = 32'h00080000;
@@ -88,12 +101,18 @@ module parc_CoreDpath
   assign branch_targ_Phl    = branch_targ_Xhl;
   assign jump_targ_Phl      = jump_targ_Dhl;
   assign jumpreg_targ_Phl   = jumpreg_targ_Dhl;
+  assign pred_targ_Phl      = pred_targ_Fhl;
+  assign fallthru_Phl       = pc_plus4_Xhl;
+  assign ras_targ_Phl       = ras_targ_Fhl;
 
   assign pc_mux_out_Phl
-    = ( pc_mux_sel_Phl == 2'd0 ) ? pc_plus4_Phl
-    : ( pc_mux_sel_Phl == 2'd1 ) ? branch_targ_Phl
-    : ( pc_mux_sel_Phl == 2'd2 ) ? jump_targ_Phl
-    : ( pc_mux_sel_Phl == 2'd3 ) ? jumpreg_targ_Phl
+    = ( pc_mux_sel_Phl == 3'd0 ) ? pc_plus4_Phl
+    : ( pc_mux_sel_Phl == 3'd1 ) ? branch_targ_Phl
+    : ( pc_mux_sel_Phl == 3'd2 ) ? jump_targ_Phl
+    : ( pc_mux_sel_Phl == 3'd3 ) ? jumpreg_targ_Phl
+    : ( pc_mux_sel_Phl == 3'd4 ) ? pred_targ_Phl
+    : ( pc_mux_sel_Phl == 3'd5 ) ? fallthru_Phl
+    : ( pc_mux_sel_Phl == 3'd6 ) ? ras_targ_Phl
     :                              32'bx;
 
   // Send out imem request early
@@ -127,17 +146,63 @@ module parc_CoreDpath
 
   assign pc_plus4_Fhl = pc_Fhl + 32'd4;
 
+  // Branch predictor, looked up with the fetch pc and updated with each
+  // branch or direct jump as it resolves in X
+
+  wire [31:0] pred_targ_Fhl;
+
+  parc_CoreDpathBranchPred bpred
+  (
+    .clk          (clk),
+    .reset        (reset),
+    .pc           (pc_Fhl),
+    .pred_taken   (pred_taken_Fhl),
+    .pred_targ    (pred_targ_Fhl),
+    .update_val   (bp_update_val_Xhl),
+    .update_pc    (pc_Xhl),
+    .update_taken (bp_update_taken_Xhl),
+    .update_targ  (bp_update_jump_Xhl ? jump_targ_Xhl : branch_targ_Xhl)
+  );
+
+  // Return address stack, pushed and popped by calls and returns in F
+  // and repaired from the checkpoint of a branch mispredicted in X
+
+  wire [31:0] ras_targ_Fhl;
+  wire  [2:0] ras_tos_Fhl;
+  wire [31:0] ras_top_Fhl;
+
+  parc_CoreDpathReturnStack ras
+  (
+    .clk        (clk),
+    .reset      (reset),
+    .push       (ras_push_Fhl),
+    .push_addr  (pc_plus4_Fhl),
+    .pop        (ras_pop_Fhl),
+    .top        (ras_targ_Fhl),
+    .ckpt_tos   (ras_tos_Fhl),
+    .ckpt_top   (ras_top_Fhl),
+    .repair     (ras_repair_Xhl),
+    .repair_tos (ras_tos_Xhl),
+    .repair_top (ras_top_Xhl)
+  );
+
   //----------------------------------------------------------------------
   // D <- F
   //----------------------------------------------------------------------
 
   reg [31:0] pc_Dhl;
   reg [31:0] pc_plus4_Dhl;
+  reg [31:0] ras_targ_Dhl;
+  reg  [2:0] ras_tos_Dhl;
+  reg [31:0] ras_top_Dhl;
 
   always @ (posedge clk) begin
     if( !stall_Dhl ) begin
       pc_Dhl       <= pc_Fhl;
       pc_plus4_Dhl <= pc_plus4_Fhl;
+      ras_targ_Dhl <= ras_targ_Fhl;
+      ras_tos_Dhl  <= ras_tos_Fhl;
+      ras_top_Dhl  <= ras_top_Fhl;
     end
   end
 
@@ -177,11 +242,10 @@ module parc_CoreDpath
   assign branch_targ_Dhl = pc_plus4_Dhl + (imm_sext_Dhl << 2);
   assign jump_targ_Dhl   = { pc_plus4_Dhl[31:28], inst_target_Dhl, 2'b0 };
 
-  // Register file
+  // Register file, read at the physical registers rs and rt are
+  // renamed to
 
-  wire [ 4:0] rf_raddr0_Dhl = inst_rs_Dhl;
   wire [31:0] rf_rdata0_Dhl;
-  wire [ 4:0] rf_raddr1_Dhl = inst_rt_Dhl;
   wire [31:0] rf_rdata1_Dhl;
 
   // Jump reg address
@@ -190,6 +254,10 @@ module parc_CoreDpath
 
   assign jumpreg_targ_Dhl  = op0_byp_mux_out_Dhl;
 
+  // Check a return against the target the RAS predicted in F
+
+  assign ras_targ_match_Dhl = ( jumpreg_targ_Dhl == ras_targ_Dhl );
+
   // Zero and sign extension immediate
 
   wire [31:0] imm_sext_Dhl = { {16{inst_imm_sign_Dhl}}, inst_imm_Dhl };
@@ -211,8 +279,9 @@ module parc_CoreDpath
     : ( op0_byp_mux_sel_Dhl == 3'd1 ) ? alu_out_Xhl
     : ( op0_byp_mux_sel_Dhl == 3'd2 ) ? dmemresp_queue_mux_out_Mhl
     : ( op0_byp_mux_sel_Dhl == 3'd3 ) ? muldiv_mux_out_X3hl
-    : ( op0_byp_mux_sel_Dhl == 3'd4 ) ? wb_mux_out_Whl
-    : ( op0_byp_mux_sel_Dhl == 3'd5 ) ? rob_data[op0_byp_rob_slot_Dhl]
+    : ( op0_byp_mux_sel_Dhl == 3'd4 ) ? alu_out_W0hl
+    : ( op0_byp_mux_sel_Dhl == 3'd5 ) ? dmemresp_out_W1hl
+    : ( op0_byp_mux_sel_Dhl == 3'd6 ) ? muldiv_out_W2hl
     :                                   32'bx;
 
   // Operand 0 mux
@@ -231,8 +300,9 @@ module parc_CoreDpath
     : ( op1_byp_mux_sel_Dhl == 3'd1 ) ? alu_out_Xhl
     : ( op1_byp_mux_sel_Dhl == 3'd2 ) ? dmemresp_queue_mux_out_Mhl
     : ( op1_byp_mux_sel_Dhl == 3'd3 ) ? muldiv_mux_out_X3hl
-    : ( op1_byp_mux_sel_Dhl == 3'd4 ) ? wb_mux_out_Whl
-    : ( op1_byp_mux_sel_Dhl == 3'd5 ) ? rob_data[op1_byp_rob_slot_Dhl]
+    : ( op1_byp_mux_sel_Dhl == 3'd4 ) ? alu_out_W0hl
+    : ( op1_byp_mux_sel_Dhl == 3'd5 ) ? dmemresp_out_W1hl
+    : ( op1_byp_mux_sel_Dhl == 3'd6 ) ? muldiv_out_W2hl
     :                                   32'bx;
 
   // Operand 1 mux
@@ -254,7 +324,11 @@ module parc_CoreDpath
   //----------------------------------------------------------------------
 
   reg [31:0] pc_Xhl;
+  reg [31:0] pc_plus4_Xhl;
   reg [31:0] branch_targ_Xhl;
+  reg [31:0] jump_targ_Xhl;
+  reg  [2:0] ras_tos_Xhl;
+  reg [31:0] ras_top_Xhl;
   reg [31:0] op0_mux_out_Xhl;
   reg [31:0] op1_mux_out_Xhl;
   reg [31:0] wdata_Xhl;
@@ -262,7 +336,11 @@ module parc_CoreDpath
   always @ (posedge clk) begin
     if( !stall_Xhl ) begin
       pc_Xhl          <= pc_Dhl;
+      pc_plus4_Xhl    <= pc_plus4_Dhl;
       branch_targ_Xhl <= branch_targ_Dhl;
+      jump_targ_Xhl   <= jump_targ_Dhl;
+      ras_tos_Xhl     <= ras_tos_Dhl;
+      ras_top_Xhl     <= ras_top_Dhl;
       op0_mux_out_Xhl <= op0_mux_out_Dhl;
       op1_mux_out_Xhl <= op1_mux_out_Dhl;
       wdata_Xhl       <= wdata_Dhl;
@@ -299,6 +377,7 @@ module parc_CoreDpath
   // Muldiv Unit
 
   wire [63:0] muldivresp_msg_result_X3hl;
+  wire [63:0] divresp_msg_result;
 
   parc_CoreDpathPipeMulDiv muldiv
   (
@@ -312,7 +391,10 @@ module parc_CoreDpath
     .muldivreq_rdy         (muldivreq_rdy),
     .muldivresp_msg_result (muldivresp_msg_result_X3hl),
     .muldivresp_val        (muldivresp_val),
-    .muldivresp_rdy        (muldivresp_rdy)
+    .muldivresp_rdy        (muldivresp_rdy),
+    .divresp_msg_result    (divresp_msg_result),
+    .divresp_val           (divresp_val),
+    .divresp_rdy           (divresp_rdy)
   );
 
   // Muldiv Result Mux
@@ -322,6 +404,27 @@ module parc_CoreDpath
     : ( muldiv_mux_sel_X3hl == 1'd1 ) ? muldivresp_msg_result_X3hl[63:32]
     :                                   32'bx;
 
+  // Divider Result Mux
+
+  wire [31:0] div_mux_out
+    = ( div_mux_sel == 1'd0 ) ? divresp_msg_result[31:0]
+    : ( div_mux_sel == 1'd1 ) ? divresp_msg_result[63:32]
+    :                           32'bx;
+
+  // The divider result goes to W2 in a cycle with no multiply in X3
+
+  wire divresp_go = divresp_val && divresp_rdy;
+
+  // PC of the divide in the divider, for the debug trace
+
+  reg [31:0] pc_div;
+
+  always @ ( posedge clk ) begin
+    if ( muldivreq_val && muldivreq_rdy
+         && ( muldivreq_msg_fn_Dhl != `IMULDIV_MULDIVREQ_MSG_FUNC_MUL ) )
+      pc_div <= pc_Dhl;
+  end
+
   //----------------------------------------------------------------------
   // M <- X
   //----------------------------------------------------------------------
@@ -405,40 +508,27 @@ module parc_CoreDpath
   end
 
   //----------------------------------------------------------------------
-  // W <- M
+  // W <- *
   //----------------------------------------------------------------------
+  // Each functional unit has its own writeback register: W0 takes ALU
+  // results from X, W1 load data from M and W2 multiply results from X3
+  // or divider results.
 
-  reg  [31:0] pc_Whl;
-  reg  [31:0] wb_mux_out_Whl;
-
-  reg  [31:0] next_pc_Whl;
-  reg  [31:0] next_wb_mux_out_Whl;
-
-  always @(*) begin
-    case(wb_mux_sel_Whl)
-    2'd1: begin
-      next_pc_Whl                 = pc_Xhl;
-      next_wb_mux_out_Whl         = alu_out_Xhl;
-    end
-    2'd2: begin
-      next_pc_Whl                 = pc_Mhl;
-      next_wb_mux_out_Whl         = dmemresp_queue_mux_out_Mhl;
-    end
-    2'd3: begin
-      next_pc_Whl                 = pc_X3hl;
-      next_wb_mux_out_Whl         = muldiv_mux_out_X3hl;
-    end
-    default: begin
-      next_pc_Whl                 = 32'b0;
-      next_wb_mux_out_Whl         = 32'b0;
-    end
-    endcase
-  end
+  reg  [31:0] pc_W0hl;
+  reg  [31:0] alu_out_W0hl;
+  reg  [31:0] pc_W1hl;
+  reg  [31:0] dmemresp_out_W1hl;
+  reg  [31:0] pc_W2hl;
+  reg  [31:0] muldiv_out_W2hl;
 
   always @(posedge clk) begin
     if( !stall_Whl ) begin
-      pc_Whl         <= next_pc_Whl;
-      wb_mux_out_Whl <= next_wb_mux_out_Whl;
+      pc_W0hl           <= pc_Xhl;
+      alu_out_W0hl      <= alu_out_Xhl;
+      pc_W1hl           <= pc_Mhl;
+      dmemresp_out_W1hl <= dmemresp_queue_mux_out_Mhl;
+      pc_W2hl           <= divresp_go ? pc_div      : pc_X3hl;
+      muldiv_out_W2hl   <= divresp_go ? div_mux_out : muldiv_mux_out_X3hl;
     end
   end
 
@@ -446,45 +536,43 @@ module parc_CoreDpath
   // Writeback Stage
   //----------------------------------------------------------------------
 
-  // CP0 write data
+  // CP0 write data; mtc0 goes through the ALU
 
-  assign proc2cop_data_Whl = wb_mux_out_Whl;
+  assign proc2cop_data_Whl = alu_out_W0hl;
 
-  wire [31:0] rf_wdata_Chl = rob_data[rob_commit_slot_Chl];
-  wire [ 4:0] rf_waddr_Chl = rob_commit_waddr_Chl;
-  wire        rf_wen_Chl   = rob_commit_wen_Chl;
+  // Results are written to their physical register as soon as they are
+  // ready; the ROB only decides when the architectural mapping moves
 
   parc_CoreDpathRegfile rfile
   (
-    .clk     (clk),
-    .raddr0  (rf_raddr0_Dhl),
-    .rdata0  (rf_rdata0_Dhl),
-    .raddr1  (rf_raddr1_Dhl),
-    .rdata1  (rf_rdata1_Dhl),
-    .wen_p   (rf_wen_Whl),
-    .waddr_p (rf_waddr_Whl),
-    .wdata_p (wb_mux_out_Whl)
+    .clk      (clk),
+    .raddr0   (rf_raddr0_Dhl),
+    .rdata0   (rf_rdata0_Dhl),
+    .raddr1   (rf_raddr1_Dhl),
+    .rdata1   (rf_rdata1_Dhl),
+    .wen0_p   (rf_wen_W0hl),
+    .waddr0_p (rf_waddr_W0hl),
+    .wdata0_p (alu_out_W0hl),
+    .wen1_p   (rf_wen_W1hl),
+    .waddr1_p (rf_waddr_W1hl),
+    .wdata1_p (dmemresp_out_W1hl),
+    .wen2_p   (rf_wen_W2hl),
+    .waddr2_p (rf_waddr_W2hl),
+    .wdata2_p (muldiv_out_W2hl)
   );
 
-  //----------------------------------------------------------------------
-  // Commit Stage
-  //----------------------------------------------------------------------
-
-  reg [31:0] rob_data [15:0];
-
-  always @(posedge clk) begin
-    if (rob_fill_wen_Whl)
-      rob_data[rob_fill_slot_Whl] <= wb_mux_out_Whl;
-  end
-
   //----------------------------------------------------------------------
   // Debug registers for instruction disassembly
   //----------------------------------------------------------------------
 
-  reg [31:0] pc_debug;
+  reg [31:0] pc_debug0;
+  reg [31:0] pc_debug1;
+  reg [31:0] pc_debug2;
 
   always @ ( posedge clk ) begin
-    pc_debug <= pc_Whl;
+    pc_debug0 <= pc_W0hl;
+    pc_debug1 <= pc_W1hl;
+    pc_debug2 <= pc_W2hl;
   end
 
 endmodule
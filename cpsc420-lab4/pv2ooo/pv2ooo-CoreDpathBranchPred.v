@@ -0,0 +1,108 @@
+//=========================================================================
+// 5-Stage PARC Branch Predictor
+//=========================================================================
+// Looked up with the fetch pc. A branch target buffer says whether the
+// instruction there is a taken branch or jump seen before and where it
+// went; a branch history table of 2-bit saturating counters says whether
+// to follow it this time. The prediction is taken only if the BTB hits
+// and the counter is in one of its two taken states.
+//
+// Both tables are updated once per resolved branch or direct jump. The
+// counter moves toward the outcome, and a taken outcome (re)writes the
+// BTB entry with its target. A not-taken branch leaves its BTB entry, so
+// only the counter has to flip back for it to be predicted taken again.
+
+`ifndef PARC_CORE_DPATH_BRANCHPRED_V
+`define PARC_CORE_DPATH_BRANCHPRED_V
+
+module parc_CoreDpathBranchPred
+#(
+  parameter BHT_ENTRIES = 256,
+  parameter BHT_ADDR_SZ = 8,
+  parameter BTB_ENTRIES = 32,
+  parameter BTB_ADDR_SZ = 5
+)(
+  input         clk,
+  input         reset,
+
+  // Lookup (combinational on pc)
+
+  input  [31:0] pc,
+  output        pred_taken,
+  output [31:0] pred_targ,
+
+  // Update (sample on rising clk edge)
+
+  input         update_val,
+  input  [31:0] update_pc,
+  input         update_taken,
+  input  [31:0] update_targ
+);
+
+  localparam TAG_SZ = 30 - BTB_ADDR_SZ;
+
+  reg  [1:0]        bht       [BHT_ENTRIES-1:0];
+  reg               btb_valid [BTB_ENTRIES-1:0];
+  reg  [TAG_SZ-1:0] btb_tag   [BTB_ENTRIES-1:0];
+  reg  [31:0]       btb_targ  [BTB_ENTRIES-1:0];
+
+  // Both tables are indexed with word address bits
+
+  wire [BHT_ADDR_SZ-1:0] bht_idx    = pc[BHT_ADDR_SZ+1:2];
+  wire [BTB_ADDR_SZ-1:0] btb_idx    = pc[BTB_ADDR_SZ+1:2];
+  wire [TAG_SZ-1:0]      btb_pc_tag = pc[31:BTB_ADDR_SZ+2];
+
+  wire [BHT_ADDR_SZ-1:0] bht_update_idx = update_pc[BHT_ADDR_SZ+1:2];
+  wire [BTB_ADDR_SZ-1:0] btb_update_idx = update_pc[BTB_ADDR_SZ+1:2];
+  wire [TAG_SZ-1:0]      btb_update_tag = update_pc[31:BTB_ADDR_SZ+2];
+
+  // Lookup
+
+  wire btb_hit = btb_valid[btb_idx] && ( btb_tag[btb_idx] == btb_pc_tag );
+
+  assign pred_taken = btb_hit && bht[bht_idx][1];
+  assign pred_targ  = btb_targ[btb_idx];
+
+  // Saturating counter update
+
+  wire [1:0] counter = bht[bht_update_idx];
+
+  wire [1:0] counter_next
+    = (  update_taken && ( counter != 2'b11 ) ) ? counter + 1'b1
+    : ( !update_taken && ( counter != 2'b00 ) ) ? counter - 1'b1
+    :                                             counter;
+
+  genvar i;
+  generate
+
+  // Counters start out weakly not taken
+
+  for( i = 0; i < BHT_ENTRIES; i = i + 1)
+  begin: bht_entry
+    always @(posedge clk) begin
+      if (reset)
+        bht[i] <= 2'b01;
+      else if ( update_val && (i == bht_update_idx) )
+        bht[i] <= counter_next;
+    end
+  end
+
+  for( i = 0; i < BTB_ENTRIES; i = i + 1)
+  begin: btb_entry
+    always @(posedge clk) begin
+      if (reset) begin
+        btb_valid[i] <= 1'b0;
+      end else if ( update_val && update_taken && (i == btb_update_idx) ) begin
+        btb_valid[i] <= 1'b1;
+        btb_tag[i]   <= btb_update_tag;
+        btb_targ[i]  <= update_targ;
+      end
+    end
+  end
+
+  endgenerate
+
+endmodule
+
+`endif
+
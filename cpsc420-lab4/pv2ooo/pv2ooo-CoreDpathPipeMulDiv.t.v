@@ -3,7 +3,7 @@
 //========================================================================
 
 `include "imuldiv-MulDivReqMsg.v"
-`include "pv2dualfetch-CoreDpathPipeMulDiv.v"
+`include "pv2ooo-CoreDpathPipeMulDiv.v"
 `include "vc-TestRandDelaySource.v"
 `include "vc-TestRandDelaySink.v"
 `include "vc-Test.v"
@@ -27,12 +27,17 @@ module parc_CoreDpathPipeMulDiv_helper
   wire        src_rdy;
   wire        src_done;
 
-  wire [63:0] sink_msg;
-  wire        sink_val;
-  wire        sink_rdy;
-  wire        sink_done;
+  wire [63:0] mulsink_msg;
+  wire        mulsink_val;
+  wire        mulsink_rdy;
+  wire        mulsink_done;
 
-  assign done = src_done && sink_done;
+  wire [63:0] divsink_msg;
+  wire        divsink_val;
+  wire        divsink_rdy;
+  wire        divsink_done;
+
+  assign done = src_done && mulsink_done && divsink_done;
 
   vc_TestRandDelaySource#(67,1024,3) src
   (
@@ -64,19 +69,34 @@ module parc_CoreDpathPipeMulDiv_helper
     .muldivreq_msg_b       (src_msg_b),
     .muldivreq_val         (src_val),
     .muldivreq_rdy         (src_rdy),
-    .muldivresp_msg_result (sink_msg),
-    .muldivresp_val        (sink_val),
-    .muldivresp_rdy        (sink_rdy)
+    .muldivresp_msg_result (mulsink_msg),
+    .muldivresp_val        (mulsink_val),
+    .muldivresp_rdy        (mulsink_rdy),
+    .divresp_msg_result    (divsink_msg),
+    .divresp_val           (divsink_val),
+    .divresp_rdy           (divsink_rdy)
+  );
+
+  // Multiplies and divides respond on separate ports, each in order
+
+  vc_TestRandDelaySink#(64,1024,3) mulsink
+  (
+    .clk   (clk),
+    .reset (reset),
+    .msg   (mulsink_msg),
+    .val   (mulsink_val),
+    .rdy   (mulsink_rdy),
+    .done  (mulsink_done)
   );
 
-  vc_TestRandDelaySink#(64,1024,3) sink
+  vc_TestRandDelaySink#(64,1024,3) divsink
   (
     .clk   (clk),
     .reset (reset),
-    .msg   (sink_msg),
-    .val   (sink_val),
-    .rdy   (sink_rdy),
-    .done  (sink_done)
+    .msg   (divsink_msg),
+    .val   (divsink_val),
+    .rdy   (divsink_rdy),
+    .done  (divsink_done)
   );
 
 endmodule
@@ -95,6 +115,10 @@ module tester;
 
   `VC_TEST_SUITE_BEGIN( "parc-CoreDpathPipeMulDiv" )
 
+  //----------------------------------------------------------------------
+  // mul
+  //----------------------------------------------------------------------
+
   reg  t0_reset = 1'b1;
   wire t0_done;
 
@@ -108,16 +132,16 @@ module tester;
   `VC_TEST_CASE_BEGIN( 1, "mul" )
   begin
 
-    t0.src.src.m[0] = 67'h0_00000000_00000000; t0.sink.sink.m[0] = 64'h00000000_00000000;
-    t0.src.src.m[1] = 67'h0_00000001_00000001; t0.sink.sink.m[1] = 64'h00000000_00000001;
-    t0.src.src.m[2] = 67'h0_ffffffff_00000001; t0.sink.sink.m[2] = 64'hffffffff_ffffffff;
-    t0.src.src.m[3] = 67'h0_00000001_ffffffff; t0.sink.sink.m[3] = 64'hffffffff_ffffffff;
-    t0.src.src.m[4] = 67'h0_ffffffff_ffffffff; t0.sink.sink.m[4] = 64'h00000000_00000001;
-    t0.src.src.m[5] = 67'h0_00000008_00000003; t0.sink.sink.m[5] = 64'h00000000_00000018;
-    t0.src.src.m[6] = 67'h0_fffffff8_00000008; t0.sink.sink.m[6] = 64'hffffffff_ffffffc0;
-    t0.src.src.m[7] = 67'h0_fffffff8_fffffff8; t0.sink.sink.m[7] = 64'h00000000_00000040;
-    t0.src.src.m[8] = 67'h0_0deadbee_10000000; t0.sink.sink.m[8] = 64'h00deadbe_e0000000;
-    t0.src.src.m[9] = 67'h0_deadbeef_10000000; t0.sink.sink.m[9] = 64'hfdeadbee_f0000000;
+    t0.src.src.m[0] = 67'h0_00000000_00000000; t0.mulsink.sink.m[0] = 64'h00000000_00000000;
+    t0.src.src.m[1] = 67'h0_00000001_00000001; t0.mulsink.sink.m[1] = 64'h00000000_00000001;
+    t0.src.src.m[2] = 67'h0_ffffffff_00000001; t0.mulsink.sink.m[2] = 64'hffffffff_ffffffff;
+    t0.src.src.m[3] = 67'h0_00000001_ffffffff; t0.mulsink.sink.m[3] = 64'hffffffff_ffffffff;
+    t0.src.src.m[4] = 67'h0_ffffffff_ffffffff; t0.mulsink.sink.m[4] = 64'h00000000_00000001;
+    t0.src.src.m[5] = 67'h0_00000008_00000003; t0.mulsink.sink.m[5] = 64'h00000000_00000018;
+    t0.src.src.m[6] = 67'h0_fffffff8_00000008; t0.mulsink.sink.m[6] = 64'hffffffff_ffffffc0;
+    t0.src.src.m[7] = 67'h0_fffffff8_fffffff8; t0.mulsink.sink.m[7] = 64'h00000000_00000040;
+    t0.src.src.m[8] = 67'h0_0deadbee_10000000; t0.mulsink.sink.m[8] = 64'h00deadbe_e0000000;
+    t0.src.src.m[9] = 67'h0_deadbeef_10000000; t0.mulsink.sink.m[9] = 64'hfdeadbee_f0000000;
 
     #5;   t0_reset = 1'b1;
     #20;  t0_reset = 1'b0;
@@ -126,75 +150,154 @@ module tester;
   end
   `VC_TEST_CASE_END
 
+  //----------------------------------------------------------------------
+  // div/rem
+  //----------------------------------------------------------------------
+
+  reg  t1_reset = 1'b1;
+  wire t1_done;
+
+  parc_CoreDpathPipeMulDiv_helper t1
+  (
+    .clk   (clk),
+    .reset (t1_reset),
+    .done  (t1_done)
+  );
+
   `VC_TEST_CASE_BEGIN( 2, "div/rem" )
   begin
 
-    t0.src.src.m[ 0] = 67'h1_00000000_00000001; t0.sink.sink.m[ 0] = 64'h00000000_00000000;
-    t0.src.src.m[ 1] = 67'h1_00000001_00000001; t0.sink.sink.m[ 1] = 64'h00000000_00000001;
-    t0.src.src.m[ 2] = 67'h1_00000000_ffffffff; t0.sink.sink.m[ 2] = 64'h00000000_00000000;
-    t0.src.src.m[ 3] = 67'h1_ffffffff_ffffffff; t0.sink.sink.m[ 3] = 64'h00000000_00000001;
-    t0.src.src.m[ 4] = 67'h1_00000222_0000002a; t0.sink.sink.m[ 4] = 64'h00000000_0000000d;
-    t0.src.src.m[ 5] = 67'h1_0a01b044_ffffb146; t0.sink.sink.m[ 5] = 64'h00000000_ffffdf76;
-    t0.src.src.m[ 6] = 67'h3_00000032_00000222; t0.sink.sink.m[ 6] = 64'h00000032_00000000;
-    t0.src.src.m[ 7] = 67'h3_00000222_00000032; t0.sink.sink.m[ 7] = 64'h0000002e_0000000a;
-    t0.src.src.m[ 8] = 67'h3_0a01b044_ffffb14a; t0.sink.sink.m[ 8] = 64'h00003372_ffffdf75;
-    t0.src.src.m[ 9] = 67'h3_deadbeef_0000beef; t0.sink.sink.m[ 9] = 64'hffffda72_ffffd353;
-    t0.src.src.m[10] = 67'h3_f5fe4fbc_00004eb6; t0.sink.sink.m[10] = 64'hffffcc8e_ffffdf75;
-    t0.src.src.m[11] = 67'h3_f5fe4fbc_ffffb14a; t0.sink.sink.m[11] = 64'hffffcc8e_0000208b;
-
-    #5;   t0_reset = 1'b1;
-    #20;  t0_reset = 1'b0;
-    #10000; `VC_TEST_CHECK( "Is sink finished?", t0_done )
+    t1.src.src.m[ 0] = 67'h1_00000000_00000001; t1.divsink.sink.m[ 0] = 64'h00000000_00000000;
+    t1.src.src.m[ 1] = 67'h1_00000001_00000001; t1.divsink.sink.m[ 1] = 64'h00000000_00000001;
+    t1.src.src.m[ 2] = 67'h1_00000000_ffffffff; t1.divsink.sink.m[ 2] = 64'h00000000_00000000;
+    t1.src.src.m[ 3] = 67'h1_ffffffff_ffffffff; t1.divsink.sink.m[ 3] = 64'h00000000_00000001;
+    t1.src.src.m[ 4] = 67'h1_00000222_0000002a; t1.divsink.sink.m[ 4] = 64'h00000000_0000000d;
+    t1.src.src.m[ 5] = 67'h1_0a01b044_ffffb146; t1.divsink.sink.m[ 5] = 64'h00000000_ffffdf76;
+    t1.src.src.m[ 6] = 67'h3_00000032_00000222; t1.divsink.sink.m[ 6] = 64'h00000032_00000000;
+    t1.src.src.m[ 7] = 67'h3_00000222_00000032; t1.divsink.sink.m[ 7] = 64'h0000002e_0000000a;
+    t1.src.src.m[ 8] = 67'h3_0a01b044_ffffb14a; t1.divsink.sink.m[ 8] = 64'h00003372_ffffdf75;
+    t1.src.src.m[ 9] = 67'h3_deadbeef_0000beef; t1.divsink.sink.m[ 9] = 64'hffffda72_ffffd353;
+    t1.src.src.m[10] = 67'h3_f5fe4fbc_00004eb6; t1.divsink.sink.m[10] = 64'hffffcc8e_ffffdf75;
+    t1.src.src.m[11] = 67'h3_f5fe4fbc_ffffb14a; t1.divsink.sink.m[11] = 64'hffffcc8e_0000208b;
+
+    #5;   t1_reset = 1'b1;
+    #20;  t1_reset = 1'b0;
+    #10000; `VC_TEST_CHECK( "Is sink finished?", t1_done )
 
   end
   `VC_TEST_CASE_END
 
+  //----------------------------------------------------------------------
+  // divu/remu
+  //----------------------------------------------------------------------
+
+  reg  t2_reset = 1'b1;
+  wire t2_done;
+
+  parc_CoreDpathPipeMulDiv_helper t2
+  (
+    .clk   (clk),
+    .reset (t2_reset),
+    .done  (t2_done)
+  );
+
   `VC_TEST_CASE_BEGIN( 3, "divu/remu" )
   begin
 
-    t0.src.src.m[ 0] = 67'h2_00000000_00000001; t0.sink.sink.m[ 0] = 64'h00000000_00000000;
-    t0.src.src.m[ 1] = 67'h2_00000001_00000001; t0.sink.sink.m[ 1] = 64'h00000000_00000001;
-    t0.src.src.m[ 2] = 67'h2_00000000_ffffffff; t0.sink.sink.m[ 2] = 64'h00000000_00000000;
-    t0.src.src.m[ 3] = 67'h2_ffffffff_ffffffff; t0.sink.sink.m[ 3] = 64'h00000000_00000001;
-    t0.src.src.m[ 4] = 67'h2_00000222_0000002a; t0.sink.sink.m[ 4] = 64'h00000000_0000000d;
-    t0.src.src.m[ 5] = 67'h2_0a01b044_00004eba; t0.sink.sink.m[ 5] = 64'h00000000_0000208a;
-    t0.src.src.m[ 6] = 67'h4_00000032_00000222; t0.sink.sink.m[ 6] = 64'h00000032_00000000;
-    t0.src.src.m[ 7] = 67'h4_00000222_00000032; t0.sink.sink.m[ 7] = 64'h0000002e_0000000a;
-    t0.src.src.m[ 8] = 67'h4_0a01b044_ffffb14a; t0.sink.sink.m[ 8] = 64'h0a01b044_00000000;
-    t0.src.src.m[ 9] = 67'h4_deadbeef_0000beef; t0.sink.sink.m[ 9] = 64'h0000227f_00012a90;
-    t0.src.src.m[10] = 67'h4_f5fe4fbc_00004eb6; t0.sink.sink.m[10] = 64'h000006f0_00032012;
-    t0.src.src.m[11] = 67'h4_f5fe4fbc_ffffb14a; t0.sink.sink.m[11] = 64'hf5fe4fbc_00000000;
-
-    #5;   t0_reset = 1'b1;
-    #20;  t0_reset = 1'b0;
-    #10000; `VC_TEST_CHECK( "Is sink finished?", t0_done )
+    t2.src.src.m[ 0] = 67'h2_00000000_00000001; t2.divsink.sink.m[ 0] = 64'h00000000_00000000;
+    t2.src.src.m[ 1] = 67'h2_00000001_00000001; t2.divsink.sink.m[ 1] = 64'h00000000_00000001;
+    t2.src.src.m[ 2] = 67'h2_00000000_ffffffff; t2.divsink.sink.m[ 2] = 64'h00000000_00000000;
+    t2.src.src.m[ 3] = 67'h2_ffffffff_ffffffff; t2.divsink.sink.m[ 3] = 64'h00000000_00000001;
+    t2.src.src.m[ 4] = 67'h2_00000222_0000002a; t2.divsink.sink.m[ 4] = 64'h00000000_0000000d;
+    t2.src.src.m[ 5] = 67'h2_0a01b044_00004eba; t2.divsink.sink.m[ 5] = 64'h00000000_0000208a;
+    t2.src.src.m[ 6] = 67'h4_00000032_00000222; t2.divsink.sink.m[ 6] = 64'h00000032_00000000;
+    t2.src.src.m[ 7] = 67'h4_00000222_00000032; t2.divsink.sink.m[ 7] = 64'h0000002e_0000000a;
+    t2.src.src.m[ 8] = 67'h4_0a01b044_ffffb14a; t2.divsink.sink.m[ 8] = 64'h0a01b044_00000000;
+    t2.src.src.m[ 9] = 67'h4_deadbeef_0000beef; t2.divsink.sink.m[ 9] = 64'h0000227f_00012a90;
+    t2.src.src.m[10] = 67'h4_f5fe4fbc_00004eb6; t2.divsink.sink.m[10] = 64'h000006f0_00032012;
+    t2.src.src.m[11] = 67'h4_f5fe4fbc_ffffb14a; t2.divsink.sink.m[11] = 64'hf5fe4fbc_00000000;
+
+    #5;   t2_reset = 1'b1;
+    #20;  t2_reset = 1'b0;
+    #10000; `VC_TEST_CHECK( "Is sink finished?", t2_done )
 
   end
   `VC_TEST_CASE_END
 
+  //----------------------------------------------------------------------
+  // mixed
+  //----------------------------------------------------------------------
+
+  reg  t3_reset = 1'b1;
+  wire t3_done;
+
+  parc_CoreDpathPipeMulDiv_helper t3
+  (
+    .clk   (clk),
+    .reset (t3_reset),
+    .done  (t3_done)
+  );
+
   `VC_TEST_CASE_BEGIN( 4, "mixed" )
   begin
 
-    t0.src.src.m[ 0] = 67'h0_fffffff8_00000008; t0.sink.sink.m[ 0] = 64'hffffffff_ffffffc0;
-    t0.src.src.m[ 1] = 67'h0_fffffff8_fffffff8; t0.sink.sink.m[ 1] = 64'h00000000_00000040;
-    t0.src.src.m[ 2] = 67'h0_0deadbee_10000000; t0.sink.sink.m[ 2] = 64'h00deadbe_e0000000;
-    t0.src.src.m[ 3] = 67'h0_deadbeef_10000000; t0.sink.sink.m[ 3] = 64'hfdeadbee_f0000000;
-    t0.src.src.m[ 4] = 67'h1_0a01b044_ffffb14a; t0.sink.sink.m[ 4] = 64'h00003372_ffffdf75;
-    t0.src.src.m[ 5] = 67'h1_deadbeef_0000beef; t0.sink.sink.m[ 5] = 64'hffffda72_ffffd353;
-    t0.src.src.m[ 6] = 67'h3_f5fe4fbc_00004eb6; t0.sink.sink.m[ 6] = 64'hffffcc8e_ffffdf75;
-    t0.src.src.m[ 7] = 67'h3_f5fe4fbc_ffffb14a; t0.sink.sink.m[ 7] = 64'hffffcc8e_0000208b;
-    t0.src.src.m[ 8] = 67'h2_0a01b044_ffffb14a; t0.sink.sink.m[ 8] = 64'h0a01b044_00000000;
-    t0.src.src.m[ 9] = 67'h2_deadbeef_0000beef; t0.sink.sink.m[ 9] = 64'h0000227f_00012a90;
-    t0.src.src.m[10] = 67'h4_f5fe4fbc_00004eb6; t0.sink.sink.m[10] = 64'h000006f0_00032012;
-    t0.src.src.m[11] = 67'h4_f5fe4fbc_ffffb14a; t0.sink.sink.m[11] = 64'hf5fe4fbc_00000000;
+    t3.src.src.m[ 0] = 67'h1_0a01b044_ffffb14a; t3.divsink.sink.m[ 0] = 64'h00003372_ffffdf75;
+    t3.src.src.m[ 1] = 67'h0_fffffff8_00000008; t3.mulsink.sink.m[ 0] = 64'hffffffff_ffffffc0;
+    t3.src.src.m[ 2] = 67'h1_deadbeef_0000beef; t3.divsink.sink.m[ 1] = 64'hffffda72_ffffd353;
+    t3.src.src.m[ 3] = 67'h0_fffffff8_fffffff8; t3.mulsink.sink.m[ 1] = 64'h00000000_00000040;
+    t3.src.src.m[ 4] = 67'h3_f5fe4fbc_00004eb6; t3.divsink.sink.m[ 2] = 64'hffffcc8e_ffffdf75;
+    t3.src.src.m[ 5] = 67'h0_0deadbee_10000000; t3.mulsink.sink.m[ 2] = 64'h00deadbe_e0000000;
+    t3.src.src.m[ 6] = 67'h3_f5fe4fbc_ffffb14a; t3.divsink.sink.m[ 3] = 64'hffffcc8e_0000208b;
+    t3.src.src.m[ 7] = 67'h0_deadbeef_10000000; t3.mulsink.sink.m[ 3] = 64'hfdeadbee_f0000000;
+    t3.src.src.m[ 8] = 67'h2_0a01b044_ffffb14a; t3.divsink.sink.m[ 4] = 64'h0a01b044_00000000;
+    t3.src.src.m[ 9] = 67'h2_deadbeef_0000beef; t3.divsink.sink.m[ 5] = 64'h0000227f_00012a90;
+    t3.src.src.m[10] = 67'h4_f5fe4fbc_00004eb6; t3.divsink.sink.m[ 6] = 64'h000006f0_00032012;
+    t3.src.src.m[11] = 67'h4_f5fe4fbc_ffffb14a; t3.divsink.sink.m[ 7] = 64'hf5fe4fbc_00000000;
+
+    #5;   t3_reset = 1'b1;
+    #20;  t3_reset = 1'b0;
+    #10000; `VC_TEST_CHECK( "Is sink finished?", t3_done )
 
-    #5;   t0_reset = 1'b1;
-    #20;  t0_reset = 1'b0;
-    #10000; `VC_TEST_CHECK( "Is sink finished?", t0_done )
+  end
+  `VC_TEST_CASE_END
+
+  //----------------------------------------------------------------------
+  // signed mul
+  //----------------------------------------------------------------------
+
+  reg  t4_reset = 1'b1;
+  wire t4_done;
+
+  parc_CoreDpathPipeMulDiv_helper t4
+  (
+    .clk   (clk),
+    .reset (t4_reset),
+    .done  (t4_done)
+  );
+
+  `VC_TEST_CASE_BEGIN( 5, "signed mul" )
+  begin
+
+    t4.src.src.m[ 0] = 67'h0_deadbeef_deadbeef; t4.mulsink.sink.m[ 0] = 64'h04564f34_216da321;
+    t4.src.src.m[ 1] = 67'h0_80000001_fffffffd; t4.mulsink.sink.m[ 1] = 64'h00000001_7ffffffd;
+    t4.src.src.m[ 2] = 67'h0_fffffff8_fffffff8; t4.mulsink.sink.m[ 2] = 64'h00000000_00000040;
+    t4.src.src.m[ 3] = 67'h0_80000000_ffffffff; t4.mulsink.sink.m[ 3] = 64'h00000000_80000000;
+    t4.src.src.m[ 4] = 67'h0_ffffffff_80000000; t4.mulsink.sink.m[ 4] = 64'h00000000_80000000;
+    t4.src.src.m[ 5] = 67'h0_80000000_80000000; t4.mulsink.sink.m[ 5] = 64'h40000000_00000000;
+    t4.src.src.m[ 6] = 67'h0_80000000_00000001; t4.mulsink.sink.m[ 6] = 64'hffffffff_80000000;
+    t4.src.src.m[ 7] = 67'h0_7fffffff_80000000; t4.mulsink.sink.m[ 7] = 64'hc0000000_80000000;
+    t4.src.src.m[ 8] = 67'h0_7fffffff_7fffffff; t4.mulsink.sink.m[ 8] = 64'h3fffffff_00000001;
+    t4.src.src.m[ 9] = 67'h0_ffffffff_00000001; t4.mulsink.sink.m[ 9] = 64'hffffffff_ffffffff;
+    t4.src.src.m[10] = 67'h0_00000001_ffffffff; t4.mulsink.sink.m[10] = 64'hffffffff_ffffffff;
+    t4.src.src.m[11] = 67'h0_ffffffff_ffffffff; t4.mulsink.sink.m[11] = 64'h00000000_00000001;
+
+    #5;   t4_reset = 1'b1;
+    #20;  t4_reset = 1'b0;
+    #10000; `VC_TEST_CHECK( "Is sink finished?", t4_done )
 
   end
   `VC_TEST_CASE_END
 
-  `VC_TEST_SUITE_END( 4 )
+  `VC_TEST_SUITE_END( 5 )
 
 endmodule
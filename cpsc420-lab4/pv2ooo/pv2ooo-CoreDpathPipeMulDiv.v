@@ -1,11 +1,21 @@
 //========================================================================
-// Functional Pipelined Mul/Div Unit
+// Pipelined Mul/Div Unit
 //========================================================================
+// Multiplies go through a radix-4 Booth / Wallace tree multiplier which
+// is pipelined across the three stages after the input registers, so a
+// multiply can start every cycle and responds three cycles later on the
+// muldivresp port. Divides and remainders go to the iterative divider
+// instead. It takes one request at a time: muldivreq_rdy is low for a
+// divide while it is busy, and its result comes back on the separate
+// divresp port whenever it is done, so a divide never holds up the
+// multiplier.
 
 `ifndef PARC_PIPE_MULDIV_ITERATIVE_V
 `define PARC_PIPE_MULDIV_ITERATIVE_V
 
 `include "imuldiv-MulDivReqMsg.v"
+`include "imuldiv-IntMulBooth.v"
+`include "imuldiv-IntDivIterative.v"
 
 module parc_CoreDpathPipeMulDiv
 (
@@ -21,27 +31,42 @@ module parc_CoreDpathPipeMulDiv
 
   output [63:0] muldivresp_msg_result,
   output        muldivresp_val,
-  input         muldivresp_rdy
+  input         muldivresp_rdy,
+
+  output [63:0] divresp_msg_result,
+  output        divresp_val,
+  input         divresp_rdy
 );
 
-  // Set request ready if not stalled
+  //----------------------------------------------------------------------
+  // Input Select
+  //----------------------------------------------------------------------
+
+  wire is_mul = ( muldivreq_msg_fn == `IMULDIV_MULDIVREQ_MSG_FUNC_MUL );
+
+  wire divreq_val    = muldivreq_val && !is_mul;
+  wire divreq_rdy;
+
+  wire divreq_msg_fn = ( muldivreq_msg_fn == `IMULDIV_MULDIVREQ_MSG_FUNC_DIV
+                     ||  muldivreq_msg_fn == `IMULDIV_MULDIVREQ_MSG_FUNC_REM );
+
+  // A multiply is ready if the pipeline is not stalled, a divide if the
+  // divider is idle
 
-  assign muldivreq_rdy = !stall;
-  wire   muldivreq_go  = muldivreq_val && muldivreq_rdy;
+  assign muldivreq_rdy = is_mul ? !stall : divreq_rdy;
+  wire   mulreq_go     = muldivreq_val && is_mul && !stall;
 
   //----------------------------------------------------------------------
   // Input Registers
   //----------------------------------------------------------------------
 
-  reg  [2:0] fn_reg;
   reg [31:0] a_reg;
   reg [31:0] b_reg;
   reg        val0_reg;
 
   always @ ( posedge clk ) begin
     if ( !reset ) begin
-      if ( muldivreq_go ) begin
-        fn_reg   <= muldivreq_msg_fn;
+      if ( mulreq_go ) begin
         a_reg    <= muldivreq_msg_a;
         b_reg    <= muldivreq_msg_b;
         val0_reg <= 1'b1;
@@ -52,68 +77,26 @@ module parc_CoreDpathPipeMulDiv
     end
   end
 
-
   //----------------------------------------------------------------------
-  // Functional Computation
+  // Multiplier
   //----------------------------------------------------------------------
 
-  // Sign of mul and div
-
-  wire sign = ( a_reg[31] ^ b_reg[31] );
-
-  // Unsigned operands
-
-  wire [31:0] a_unsign   = ( a_reg[31] == 1'b1 ) ? ( ~a_reg + 1'b1 )
-                         :                         a_reg;
-  wire [31:0] b_unsign   = ( b_reg[31] == 1'b1 ) ? ( ~b_reg + 1'b1 )
-                         :                         b_reg;
-
-  // Unsigned computation
-
-  wire [31:0] quotientu  = a_reg / b_reg;
-  wire [31:0] remainderu = a_reg % b_reg;
-
-  // Signed computation
+  wire [63:0] product3;
 
-  wire [63:0] product_raw   = a_unsign * b_unsign;
-  wire [31:0] quotient_raw  = a_unsign / b_unsign;
-  wire [31:0] remainder_raw = a_unsign % b_unsign;
-
-  // Signed Product
-
-  wire [63:0] product
-    = ( sign ) ? ( ~product_raw + 1'b1 )
-               : product_raw;
-
-  // Signed Quotient
-
-  wire [31:0] quotient
-    = ( sign ) ? ( ~quotient_raw + 1'b1 )
-               : quotient_raw;
-
-  // Remainder is same sign as dividend
-
-  wire [31:0] remainder
-    = ( a_reg[31] ) ? ( ~remainder_raw + 1'b1 )
-    :                 remainder_raw;
-
-  // Result mux
-
-  wire [63:0] result0
-    = ( fn_reg == `IMULDIV_MULDIVREQ_MSG_FUNC_MUL  ) ? product
-    : ( fn_reg == `IMULDIV_MULDIVREQ_MSG_FUNC_DIV  ) ? { remainder, quotient }
-    : ( fn_reg == `IMULDIV_MULDIVREQ_MSG_FUNC_DIVU ) ? { remainderu, quotientu }
-    : ( fn_reg == `IMULDIV_MULDIVREQ_MSG_FUNC_REM  ) ? { remainder, quotient }
-    : ( fn_reg == `IMULDIV_MULDIVREQ_MSG_FUNC_REMU ) ? { remainderu, quotientu }
-    :                                                  32'bx;
+  imuldiv_IntMulBooth mul
+  (
+    .clk     (clk),
+    .en1     (!stall && !stall_mult1),
+    .en      (!stall),
+    .a       (a_reg),
+    .b       (b_reg),
+    .product (product3)
+  );
 
   //----------------------------------------------------------------------
-  // Dummy Pipeline Stages
+  // Multiplier Pipeline Stages
   //----------------------------------------------------------------------
 
-  reg [63:0] result1_reg;
-  reg [63:0] result2_reg;
-  reg [63:0] result3_reg;
   reg        val1_reg;
   reg        val2_reg;
   reg        val3_reg;
@@ -121,30 +104,40 @@ module parc_CoreDpathPipeMulDiv
   always @ ( posedge clk ) begin
     if ( !reset ) begin
       if ( !stall ) begin
-        if (!stall_mult1) begin
-          result1_reg <= result0;
-        end
-        result2_reg <= result1_reg;
-        result3_reg <= result2_reg;
-        val1_reg    <= val0_reg;
-        val2_reg    <= val1_reg;
-        val3_reg    <= val2_reg;
+        val1_reg        <= val0_reg;
+        val2_reg        <= val1_reg;
+        val3_reg        <= val2_reg;
       end
     end
   end
 
-  // Set response data
-
-  assign muldivresp_msg_result = result3_reg;
+  // Set response data and valid
 
-  // Set response valid
-
-  assign muldivresp_val = val3_reg;
+  assign muldivresp_msg_result = product3;
+  assign muldivresp_val        = val3_reg;
 
   // Stall signal
 
   wire stall = val3_reg && !muldivresp_rdy;
 
+  //----------------------------------------------------------------------
+  // Divider
+  //----------------------------------------------------------------------
+
+  imuldiv_IntDivIterative idiv
+  (
+    .clk                (clk),
+    .reset              (reset),
+    .divreq_msg_fn      (divreq_msg_fn),
+    .divreq_msg_a       (muldivreq_msg_a),
+    .divreq_msg_b       (muldivreq_msg_b),
+    .divreq_val         (divreq_val),
+    .divreq_rdy         (divreq_rdy),
+    .divresp_msg_result (divresp_msg_result),
+    .divresp_val        (divresp_val),
+    .divresp_rdy        (divresp_rdy)
+  );
+
 endmodule
 
 `endif
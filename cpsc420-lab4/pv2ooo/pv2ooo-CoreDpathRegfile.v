@@ -1,35 +1,59 @@
 //=========================================================================
 // 5-Stage PARC Register File
 //=========================================================================
+// 64 physical registers, mapped onto the architectural registers by
+// parc_CoreRenameTable. p0 holds r0 and always reads as zero. There is
+// one write port per functional unit; renaming guarantees no two of
+// them ever write the same register in a cycle.
 
 `ifndef PARC_CORE_DPATH_REGFILE_V
 `define PARC_CORE_DPATH_REGFILE_V
 
+`include "vc-Regfiles.v"
+
 module parc_CoreDpathRegfile
 (
   input         clk,
-  input  [ 4:0] raddr0,  // Read 0 address (combinational input)
-  output [31:0] rdata0,  // Read 0 data (combinational on raddr)
-  input  [ 4:0] raddr1,  // Read 1 address (combinational input)
-  output [31:0] rdata1,  // Read 1 data (combinational on raddr)
-  input         wen_p,   // Write enable (sample on rising clk edge)
-  input  [ 4:0] waddr_p, // Write address (sample on rising clk edge)
-  input  [31:0] wdata_p  // Write data (sample on rising clk edge)
+  input  [ 5:0] raddr0,   // Read 0 address (combinational input)
+  output [31:0] rdata0,   // Read 0 data (combinational on raddr)
+  input  [ 5:0] raddr1,   // Read 1 address (combinational input)
+  output [31:0] rdata1,   // Read 1 data (combinational on raddr)
+  input         wen0_p,   // Write 0 enable (sample on rising clk edge)
+  input  [ 5:0] waddr0_p, // Write 0 address (sample on rising clk edge)
+  input  [31:0] wdata0_p, // Write 0 data (sample on rising clk edge)
+  input         wen1_p,   // Write 1 enable (sample on rising clk edge)
+  input  [ 5:0] waddr1_p, // Write 1 address (sample on rising clk edge)
+  input  [31:0] wdata1_p, // Write 1 data (sample on rising clk edge)
+  input         wen2_p,   // Write 2 enable (sample on rising clk edge)
+  input  [ 5:0] waddr2_p, // Write 2 address (sample on rising clk edge)
+  input  [31:0] wdata2_p  // Write 2 data (sample on rising clk edge)
 );
 
-  // We use an array of 32 bit register for the regfile itself
-  reg [31:0] registers[31:0];
-
-  // Combinational read ports
-  assign rdata0 = ( raddr0 == 0 ) ? 32'b0 : registers[raddr0];
-  assign rdata1 = ( raddr1 == 0 ) ? 32'b0 : registers[raddr1];
-
-  // Write port is active only when wen is asserted
-  always @( posedge clk )
-  begin
-    if ( wen_p && (waddr_p != 5'b0) )
-      registers[waddr_p] <= wdata_p;
-  end
+  wire [31:0] regs_rdata0;
+  wire [31:0] regs_rdata1;
+
+  vc_Regfile_3w2r_pf#(32,64,6) regs
+  (
+    .clk      (clk),
+    .raddr0   (raddr0),
+    .rdata0   (regs_rdata0),
+    .raddr1   (raddr1),
+    .rdata1   (regs_rdata1),
+    .wen0_p   (wen0_p && (waddr0_p != 6'b0)),
+    .waddr0_p (waddr0_p),
+    .wdata0_p (wdata0_p),
+    .wen1_p   (wen1_p && (waddr1_p != 6'b0)),
+    .waddr1_p (waddr1_p),
+    .wdata1_p (wdata1_p),
+    .wen2_p   (wen2_p && (waddr2_p != 6'b0)),
+    .waddr2_p (waddr2_p),
+    .wdata2_p (wdata2_p)
+  );
+
+  // p0 is never written, so reads of it are forced to zero here
+
+  assign rdata0 = ( raddr0 == 0 ) ? 32'b0 : regs_rdata0;
+  assign rdata1 = ( raddr1 == 0 ) ? 32'b0 : regs_rdata1;
 
 endmodule
 
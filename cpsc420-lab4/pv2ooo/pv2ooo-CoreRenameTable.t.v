@@ -0,0 +1,161 @@
+//========================================================================
+// Test for Register Rename Table
+//========================================================================
+
+`include "pv2ooo-CoreRenameTable.v"
+`include "vc-Test.v"
+
+module tester;
+
+  `VC_TEST_SUITE_BEGIN( "parc-CoreRenameTable" )
+
+  reg        t1_reset = 1;
+  reg  [4:0] t1_src0_areg;
+  wire [5:0] t1_src0_preg;
+  reg  [4:0] t1_src1_areg;
+  wire [5:0] t1_src1_preg;
+  reg        t1_rename_val = 0;
+  wire       t1_rename_rdy;
+  reg  [4:0] t1_rename_areg;
+  wire [5:0] t1_rename_preg;
+  wire [5:0] t1_rename_old_preg;
+  reg        t1_commit_val = 0;
+  reg  [4:0] t1_commit_areg;
+  reg  [5:0] t1_commit_preg;
+  reg  [5:0] t1_commit_old_preg;
+  reg        t1_ckpt_save = 0;
+  reg  [1:0] t1_ckpt_save_idx;
+  reg        t1_ckpt_restore = 0;
+  reg  [1:0] t1_ckpt_restore_idx;
+
+  parc_CoreRenameTable t1_rename
+  (
+    .clk              (clk),
+    .reset            (t1_reset),
+    .src0_areg        (t1_src0_areg),
+    .src0_preg        (t1_src0_preg),
+    .src1_areg        (t1_src1_areg),
+    .src1_preg        (t1_src1_preg),
+    .rename_val       (t1_rename_val),
+    .rename_rdy       (t1_rename_rdy),
+    .rename_areg      (t1_rename_areg),
+    .rename_preg      (t1_rename_preg),
+    .rename_old_preg  (t1_rename_old_preg),
+    .commit_val       (t1_commit_val),
+    .commit_areg      (t1_commit_areg),
+    .commit_preg      (t1_commit_preg),
+    .commit_old_preg  (t1_commit_old_preg),
+    .ckpt_save        (t1_ckpt_save),
+    .ckpt_save_idx    (t1_ckpt_save_idx),
+    .ckpt_restore     (t1_ckpt_restore),
+    .ckpt_restore_idx (t1_ckpt_restore_idx)
+  );
+
+  // Helper task: drive one cycle of inputs and check the outputs
+
+  task t1_do_test
+  (
+    input [22*8-1:0] test_case_str,
+    input            tst_rename_val,
+    input      [4:0] tst_rename_areg,
+    input            tst_commit_val,
+    input      [4:0] tst_commit_areg,
+    input      [5:0] tst_commit_preg,
+    input      [5:0] tst_commit_old_preg,
+    input            tst_ckpt_save,
+    input      [1:0] tst_ckpt_save_idx,
+    input            tst_ckpt_restore,
+    input      [1:0] tst_ckpt_restore_idx,
+    input      [4:0] tst_src0_areg,
+    input      [4:0] tst_src1_areg,
+    input            tst_rename_rdy,
+    input      [5:0] tst_rename_preg,
+    input      [5:0] tst_rename_old_preg,
+    input      [5:0] tst_src0_preg,
+    input      [5:0] tst_src1_preg
+  );
+  begin
+    t1_rename_val       = tst_rename_val;
+    t1_rename_areg      = tst_rename_areg;
+    t1_commit_val       = tst_commit_val;
+    t1_commit_areg      = tst_commit_areg;
+    t1_commit_preg      = tst_commit_preg;
+    t1_commit_old_preg  = tst_commit_old_preg;
+    t1_ckpt_save        = tst_ckpt_save;
+    t1_ckpt_save_idx    = tst_ckpt_save_idx;
+    t1_ckpt_restore     = tst_ckpt_restore;
+    t1_ckpt_restore_idx = tst_ckpt_restore_idx;
+    t1_src0_areg        = tst_src0_areg;
+    t1_src1_areg        = tst_src1_areg;
+    #1;
+    `VC_TEST_NOTE( test_case_str )
+    `VC_TEST_EQ3( "rename", t1_rename_rdy, tst_rename_rdy,
+                  t1_rename_preg, tst_rename_preg, t1_rename_old_preg, tst_rename_old_preg )
+    `VC_TEST_EQ2( "lookup", t1_src0_preg, tst_src0_preg, t1_src1_preg, tst_src1_preg )
+    #9;
+  end
+  endtask
+
+  // Renames younger than a mispredicted branch are undone: the map goes
+  // back to what it was when the branch was renamed, and the free list
+  // hands out the same physical registers again. A commit while they
+  // were in flight does not disturb the restore.
+
+  `VC_TEST_CASE_BEGIN( 1, "mispredict restore" )
+  begin
+
+    #1;  t1_reset = 1'b1;
+    #20; t1_reset = 1'b0;
+
+    //                                  - rename -  ----- commit -----  - save -  - rest -  - src -  ------ rename ------  - lookup -
+    //                                  val ar      val ar  pr   op     val idx   val idx   s0 s1   rdy pr   op           p0   p1
+
+    t1_do_test( "rename r1            ", 1,  1,     0, 'hx, 'hx, 'hx,   0, 'hx,   0, 'hx,   1,  2,  1,  32,  1,          1,   2 );
+    t1_do_test( "branch, save 0       ", 0,  0,     0, 'hx, 'hx, 'hx,   1, 0,     0, 'hx,   1,  2,  1,  33, 'h?,         32,  2 );
+    t1_do_test( "rename r2            ", 1,  2,     0, 'hx, 'hx, 'hx,   0, 'hx,   0, 'hx,   1,  2,  1,  33,  2,          32,  2 );
+    t1_do_test( "rename r1            ", 1,  1,     0, 'hx, 'hx, 'hx,   0, 'hx,   0, 'hx,   1,  2,  1,  34,  32,         32,  33 );
+    t1_do_test( "rename r3, commit r1 ", 1,  3,     1,  1,  32,  1,     0, 'hx,   0, 'hx,   1,  2,  1,  35,  3,          34,  33 );
+
+    // Mispredict: the restore wins over a rename in the same cycle
+
+    t1_do_test( "restore 0            ", 1,  4,     0, 'hx, 'hx, 'hx,   0, 'hx,   1, 0,     1,  3,  1,  36,  4,          34,  35 );
+
+    // The map and the free list head are as the branch left them
+
+    t1_do_test( "after restore        ", 0,  0,     0, 'hx, 'hx, 'hx,   0, 'hx,   0, 'hx,   1,  2,  1,  33, 'h?,         32,  2 );
+    t1_do_test( "lookup r3, r4        ", 0,  0,     0, 'hx, 'hx, 'hx,   0, 'hx,   0, 'hx,   3,  4,  1,  33, 'h?,         3,   4 );
+    t1_do_test( "rename r2 again      ", 1,  2,     0, 'hx, 'hx, 'hx,   0, 'hx,   0, 'hx,   1,  2,  1,  33,  2,          32,  2 );
+    t1_do_test( "rename r1 again      ", 1,  1,     0, 'hx, 'hx, 'hx,   0, 'hx,   0, 'hx,   1,  2,  1,  34,  32,         32,  33 );
+    t1_do_test( "done                 ", 0,  0,     0, 'hx, 'hx, 'hx,   0, 'hx,   0, 'hx,   1,  2,  1,  35, 'h?,         34,  33 );
+
+  end
+  `VC_TEST_CASE_END
+
+  // Two branches in flight: the younger one's restore keeps the older
+  // branch's renames, and the older one's restore then undoes both
+
+  `VC_TEST_CASE_BEGIN( 2, "nested checkpoints" )
+  begin
+
+    #1;  t1_reset = 1'b1;
+    #20; t1_reset = 1'b0;
+
+    //                                  - rename -  ----- commit -----  - save -  - rest -  - src -  ------ rename ------  - lookup -
+    //                                  val ar      val ar  pr   op     val idx   val idx   s0 s1   rdy pr   op           p0   p1
+
+    t1_do_test( "rename r1            ", 1,  1,     0, 'hx, 'hx, 'hx,   0, 'hx,   0, 'hx,   1,  2,  1,  32,  1,          1,   2 );
+    t1_do_test( "branch, save 0       ", 0,  0,     0, 'hx, 'hx, 'hx,   1, 0,     0, 'hx,   1,  2,  1,  33, 'h?,         32,  2 );
+    t1_do_test( "rename r2            ", 1,  2,     0, 'hx, 'hx, 'hx,   0, 'hx,   0, 'hx,   1,  2,  1,  33,  2,          32,  2 );
+    t1_do_test( "branch, save 1       ", 0,  0,     0, 'hx, 'hx, 'hx,   1, 1,     0, 'hx,   1,  2,  1,  34, 'h?,         32,  33 );
+    t1_do_test( "rename r2            ", 1,  2,     0, 'hx, 'hx, 'hx,   0, 'hx,   0, 'hx,   1,  2,  1,  34,  33,         32,  33 );
+    t1_do_test( "restore 1            ", 0,  0,     0, 'hx, 'hx, 'hx,   0, 'hx,   1, 1,     1,  2,  1,  35, 'h?,         32,  34 );
+    t1_do_test( "restore 0            ", 0,  0,     0, 'hx, 'hx, 'hx,   0, 'hx,   1, 0,     1,  2,  1,  34, 'h?,         32,  33 );
+    t1_do_test( "rename r5            ", 1,  5,     0, 'hx, 'hx, 'hx,   0, 'hx,   0, 'hx,   1,  2,  1,  33,  5,          32,  2 );
+    t1_do_test( "done                 ", 0,  0,     0, 'hx, 'hx, 'hx,   0, 'hx,   0, 'hx,   5,  2,  1,  34, 'h?,         33,  2 );
+
+  end
+  `VC_TEST_CASE_END
+
+  `VC_TEST_SUITE_END( 2 )
+endmodule
+
@@ -0,0 +1,169 @@
+//=========================================================================
+// 5-Stage PARC Register Rename Table
+//=========================================================================
+// Maps the 32 architectural registers onto a 64-entry physical register
+// file. Each instruction that writes a register gets a fresh physical
+// register from the free list in decode, so a later write to the same
+// architectural register never waits on an earlier one still in flight.
+//
+//  - rat  : speculative map, read for sources and written on rename
+//  - rrat : retirement map, written as the ROB commits; this is where
+//           the architectural state lives
+//  - free : FIFO of unmapped physical registers. Rename pops the head,
+//           commit pushes the physical register the committing
+//           instruction's destination was mapped to before it.
+//
+// r0 always maps to p0, which is never renamed, allocated or freed.
+//
+// A checkpoint of the rat and of the free list head can be saved in up
+// to NUM_CKPT slots when a branch is renamed and restored if the branch
+// turns out to be mispredicted. Restoring the head hands back every
+// physical register allocated after the branch; commits in the meantime
+// push at the tail and are unaffected.
+
+`ifndef PARC_CORE_RENAMETABLE_V
+`define PARC_CORE_RENAMETABLE_V
+
+module parc_CoreRenameTable
+#(
+  parameter NUM_CKPT = 4,
+  parameter CKPT_SZ  = 2
+)(
+  input         clk,
+  input         reset,
+
+  // Source lookups (combinational)
+
+  input  [ 4:0] src0_areg,
+  output [ 5:0] src0_preg,
+  input  [ 4:0] src1_areg,
+  output [ 5:0] src1_preg,
+
+  // Destination rename
+
+  input         rename_val,
+  output        rename_rdy,
+  input  [ 4:0] rename_areg,
+  output [ 5:0] rename_preg,      // Newly allocated physical register
+  output [ 5:0] rename_old_preg,  // Previous mapping, freed at commit
+
+  // Commit
+
+  input         commit_val,
+  input  [ 4:0] commit_areg,
+  input  [ 5:0] commit_preg,
+  input  [ 5:0] commit_old_preg,
+
+  // Branch checkpoints
+
+  input                ckpt_save,
+  input  [CKPT_SZ-1:0] ckpt_save_idx,
+  input                ckpt_restore,
+  input  [CKPT_SZ-1:0] ckpt_restore_idx
+);
+
+  reg [5:0] rat  [31:0];
+  reg [5:0] rrat [31:0];
+
+  // Free list of the 32 physical registers not in the retirement map.
+  // Pointers carry a wrap bit so full and empty can be told apart.
+
+  reg [5:0] free [31:0];
+  reg [5:0] free_head;
+  reg [5:0] free_tail;
+
+  reg [5:0] ckpt_rat  [NUM_CKPT*32-1:0];
+  reg [5:0] ckpt_head [NUM_CKPT-1:0];
+
+  // Lookups
+
+  assign src0_preg = rat[src0_areg];
+  assign src1_preg = rat[src1_areg];
+
+  assign rename_rdy      = ( free_head != free_tail );
+  assign rename_preg     = free[free_head[4:0]];
+  assign rename_old_preg = rat[rename_areg];
+
+  wire rename = rename_val && rename_rdy && !ckpt_restore
+             && ( rename_areg != 5'd0 );
+
+  // Free list pointers
+
+  always @(posedge clk) begin
+    if (reset) begin
+      free_head <= 6'd0;
+      free_tail <= 6'd32;
+    end else begin
+      if (ckpt_restore)
+        free_head <= ckpt_head[ckpt_restore_idx];
+      else if (rename)
+        free_head <= free_head + 1'b1;
+      if (commit_val)
+        free_tail <= free_tail + 1'b1;
+    end
+  end
+
+  genvar i, c;
+  generate
+
+  // Free list entries. Registers p32-p63 start out free.
+
+  for( i = 0; i < 32; i = i + 1)
+  begin: free_entry
+    always @(posedge clk) begin
+      if (reset)
+        free[i] <= 6'd32 + i;
+      else if ( commit_val && (i == free_tail[4:0]) )
+        free[i] <= commit_old_preg;
+    end
+  end
+
+  // Speculative and retirement maps. Register ri starts out in pi.
+
+  for( i = 0; i < 32; i = i + 1)
+  begin: rat_entry
+    always @(posedge clk) begin
+      if (reset)
+        rat[i] <= i;
+      else if (ckpt_restore)
+        rat[i] <= ckpt_rat[ckpt_restore_idx*32 + i];
+      else if ( rename && (i == rename_areg) )
+        rat[i] <= rename_preg;
+    end
+
+    always @(posedge clk) begin
+      if (reset)
+        rrat[i] <= i;
+      else if ( commit_val && (i == commit_areg) )
+        rrat[i] <= commit_preg;
+    end
+  end
+
+  // Checkpoints capture the map as it is after this cycle's rename.
+  // Only conditional branches save one, and none of them write a
+  // register, so the core never saves and renames in the same cycle;
+  // jal and jalr keep no checkpoint.
+
+  for( c = 0; c < NUM_CKPT; c = c + 1)
+  begin: ckpt
+    for( i = 0; i < 32; i = i + 1)
+    begin: ckpt_entry
+      always @(posedge clk) begin
+        if ( ckpt_save && (c == ckpt_save_idx) )
+          ckpt_rat[c*32 + i]
+            <= ( rename && (i == rename_areg) ) ? rename_preg : rat[i];
+      end
+    end
+
+    always @(posedge clk) begin
+      if ( ckpt_save && (c == ckpt_save_idx) )
+        ckpt_head[c] <= rename ? free_head + 1'b1 : free_head;
+    end
+  end
+
+  endgenerate
+
+endmodule
+
+`endif
+
@@ -0,0 +1,190 @@
+//========================================================================
+// Test for Reorder Buffer
+//========================================================================
+
+`include "pv2ooo-CoreReorderBuffer.v"
+`include "vc-Test.v"
+
+module tester;
+
+  `VC_TEST_SUITE_BEGIN( "parc-CoreReorderBuffer" )
+
+  reg        t1_reset = 1;
+  reg        t1_alloc_val = 0;
+  wire       t1_alloc_rdy;
+  reg  [4:0] t1_alloc_areg;
+  reg  [5:0] t1_alloc_preg;
+  reg  [5:0] t1_alloc_old_preg;
+  wire [3:0] t1_alloc_slot;
+  reg        t1_fill_val = 0;
+  reg  [3:0] t1_fill_slot;
+  reg        t1_fill1_val = 0;
+  reg  [3:0] t1_fill1_slot;
+  reg        t1_fill2_val = 0;
+  reg  [3:0] t1_fill2_slot;
+  wire       t1_commit_wen;
+  wire [3:0] t1_commit_slot;
+  wire [4:0] t1_commit_areg;
+  wire [5:0] t1_commit_preg;
+  wire [5:0] t1_commit_old_preg;
+
+  parc_CoreReorderBuffer t1_rob
+  (
+    .clk                    (clk),
+    .reset                  (t1_reset),
+    .rob_alloc_req_val      (t1_alloc_val),
+    .rob_alloc_req_rdy      (t1_alloc_rdy),
+    .rob_alloc_req_areg     (t1_alloc_areg),
+    .rob_alloc_req_preg     (t1_alloc_preg),
+    .rob_alloc_req_old_preg (t1_alloc_old_preg),
+    .rob_alloc_resp_slot    (t1_alloc_slot),
+    .rob_fill0_val          (t1_fill_val),
+    .rob_fill0_slot         (t1_fill_slot),
+    .rob_fill1_val          (t1_fill1_val),
+    .rob_fill1_slot         (t1_fill1_slot),
+    .rob_fill2_val          (t1_fill2_val),
+    .rob_fill2_slot         (t1_fill2_slot),
+    .rob_commit_wen         (t1_commit_wen),
+    .rob_commit_slot        (t1_commit_slot),
+    .rob_commit_areg        (t1_commit_areg),
+    .rob_commit_preg        (t1_commit_preg),
+    .rob_commit_old_preg    (t1_commit_old_preg)
+  );
+
+  // Helper task: drive one cycle of inputs and check the outputs. The
+  // fill columns drive fill port 0; ports 1 and 2 are set directly.
+
+  task t1_do_test
+  (
+    input [22*8-1:0] test_case_str,
+    input            tst_alloc_val,
+    input      [4:0] tst_alloc_areg,
+    input      [5:0] tst_alloc_preg,
+    input      [5:0] tst_alloc_old_preg,
+    input            tst_alloc_rdy,
+    input      [3:0] tst_alloc_slot,
+    input            tst_fill_val,
+    input      [3:0] tst_fill_slot,
+    input            tst_commit_wen,
+    input      [3:0] tst_commit_slot,
+    input      [4:0] tst_commit_areg,
+    input      [5:0] tst_commit_preg,
+    input      [5:0] tst_commit_old_preg
+  );
+  begin
+    t1_alloc_val      = tst_alloc_val;
+    t1_alloc_areg     = tst_alloc_areg;
+    t1_alloc_preg     = tst_alloc_preg;
+    t1_alloc_old_preg = tst_alloc_old_preg;
+    t1_fill_val       = tst_fill_val;
+    t1_fill_slot      = tst_fill_slot;
+    #1;
+    `VC_TEST_NOTE( test_case_str )
+    `VC_TEST_EQ2( "alloc", t1_alloc_rdy, tst_alloc_rdy, t1_alloc_slot, tst_alloc_slot )
+    `VC_TEST_EQ2( "commit", t1_commit_wen, tst_commit_wen, t1_commit_slot, tst_commit_slot )
+    `VC_TEST_EQ3( "commit regs", t1_commit_areg, tst_commit_areg,
+                  t1_commit_preg, tst_commit_preg, t1_commit_old_preg, tst_commit_old_preg )
+    #9;
+  end
+  endtask
+
+  `VC_TEST_CASE_BEGIN( 1, "in-order commit" )
+  begin
+
+    #1;  t1_reset = 1'b1;
+    #20; t1_reset = 1'b0;
+
+    //                                  ------- alloc -------  - fill -  ------- commit -------
+    //                                  val ar pr  op rdy slot val slot wen slot ar   pr   op
+
+    t1_do_test( "alloc r1 -> p32      ", 1,  1, 32,  1, 1, 0,   0, 'hx, 0, 'h?, 'h?, 'h?, 'h? );
+    t1_do_test( "alloc r2 -> p33      ", 1,  2, 33,  2, 1, 1,   0, 'hx, 0, 'h?, 'h?, 'h?, 'h? );
+    t1_do_test( "alloc r3 -> p34      ", 1,  3, 34,  3, 1, 2,   0, 'hx, 0, 'h?, 'h?, 'h?, 'h? );
+
+    // Fill out of order: nothing commits until the head is filled
+
+    t1_do_test( "fill 2               ", 0, 'hx, 'hx, 'hx, 1, 3,  1, 2,   0, 'h?, 'h?, 'h?, 'h? );
+    t1_do_test( "fill 1               ", 0, 'hx, 'hx, 'hx, 1, 3,  1, 1,   0, 'h?, 'h?, 'h?, 'h? );
+    t1_do_test( "fill 0               ", 0, 'hx, 'hx, 'hx, 1, 3,  1, 0,   0, 'h?, 'h?, 'h?, 'h? );
+
+    // Then commit one per cycle in program order
+
+    t1_do_test( "commit 0             ", 0, 'hx, 'hx, 'hx, 1, 3,  0, 'hx, 1, 0,    1, 32,  1 );
+    t1_do_test( "commit 1             ", 0, 'hx, 'hx, 'hx, 1, 3,  0, 'hx, 1, 1,    2, 33,  2 );
+    t1_do_test( "commit 2             ", 0, 'hx, 'hx, 'hx, 1, 3,  0, 'hx, 1, 2,    3, 34,  3 );
+    t1_do_test( "empty                ", 0, 'hx, 'hx, 'hx, 1, 3,  0, 'hx, 0, 'h?, 'h?, 'h?, 'h? );
+
+  end
+  `VC_TEST_CASE_END
+
+  `VC_TEST_CASE_BEGIN( 2, "full buffer" )
+  begin
+
+    #1;  t1_reset = 1'b1;
+    #20; t1_reset = 1'b0;
+
+    //                                  ------- alloc -------  - fill -  ------- commit -------
+    //                                  val ar pr  op rdy slot val slot wen slot ar   pr   op
+
+    t1_do_test( "alloc slot 0         ", 1,  1, 32,  1, 1,  0,  0, 'hx, 0, 'h?, 'h?, 'h?, 'h? );
+    t1_do_test( "alloc slot 1         ", 1,  2, 33,  2, 1,  1,  0, 'hx, 0, 'h?, 'h?, 'h?, 'h? );
+    t1_do_test( "alloc slot 2         ", 1,  3, 34,  3, 1,  2,  0, 'hx, 0, 'h?, 'h?, 'h?, 'h? );
+    t1_do_test( "alloc slot 3         ", 1,  4, 35,  4, 1,  3,  0, 'hx, 0, 'h?, 'h?, 'h?, 'h? );
+    t1_do_test( "alloc slot 4         ", 1,  5, 36,  5, 1,  4,  0, 'hx, 0, 'h?, 'h?, 'h?, 'h? );
+    t1_do_test( "alloc slot 5         ", 1,  6, 37,  6, 1,  5,  0, 'hx, 0, 'h?, 'h?, 'h?, 'h? );
+    t1_do_test( "alloc slot 6         ", 1,  7, 38,  7, 1,  6,  0, 'hx, 0, 'h?, 'h?, 'h?, 'h? );
+    t1_do_test( "alloc slot 7         ", 1,  8, 39,  8, 1,  7,  0, 'hx, 0, 'h?, 'h?, 'h?, 'h? );
+    t1_do_test( "alloc slot 8         ", 1,  9, 40,  9, 1,  8,  0, 'hx, 0, 'h?, 'h?, 'h?, 'h? );
+    t1_do_test( "alloc slot 9         ", 1, 10, 41, 10, 1,  9,  0, 'hx, 0, 'h?, 'h?, 'h?, 'h? );
+    t1_do_test( "alloc slot 10        ", 1, 11, 42, 11, 1, 10,  0, 'hx, 0, 'h?, 'h?, 'h?, 'h? );
+    t1_do_test( "alloc slot 11        ", 1, 12, 43, 12, 1, 11,  0, 'hx, 0, 'h?, 'h?, 'h?, 'h? );
+    t1_do_test( "alloc slot 12        ", 1, 13, 44, 13, 1, 12,  0, 'hx, 0, 'h?, 'h?, 'h?, 'h? );
+    t1_do_test( "alloc slot 13        ", 1, 14, 45, 14, 1, 13,  0, 'hx, 0, 'h?, 'h?, 'h?, 'h? );
+    t1_do_test( "alloc slot 14        ", 1, 15, 46, 15, 1, 14,  0, 'hx, 0, 'h?, 'h?, 'h?, 'h? );
+    t1_do_test( "alloc slot 15        ", 1, 16, 47, 16, 1, 15,  0, 'hx, 0, 'h?, 'h?, 'h?, 'h? );
+
+    // Full: an allocation is refused until the head commits
+
+    t1_do_test( "full, fill 0         ", 1, 17, 48, 17, 0,  0,  1, 0,   0, 'h?, 'h?, 'h?, 'h? );
+
+    // The head commits and its slot is reallocated in the same cycle
+
+    t1_do_test( "commit 0, alloc 0    ", 1, 17, 48, 17, 1,  0,  0, 'hx, 1, 0,    1, 32,  1 );
+    t1_do_test( "full again           ", 0, 'hx, 'hx, 'hx, 0, 1,  1, 1,   0, 'h?, 'h?, 'h?, 'h? );
+    t1_do_test( "commit 1             ", 0, 'hx, 'hx, 'hx, 1, 1,  0, 'hx, 1, 1,    2, 33,  2 );
+
+  end
+  `VC_TEST_CASE_END
+
+  `VC_TEST_CASE_BEGIN( 3, "fill from every writeback port" )
+  begin
+
+    #1;  t1_reset = 1'b1;
+    #20; t1_reset = 1'b0;
+
+    //                                  ------- alloc -------  - fill -  ------- commit -------
+    //                                  val ar pr  op rdy slot val slot wen slot ar   pr   op
+
+    t1_do_test( "alloc r1 -> p32      ", 1,  1, 32,  1, 1, 0,   0, 'hx, 0, 'h?, 'h?, 'h?, 'h? );
+    t1_do_test( "alloc r2 -> p33      ", 1,  2, 33,  2, 1, 1,   0, 'hx, 0, 'h?, 'h?, 'h?, 'h? );
+    t1_do_test( "alloc r3 -> p34      ", 1,  3, 34,  3, 1, 2,   0, 'hx, 0, 'h?, 'h?, 'h?, 'h? );
+
+    // The muldiv, memory and ALU ports fill all three in one cycle
+
+    t1_fill1_val = 1; t1_fill1_slot = 4'd1;
+    t1_fill2_val = 1; t1_fill2_slot = 4'd0;
+    t1_do_test( "fill 0, 1 and 2      ", 0, 'hx, 'hx, 'hx, 1, 3,  1, 2,   0, 'h?, 'h?, 'h?, 'h? );
+    t1_fill1_val = 0;
+    t1_fill2_val = 0;
+
+    t1_do_test( "commit 0             ", 0, 'hx, 'hx, 'hx, 1, 3,  0, 'hx, 1, 0,    1, 32,  1 );
+    t1_do_test( "commit 1             ", 0, 'hx, 'hx, 'hx, 1, 3,  0, 'hx, 1, 1,    2, 33,  2 );
+    t1_do_test( "commit 2             ", 0, 'hx, 'hx, 'hx, 1, 3,  0, 'hx, 1, 2,    3, 34,  3 );
+    t1_do_test( "empty                ", 0, 'hx, 'hx, 'hx, 1, 3,  0, 'hx, 0, 'h?, 'h?, 'h?, 'h? );
+
+  end
+  `VC_TEST_CASE_END
+
+  `VC_TEST_SUITE_END( 3 )
+endmodule
+
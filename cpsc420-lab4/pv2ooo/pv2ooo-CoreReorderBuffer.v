@@ -1,6 +1,14 @@
 //=========================================================================
-// 5-Stage PARC Scoreboard
+// 5-Stage PARC Reorder Buffer
 //=========================================================================
+// A 16-entry circular buffer of register writes, allocated in program
+// order in decode, filled out of order by the ALU, memory and muldiv
+// writeback ports and committed to the register state in order, one per
+// cycle, from the head. The write data
+// is already in the physical register file by then; a slot only holds
+// its valid/ready bits and the destination's architectural register,
+// its physical register and the physical register it replaced, which
+// commit returns to the free list.
 
 `ifndef PARC_CORE_REORDERBUFFER_V
 `define PARC_CORE_REORDERBUFFER_V
@@ -12,24 +20,92 @@ module parc_CoreReorderBuffer
 
   input         rob_alloc_req_val,
   output        rob_alloc_req_rdy,
-  input  [ 4:0] rob_alloc_req_preg,
-  
+  input  [ 4:0] rob_alloc_req_areg,
+  input  [ 5:0] rob_alloc_req_preg,
+  input  [ 5:0] rob_alloc_req_old_preg,
+
   output [ 3:0] rob_alloc_resp_slot,
 
-  input         rob_fill_val,
-  input  [ 3:0] rob_fill_slot,
+  input         rob_fill0_val,
+  input  [ 3:0] rob_fill0_slot,
+  input         rob_fill1_val,
+  input  [ 3:0] rob_fill1_slot,
+  input         rob_fill2_val,
+  input  [ 3:0] rob_fill2_slot,
 
   output        rob_commit_wen,
   output [ 3:0] rob_commit_slot,
-  output [ 4:0] rob_commit_rf_waddr
+  output [ 4:0] rob_commit_areg,
+  output [ 5:0] rob_commit_preg,
+  output [ 5:0] rob_commit_old_preg
 );
 
-  wire rob_alloc_req_rdy   = 1'b1;
-  wire rob_alloc_resp_slot = 4'b0;
-  wire rob_commit_wen      = 1'b0;
-  wire rob_commit_rf_waddr = 1'b0;
-  wire rob_commit_slot     = 4'b0;
-  
+  reg        valid    [15:0];  // Slot allocated and not yet committed
+  reg        ready    [15:0];  // Slot has been filled in writeback
+  reg  [4:0] areg     [15:0];  // Destination architectural register
+  reg  [5:0] preg     [15:0];  // Destination physical register
+  reg  [5:0] old_preg [15:0];  // Physical register areg mapped to before
+
+  reg  [3:0] head;             // Oldest allocated slot
+  reg  [3:0] tail;             // Next slot to allocate
+  reg  [4:0] count;            // Number of allocated slots
+
+  // Commit the head once it has been filled
+
+  assign rob_commit_wen      = valid[head] && ready[head];
+  assign rob_commit_slot     = head;
+  assign rob_commit_areg     = areg[head];
+  assign rob_commit_preg     = preg[head];
+  assign rob_commit_old_preg = old_preg[head];
+
+  // Allocate at the tail. A full buffer can still allocate in a cycle
+  // where the head commits, since that frees the slot being reused.
+
+  assign rob_alloc_req_rdy   = ( count != 5'd16 ) || rob_commit_wen;
+  assign rob_alloc_resp_slot = tail;
+
+  wire alloc = rob_alloc_req_val && rob_alloc_req_rdy;
+
+  always @(posedge clk) begin
+    if (reset) begin
+      head  <= 4'b0;
+      tail  <= 4'b0;
+      count <= 5'b0;
+    end else begin
+      if (alloc)
+        tail <= tail + 1'b1;
+      if (rob_commit_wen)
+        head <= head + 1'b1;
+      count <= count + alloc - rob_commit_wen;
+    end
+  end
+
+  genvar s;
+  generate
+  for( s = 0; s < 16; s = s + 1)
+  begin: rob_entry
+    always @(posedge clk) begin
+      if (reset) begin
+        valid[s] <= 1'b0;
+        ready[s] <= 1'b0;
+      end else if ( alloc && (s == tail) ) begin
+        valid[s]    <= 1'b1;
+        ready[s]    <= 1'b0;
+        areg[s]     <= rob_alloc_req_areg;
+        preg[s]     <= rob_alloc_req_preg;
+        old_preg[s] <= rob_alloc_req_old_preg;
+      end else if ( rob_commit_wen && (s == head) ) begin
+        valid[s] <= 1'b0;
+        ready[s] <= 1'b0;
+      end else if ( ( rob_fill0_val && (s == rob_fill0_slot) )
+                 || ( rob_fill1_val && (s == rob_fill1_slot) )
+                 || ( rob_fill2_val && (s == rob_fill2_slot) ) ) begin
+        ready[s] <= 1'b1;
+      end
+    end
+  end
+  endgenerate
+
 endmodule
 
 `endif
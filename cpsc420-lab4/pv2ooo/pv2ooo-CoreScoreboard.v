@@ -1,6 +1,16 @@
 //=========================================================================
 // 5-Stage PARC Scoreboard
 //=========================================================================
+// Tracks the physical registers handed out by parc_CoreRenameTable. A
+// physical register is pending from rename until its value is written
+// to the physical register file in writeback; until then a reader is
+// bypassed from the functional unit or the writeback stage. Since every
+// write gets a fresh physical register, there are no WAW or WAR hazards
+// to check here, and since each functional unit has its own writeback
+// port, instructions of different latencies never compete for one.
+// A divide takes as long as the iterative divider needs, so its
+// register stays pending and cannot be bypassed until the divider
+// result goes to the muldiv writeback port.
 
 `ifndef PARC_CORE_SCOREBOARD_V
 `define PARC_CORE_SCOREBOARD_V
@@ -8,55 +18,39 @@
 `define FUNC_UNIT_ALU 1
 `define FUNC_UNIT_MEM 2
 `define FUNC_UNIT_MUL 3
+`define FUNC_UNIT_DIV 4
 
 module parc_CoreScoreboard
 (
   input         clk,
   input         reset,
-  input  [ 4:0] src0,             // Source register 0
+  input  [ 5:0] src0,             // Source physical register 0
   input         src0_en,          // Use source register 0
-  input  [ 4:0] src1,             // Source register 1
+  input  [ 5:0] src1,             // Source physical register 1
   input         src1_en,          // Use source register 1
-  input  [ 4:0] dst,              // Destination register
+  input  [ 5:0] dst,              // Destination physical register
   input         dst_en,           // Write to destination register
   input  [ 2:0] func_unit,        // Functional Unit
   input  [ 4:0] latency,          // Instruction latency (one-hot)
   input         inst_val_Dhl,     // Instruction valid
 
-  input  [ 3:0] rob_alloc_slot,   // ROB slot allocated to dst reg
-  input  [ 3:0] rob_commit_slot,  // ROB slot emptied during commit
-  input         rob_commit_wen,   // ROB slot emptied during commit
+  input         alloc_rdy,        // ROB slot and physical reg free
 
-  input  [ 4:0] stalls,           // Input stall signals
+  input         stall_Xhl,        // X stage stalled
+  input         stall_Mhl,        // M stage stalled
+
+  input         div_wb_val,       // Divider result goes to writeback
+  input  [ 5:0] div_wb_dst,       // Destination of the divider result
 
   output [ 2:0] src0_byp_mux_sel, // Source reg 0 byp mux
-  output [ 3:0] src0_byp_rob_slot,// Source reg 0 ROB slot
   output [ 2:0] src1_byp_mux_sel, // Source reg 1 byp mux
-  output [ 3:0] src1_byp_rob_slot,// Source reg 1 ROB slot
 
-  output        stall_hazard,     // Destination register ready
-  output [ 1:0] wb_mux_sel        // Writeback mux sel out
+  output        stall_hazard      // Destination register ready
 );
 
-  reg       pending          [31:0];
-  reg [2:0] functional_unit  [31:0];
-  reg [4:0] reg_latency      [31:0];
-  reg [3:0] reg_rob_slot     [31:0];
-
-  reg [4:0] wb_alu_latency;
-  reg [4:0] wb_mem_latency;
-  reg [4:0] wb_mul_latency;
-
-  // Store ROB slots (for bypassing)
-
-  always @(posedge clk) begin
-    if( accept ) begin
-      reg_rob_slot[dst] <= rob_alloc_slot;
-    end
-  end
-
-  wire src0_byp_rob_slot = reg_rob_slot[src0];
-  wire src1_byp_rob_slot = reg_rob_slot[src1];
+  reg       pending          [63:0];
+  reg [2:0] functional_unit  [63:0];
+  reg [4:0] reg_latency      [63:0];
 
   // Check if src registers are ready
 
@@ -66,127 +60,87 @@ module parc_CoreScoreboard
   wire src0_ok = !pending[src0] || src0_can_byp || !src0_en;
   wire src1_ok = !pending[src1] || src1_can_byp || !src1_en;
 
+  // A result is bypassed from its functional unit in the last cycle
+  // there, and then from that unit's writeback port (4 ALU, 5 memory,
+  // 6 muldiv)
+
   reg [2:0] src0_byp_mux_sel;
   reg [2:0] src1_byp_mux_sel;
 
   always @(*) begin
-    if (!pending[src0] || src0 == 5'b0)
+    if (!pending[src0] || src0 == 6'b0)
       src0_byp_mux_sel = 3'b0;
     else if (reg_latency[src0] == 5'b00001)
-      src0_byp_mux_sel = 3'd4;
-    else if (reg_latency[src0] == 5'b00000)
-      //src0_byp_mux_sel = 3'd5; // UNCOMMENT THIS WHEN YOUR ROB IS READY!
-      src0_byp_mux_sel = 3'd0;   // DELETE THIS WHEN YOUR ROB IS READY!
+      src0_byp_mux_sel = 3'd3 + functional_unit[src0];
     else
       src0_byp_mux_sel = functional_unit[src0];
   end
 
   always @(*) begin
-    if (!pending[src1] || src1 == 5'b0)
+    if (!pending[src1] || src1 == 6'b0)
       src1_byp_mux_sel = 3'b0;
     else if (reg_latency[src1] == 5'b00001)
-      src1_byp_mux_sel = 3'd4;
-    else if (reg_latency[src1] == 5'b00000)
-      //src1_byp_mux_sel = 3'd5; // UNCOMMENT THIS WHEN YOUR ROB IS READY!
-      src1_byp_mux_sel = 3'd0;   // DELETE THIS WHEN YOUR ROB IS READY!
+      src1_byp_mux_sel = 3'd3 + functional_unit[src1];
     else
       src1_byp_mux_sel = functional_unit[src1];
   end
 
   // Check for hazards
 
-  wire stall_wb_hazard =
-    ((wb_alu_latency >> 1) & latency) > 5'b0 ? 1'b1 :
-    ((wb_mem_latency >> 1) & latency) > 5'b0 ? 1'b1 :
-    ((wb_mul_latency >> 1) & latency) > 5'b0 ? 1'b1 : 1'b0;
-
-  wire accept =
-    src0_ok && src1_ok && !stall_wb_hazard && inst_val_Dhl;
+  wire accept = src0_ok && src1_ok && inst_val_Dhl;
 
   wire stall_hazard = ~accept;
-  
-  // Advance one cycle
-  
+
+  // The instruction only leaves decode if X is not stalled and it got a
+  // ROB slot and a physical register; until then it must not show up as
+  // pending, or it would bypass its own result to itself
+
+  wire issue = accept && !stall_Xhl && alloc_rdy;
+
+  // Advance one cycle. The latency is one-hot in the number of cycles
+  // left until writeback, so which stage an instruction is in follows
+  // from its functional unit; it holds while that stage is stalled.
+  // A divide holds until its result is written back, and from then on
+  // is bypassed from the muldiv writeback port like a multiply.
+
+  wire [4:0] latency_next [63:0];
+
   genvar r;
   generate
-  for( r = 0; r < 32; r = r + 1)
+  for( r = 0; r < 64; r = r + 1)
   begin: sb_entry
+    wire in_X = ( functional_unit[r] == `FUNC_UNIT_ALU ) ? reg_latency[r][1]
+              : ( functional_unit[r] == `FUNC_UNIT_MEM ) ? reg_latency[r][2]
+              :                                            reg_latency[r][4];
+    wire in_M = ( functional_unit[r] == `FUNC_UNIT_MEM ) ? reg_latency[r][1]
+              : ( functional_unit[r] == `FUNC_UNIT_MUL ) ? reg_latency[r][3]
+              :                                            1'b0;
+
+    wire hold = ( in_X && stall_Xhl ) || ( in_M && stall_Mhl )
+             || ( functional_unit[r] == `FUNC_UNIT_DIV );
+
+    assign latency_next[r] = hold ? reg_latency[r] : ( reg_latency[r] >> 1 );
+
     always @(posedge clk) begin
       if (reset) begin
         reg_latency[r]     <= 5'b0;
         pending[r]         <= 1'b0;
-        functional_unit[r] <= 3'b0; 
-      end else if ( accept && (r == dst) ) begin
+        functional_unit[r] <= 3'b0;
+      end else if ( issue && dst_en && (r == dst) ) begin
         reg_latency[r]     <= latency;
         pending[r]         <= 1'b1;
         functional_unit[r] <= func_unit;
+      end else if ( div_wb_val && (r == div_wb_dst) ) begin
+        reg_latency[r]     <= 5'b00001;
+        functional_unit[r] <= `FUNC_UNIT_MUL;
       end else begin
-        reg_latency[r]     <= 
-          (reg_latency[r] & stalls) | 
-          ((reg_latency[r] & ~stalls) >> 1);
-        pending[r]         <= pending[r] &&
-          !(rob_commit_wen && rob_commit_slot == reg_rob_slot[r]);
+        reg_latency[r]     <= latency_next[r];
+        pending[r]         <= pending[r] && ( latency_next[r] != 5'b0 );
       end
     end
   end
   endgenerate
 
-  // ALU Latency 
-
-  always @(posedge clk) begin
-    if (reset) begin
-      wb_alu_latency <= 5'b0;
-    end else if (accept && (func_unit == 2'd1)) begin
-      wb_alu_latency <= 
-        (wb_alu_latency & stalls) |
-        ((wb_alu_latency & ~stalls) >> 1) |
-        latency;
-    end else begin
-      wb_alu_latency <= 
-        (wb_alu_latency & stalls) |
-        ((wb_alu_latency & ~stalls) >> 1);
-    end
-  end
-
-  // MEM Latency 
-
-  always @(posedge clk) begin
-    if (reset) begin
-      wb_mem_latency <= 5'b0;
-    end else if (accept && (func_unit == 2'd2)) begin
-      wb_mem_latency <= 
-        (wb_mem_latency & stalls) |
-        ((wb_mem_latency & ~stalls) >> 1) |
-        latency;
-    end else begin
-      wb_mem_latency <= 
-        (wb_mem_latency & stalls) |
-        ((wb_mem_latency & ~stalls) >> 1);
-    end
-  end
-
-  // MUL Latency 
-
-  always @(posedge clk) begin
-    if (reset) begin
-      wb_mul_latency <= 5'b0;
-    end else if (accept && (func_unit == 2'd3)) begin
-      wb_mul_latency <= 
-        (wb_mul_latency & stalls) |
-        ((wb_mul_latency & ~stalls) >> 1) |
-        latency;
-    end else begin
-      wb_mul_latency <= 
-        (wb_mul_latency & stalls) |
-        ((wb_mul_latency & ~stalls) >> 1);
-    end
-  end
-
-  wire wb_mux_sel = (wb_alu_latency & 5'b10) ? 2'd1 :
-                    (wb_mem_latency & 5'b10) ? 2'd2 :
-                    (wb_mul_latency & 5'b10) ? 2'd3 : 2'd0;
-
 endmodule
 
 `endif
-
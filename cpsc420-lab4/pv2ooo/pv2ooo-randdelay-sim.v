@@ -255,48 +255,82 @@ module parc_sim;
 
       $write( "|" );
 
-      // Writeback Stage
+      // Writeback Stages (ALU, memory, muldiv)
 
-      if ( proc.ctrl.bubble_Whl )
+      if ( proc.ctrl.bubble_W0hl )
         $write( "  (-_-) " );
       else if ( proc.ctrl.squash_Whl )
-        $write( "-%s-", proc.ctrl.inst_msg_disasm_W.minidasm );
+        $write( "-%s-", proc.ctrl.inst_msg_disasm_W0.minidasm );
       else if ( proc.ctrl.stall_Whl )
-        $write( "#%s ", proc.ctrl.inst_msg_disasm_W.minidasm );
+        $write( "#%s ", proc.ctrl.inst_msg_disasm_W0.minidasm );
       else
-        $write( " %s ", proc.ctrl.inst_msg_disasm_W.minidasm );
+        $write( " %s ", proc.ctrl.inst_msg_disasm_W0.minidasm );
+
+      $write( "|" );
+
+      if ( proc.ctrl.bubble_W1hl )
+        $write( "  (-_-) " );
+      else if ( proc.ctrl.squash_Whl )
+        $write( "-%s-", proc.ctrl.inst_msg_disasm_W1.minidasm );
+      else if ( proc.ctrl.stall_Whl )
+        $write( "#%s ", proc.ctrl.inst_msg_disasm_W1.minidasm );
+      else
+        $write( " %s ", proc.ctrl.inst_msg_disasm_W1.minidasm );
+
+      $write( "|" );
+
+      if ( proc.ctrl.bubble_W2hl )
+        $write( "  (-_-) " );
+      else if ( proc.ctrl.squash_Whl )
+        $write( "-%s-", proc.ctrl.inst_msg_disasm_W2.minidasm );
+      else if ( proc.ctrl.stall_Whl )
+        $write( "#%s ", proc.ctrl.inst_msg_disasm_W2.minidasm );
+      else
+        $write( " %s ", proc.ctrl.inst_msg_disasm_W2.minidasm );
 
       $display( "}" );
 
     end
     else if ( disasm > 0 ) begin
-      if ( proc.ctrl.inst_val_debug ) begin
+      // Up to one instruction leaves each writeback port per cycle
+
+      if ( proc.ctrl.inst_val_debug0 )
+        $display( "%h: %h: %s",
+                   proc.dpath.pc_debug0, proc.ctrl.ir_debug0, proc.ctrl.inst_msg_disasm_debug0.dasm );
+      if ( proc.ctrl.inst_val_debug1 )
         $display( "%h: %h: %s",
-                   proc.dpath.pc_debug, proc.ctrl.ir_debug, proc.ctrl.inst_msg_disasm_debug.dasm );
+                   proc.dpath.pc_debug1, proc.ctrl.ir_debug1, proc.ctrl.inst_msg_disasm_debug1.dasm );
+      if ( proc.ctrl.inst_val_debug2 )
+        $display( "%h: %h: %s",
+                   proc.dpath.pc_debug2, proc.ctrl.ir_debug2, proc.ctrl.inst_msg_disasm_debug2.dasm );
+
+      if ( proc.ctrl.inst_val_debug0 || proc.ctrl.inst_val_debug1 || proc.ctrl.inst_val_debug2 ) begin
 
+        // Architectural registers are in the physical registers the
+        // retirement map points at
         if ( disasm > 1 ) begin
           $display( "r00=%h r01=%h r02=%h r03=%h r04=%h r05=%h",
-                     proc.dpath.rfile.registers[ 0], proc.dpath.rfile.registers[ 1],
-                     proc.dpath.rfile.registers[ 2], proc.dpath.rfile.registers[ 3],
-                     proc.dpath.rfile.registers[ 4], proc.dpath.rfile.registers[ 5] );
+                     proc.dpath.rfile.regs.rfile[proc.ctrl.rename.rrat[ 0]], proc.dpath.rfile.regs.rfile[proc.ctrl.rename.rrat[ 1]],
+                     proc.dpath.rfile.regs.rfile[proc.ctrl.rename.rrat[ 2]], proc.dpath.rfile.regs.rfile[proc.ctrl.rename.rrat[ 3]],
+                     proc.dpath.rfile.regs.rfile[proc.ctrl.rename.rrat[ 4]], proc.dpath.rfile.regs.rfile[proc.ctrl.rename.rrat[ 5]] );
           $display( "r06=%h r07=%h r08=%h r09=%h r10=%h r11=%h",
-                     proc.dpath.rfile.registers[ 6], proc.dpath.rfile.registers[ 7],
-                     proc.dpath.rfile.registers[ 8], proc.dpath.rfile.registers[ 9],
-                     proc.dpath.rfile.registers[10], proc.dpath.rfile.registers[11] );
+                     proc.dpath.rfile.regs.rfile[proc.ctrl.rename.rrat[ 6]], proc.dpath.rfile.regs.rfile[proc.ctrl.rename.rrat[ 7]],
+                     proc.dpath.rfile.regs.rfile[proc.ctrl.rename.rrat[ 8]], proc.dpath.rfile.regs.rfile[proc.ctrl.rename.rrat[ 9]],
+                     proc.dpath.rfile.regs.rfile[proc.ctrl.rename.rrat[10]], proc.dpath.rfile.regs.rfile[proc.ctrl.rename.rrat[11]] );
           $display( "r12=%h r13=%h r14=%h r15=%h r16=%h r17=%h",
-                     proc.dpath.rfile.registers[12], proc.dpath.rfile.registers[13],
-                     proc.dpath.rfile.registers[14], proc.dpath.rfile.registers[15],
-                     proc.dpath.rfile.registers[16], proc.dpath.rfile.registers[17] );
+                     proc.dpath.rfile.regs.rfile[proc.ctrl.rename.rrat[12]], proc.dpath.rfile.regs.rfile[proc.ctrl.rename.rrat[13]],
+                     proc.dpath.rfile.regs.rfile[proc.ctrl.rename.rrat[14]], proc.dpath.rfile.regs.rfile[proc.ctrl.rename.rrat[15]],
+                     proc.dpath.rfile.regs.rfile[proc.ctrl.rename.rrat[16]], proc.dpath.rfile.regs.rfile[proc.ctrl.rename.rrat[17]] );
           $display( "r18=%h r19=%h r20=%h r21=%h r22=%h r23=%h",
-                     proc.dpath.rfile.registers[18], proc.dpath.rfile.registers[19],
-                     proc.dpath.rfile.registers[20], proc.dpath.rfile.registers[21],
-                     proc.dpath.rfile.registers[22], proc.dpath.rfile.registers[23] );
+                     proc.dpath.rfile.regs.rfile[proc.ctrl.rename.rrat[18]], proc.dpath.rfile.regs.rfile[proc.ctrl.rename.rrat[19]],
+                     proc.dpath.rfile.regs.rfile[proc.ctrl.rename.rrat[20]], proc.dpath.rfile.regs.rfile[proc.ctrl.rename.rrat[21]],
+                     proc.dpath.rfile.regs.rfile[proc.ctrl.rename.rrat[22]], proc.dpath.rfile.regs.rfile[proc.ctrl.rename.rrat[23]] );
           $display( "r24=%h r25=%h r26=%h r27=%h r28=%h r29=%h",
-                     proc.dpath.rfile.registers[24], proc.dpath.rfile.registers[25],
-                     proc.dpath.rfile.registers[26], proc.dpath.rfile.registers[27],
-                     proc.dpath.rfile.registers[28], proc.dpath.rfile.registers[29] );
+                     proc.dpath.rfile.regs.rfile[proc.ctrl.rename.rrat[24]], proc.dpath.rfile.regs.rfile[proc.ctrl.rename.rrat[25]],
+                     proc.dpath.rfile.regs.rfile[proc.ctrl.rename.rrat[26]], proc.dpath.rfile.regs.rfile[proc.ctrl.rename.rrat[27]],
+                     proc.dpath.rfile.regs.rfile[proc.ctrl.rename.rrat[28]], proc.dpath.rfile.regs.rfile[proc.ctrl.rename.rrat[29]] );
           $display( "r30=%h r31=%h",
-                     proc.dpath.rfile.registers[30], proc.dpath.rfile.registers[31] );
+                     proc.dpath.rfile.regs.rfile[proc.ctrl.rename.rrat[30]], proc.dpath.rfile.regs.rfile[proc.ctrl.rename.rrat[31]] );
         end
 
         $display( "-----" );
@@ -309,6 +343,7 @@ module parc_sim;
   //----------------------------------------------------------------------
 
   real ipc;
+  real br_acc;
 
   always @ ( * ) begin
     if ( !reset && ( status != 0 ) ) begin
@@ -321,6 +356,8 @@ module parc_sim;
 
       if ( verbose == 1'b1 ) begin
         ipc = proc.ctrl.num_inst/$itor(proc.ctrl.num_cycles);
+        br_acc = ( proc.ctrl.num_br == 0 ) ? 1.0
+               : 1.0 - proc.ctrl.num_br_miss/$itor(proc.ctrl.num_br);
 
         $display( "--------------------------------------------" );
         $display( " STATS                                      " );
@@ -330,6 +367,11 @@ module parc_sim;
         $display( " num_cycles = %d", proc.ctrl.num_cycles       );
         $display( " num_inst   = %d", proc.ctrl.num_inst         );
         $display( " ipc        = %f", ipc                        );
+        $display( " num_br     = %d", proc.ctrl.num_br           );
+        $display( " br_miss    = %d", proc.ctrl.num_br_miss      );
+        $display( " br_acc     = %f", br_acc                     );
+        $display( " ras_hit    = %d", proc.ctrl.num_ras_hit      );
+        $display( " ras_miss   = %d", proc.ctrl.num_ras_miss     );
       end
 
       #20 $finish;
@@ -0,0 +1,1654 @@
+//=========================================================================
+// 5-Stage PARCv2 Control Unit
+//=========================================================================
+// Speculative variant of the pv2ooo control unit, sharing its branch
+// predictor and return address stack. A conditional branch whose sources
+// are ready resolves in X as before. One whose sources are still in
+// flight no longer holds up decode: it takes one of four branch tags,
+// checkpoints the rename table and issues down the muldiv lane, carrying
+// the prediction fetch made for it, to resolve in W once its sources are
+// in the register file. Everything issued after it carries the tag in
+// its branch mask. If the prediction turns out wrong, W kills every
+// instruction whose mask has the tag, drops the younger ROB slots,
+// restores the rename and RAS checkpoints and redirects fetch.
+//
+// Stores and mtc0 have side effects that cannot be undone. One issued
+// while a speculative branch is in flight, or behind another such store,
+// takes a ROB slot instead of going to memory or CP0 as it passes X and
+// W. The datapath keeps its address and data by slot, and it is sent
+// when the slot commits. Loads wait in X while any buffered store has
+// not yet been written to memory.
+
+`ifndef PARC_CORE_CTRL_V
+`define PARC_CORE_CTRL_V
+
+`include "pv2ooo-InstMsg.v"
+`include "pv2spec-CoreScoreboard.v"
+`include "pv2spec-CoreReorderBuffer.v"
+`include "pv2ooo-CoreRenameTable.v"
+
+module parc_CoreCtrl
+(
+  input clk,
+  input reset,
+
+  // Instruction Memory Port
+  output        imemreq_val,
+  input         imemreq_rdy,
+  input  [31:0] imemresp_msg_data,
+  input         imemresp_val,
+
+  // Data Memory Port
+
+  output        dmemreq_msg_rw,
+  output  [1:0] dmemreq_msg_len,
+  output        dmemreq_val,
+  input         dmemreq_rdy,
+  input         dmemresp_val,
+
+  // Controls Signals (ctrl->dpath)
+
+  output  [2:0] pc_mux_sel_Phl,
+  output  [5:0] rf_raddr0_Dhl,
+  output  [5:0] rf_raddr1_Dhl,
+  output  [2:0] op0_byp_mux_sel_Dhl,
+  output  [1:0] op0_mux_sel_Dhl,
+  output  [2:0] op1_byp_mux_sel_Dhl,
+  output  [2:0] op1_mux_sel_Dhl,
+  output [31:0] inst_Dhl,
+  output  [3:0] alu_fn_Xhl,
+  output  [2:0] muldivreq_msg_fn_Dhl,
+  output        muldivreq_val,
+  input         muldivreq_rdy,
+  input         muldivresp_val,
+  output        muldivresp_rdy,
+  output        muldiv_mux_sel_X3hl,
+  input         divresp_val,
+  output        divresp_rdy,
+  output        execute_mux_sel_Xhl,
+  output        muldiv_mux_sel_Xhl,
+  output  [2:0] dmemresp_mux_sel_Mhl,
+  output        dmemresp_queue_en_Mhl,
+  output        dmemresp_queue_val_Mhl,
+  output  [1:0] wb_mux_sel_Whl,
+  output        rf_wen_out_Whl,
+  output  [5:0] rf_waddr_Whl,
+  output        bp_update_val_Xhl,
+  output        bp_update_taken_Xhl,
+  output        bp_update_jump_Xhl,
+  output        ras_push_Fhl,
+  output        ras_pop_Fhl,
+  output        ras_repair_Xhl,
+  output        stbuf_wen_Xhl,
+  output  [3:0] stbuf_waddr_Xhl,
+  output        stbuf_req_Chl,
+  output  [3:0] stbuf_raddr_Chl,
+  output  [5:0] br_raddr0_Whl,
+  output  [5:0] br_raddr1_Whl,
+  output        bp_update_val_Whl,
+  output        bp_update_taken_Whl,
+  output        ras_repair_Whl,
+  output        brj_mispred_Whl,
+  output        brj_taken_Whl,
+  output        stall_Fhl,
+  output        stall_Dhl,
+  output        stall_Xhl,
+  output        stall_Mhl,
+  output        stall_Whl,
+
+  // Control Signals (dpath->ctrl)
+
+  input         branch_cond_eq_Xhl,
+  input         branch_cond_zero_Xhl,
+  input         branch_cond_neg_Xhl,
+  input         pred_taken_Fhl,
+  input         ras_targ_match_Dhl,
+  input         branch_cond_eq_Whl,
+  input         branch_cond_zero_Whl,
+  input         branch_cond_neg_Whl,
+  input  [31:0] proc2cop_data_Whl,
+  input  [31:0] proc2cop_data_Chl,
+
+  // CP0 Status
+
+  output [31:0] cp0_status
+);
+
+  //----------------------------------------------------------------------
+  // PC Stage: Instruction Memory Request
+  //----------------------------------------------------------------------
+
+  // PC Mux Select. A mispredicted speculative branch in W redirects to
+  // its target or its fall-through, and takes priority over anything
+  // younger. Otherwise a mispredicted branch in X redirects to its
+  // target or its fall-through, a jump in D the predictor missed to the
+  // jump target, and fetch follows the RAS for a return in F and the
+  // predictor for anything else.
+
+  wire pred_taken_Phl = ( inst_val_Fhl && pred_taken_Fhl );
+  wire ras_pred_Phl   = ( inst_val_Fhl && ras_ret_Fhl );
+
+  assign pc_mux_sel_Phl
+    = redirect_Phl     ? pm_w
+    : br_mispred_Xhl   ? ( any_br_taken_Xhl ? pm_b : pm_n )
+    : brj_taken_Dhl    ? pc_mux_sel_Dhl
+    : ras_pred_Phl     ? pm_s
+    : pred_taken_Phl   ? pm_t
+    :                    pm_p;
+
+  // A mispredicted speculative branch in W redirects fetch from the next
+  // cycle on, until the PC stage is free to send the request
+
+  reg redirect_Phl;
+
+  always @ ( posedge clk ) begin
+    if ( reset )
+      redirect_Phl <= 1'b0;
+    else if ( brj_mispred_Whl )
+      redirect_Phl <= 1'b1;
+    else if ( !stall_Phl )
+      redirect_Phl <= 1'b0;
+  end
+
+  // Only send a valid imem request if not stalled
+
+  wire   imemreq_val_Phl = reset || !stall_Phl;
+  assign imemreq_val     = imemreq_val_Phl;
+
+  // Dummy Squash Signal
+
+  wire squash_Phl = 1'b0;
+
+  // Stall in PC if F is stalled
+
+  wire stall_Phl = stall_Fhl;
+
+  // Next bubble bit
+
+  wire bubble_next_Phl = ( squash_Phl || stall_Phl );
+
+  //----------------------------------------------------------------------
+  // F <- P
+  //----------------------------------------------------------------------
+
+  reg imemreq_val_Fhl;
+
+  reg bubble_Fhl;
+
+  always @ ( posedge clk ) begin
+    // Only pipeline the bubble bit if the next stage is not stalled
+    if ( reset ) begin
+      imemreq_val_Fhl <= 1'b0;
+
+      bubble_Fhl <= 1'b0;
+    end
+    else if( !stall_Fhl ) begin
+      imemreq_val_Fhl <= imemreq_val_Phl;
+
+      bubble_Fhl <= bubble_next_Phl;
+    end
+  end
+
+  //----------------------------------------------------------------------
+  // Fetch Stage: Instruction Memory Response
+  //----------------------------------------------------------------------
+
+  // Is the current stage valid?
+
+  wire inst_val_Fhl = ( !bubble_Fhl && !squash_Fhl );
+
+  // Squash instruction in F stage if a valid jump in D was not
+  // predicted or a valid branch in X was mispredicted, and on the wrong
+  // path of a mispredicted speculative branch
+
+  wire squash_Fhl
+    = ( inst_val_Dhl && brj_taken_Dhl )
+   || ( inst_val_Xhl && br_mispred_Xhl )
+   || brj_mispred_Whl || redirect_Phl;
+
+  // Stall in F if D is stalled
+
+  assign stall_Fhl = stall_Dhl;
+
+  // Next bubble bit
+
+  wire bubble_sel_Fhl  = ( squash_Fhl || stall_Fhl );
+  wire bubble_next_Fhl = ( !bubble_sel_Fhl ) ? bubble_Fhl
+                       : ( bubble_sel_Fhl )  ? 1'b1
+                       :                       1'bx;
+
+  //----------------------------------------------------------------------
+  // Queue for instruction memory response
+  //----------------------------------------------------------------------
+
+  wire imemresp_queue_en_Fhl = ( stall_Dhl && imemresp_val );
+  wire imemresp_queue_val_next_Fhl
+    = stall_Dhl && ( imemresp_val || imemresp_queue_val_Fhl );
+
+  reg [31:0] imemresp_queue_reg_Fhl;
+  reg        imemresp_queue_val_Fhl;
+
+  always @ ( posedge clk ) begin
+    if ( imemresp_queue_en_Fhl ) begin
+      imemresp_queue_reg_Fhl <= imemresp_msg_data;
+    end
+    imemresp_queue_val_Fhl <= imemresp_queue_val_next_Fhl;
+  end
+
+  //----------------------------------------------------------------------
+  // Instruction memory queue mux
+  //----------------------------------------------------------------------
+
+  wire [31:0] imemresp_queue_mux_out_Fhl
+    = ( !imemresp_queue_val_Fhl ) ? imemresp_msg_data
+    : ( imemresp_queue_val_Fhl )  ? imemresp_queue_reg_Fhl
+    :                               32'bx;
+
+  //----------------------------------------------------------------------
+  // Return address stack
+  //----------------------------------------------------------------------
+
+  // Calls push and returns (jr $31) pop as they leave F
+
+  wire [31:0] ir_Fhl = imemresp_queue_mux_out_Fhl;
+
+  reg ras_call_Fhl;
+  reg ras_ret_Fhl;
+
+  always @ (*) begin
+    ras_call_Fhl = 1'b0;
+    ras_ret_Fhl  = 1'b0;
+    casez ( ir_Fhl )
+      `PARC_INST_MSG_JAL  : ras_call_Fhl = 1'b1;
+      `PARC_INST_MSG_JALR : ras_call_Fhl = 1'b1;
+      `PARC_INST_MSG_JR   : ras_ret_Fhl  = ( ir_Fhl[25:21] == 5'd31 );
+    endcase
+  end
+
+  assign ras_push_Fhl = ( inst_val_Fhl && !stall_Fhl && ras_call_Fhl );
+  assign ras_pop_Fhl  = ( inst_val_Fhl && !stall_Fhl && ras_ret_Fhl );
+
+  //----------------------------------------------------------------------
+  // D <- F
+  //----------------------------------------------------------------------
+
+  reg [31:0] ir_Dhl;
+  reg        pred_taken_Dhl;
+  reg        ras_ret_Dhl;
+  reg        bubble_Dhl;
+
+  always @ ( posedge clk ) begin
+    if ( reset ) begin
+      bubble_Dhl <= 1'b1;
+    end
+    else if( !stall_Dhl ) begin
+      ir_Dhl         <= imemresp_queue_mux_out_Fhl;
+      pred_taken_Dhl <= pred_taken_Fhl;
+      ras_ret_Dhl    <= ras_ret_Fhl;
+      bubble_Dhl     <= bubble_next_Fhl;
+    end
+  end
+
+  //----------------------------------------------------------------------
+  // Decode Stage: Constants
+  //----------------------------------------------------------------------
+
+  // Generic Parameters
+
+  localparam n = 1'd0;
+  localparam y = 1'd1;
+
+  // Register specifiers
+
+  localparam rx = 5'bx;
+  localparam r0 = 5'd0;
+  localparam rL = 5'd31;
+
+  // Branch Type
+
+  localparam br_x    = 3'bx;
+  localparam br_none = 3'd0;
+  localparam br_beq  = 3'd1;
+  localparam br_bne  = 3'd2;
+  localparam br_blez = 3'd3;
+  localparam br_bgtz = 3'd4;
+  localparam br_bltz = 3'd5;
+  localparam br_bgez = 3'd6;
+
+  // PC Mux Select
+
+  localparam pm_x   = 2'bx;  // Don't care
+  localparam pm_p   = 2'd0;  // Use pc+4
+  localparam pm_b   = 2'd1;  // Use branch address
+  localparam pm_j   = 2'd2;  // Use jump address
+  localparam pm_r   = 2'd3;  // Use jump register
+  localparam pm_t   = 3'd4;  // Use predicted target
+  localparam pm_n   = 3'd5;  // Use fall-through of branch in X
+  localparam pm_s   = 3'd6;  // Use return address stack
+  localparam pm_w   = 3'd7;  // Use redirect of speculative branch in W
+
+  // Operand 0 Bypass Mux Select
+
+  localparam am_r0    = 3'd0; // Use rdata0
+  localparam am_X_byp = 3'd1; // Bypass from X
+  localparam am_M_byp = 3'd2; // Bypass from M
+  localparam am_X3_byp= 3'd3; // Bypass from X3
+  localparam am_W_byp = 3'd4; // Bypass from W
+
+  // Operand 0 Mux Select
+
+  localparam am_x     = 2'bx; // Don't care
+  localparam am_rdat  = 2'd0; // Use output of bypass mux
+  localparam am_sh    = 2'd1; // Use shamt
+  localparam am_16    = 2'd2; // Use constant 16
+  localparam am_0     = 2'd3; // Use constant 0 (for mtc0)
+
+  // Operand 1 Bypass Mux Select
+
+  localparam bm_r1    = 3'd0; // Use rdata1
+  localparam bm_X_byp = 3'd1; // Bypass from X
+  localparam bm_M_byp = 3'd2; // Bypass from M
+  localparam bm_X3_byp= 3'd3; // Bypass from X3
+  localparam bm_W_byp = 3'd4; // Bypass from W
+
+  // Operand 1 Mux Select
+
+  localparam bm_x     = 3'bx; // Don't care
+  localparam bm_rdat  = 3'd0; // Use output of bypass mux
+  localparam bm_zi    = 3'd1; // Use zero-extended immediate
+  localparam bm_si    = 3'd2; // Use sign-extended immediate
+  localparam bm_pc    = 3'd3; // Use PC
+  localparam bm_0     = 3'd4; // Use constant 0
+
+  // ALU Function
+
+  localparam alu_x    = 4'bx;
+  localparam alu_add  = 4'd0;
+  localparam alu_sub  = 4'd1;
+  localparam alu_sll  = 4'd2;
+  localparam alu_or   = 4'd3;
+  localparam alu_lt   = 4'd4;
+  localparam alu_ltu  = 4'd5;
+  localparam alu_and  = 4'd6;
+  localparam alu_xor  = 4'd7;
+  localparam alu_nor  = 4'd8;
+  localparam alu_srl  = 4'd9;
+  localparam alu_sra  = 4'd10;
+
+  // Muldiv Function
+
+  localparam md_x    = 3'bx;
+  localparam md_mul  = 3'd0;
+  localparam md_div  = 3'd1;
+  localparam md_divu = 3'd2;
+  localparam md_rem  = 3'd3;
+  localparam md_remu = 3'd4;
+
+  // MulDiv Mux Select
+
+  localparam mdm_x = 1'bx; // Don't Care
+  localparam mdm_l = 1'd0; // Take lower half of 64-bit result, mul/div/divu
+  localparam mdm_u = 1'd1; // Take upper half of 64-bit result, rem/remu
+
+  // Execute Mux Select
+
+  localparam em_x   = 1'bx; // Don't Care
+  localparam em_alu = 1'd0; // Use ALU output
+  localparam em_md  = 1'd1; // Use muldiv output
+
+  // Memory Request Type
+
+  localparam nr = 2'b0; // No request
+  localparam ld = 2'd1; // Load
+  localparam st = 2'd2; // Store
+
+  // Subword Memop Length
+
+  localparam ml_x  = 2'bx;
+  localparam ml_w  = 2'd0;
+  localparam ml_b  = 2'd1;
+  localparam ml_h  = 2'd2;
+
+  // Memory Response Mux Select
+
+  localparam dmm_x  = 3'bx;
+  localparam dmm_w  = 3'd0;
+  localparam dmm_b  = 3'd1;
+  localparam dmm_bu = 3'd2;
+  localparam dmm_h  = 3'd3;
+  localparam dmm_hu = 3'd4;
+
+  // Writeback Mux 1
+
+  localparam wm_x   = 1'bx; // Don't care
+  localparam wm_alu = 1'd0; // Use ALU output
+  localparam wm_mem = 1'd1; // Use data memory response
+
+  //----------------------------------------------------------------------
+  // Decode Stage: Logic
+  //----------------------------------------------------------------------
+
+  // Is the current stage valid?
+
+  wire inst_val_Dhl = ( !bubble_Dhl && !squash_Dhl );
+
+  // Ship instruction for field parsing to datapath
+
+  assign inst_Dhl = ir_Dhl;
+
+  // Parse instruction fields
+
+  wire   [4:0] inst_rs_Dhl;
+  wire   [4:0] inst_rt_Dhl;
+  wire   [4:0] inst_rd_Dhl;
+
+  parc_InstMsgFromBits inst_msg_from_bits
+  (
+    .msg      (ir_Dhl),
+    .opcode   (),
+    .rs       (inst_rs_Dhl),
+    .rt       (inst_rt_Dhl),
+    .rd       (inst_rd_Dhl),
+    .shamt    (),
+    .func     (),
+    .imm      (),
+    .imm_sign (),
+    .target   ()
+  );
+
+  // Shorten register specifier name for table
+
+  wire [4:0] rs = inst_rs_Dhl;
+  wire [4:0] rt = inst_rt_Dhl;
+  wire [4:0] rd = inst_rd_Dhl;
+
+  // Instruction Decode
+
+  localparam cs_sz = 39;
+  reg [cs_sz-1:0] cs;
+
+  always @ (*) begin
+
+    cs = {cs_sz{1'bx}}; // Default to invalid instruction
+
+    casez ( ir_Dhl )
+
+      //                               j     br       pc      op0      rs op1      rt alu       md       md md     ex      mem  mem   memresp wb      rf      cp0
+      //                           val taken type     muxsel  muxsel   en muxsel   en fn        fn       en muxsel muxsel  rq   len   muxsel  muxsel  wen wa  wen
+      `PARC_INST_MSG_NOP     :cs={ y,  n,    br_none, pm_p,   am_x,    n, bm_x,    n, alu_x,    md_x,    n, mdm_x, em_x,   nr,  ml_x, dmm_x,  wm_x,   n,  rx, n   };
+
+      `PARC_INST_MSG_ADDIU   :cs={ y,  n,    br_none, pm_p,   am_rdat, y, bm_si,   n, alu_add,  md_x,    n, mdm_x, em_alu, nr,  ml_x, dmm_x,  wm_alu, y,  rt, n   };
+      `PARC_INST_MSG_SLTI    :cs={ y,  n,    br_none, pm_p,   am_rdat, y, bm_si,   n, alu_lt,   md_x,    n, mdm_x, em_alu, nr,  ml_x, dmm_x,  wm_alu, y,  rt, n   };
+      `PARC_INST_MSG_SLTIU   :cs={ y,  n,    br_none, pm_p,   am_rdat, y, bm_si,   n, alu_ltu,  md_x,    n, mdm_x, em_alu, nr,  ml_x, dmm_x,  wm_alu, y,  rt, n   };
+      `PARC_INST_MSG_ANDI    :cs={ y,  n,    br_none, pm_p,   am_rdat, y, bm_zi,   n, alu_and,  md_x,    n, mdm_x, em_alu, nr,  ml_x, dmm_x,  wm_alu, y,  rt, n   };
+      `PARC_INST_MSG_ORI     :cs={ y,  n,    br_none, pm_p,   am_rdat, y, bm_zi,   n, alu_or,   md_x,    n, mdm_x, em_alu, nr,  ml_x, dmm_x,  wm_alu, y,  rt, n   };
+      `PARC_INST_MSG_XORI    :cs={ y,  n,    br_none, pm_p,   am_rdat, y, bm_zi,   n, alu_xor,  md_x,    n, mdm_x, em_alu, nr,  ml_x, dmm_x,  wm_alu, y,  rt, n   };
+      `PARC_INST_MSG_LUI     :cs={ y,  n,    br_none, pm_p,   am_16,   n, bm_zi,   n, alu_sll,  md_x,    n, mdm_x, em_alu, nr,  ml_x, dmm_x,  wm_alu, y,  rt, n   };
+
+      `PARC_INST_MSG_ADDU    :cs={ y,  n,    br_none, pm_p,   am_rdat, y, bm_rdat, y, alu_add,  md_x,    n, mdm_x, em_alu, nr,  ml_x, dmm_x,  wm_alu, y,  rd, n   };
+      `PARC_INST_MSG_SUBU    :cs={ y,  n,    br_none, pm_p,   am_rdat, y, bm_rdat, y, alu_sub,  md_x,    n, mdm_x, em_alu, nr,  ml_x, dmm_x,  wm_alu, y,  rd, n   };
+      `PARC_INST_MSG_AND     :cs={ y,  n,    br_none, pm_p,   am_rdat, y, bm_rdat, y, alu_and,  md_x,    n, mdm_x, em_alu, nr,  ml_x, dmm_x,  wm_alu, y,  rd, n   };
+      `PARC_INST_MSG_OR      :cs={ y,  n,    br_none, pm_p,   am_rdat, y, bm_rdat, y, alu_or,   md_x,    n, mdm_x, em_alu, nr,  ml_x, dmm_x,  wm_alu, y,  rd, n   };
+      `PARC_INST_MSG_XOR     :cs={ y,  n,    br_none, pm_p,   am_rdat, y, bm_rdat, y, alu_xor,  md_x,    n, mdm_x, em_alu, nr,  ml_x, dmm_x,  wm_alu, y,  rd, n   };
+      `PARC_INST_MSG_NOR     :cs={ y,  n,    br_none, pm_p,   am_rdat, y, bm_rdat, y, alu_nor,  md_x,    n, mdm_x, em_alu, nr,  ml_x, dmm_x,  wm_alu, y,  rd, n   };
+
+      `PARC_INST_MSG_SLL     :cs={ y,  n,    br_none, pm_p,   am_sh,   n, bm_rdat, y, alu_sll,  md_x,    n, mdm_x, em_alu, nr,  ml_x, dmm_x,  wm_alu, y,  rd, n   };
+      `PARC_INST_MSG_SRL     :cs={ y,  n,    br_none, pm_p,   am_sh,   n, bm_rdat, y, alu_srl,  md_x,    n, mdm_x, em_alu, nr,  ml_x, dmm_x,  wm_alu, y,  rd, n   };
+      `PARC_INST_MSG_SRA     :cs={ y,  n,    br_none, pm_p,   am_sh,   n, bm_rdat, y, alu_sra,  md_x,    n, mdm_x, em_alu, nr,  ml_x, dmm_x,  wm_alu, y,  rd, n   };
+      `PARC_INST_MSG_SLLV    :cs={ y,  n,    br_none, pm_p,   am_rdat, y, bm_rdat, y, alu_sll,  md_x,    n, mdm_x, em_alu, nr,  ml_x, dmm_x,  wm_alu, y,  rd, n   };
+      `PARC_INST_MSG_SRLV    :cs={ y,  n,    br_none, pm_p,   am_rdat, y, bm_rdat, y, alu_srl,  md_x,    n, mdm_x, em_alu, nr,  ml_x, dmm_x,  wm_alu, y,  rd, n   };
+      `PARC_INST_MSG_SRAV    :cs={ y,  n,    br_none, pm_p,   am_rdat, y, bm_rdat, y, alu_sra,  md_x,    n, mdm_x, em_alu, nr,  ml_x, dmm_x,  wm_alu, y,  rd, n   };
+
+      `PARC_INST_MSG_SLT     :cs={ y,  n,    br_none, pm_p,   am_rdat, y, bm_rdat, y, alu_lt,   md_x,    n, mdm_x, em_alu, nr,  ml_x, dmm_x,  wm_alu, y,  rd, n   };
+      `PARC_INST_MSG_SLTU    :cs={ y,  n,    br_none, pm_p,   am_rdat, y, bm_rdat, y, alu_ltu,  md_x,    n, mdm_x, em_alu, nr,  ml_x, dmm_x,  wm_alu, y,  rd, n   };
+
+      `PARC_INST_MSG_MUL     :cs={ y,  n,    br_none, pm_p,   am_rdat, y, bm_rdat, y, alu_x,    md_mul,  y, mdm_l, em_md,  nr,  ml_x, dmm_x,  wm_alu, y,  rd, n   };
+      `PARC_INST_MSG_DIV     :cs={ y,  n,    br_none, pm_p,   am_rdat, y, bm_rdat, y, alu_x,    md_div,  y, mdm_l, em_md,  nr,  ml_x, dmm_x,  wm_alu, y,  rd, n   };
+      `PARC_INST_MSG_DIVU    :cs={ y,  n,    br_none, pm_p,   am_rdat, y, bm_rdat, y, alu_x,    md_divu, y, mdm_l, em_md,  nr,  ml_x, dmm_x,  wm_alu, y,  rd, n   };
+      `PARC_INST_MSG_REM     :cs={ y,  n,    br_none, pm_p,   am_rdat, y, bm_rdat, y, alu_x,    md_rem,  y, mdm_u, em_md,  nr,  ml_x, dmm_x,  wm_alu, y,  rd, n   };
+      `PARC_INST_MSG_REMU    :cs={ y,  n,    br_none, pm_p,   am_rdat, y, bm_rdat, y, alu_x,    md_remu, y, mdm_u, em_md,  nr,  ml_x, dmm_x,  wm_alu, y,  rd, n   };
+
+      `PARC_INST_MSG_LW      :cs={ y,  n,    br_none, pm_p,   am_rdat, y, bm_si,   n, alu_add,  md_x,    n, mdm_x, em_x,   ld,  ml_w, dmm_w,  wm_mem, y,  rt, n   };
+      `PARC_INST_MSG_LB      :cs={ y,  n,    br_none, pm_p,   am_rdat, y, bm_si,   n, alu_add,  md_x,    n, mdm_x, em_x,   ld,  ml_b, dmm_b,  wm_mem, y,  rt, n   };
+      `PARC_INST_MSG_LBU     :cs={ y,  n,    br_none, pm_p,   am_rdat, y, bm_si,   n, alu_add,  md_x,    n, mdm_x, em_x,   ld,  ml_b, dmm_bu, wm_mem, y,  rt, n   };
+      `PARC_INST_MSG_LH      :cs={ y,  n,    br_none, pm_p,   am_rdat, y, bm_si,   n, alu_add,  md_x,    n, mdm_x, em_x,   ld,  ml_h, dmm_h,  wm_mem, y,  rt, n   };
+      `PARC_INST_MSG_LHU     :cs={ y,  n,    br_none, pm_p,   am_rdat, y, bm_si,   n, alu_add,  md_x,    n, mdm_x, em_x,   ld,  ml_h, dmm_hu, wm_mem, y,  rt, n   };
+      `PARC_INST_MSG_SW      :cs={ y,  n,    br_none, pm_p,   am_rdat, y, bm_si,   y, alu_add,  md_x,    n, mdm_x, em_x,   st,  ml_w, dmm_w,  wm_mem, n,  rx, n   };
+      `PARC_INST_MSG_SB      :cs={ y,  n,    br_none, pm_p,   am_rdat, y, bm_si,   y, alu_add,  md_x,    n, mdm_x, em_x,   st,  ml_b, dmm_x,  wm_mem, n,  rx, n   };
+      `PARC_INST_MSG_SH      :cs={ y,  n,    br_none, pm_p,   am_rdat, y, bm_si,   y, alu_add,  md_x,    n, mdm_x, em_x,   st,  ml_h, dmm_x,  wm_mem, n,  rx, n   };
+
+      `PARC_INST_MSG_J       :cs={ y,  y,    br_none, pm_j,   am_x,    n, bm_x,    n, alu_x,    md_x,    n, mdm_x, em_x,   nr,  ml_x, dmm_x,  wm_x,   n,  rx, n   };
+      `PARC_INST_MSG_JAL     :cs={ y,  y,    br_none, pm_j,   am_0,    n, bm_pc,   n, alu_add,  md_x,    n, mdm_x, em_alu, nr,  ml_x, dmm_x,  wm_alu, y,  rL, n   };
+      `PARC_INST_MSG_JALR    :cs={ y,  y,    br_none, pm_r,   am_0,    y, bm_pc,   n, alu_add,  md_x,    n, mdm_x, em_alu, nr,  ml_x, dmm_x,  wm_alu, y,  rd, n   };
+      `PARC_INST_MSG_JR      :cs={ y,  y,    br_none, pm_r,   am_x,    y, bm_x,    n, alu_x,    md_x,    n, mdm_x, em_x,   nr,  ml_x, dmm_x,  wm_x,   n,  rx, n   };
+      `PARC_INST_MSG_BEQ     :cs={ y,  n,    br_beq,  pm_b,   am_rdat, y, bm_rdat, y, alu_xor,  md_x,    n, mdm_x, em_x,   nr,  ml_x, dmm_x,  wm_x,   n,  rx, n   };
+      `PARC_INST_MSG_BNE     :cs={ y,  n,    br_bne,  pm_b,   am_rdat, y, bm_rdat, y, alu_xor,  md_x,    n, mdm_x, em_x,   nr,  ml_x, dmm_x,  wm_x,   n,  rx, n   };
+      `PARC_INST_MSG_BLEZ    :cs={ y,  n,    br_blez, pm_b,   am_rdat, y, bm_rdat, y, alu_sub,  md_x,    n, mdm_x, em_x,   nr,  ml_x, dmm_x,  wm_x,   n,  rx, n   };
+      `PARC_INST_MSG_BGTZ    :cs={ y,  n,    br_bgtz, pm_b,   am_rdat, y, bm_rdat, y, alu_sub,  md_x,    n, mdm_x, em_x,   nr,  ml_x, dmm_x,  wm_x,   n,  rx, n   };
+      `PARC_INST_MSG_BLTZ    :cs={ y,  n,    br_bltz, pm_b,   am_rdat, y, bm_rdat, y, alu_sub,  md_x,    n, mdm_x, em_x,   nr,  ml_x, dmm_x,  wm_x,   n,  rx, n   };
+      `PARC_INST_MSG_BGEZ    :cs={ y,  n,    br_bgez, pm_b,   am_rdat, y, bm_rdat, y, alu_sub,  md_x,    n, mdm_x, em_x,   nr,  ml_x, dmm_x,  wm_x,   n,  rx, n   };
+
+      `PARC_INST_MSG_MTC0    :cs={ y,  n,    br_none, pm_p,   am_0,    n, bm_rdat, y, alu_add,  md_x,    n, mdm_x, em_alu, nr,  ml_x, dmm_x,  wm_alu, n,  rx, y   };
+
+    endcase
+
+  end
+
+  // Jump and Branch Controls
+
+  wire [2:0] br_sel_Dhl    = cs[`PARC_INST_MSG_BR_SEL];
+
+  // PC Mux Select
+
+  wire [1:0] pc_mux_sel_Dhl = cs[`PARC_INST_MSG_PC_SEL];
+
+  // A direct jump the predictor already followed in F, or a return
+  // the RAS predicted correctly, needs no redirect; any other jump
+  // redirects from D
+
+  wire       jump_Dhl      = ( cs[`PARC_INST_MSG_J_EN] && ( pc_mux_sel_Dhl == pm_j ) );
+  wire       ras_hit_Dhl   = ( ras_ret_Dhl && ras_targ_match_Dhl );
+  wire       brj_taken_Dhl = ( inst_val_Dhl && cs[`PARC_INST_MSG_J_EN]
+                               && !( jump_Dhl && pred_taken_Dhl ) && !ras_hit_Dhl );
+
+  // Operand Bypassing Logic
+
+  wire       rs_en_Dhl    = cs[`PARC_INST_MSG_RS_EN];
+  wire       rt_en_Dhl    = cs[`PARC_INST_MSG_RT_EN];
+
+  // Register Writeback Controls
+
+  wire [4:0] rf_waddr_Dhl = cs[`PARC_INST_MSG_RF_WADDR];
+  wire rf_wen_Dhl         = cs[`PARC_INST_MSG_RF_WEN];
+
+  // Register Renaming
+  //
+  // Sources are read from the physical registers the rename table maps
+  // them to, and a write to any register but r0 is given a new physical
+  // register. From here on the pipeline carries the physical register
+  // in rf_waddr_*.
+
+  wire       prf_wen_Dhl = rf_wen_Dhl && ( rf_waddr_Dhl != 5'd0 );
+  wire [5:0] prf_waddr_Dhl;
+  wire [5:0] prf_old_waddr_Dhl;
+  wire       rename_rdy_Dhl;
+
+  // Speculative Branches
+  //
+  // A conditional branch goes speculative if its sources are not ready
+  // to be read or bypassed. It needs a free branch tag, which also names
+  // its rename checkpoint. Every unresolved speculative branch is older
+  // than the instruction in decode, so the busy tags are its branch mask.
+  // A branch resolving in X needs no checkpoint: whatever is in D behind
+  // it is squashed before being renamed.
+
+  wire       src_rdy_Dhl;
+  wire       br_spec_Dhl = ( br_sel_Dhl != br_none ) && !src_rdy_Dhl;
+
+  reg  [3:0] br_tags_busy;
+
+  wire [3:0] br_mask_Dhl    = br_tags_busy;
+  wire       br_tag_rdy_Dhl = ( br_tags_busy != 4'b1111 );
+  wire [1:0] br_tag_Dhl
+    = !br_tags_busy[0] ? 2'd0
+    : !br_tags_busy[1] ? 2'd1
+    : !br_tags_busy[2] ? 2'd2
+    :                    2'd3;
+
+  wire       br_spec_issue_Dhl = inst_val_Dhl && !stall_Dhl && br_spec_Dhl;
+
+  // Speculative branches resolve in W in program order, so when one is
+  // mispredicted every other busy tag belongs to a younger, killed branch
+
+  always @ ( posedge clk ) begin
+    if ( reset || brj_mispred_Whl )
+      br_tags_busy <= 4'b0;
+    else
+      br_tags_busy <= ( br_tags_busy & ~br_clear_Whl )
+                    | ( br_spec_issue_Dhl ? ( 4'b1 << br_tag_Dhl ) : 4'b0 );
+  end
+
+  wire [4:0] rob_commit_areg_Chl;
+  wire [5:0] rob_commit_preg_Chl;
+  wire [5:0] rob_commit_old_preg_Chl;
+  wire       rob_commit_wen_Chl;
+
+  parc_CoreRenameTable rename
+  (
+    .clk              (clk),
+    .reset            (reset),
+
+    .src0_areg        (inst_rs_Dhl),
+    .src0_preg        (rf_raddr0_Dhl),
+    .src1_areg        (inst_rt_Dhl),
+    .src1_preg        (rf_raddr1_Dhl),
+
+    .rename_val       (inst_val_Dhl && !stall_Dhl && prf_wen_Dhl),
+    .rename_rdy       (rename_rdy_Dhl),
+    .rename_areg      (rf_waddr_Dhl),
+    .rename_preg      (prf_waddr_Dhl),
+    .rename_old_preg  (prf_old_waddr_Dhl),
+
+    .commit_val       (rob_commit_wen_Chl),
+    .commit_areg      (rob_commit_areg_Chl),
+    .commit_preg      (rob_commit_preg_Chl),
+    .commit_old_preg  (rob_commit_old_preg_Chl),
+
+    .ckpt_save        (br_spec_issue_Dhl),
+    .ckpt_save_idx    (br_tag_Dhl),
+    .ckpt_restore     (brj_mispred_Whl),
+    .ckpt_restore_idx (br_tag_Whl)
+  );
+
+  // Operand Mux Select
+
+  assign op0_mux_sel_Dhl = cs[`PARC_INST_MSG_OP0_SEL];
+  assign op1_mux_sel_Dhl = cs[`PARC_INST_MSG_OP1_SEL];
+
+  // ALU Function
+
+  wire [3:0] alu_fn_Dhl = cs[`PARC_INST_MSG_ALU_FN];
+
+  // Muldiv Function
+
+  wire [2:0] muldivreq_msg_fn_Dhl = cs[`PARC_INST_MSG_MULDIV_FN];
+
+  // Muldiv Controls
+
+  wire muldivreq_val_Dhl = cs[`PARC_INST_MSG_MULDIV_EN];
+
+  // Divides and remainders go to the iterative divider
+
+  wire is_div_Dhl = muldivreq_val_Dhl && ( muldivreq_msg_fn_Dhl != md_mul );
+
+  // Muldiv Mux Select
+
+  wire muldiv_mux_sel_Dhl = cs[`PARC_INST_MSG_MULDIV_SEL];
+
+  // Execute Mux Select
+
+  wire execute_mux_sel_Dhl = cs[`PARC_INST_MSG_EX_SEL];
+
+  // Memory Controls
+
+  wire       is_load_Dhl         = ( cs[`PARC_INST_MSG_MEM_REQ] == ld );
+
+  wire       dmemreq_msg_rw_Dhl  = ( cs[`PARC_INST_MSG_MEM_REQ] == st );
+  wire [1:0] dmemreq_msg_len_Dhl = cs[`PARC_INST_MSG_MEM_LEN];
+  wire       dmemreq_val_Dhl     = ( cs[`PARC_INST_MSG_MEM_REQ] != nr );
+
+  // Memory response mux select
+
+  wire [2:0] dmemresp_mux_sel_Dhl = cs[`PARC_INST_MSG_MEM_SEL];
+
+  // Writeback Mux Select
+
+  wire wb_mux_sel_Dhl = cs[`PARC_INST_MSG_WB_SEL];
+
+  // Coprocessor write enable
+
+  wire cp0_wen_Dhl = cs[`PARC_INST_MSG_CP0_WEN];
+
+  // Coprocessor register specifier
+
+  wire [4:0] cp0_addr_Dhl = inst_rd_Dhl;
+
+  // Buffered Stores
+  //
+  // A store or mtc0 is buffered in the ROB if something older could
+  // still be squashed, or if an older one is still buffered, so that
+  // they reach memory and CP0 in program order
+
+  wire       st_buf_Dhl = ( dmemreq_msg_rw_Dhl || cp0_wen_Dhl )
+                       && ( ( br_tags_busy != 4'b0 ) || rob_st_busy || st_pending );
+
+  //----------------------------------------------------------------------
+  // Scoreboard
+  //----------------------------------------------------------------------
+
+  // Speculative branches take the muldiv lane to W. A divide has its
+  // result by the time it leaves D, so it takes the ALU lane.
+
+  reg [4:0] inst_latency_Dhl;
+  always @(*) begin
+    inst_latency_Dhl =
+      is_div_Dhl                             ? 5'b00010 :
+      (cs[`PARC_INST_MSG_MULDIV_EN] != n)    ? 5'b10000 :
+      br_spec_Dhl                            ? 5'b10000 :
+      (cs[`PARC_INST_MSG_MEM_REQ]   != nr)   ? 5'b00100 :
+                                               5'b00010;
+  end
+    
+  reg [2:0] inst_func_unit_Dhl;
+  always @(*) begin
+    inst_func_unit_Dhl =
+      is_div_Dhl                             ? 3'd1 :
+      (cs[`PARC_INST_MSG_MULDIV_EN] != n)    ? 3'd3 :
+      br_spec_Dhl                            ? 3'd3 :
+      (cs[`PARC_INST_MSG_MEM_REQ]   != nr)   ? 3'd2 :
+                                               3'd1;
+  end
+    
+  wire       stall_sb_Dhl;
+
+  wire [3:0] rob_fill_slot_Dhl;
+  wire       rob_req_rdy_Dhl;
+
+  // Decode can only issue with a ROB slot and a physical register free,
+  // and a branch tag for a speculative branch
+
+  wire       issue_rdy_Dhl = rob_req_rdy_Dhl && rename_rdy_Dhl
+                          && ( !br_spec_Dhl || br_tag_rdy_Dhl );
+
+  // A divide is sent to the divider once its sources are ready, and
+  // waits in D until the divider has the result
+
+  reg        div_sent_Dhl;
+
+  wire       stall_div_Dhl = ( inst_val_Dhl && is_div_Dhl && !( div_sent_Dhl && divresp_val ) );
+
+  parc_CoreScoreboard scoreboard
+  (
+    .clk                 (clk),
+    .reset               (reset),
+    .src0                (rf_raddr0_Dhl),
+    .src0_en             (rs_en_Dhl),
+    .src1                (rf_raddr1_Dhl),
+    .src1_en             (rt_en_Dhl),
+    .dst                 (prf_waddr_Dhl),
+    .dst_en              (prf_wen_Dhl),
+    .latency             (inst_latency_Dhl),
+    .func_unit           (inst_func_unit_Dhl), 
+    .inst_val_Dhl        (inst_val_Dhl),
+    .src_spec            (br_sel_Dhl != br_none),
+
+    .alloc_rdy           (issue_rdy_Dhl && !stall_div_Dhl),
+
+    .stall_Xhl           (stall_Xhl),
+    .stall_Mhl           (stall_Mhl),
+
+    .src0_byp_mux_sel    (op0_byp_mux_sel_Dhl),
+    .src1_byp_mux_sel    (op1_byp_mux_sel_Dhl),
+
+    .src_rdy             (src_rdy_Dhl),
+    .stall_hazard        (stall_sb_Dhl)
+  );
+
+  //----------------------------------------------------------------------
+  // Squash and Stall Logic
+  //----------------------------------------------------------------------
+
+  // Squash instruction in D if a valid branch in X was mispredicted, or
+  // if it is on the wrong path of a mispredicted speculative branch
+
+  wire squash_Dhl = ( inst_val_Xhl && br_mispred_Xhl )
+                 || brj_mispred_Whl || redirect_Phl;
+
+  // Aggregate Stall Signal
+
+  assign stall_Dhl = ( stall_Xhl ||
+                      (inst_val_Dhl && stall_sb_Dhl ) ||
+                      (inst_val_Dhl && !issue_rdy_Dhl) ||
+                      stall_div_Dhl );
+
+  // Next bubble bit
+
+  wire bubble_sel_Dhl  = ( squash_Dhl || stall_Dhl );
+  wire bubble_next_Dhl = ( !bubble_sel_Dhl ) ? bubble_Dhl
+                       : ( bubble_sel_Dhl )  ? 1'b1
+                       :                       1'bx;
+
+  //----------------------------------------------------------------------
+  // X <- D
+  //----------------------------------------------------------------------
+
+  reg [31:0] ir_Xhl;
+  reg  [2:0] br_sel_Xhl;
+  reg        br_spec_Xhl;
+  reg        jump_Xhl;
+  reg        pred_taken_Xhl;
+  reg  [1:0] br_tag_Xhl;
+  reg  [3:0] br_mask_Xhl;
+  reg  [5:0] br_raddr0_Xhl;
+  reg  [5:0] br_raddr1_Xhl;
+  reg  [3:0] alu_fn_Xhl;
+  reg        muldivreq_val_Xhl;
+  reg        muldiv_mux_sel_Xhl;
+  reg        execute_mux_sel_Xhl;
+  reg        is_load_Xhl;
+  reg        dmemreq_msg_rw_Xhl;
+  reg  [1:0] dmemreq_msg_len_Xhl;
+  reg        dmemreq_val_Xhl;
+  reg  [2:0] dmemresp_mux_sel_Xhl;
+  reg        wb_mux_sel_Xhl;
+  reg        rf_wen_Xhl;
+  reg  [5:0] rf_waddr_Xhl;
+  reg  [3:0] rob_fill_slot_Xhl;
+  reg        cp0_wen_Xhl;
+  reg  [4:0] cp0_addr_Xhl;
+  reg        st_buf_Xhl;
+  reg  [2:0] func_unit_Xhl;
+
+  reg        bubble_Xhl;
+
+  // Pipeline Controls
+
+  always @ ( posedge clk ) begin
+    if ( reset ) begin
+      bubble_Xhl <= 1'b1;
+    end
+    else if( !stall_Xhl ) begin
+      ir_Xhl               <= ir_Dhl;
+      br_sel_Xhl           <= br_sel_Dhl;
+      br_spec_Xhl          <= br_spec_Dhl;
+      jump_Xhl             <= jump_Dhl;
+      pred_taken_Xhl       <= pred_taken_Dhl;
+      br_tag_Xhl           <= br_tag_Dhl;
+      br_mask_Xhl          <= br_mask_Dhl & ~br_clear_Whl;
+      br_raddr0_Xhl        <= rf_raddr0_Dhl;
+      br_raddr1_Xhl        <= rf_raddr1_Dhl;
+      alu_fn_Xhl           <= alu_fn_Dhl;
+      muldivreq_val_Xhl    <= muldivreq_val_Dhl;
+      muldiv_mux_sel_Xhl   <= muldiv_mux_sel_Dhl;
+      execute_mux_sel_Xhl  <= execute_mux_sel_Dhl;
+      is_load_Xhl          <= is_load_Dhl;
+      dmemreq_msg_rw_Xhl   <= dmemreq_msg_rw_Dhl;
+      dmemreq_msg_len_Xhl  <= dmemreq_msg_len_Dhl;
+      dmemreq_val_Xhl      <= dmemreq_val_Dhl;
+      dmemresp_mux_sel_Xhl <= dmemresp_mux_sel_Dhl;
+      wb_mux_sel_Xhl       <= wb_mux_sel_Dhl;
+      rf_waddr_Xhl         <= prf_waddr_Dhl;
+      rf_wen_Xhl           <= prf_wen_Dhl;
+      rob_fill_slot_Xhl    <= rob_fill_slot_Dhl;
+      cp0_wen_Xhl          <= cp0_wen_Dhl;
+      cp0_addr_Xhl         <= cp0_addr_Dhl;
+      st_buf_Xhl           <= st_buf_Dhl;
+      func_unit_Xhl        <= inst_func_unit_Dhl;
+
+      bubble_Xhl           <= bubble_next_Dhl;
+    end
+    else begin
+      // Held, but may still be killed or see a branch resolve
+      br_mask_Xhl          <= br_mask_Xhl & ~br_clear_Whl;
+      bubble_Xhl           <= bubble_Xhl || squash_Xhl;
+    end
+
+  end
+
+  //----------------------------------------------------------------------
+  // Execute Stage
+  //----------------------------------------------------------------------
+
+  // Is the current stage valid?
+
+  wire inst_val_Xhl = ( !bubble_Xhl && !squash_Xhl );
+
+  // Muldiv request
+
+  assign muldivreq_val = is_div_Dhl ? ( inst_val_Dhl && src_rdy_Dhl && !div_sent_Dhl )
+                       :              ( muldivreq_val_Dhl && inst_val_Dhl && !stall_Dhl );
+  assign muldivresp_rdy = 1'b1;
+
+  // The divide in D takes the divider result as it leaves D. A result
+  // whose divide was squashed while it waited is dropped.
+
+  always @ ( posedge clk ) begin
+    if ( reset )
+      div_sent_Dhl <= 1'b0;
+    else if ( muldivreq_val && muldivreq_rdy && is_div_Dhl )
+      div_sent_Dhl <= 1'b1;
+    else if ( !inst_val_Dhl || !stall_Dhl )
+      div_sent_Dhl <= 1'b0;
+  end
+
+  assign divresp_rdy = ( divresp_val && !div_sent_Dhl )
+                    || ( div_sent_Dhl && inst_val_Dhl && !stall_Dhl );
+
+  // Only send a valid dmem request if not stalled. A buffered store
+  // writes its address and data to the store buffer instead, and the
+  // port is then shared with the buffered store committing at the head
+  // of the ROB; loads wait while there is one, so only one side uses it.
+
+  wire   dmemreq_val_X_Xhl = ( dmemreq_val_Xhl && !st_buf_Xhl );
+  wire   dmemreq_go_Xhl    = ( inst_val_Xhl && !stall_Xhl && dmemreq_val_X_Xhl );
+
+  assign dmemreq_msg_rw  = stbuf_req_Chl ? 1'b1 : dmemreq_msg_rw_Xhl;
+  assign dmemreq_msg_len = stbuf_req_Chl ? st_len[rob_commit_slot_Chl] : dmemreq_msg_len_Xhl;
+  assign dmemreq_val     = dmemreq_go_Xhl || stbuf_req_Chl;
+
+  assign stbuf_wen_Xhl   = ( inst_val_Xhl && !stall_Xhl && st_buf_Xhl );
+  assign stbuf_waddr_Xhl = rob_fill_slot_Xhl;
+
+  // Branch Conditions
+
+  wire beq_resolve_Xhl  = branch_cond_eq_Xhl;
+  wire bne_resolve_Xhl  = ~branch_cond_eq_Xhl;
+  wire blez_resolve_Xhl = branch_cond_zero_Xhl | branch_cond_neg_Xhl;
+  wire bgtz_resolve_Xhl = ~( branch_cond_zero_Xhl | branch_cond_neg_Xhl );
+  wire bltz_resolve_Xhl = branch_cond_neg_Xhl;
+  wire bgez_resolve_Xhl = branch_cond_zero_Xhl | ~branch_cond_neg_Xhl;
+
+  // Resolve Branch
+
+  wire beq_taken_Xhl  = ( ( br_sel_Xhl == br_beq ) && beq_resolve_Xhl );
+  wire bne_taken_Xhl  = ( ( br_sel_Xhl == br_bne ) && bne_resolve_Xhl );
+  wire blez_taken_Xhl = ( ( br_sel_Xhl == br_blez ) && blez_resolve_Xhl );
+  wire bgtz_taken_Xhl = ( ( br_sel_Xhl == br_bgtz ) && bgtz_resolve_Xhl );
+  wire bltz_taken_Xhl = ( ( br_sel_Xhl == br_bltz ) && bltz_resolve_Xhl );
+  wire bgez_taken_Xhl = ( ( br_sel_Xhl == br_bgez ) && bgez_resolve_Xhl );
+
+  wire any_br_taken_Xhl
+    = ( beq_taken_Xhl
+   ||   bne_taken_Xhl
+   ||   blez_taken_Xhl
+   ||   bgtz_taken_Xhl
+   ||   bltz_taken_Xhl
+   ||   bgez_taken_Xhl );
+
+  // A branch with its sources ready is mispredicted if it did not go
+  // the way F predicted
+
+  wire br_mispred_Xhl = ( inst_val_Xhl && ( br_sel_Xhl != br_none ) && !br_spec_Xhl
+                          && ( any_br_taken_Xhl != pred_taken_Xhl ) );
+
+  // Train the predictor once per branch or direct jump, as it leaves X.
+  // Speculative branches train it from W instead.
+
+  assign bp_update_val_Xhl
+    = ( inst_val_Xhl && !stall_Xhl && !br_spec_Xhl
+        && ( ( br_sel_Xhl != br_none ) || jump_Xhl ) );
+  assign bp_update_taken_Xhl = ( any_br_taken_Xhl || jump_Xhl );
+  assign bp_update_jump_Xhl  = jump_Xhl;
+
+  // Undo the RAS pushes and pops of the instructions being squashed
+
+  assign ras_repair_Xhl = br_mispred_Xhl;
+
+  // Squash if younger than a mispredicted speculative branch
+
+  wire squash_Xhl = brj_mispred_Whl && br_mask_Xhl[br_tag_Whl];
+
+  // Stall in X if imem is not ready
+
+  wire stall_imem_Xhl = !imemreq_rdy;
+
+  // Stall in X if dmem is not ready and there was a valid request
+
+  wire stall_dmem_Xhl = ( dmemreq_val_X_Xhl && inst_val_Xhl && !dmemreq_rdy );
+
+  // Stall in X if a memory request could pass a buffered store. Every
+  // buffered store is older than the instruction in X, since nothing
+  // younger leaves D while X is stalled.
+
+  wire stall_st_Xhl = ( dmemreq_val_X_Xhl && inst_val_Xhl && ( rob_st_busy || st_pending ) );
+
+  // Stall in X if the ALU result cannot have the writeback stage
+
+  wire stall_wb_Xhl = ( wb_req_Xhl && ( wb_req_X3hl || wb_req_Mhl ) );
+
+  // Aggregate Stall Signal
+
+  assign stall_Xhl = ( stall_Mhl || stall_imem_Xhl || stall_dmem_Xhl || stall_st_Xhl
+                    || stall_wb_Xhl );
+
+  // Next bubble bit
+
+  wire bubble_sel_Xhl  = ( squash_Xhl || stall_Xhl );
+  wire bubble_next_Xhl = ( !bubble_sel_Xhl ) ? bubble_Xhl
+                       : ( bubble_sel_Xhl )  ? 1'b1
+                       :                       1'bx;
+
+  //----------------------------------------------------------------------
+  // M <- X
+  //----------------------------------------------------------------------
+
+  reg [31:0] ir_Mhl;
+  reg  [2:0] br_sel_Mhl;
+  reg        br_spec_Mhl;
+  reg        pred_taken_Mhl;
+  reg  [1:0] br_tag_Mhl;
+  reg  [3:0] br_mask_Mhl;
+  reg  [5:0] br_raddr0_Mhl;
+  reg  [5:0] br_raddr1_Mhl;
+  reg        is_load_Mhl;
+  reg        dmemreq_val_Mhl;
+  reg  [2:0] dmemresp_mux_sel_Mhl;
+  reg        muldiv_mux_sel_Mhl;
+  reg        wb_mux_sel_Mhl;
+  reg        rf_wen_Mhl;
+  reg  [5:0] rf_waddr_Mhl;
+  reg  [3:0] rob_fill_slot_Mhl;
+  reg        cp0_wen_Mhl;
+  reg  [4:0] cp0_addr_Mhl;
+  reg        st_buf_Mhl;
+  reg  [2:0] func_unit_Mhl;
+
+  reg        bubble_Mhl;
+
+  // Pipeline Controls
+
+  always @ ( posedge clk ) begin
+    if ( reset ) begin
+      dmemreq_val_Mhl <= 1'b0;
+
+      bubble_Mhl <= 1'b1;
+    end
+    else if( !stall_Mhl ) begin
+      ir_Mhl               <= ir_Xhl;
+      br_sel_Mhl           <= br_sel_Xhl;
+      br_spec_Mhl          <= br_spec_Xhl;
+      pred_taken_Mhl       <= pred_taken_Xhl;
+      br_tag_Mhl           <= br_tag_Xhl;
+      br_mask_Mhl          <= br_mask_Xhl & ~br_clear_Whl;
+      br_raddr0_Mhl        <= br_raddr0_Xhl;
+      br_raddr1_Mhl        <= br_raddr1_Xhl;
+      is_load_Mhl          <= is_load_Xhl;
+      dmemreq_val_Mhl      <= dmemreq_go_Xhl;
+      dmemresp_mux_sel_Mhl <= dmemresp_mux_sel_Xhl;
+      muldiv_mux_sel_Mhl   <= muldiv_mux_sel_Xhl;
+      wb_mux_sel_Mhl       <= wb_mux_sel_Xhl;
+      rf_wen_Mhl           <= rf_wen_Xhl;
+      rf_waddr_Mhl         <= rf_waddr_Xhl;
+      rob_fill_slot_Mhl    <= rob_fill_slot_Xhl;
+      cp0_wen_Mhl          <= cp0_wen_Xhl;
+      cp0_addr_Mhl         <= cp0_addr_Xhl;
+      st_buf_Mhl           <= st_buf_Xhl;
+      func_unit_Mhl        <= func_unit_Xhl;
+
+      bubble_Mhl           <= bubble_next_Xhl;
+    end
+    else begin
+      br_mask_Mhl          <= br_mask_Mhl & ~br_clear_Whl;
+      bubble_Mhl           <= bubble_Mhl || squash_Mhl;
+    end
+  end
+
+  //----------------------------------------------------------------------
+  // Memory Stage
+  //----------------------------------------------------------------------
+
+  // Is current stage valid?
+
+  wire inst_val_Mhl = ( !bubble_Mhl && !squash_Mhl );
+
+  // The response to a buffered store is not for M
+
+  wire dmemresp_val_Mhl = ( dmemresp_val && !st_pending );
+
+  // Data memory queue control signals
+
+  assign dmemresp_queue_en_Mhl = ( stall_Mhl && dmemresp_val_Mhl );
+  wire   dmemresp_queue_val_next_Mhl
+    = stall_Mhl && ( dmemresp_val_Mhl || dmemresp_queue_val_Mhl );
+
+  // Squash if younger than a mispredicted speculative branch
+
+  wire squash_Mhl = brj_mispred_Whl && br_mask_Mhl[br_tag_Whl];
+
+  // Stall in M if memory response is not returned for a request. A load
+  // squashed while it waits still has to take its response.
+
+  wire stall_dmem_Mhl
+    = ( !reset && dmemreq_val_Mhl && !dmemresp_val_Mhl && !dmemresp_queue_val_Mhl );
+  wire stall_imem_Mhl
+    = ( !reset && imemreq_val_Fhl && inst_val_Fhl && !imemresp_val && !imemresp_queue_val_Fhl );
+
+  // Stall in M if the memory result cannot have the writeback stage
+
+  wire stall_wb_Mhl = ( wb_req_Mhl && wb_req_X3hl );
+
+  // Aggregate Stall Signal
+
+  wire stall_Mhl = ( stall_imem_Mhl || stall_dmem_Mhl || stall_wb_Mhl );
+
+  // Next bubble bit
+
+  wire bubble_sel_Mhl  = ( squash_Mhl || stall_Mhl );
+  wire bubble_next_Mhl = ( !bubble_sel_Mhl ) ? bubble_Mhl
+                       : ( bubble_sel_Mhl )  ? 1'b1
+                       :                       1'bx;
+
+  //----------------------------------------------------------------------
+  // X2 <- M
+  //----------------------------------------------------------------------
+  
+  reg [31:0] ir_X2hl;
+  reg  [2:0] br_sel_X2hl;
+  reg        br_spec_X2hl;
+  reg        pred_taken_X2hl;
+  reg  [1:0] br_tag_X2hl;
+  reg  [3:0] br_mask_X2hl;
+  reg  [5:0] br_raddr0_X2hl;
+  reg  [5:0] br_raddr1_X2hl;
+  reg        dmemresp_queue_val_X2hl;
+  reg        muldiv_mux_sel_X2hl;
+  reg        rf_wen_X2hl;
+  reg  [5:0] rf_waddr_X2hl;
+  reg  [3:0] rob_fill_slot_X2hl;
+  reg        cp0_wen_X2hl;
+  reg  [4:0] cp0_addr_X2hl;
+  reg  [2:0] func_unit_X2hl;
+  reg        bubble_X2hl;
+
+  // Dummy stall signal, squash if younger than a mispredicted branch
+  wire squash_X2hl = brj_mispred_Whl && br_mask_X2hl[br_tag_Whl];
+  wire stall_X2hl  = 1'b0;
+
+  // Next bubble bit
+
+  wire bubble_sel_X2hl  = ( squash_X2hl || stall_X2hl );
+  wire bubble_next_X2hl = ( !bubble_sel_X2hl ) ? bubble_X2hl
+                        : ( bubble_sel_X2hl )  ? 1'b1
+                        :                        1'bx;
+
+  always @(posedge clk) begin
+    if (reset)
+      bubble_X2hl         <= 1'b1;
+    else if (!stall_X2hl) begin
+      ir_X2hl             <= ir_Mhl;
+      br_sel_X2hl         <= br_sel_Mhl;
+      br_spec_X2hl        <= br_spec_Mhl;
+      pred_taken_X2hl     <= pred_taken_Mhl;
+      br_tag_X2hl         <= br_tag_Mhl;
+      br_mask_X2hl        <= br_mask_Mhl & ~br_clear_Whl;
+      br_raddr0_X2hl      <= br_raddr0_Mhl;
+      br_raddr1_X2hl      <= br_raddr1_Mhl;
+      muldiv_mux_sel_X2hl <= muldiv_mux_sel_Mhl;
+      rf_wen_X2hl         <= rf_wen_Mhl;
+      rf_waddr_X2hl       <= rf_waddr_Mhl;
+      rob_fill_slot_X2hl  <= rob_fill_slot_Mhl;
+      cp0_wen_X2hl        <= cp0_wen_Mhl;
+      cp0_addr_X2hl       <= cp0_addr_Mhl;
+      func_unit_X2hl      <= func_unit_Mhl;
+      bubble_X2hl         <= bubble_next_Mhl;
+    end
+  end
+      
+  //----------------------------------------------------------------------
+  // X3 <- X2
+  //----------------------------------------------------------------------
+  
+  reg [31:0] ir_X3hl;
+  reg  [2:0] br_sel_X3hl;
+  reg        br_spec_X3hl;
+  reg        pred_taken_X3hl;
+  reg  [1:0] br_tag_X3hl;
+  reg  [3:0] br_mask_X3hl;
+  reg  [5:0] br_raddr0_X3hl;
+  reg  [5:0] br_raddr1_X3hl;
+  reg        dmemresp_queue_val_X3hl;
+  reg        muldiv_mux_sel_X3hl;
+  reg        rf_wen_X3hl;
+  reg  [5:0] rf_waddr_X3hl;
+  reg  [3:0] rob_fill_slot_X3hl;
+  reg        cp0_wen_X3hl;
+  reg  [4:0] cp0_addr_X3hl;
+  reg  [2:0] func_unit_X3hl;
+  reg        bubble_X3hl;
+
+  // Dummy stall signal, squash if younger than a mispredicted branch
+  wire squash_X3hl = brj_mispred_Whl && br_mask_X3hl[br_tag_Whl];
+  wire stall_X3hl  = 1'b0;
+
+  // Next bubble bit
+
+  wire bubble_sel_X3hl  = ( squash_X3hl || stall_X3hl );
+  wire bubble_next_X3hl = ( !bubble_sel_X3hl ) ? bubble_X3hl
+                        : ( bubble_sel_X3hl )  ? 1'b1
+                        :                        1'bx;
+
+  always @(posedge clk) begin
+    if (reset)
+      bubble_X3hl         <= 1'b1;
+    else if (!stall_X3hl) begin
+      ir_X3hl             <= ir_X2hl;
+      br_sel_X3hl         <= br_sel_X2hl;
+      br_spec_X3hl        <= br_spec_X2hl;
+      pred_taken_X3hl     <= pred_taken_X2hl;
+      br_tag_X3hl         <= br_tag_X2hl;
+      br_mask_X3hl        <= br_mask_X2hl & ~br_clear_Whl;
+      br_raddr0_X3hl      <= br_raddr0_X2hl;
+      br_raddr1_X3hl      <= br_raddr1_X2hl;
+      muldiv_mux_sel_X3hl <= muldiv_mux_sel_X2hl;
+      rf_wen_X3hl         <= rf_wen_X2hl;
+      rf_waddr_X3hl       <= rf_waddr_X2hl;
+      rob_fill_slot_X3hl  <= rob_fill_slot_X2hl;
+      cp0_wen_X3hl        <= cp0_wen_X2hl;
+      cp0_addr_X3hl       <= cp0_addr_X2hl;
+      func_unit_X3hl      <= func_unit_X2hl;
+      bubble_X3hl         <= bubble_next_X2hl;
+    end
+  end
+      
+  //----------------------------------------------------------------------
+  // W <- *
+  //----------------------------------------------------------------------
+
+  reg [31:0] ir_Whl;
+  reg  [2:0] br_sel_Whl;
+  reg        br_spec_Whl;
+  reg        pred_taken_Whl;
+  reg  [1:0] br_tag_Whl;
+  reg  [3:0] br_mask_Whl;
+  reg  [5:0] br_raddr0_Whl;
+  reg  [5:0] br_raddr1_Whl;
+  reg        dmemresp_queue_val_Mhl;
+  reg        rf_wen_Whl;
+  reg  [5:0] rf_waddr_Whl;
+  reg  [3:0] rob_fill_slot_Whl;
+  reg        cp0_wen_Whl;
+  reg  [4:0] cp0_addr_Whl;
+  reg        st_buf_Whl;
+
+  reg        bubble_Whl;
+
+  // Writeback arbitration. Each unit asks for the writeback stage with
+  // the instruction in its last stage. The muldiv lane cannot stall, so
+  // it always gets it, then memory, then the ALU; the stage that loses
+  // stalls in M or X.
+
+  wire wb_req_Xhl  = !bubble_Xhl  && ( func_unit_Xhl  == `FUNC_UNIT_ALU );
+  wire wb_req_Mhl  = !bubble_Mhl  && ( func_unit_Mhl  == `FUNC_UNIT_MEM );
+  wire wb_req_X3hl = !bubble_X3hl && ( func_unit_X3hl == `FUNC_UNIT_MUL );
+
+  assign wb_mux_sel_Whl
+    = wb_req_X3hl ? `FUNC_UNIT_MUL
+    : wb_req_Mhl  ? `FUNC_UNIT_MEM
+    : wb_req_Xhl  ? `FUNC_UNIT_ALU
+    :               2'd0;
+
+  // Pipeline Controls
+
+  always @(posedge clk) begin
+    if (reset) begin
+      bubble_Whl   <= 1'b1;
+    end else case(wb_mux_sel_Whl)
+    `FUNC_UNIT_ALU: begin
+      ir_Whl            <= ir_Xhl;
+      br_spec_Whl       <= 1'b0;
+      br_mask_Whl       <= br_mask_Xhl & ~br_clear_Whl;
+      rf_wen_Whl        <= rf_wen_Xhl;
+      rf_waddr_Whl      <= rf_waddr_Xhl;
+      rob_fill_slot_Whl <= rob_fill_slot_Xhl;
+      cp0_wen_Whl       <= cp0_wen_Xhl;
+      cp0_addr_Whl      <= cp0_addr_Xhl;
+      st_buf_Whl        <= st_buf_Xhl;
+      bubble_Whl        <= bubble_next_Xhl;
+    end
+    `FUNC_UNIT_MEM: begin
+      ir_Whl            <= ir_Mhl;
+      br_spec_Whl       <= 1'b0;
+      br_mask_Whl       <= br_mask_Mhl & ~br_clear_Whl;
+      rf_wen_Whl        <= rf_wen_Mhl;
+      rf_waddr_Whl      <= rf_waddr_Mhl;
+      rob_fill_slot_Whl <= rob_fill_slot_Mhl;
+      cp0_wen_Whl       <= cp0_wen_Mhl;
+      cp0_addr_Whl      <= cp0_addr_Mhl;
+      st_buf_Whl        <= st_buf_Mhl;
+      bubble_Whl        <= bubble_next_Mhl;
+    end
+    `FUNC_UNIT_MUL: begin
+      ir_Whl            <= ir_X3hl;
+      br_sel_Whl        <= br_sel_X3hl;
+      br_spec_Whl       <= br_spec_X3hl;
+      pred_taken_Whl    <= pred_taken_X3hl;
+      br_tag_Whl        <= br_tag_X3hl;
+      br_mask_Whl       <= br_mask_X3hl & ~br_clear_Whl;
+      br_raddr0_Whl     <= br_raddr0_X3hl;
+      br_raddr1_Whl     <= br_raddr1_X3hl;
+      rf_wen_Whl        <= rf_wen_X3hl;
+      rf_waddr_Whl      <= rf_waddr_X3hl;
+      rob_fill_slot_Whl <= rob_fill_slot_X3hl;
+      cp0_wen_Whl       <= cp0_wen_X3hl;
+      cp0_addr_Whl      <= cp0_addr_X3hl;
+      st_buf_Whl        <= 1'b0;
+      bubble_Whl        <= bubble_next_X3hl;
+    end
+    default: begin
+      ir_Whl            <= 32'b0;
+      br_spec_Whl       <= 1'b0;
+      br_mask_Whl       <= 4'b0;
+      rf_wen_Whl        <= 1'b0;
+      rf_waddr_Whl      <= 6'b0;
+      rob_fill_slot_Whl <= 5'b0;
+      cp0_wen_Whl       <= 1'b0;
+      cp0_addr_Whl      <= 5'b0;
+      st_buf_Whl        <= 1'b0;
+      bubble_Whl        <= 1'b1;
+    end
+    endcase
+    dmemresp_queue_val_Mhl <= dmemresp_queue_val_next_Mhl;
+  end
+
+  //----------------------------------------------------------------------
+  // Writeback Stage
+  //----------------------------------------------------------------------
+
+  // Is current stage valid?
+
+  wire inst_val_Whl = ( !bubble_Whl && !squash_Whl );
+
+  // Only set register file wen if stage is valid
+
+  assign rf_wen_out_Whl = ( inst_val_Whl && !stall_Whl && rf_wen_Whl );
+
+  // Dummy squahs and stall signals
+
+  wire squash_Whl = 1'b0;
+  wire stall_Whl  = 1'b0;
+
+  // Speculative Branch Conditions
+
+  wire beq_resolve_Whl  = branch_cond_eq_Whl;
+  wire bne_resolve_Whl  = ~branch_cond_eq_Whl;
+  wire blez_resolve_Whl = branch_cond_zero_Whl | branch_cond_neg_Whl;
+  wire bgtz_resolve_Whl = ~( branch_cond_zero_Whl | branch_cond_neg_Whl );
+  wire bltz_resolve_Whl = branch_cond_neg_Whl;
+  wire bgez_resolve_Whl = branch_cond_zero_Whl | ~branch_cond_neg_Whl;
+
+  // Resolve Speculative Branch
+
+  wire beq_taken_Whl  = ( ( br_sel_Whl == br_beq ) && beq_resolve_Whl );
+  wire bne_taken_Whl  = ( ( br_sel_Whl == br_bne ) && bne_resolve_Whl );
+  wire blez_taken_Whl = ( ( br_sel_Whl == br_blez ) && blez_resolve_Whl );
+  wire bgtz_taken_Whl = ( ( br_sel_Whl == br_bgtz ) && bgtz_resolve_Whl );
+  wire bltz_taken_Whl = ( ( br_sel_Whl == br_bltz ) && bltz_resolve_Whl );
+  wire bgez_taken_Whl = ( ( br_sel_Whl == br_bgez ) && bgez_resolve_Whl );
+
+  wire any_br_taken_Whl
+    = ( beq_taken_Whl
+   ||   bne_taken_Whl
+   ||   blez_taken_Whl
+   ||   bgtz_taken_Whl
+   ||   bltz_taken_Whl
+   ||   bgez_taken_Whl );
+
+  // Either way the branch frees its tag; one that did not go the way F
+  // predicted also kills everything issued after it
+
+  wire       br_resolve_Whl  = ( inst_val_Whl && br_spec_Whl );
+  assign     brj_mispred_Whl = ( br_resolve_Whl && ( any_br_taken_Whl != pred_taken_Whl ) );
+  assign     brj_taken_Whl   = any_br_taken_Whl;
+
+  // Train the predictor and undo the RAS pushes and pops of the
+  // instructions being killed
+
+  assign bp_update_val_Whl   = br_resolve_Whl;
+  assign bp_update_taken_Whl = any_br_taken_Whl;
+  assign ras_repair_Whl      = brj_mispred_Whl;
+
+  wire [3:0] br_clear_Whl
+    = br_resolve_Whl ? ( 4'b1 << br_tag_Whl ) : 4'b0;
+  
+  //----------------------------------------------------------------------
+  // Reorder Buffer
+  //----------------------------------------------------------------------
+
+  // Speculative branches hold a slot too, so nothing younger commits
+  // before they resolve, and so do buffered stores, which take effect
+  // when they commit
+
+  wire rob_req_val_Dhl = inst_val_Dhl && !stall_Dhl
+                      && ( prf_wen_Dhl || br_spec_Dhl || st_buf_Dhl );
+
+  wire       rob_fill_wen_Whl = inst_val_Whl && ( rf_wen_Whl || br_spec_Whl || st_buf_Whl );
+
+  wire [3:0] rob_commit_slot_Chl;
+  wire       rob_commit_st_Chl;
+  wire       rob_st_busy;
+
+  // What each buffered store does when it commits, by slot: an mtc0 to
+  // st_cp0_addr, or else a store of st_len
+
+  reg        st_cp0      [15:0];
+  reg  [4:0] st_cp0_addr [15:0];
+  reg  [1:0] st_len      [15:0];
+
+  always @ ( posedge clk ) begin
+    if ( rob_req_val_Dhl && st_buf_Dhl ) begin
+      st_cp0[rob_fill_slot_Dhl]      <= cp0_wen_Dhl;
+      st_cp0_addr[rob_fill_slot_Dhl] <= cp0_addr_Dhl;
+      st_len[rob_fill_slot_Dhl]      <= dmemreq_msg_len_Dhl;
+    end
+  end
+
+  // A buffered store at the head sends its request once nothing else is
+  // using the data memory port, and commits when it is accepted. Its
+  // response is then pending until it comes back. A buffered mtc0
+  // commits straight away.
+
+  wire       st_cp0_Chl    = st_cp0[rob_commit_slot_Chl];
+
+  assign     stbuf_req_Chl   = rob_commit_st_Chl && !st_cp0_Chl
+                            && !st_pending && !dmemreq_val_Mhl;
+  assign     stbuf_raddr_Chl = rob_commit_slot_Chl;
+
+  wire       st_commit_rdy_Chl = st_cp0_Chl || ( stbuf_req_Chl && dmemreq_rdy );
+
+  reg        st_pending;
+
+  always @ ( posedge clk ) begin
+    if ( reset )
+      st_pending <= 1'b0;
+    else if ( stbuf_req_Chl && dmemreq_rdy )
+      st_pending <= 1'b1;
+    else if ( dmemresp_val )
+      st_pending <= 1'b0;
+  end
+
+  parc_CoreReorderBuffer rob
+  (
+    .clk                       (clk),
+    .reset                     (reset),
+    .rob_alloc_req_val         (rob_req_val_Dhl),
+    .rob_alloc_req_rdy         (rob_req_rdy_Dhl),
+    .rob_alloc_req_wen         (prf_wen_Dhl),
+    .rob_alloc_req_areg        (rf_waddr_Dhl),
+    .rob_alloc_req_preg        (prf_waddr_Dhl),
+    .rob_alloc_req_old_preg    (prf_old_waddr_Dhl),
+    .rob_alloc_req_st          (st_buf_Dhl),
+    .rob_alloc_resp_slot       (rob_fill_slot_Dhl),
+    .rob_fill_val              (rob_fill_wen_Whl),
+    .rob_fill_slot             (rob_fill_slot_Whl),
+    .rob_squash_val            (brj_mispred_Whl),
+    .rob_squash_tail           (rob_fill_slot_Whl + 1'b1),
+    .rob_commit_slot           (rob_commit_slot_Chl),
+    .rob_commit_wen            (rob_commit_wen_Chl),
+    .rob_commit_areg           (rob_commit_areg_Chl),
+    .rob_commit_preg           (rob_commit_preg_Chl),
+    .rob_commit_old_preg       (rob_commit_old_preg_Chl),
+    .rob_commit_st             (rob_commit_st_Chl),
+    .rob_commit_st_rdy         (st_commit_rdy_Chl),
+    .rob_st_busy               (rob_st_busy)
+  );
+
+  //----------------------------------------------------------------------
+  // Debug registers for instruction disassembly
+  //----------------------------------------------------------------------
+
+  reg [31:0] ir_debug;
+  reg        inst_val_debug;
+
+  always @ ( posedge clk ) begin
+    ir_debug       <= ir_Whl;
+    inst_val_debug <= inst_val_Whl;
+  end
+
+  //----------------------------------------------------------------------
+  // Coprocessor 0
+  //----------------------------------------------------------------------
+
+  reg  [31:0] cp0_status;
+  reg         cp0_stats;
+
+  // An mtc0 writes CP0 in W, or as it commits if it was buffered
+
+  always @ ( posedge clk ) begin
+    if ( cp0_wen_Whl && inst_val_Whl && !st_buf_Whl ) begin
+      case ( cp0_addr_Whl )
+        5'd10 : cp0_stats  <= proc2cop_data_Whl[0];
+        5'd21 : cp0_status <= proc2cop_data_Whl;
+      endcase
+    end
+    else if ( rob_commit_st_Chl && st_cp0_Chl ) begin
+      case ( st_cp0_addr[rob_commit_slot_Chl] )
+        5'd10 : cp0_stats  <= proc2cop_data_Chl[0];
+        5'd21 : cp0_status <= proc2cop_data_Chl;
+      endcase
+    end
+  end
+
+//========================================================================
+// Disassemble instructions
+//========================================================================
+
+  `ifndef SYNTHESIS
+
+  parc_InstMsgDisasm inst_msg_disasm_D
+  (
+    .msg ( ir_Dhl )
+  );
+
+  parc_InstMsgDisasm inst_msg_disasm_X
+  (
+    .msg ( ir_Xhl )
+  );
+
+  parc_InstMsgDisasm inst_msg_disasm_M
+  (
+    .msg ( ir_Mhl )
+  );
+
+  parc_InstMsgDisasm inst_msg_disasm_W
+  (
+    .msg ( ir_Whl )
+  );
+
+  parc_InstMsgDisasm inst_msg_disasm_debug
+  (
+    .msg ( ir_debug )
+  );
+
+  `endif
+
+//========================================================================
+// Assertions
+//========================================================================
+// Detect illegal instructions and terminate the simulation if multiple
+// illegal instructions are detected in succession.
+
+  `ifndef SYNTHESIS
+
+  reg overload = 1'b0;
+
+  always @ ( posedge clk ) begin
+    if ( !cs[`PARC_INST_MSG_INST_VAL] && !reset ) begin
+      $display(" RTL-ERROR : %m : Illegal instruction!");
+
+      if ( overload == 1'b1 ) begin
+        $finish;
+      end
+
+      overload = 1'b1;
+    end
+    else begin
+      overload = 1'b0;
+    end
+  end
+
+  `endif
+
+//========================================================================
+// Stats
+//========================================================================
+
+  `ifndef SYNTHESIS
+
+  reg [31:0] num_inst    = 32'b0;
+  reg [31:0] num_cycles  = 32'b0;
+  reg [31:0] num_br      = 32'b0;
+  reg [31:0] num_br_miss = 32'b0;
+  reg [31:0] num_ras_hit  = 32'b0;
+  reg [31:0] num_ras_miss = 32'b0;
+  reg        stats_en    = 1'b0; // Used for enabling stats on asm tests
+
+  // Instructions which have left W but still depend on an unresolved
+  // speculative branch, indexed by their branch mask. Younger
+  // instructions can reach W down the ALU and memory lanes before the
+  // branch does down the muldiv lane, so one on the wrong path may get
+  // through W before it is known to be wrong.
+
+  reg [31:0] num_inst_spec [15:0];
+  integer    m;
+
+  initial begin
+    for ( m = 0; m < 16; m = m + 1 )
+      num_inst_spec[m] = 32'b0;
+  end
+
+  always @( posedge clk ) begin
+    if ( !reset ) begin
+
+      // Count cycles if stats are enabled
+
+      if ( stats_en || cp0_stats ) begin
+        num_cycles = num_cycles + 1;
+
+        if ( inst_val_Whl ) begin
+          num_inst_spec[br_mask_Whl] = num_inst_spec[br_mask_Whl] + 1;
+        end
+
+        // Count branches and direct jumps as they resolve, in X or for
+        // a speculative branch in W, and those the predictor got wrong
+
+        if ( bp_update_val_Xhl ) begin
+          num_br = num_br + 1;
+          if ( bp_update_taken_Xhl != pred_taken_Xhl )
+            num_br_miss = num_br_miss + 1;
+        end
+
+        if ( br_resolve_Whl ) begin
+          num_br = num_br + 1;
+          if ( brj_mispred_Whl )
+            num_br_miss = num_br_miss + 1;
+        end
+
+        // Count returns as they leave D, and whether the RAS was right
+
+        if ( inst_val_Dhl && !stall_Dhl && ras_ret_Dhl ) begin
+          if ( ras_targ_match_Dhl )
+            num_ras_hit = num_ras_hit + 1;
+          else
+            num_ras_miss = num_ras_miss + 1;
+        end
+
+      end
+
+      // A branch resolving in W drops its tag from every waiting mask,
+      // or on a misprediction drops every instruction waiting on it.
+      // An instruction whose mask is empty is on the right path and
+      // counts.
+
+      if ( br_resolve_Whl ) begin
+        for ( m = 0; m < 16; m = m + 1 ) begin
+          if ( (m >> br_tag_Whl) & 1 ) begin
+            if ( !brj_mispred_Whl )
+              num_inst_spec[m & ~(1 << br_tag_Whl)]
+                = num_inst_spec[m & ~(1 << br_tag_Whl)] + num_inst_spec[m];
+            num_inst_spec[m] = 32'b0;
+          end
+        end
+      end
+
+      num_inst = num_inst + num_inst_spec[0];
+      num_inst_spec[0] = 32'b0;
+
+    end
+  end
+
+  `endif
+
+endmodule
+
+`endif
+
@@ -0,0 +1,673 @@
+//=========================================================================
+// 5-Stage PARCv2 Datapath
+//=========================================================================
+
+`ifndef PARC_CORE_DPATH_V
+`define PARC_CORE_DPATH_V
+
+`include "pv2ooo-CoreDpathPipeMulDiv.v"
+`include "pv2ooo-InstMsg.v"
+`include "pv2ooo-CoreDpathAlu.v"
+`include "pv2spec-CoreDpathRegfile.v"
+`include "pv2ooo-CoreDpathBranchPred.v"
+`include "pv2ooo-CoreDpathReturnStack.v"
+
+module parc_CoreDpath
+(
+  input clk,
+  input reset,
+
+  // Instruction Memory Port
+
+  output [31:0] imemreq_msg_addr,
+
+  // Data Memory Port
+
+  output [31:0] dmemreq_msg_addr,
+  output [31:0] dmemreq_msg_data,
+  input  [31:0] dmemresp_msg_data,
+
+  // Controls Signals (ctrl->dpath)
+
+  input   [2:0] pc_mux_sel_Phl,
+  input   [5:0] rf_raddr0_Dhl,
+  input   [5:0] rf_raddr1_Dhl,
+  input   [2:0] op0_byp_mux_sel_Dhl,
+  input   [1:0] op0_mux_sel_Dhl,
+  input   [2:0] op1_byp_mux_sel_Dhl,
+  input   [2:0] op1_mux_sel_Dhl,
+  input  [31:0] inst_Dhl,
+  input   [3:0] alu_fn_Xhl,
+  input   [2:0] muldivreq_msg_fn_Dhl,
+  input         muldivreq_val,
+  output        muldivreq_rdy,
+  output        muldivresp_val,
+  input         muldivresp_rdy,
+  input         muldiv_mux_sel_X3hl,
+  output        divresp_val,
+  input         divresp_rdy,
+  input         execute_mux_sel_Xhl,
+  input         muldiv_mux_sel_Xhl,
+  input   [2:0] dmemresp_mux_sel_Mhl,
+  input         dmemresp_queue_en_Mhl,
+  input         dmemresp_queue_val_Mhl,
+  input   [1:0] wb_mux_sel_Whl,
+  input         rf_wen_Whl,
+  input  [ 5:0] rf_waddr_Whl,
+  input         bp_update_val_Xhl,
+  input         bp_update_taken_Xhl,
+  input         bp_update_jump_Xhl,
+  input         ras_push_Fhl,
+  input         ras_pop_Fhl,
+  input         ras_repair_Xhl,
+  input  [ 5:0] br_raddr0_Whl,
+  input  [ 5:0] br_raddr1_Whl,
+  input         bp_update_val_Whl,
+  input         bp_update_taken_Whl,
+  input         ras_repair_Whl,
+  input         brj_mispred_Whl,
+  input         brj_taken_Whl,
+  input         stbuf_wen_Xhl,
+  input   [3:0] stbuf_waddr_Xhl,
+  input         stbuf_req_Chl,
+  input   [3:0] stbuf_raddr_Chl,
+  input         stall_Fhl,
+  input         stall_Dhl,
+  input         stall_Xhl,
+  input         stall_Mhl,
+  input         stall_Whl,
+
+  // Control Signals (dpath->ctrl)
+
+  output        branch_cond_eq_Xhl,
+  output        branch_cond_zero_Xhl,
+  output        branch_cond_neg_Xhl,
+  output        pred_taken_Fhl,
+  output        ras_targ_match_Dhl,
+  output        branch_cond_eq_Whl,
+  output        branch_cond_zero_Whl,
+  output        branch_cond_neg_Whl,
+  output [31:0] proc2cop_data_Whl,
+  output [31:0] proc2cop_data_Chl
+);
+
+  //--------------------------------------------------------------------
+  // PC Logic Stage
+  //--------------------------------------------------------------------
+
+  // PC mux
+
+  wire [31:0] pc_plus4_Phl;
+  wire [31:0] branch_targ_Phl;
+  wire [31:0] jump_targ_Phl;
+  wire [31:0] jumpreg_targ_Phl;
+  wire [31:0] pred_targ_Phl;
+  wire [31:0] fallthru_Phl;
+  wire [31:0] ras_targ_Phl;
+  wire [31:0] pc_mux_out_Phl;
+
+  wire [31:0] reset_vector = 32'h00080000;
+
+  // Pull mux inputs from later stages
+
+  assign pc_plus4_Phl       = pc_plus4_Fhl;
+  assign branch_targ_Phl    = branch_targ_Xhl;
+  assign jump_targ_Phl      = jump_targ_Dhl;
+  assign jumpreg_targ_Phl   = jumpreg_targ_Dhl;
+  assign pred_targ_Phl      = pred_targ_Fhl;
+  assign fallthru_Phl       = pc_plus4_Xhl;
+  assign ras_targ_Phl       = ras_targ_Fhl;
+
+  // A mispredicted speculative branch redirects fetch from W to its
+  // target or its fall-through. The address is held here until the PC
+  // stage is free to send it.
+
+  reg  [31:0] redirect_targ_Phl;
+
+  always @ (posedge clk) begin
+    if ( brj_mispred_Whl ) begin
+      redirect_targ_Phl <= brj_taken_Whl ? branch_targ_Whl : pc_plus4_Whl;
+    end
+  end
+
+  assign pc_mux_out_Phl
+    = ( pc_mux_sel_Phl == 3'd0 ) ? pc_plus4_Phl
+    : ( pc_mux_sel_Phl == 3'd1 ) ? branch_targ_Phl
+    : ( pc_mux_sel_Phl == 3'd2 ) ? jump_targ_Phl
+    : ( pc_mux_sel_Phl == 3'd3 ) ? jumpreg_targ_Phl
+    : ( pc_mux_sel_Phl == 3'd4 ) ? pred_targ_Phl
+    : ( pc_mux_sel_Phl == 3'd5 ) ? fallthru_Phl
+    : ( pc_mux_sel_Phl == 3'd6 ) ? ras_targ_Phl
+    : ( pc_mux_sel_Phl == 3'd7 ) ? redirect_targ_Phl
+    :                              32'bx;
+
+  // Send out imem request early
+
+  assign imemreq_msg_addr
+    = ( reset ) ? reset_vector
+    :             pc_mux_out_Phl;
+
+  //----------------------------------------------------------------------
+  // F <- P
+  //----------------------------------------------------------------------
+
+  reg  [31:0] pc_Fhl;
+
+  always @ (posedge clk) begin
+    if( reset ) begin
+      pc_Fhl <= reset_vector;
+    end
+    else if( !stall_Fhl ) begin
+      pc_Fhl <= pc_mux_out_Phl;
+    end
+  end
+
+  //--------------------------------------------------------------------
+  // Fetch Stage
+  //--------------------------------------------------------------------
+
+  // PC incrementer
+
+  wire [31:0] pc_plus4_Fhl;
+
+  assign pc_plus4_Fhl = pc_Fhl + 32'd4;
+
+  // Branch predictor, looked up with the fetch pc and updated with each
+  // branch or direct jump as it resolves in X, or with a speculative
+  // branch as it resolves in W. W has the one update port to itself
+  // that cycle, so a branch leaving X alongside goes untrained.
+
+  wire [31:0] pred_targ_Fhl;
+
+  parc_CoreDpathBranchPred bpred
+  (
+    .clk          (clk),
+    .reset        (reset),
+    .pc           (pc_Fhl),
+    .pred_taken   (pred_taken_Fhl),
+    .pred_targ    (pred_targ_Fhl),
+    .update_val   (bp_update_val_Whl || bp_update_val_Xhl),
+    .update_pc    (bp_update_val_Whl ? pc_Whl : pc_Xhl),
+    .update_taken (bp_update_val_Whl ? bp_update_taken_Whl : bp_update_taken_Xhl),
+    .update_targ  (bp_update_val_Whl  ? branch_targ_Whl
+                  : bp_update_jump_Xhl ? jump_targ_Xhl
+                  :                      branch_targ_Xhl)
+  );
+
+  // Return address stack, pushed and popped by calls and returns in F
+  // and repaired from the checkpoint of a branch mispredicted in X or,
+  // taking priority as the older, in W
+
+  wire [31:0] ras_targ_Fhl;
+  wire  [2:0] ras_tos_Fhl;
+  wire [31:0] ras_top_Fhl;
+
+  parc_CoreDpathReturnStack ras
+  (
+    .clk        (clk),
+    .reset      (reset),
+    .push       (ras_push_Fhl),
+    .push_addr  (pc_plus4_Fhl),
+    .pop        (ras_pop_Fhl),
+    .top        (ras_targ_Fhl),
+    .ckpt_tos   (ras_tos_Fhl),
+    .ckpt_top   (ras_top_Fhl),
+    .repair     (ras_repair_Whl || ras_repair_Xhl),
+    .repair_tos (ras_repair_Whl ? ras_tos_Whl : ras_tos_Xhl),
+    .repair_top (ras_repair_Whl ? ras_top_Whl : ras_top_Xhl)
+  );
+
+  //----------------------------------------------------------------------
+  // D <- F
+  //----------------------------------------------------------------------
+
+  reg [31:0] pc_Dhl;
+  reg [31:0] pc_plus4_Dhl;
+  reg [31:0] ras_targ_Dhl;
+  reg  [2:0] ras_tos_Dhl;
+  reg [31:0] ras_top_Dhl;
+
+  always @ (posedge clk) begin
+    if( !stall_Dhl ) begin
+      pc_Dhl       <= pc_Fhl;
+      pc_plus4_Dhl <= pc_plus4_Fhl;
+      ras_targ_Dhl <= ras_targ_Fhl;
+      ras_tos_Dhl  <= ras_tos_Fhl;
+      ras_top_Dhl  <= ras_top_Fhl;
+    end
+  end
+
+  //--------------------------------------------------------------------
+  // Decode Stage (Register Read)
+  //--------------------------------------------------------------------
+
+  // Parse instruction fields
+
+  wire   [4:0] inst_rs_Dhl;
+  wire   [4:0] inst_rt_Dhl;
+  wire   [4:0] inst_rd_Dhl;
+  wire   [4:0] inst_shamt_Dhl;
+  wire  [15:0] inst_imm_Dhl;
+  wire         inst_imm_sign_Dhl;
+  wire  [25:0] inst_target_Dhl;
+
+  parc_InstMsgFromBits inst_msg_from_bits
+  (
+    .msg      (inst_Dhl),
+    .opcode   (),
+    .rs       (inst_rs_Dhl),
+    .rt       (inst_rt_Dhl),
+    .rd       (inst_rd_Dhl),
+    .shamt    (inst_shamt_Dhl),
+    .func     (),
+    .imm      (inst_imm_Dhl),
+    .imm_sign (inst_imm_sign_Dhl),
+    .target   (inst_target_Dhl)
+  );
+
+  // Branch and jump address generation
+
+  wire [31:0] branch_targ_Dhl;
+  wire [31:0] jump_targ_Dhl;
+
+  assign branch_targ_Dhl = pc_plus4_Dhl + (imm_sext_Dhl << 2);
+  assign jump_targ_Dhl   = { pc_plus4_Dhl[31:28], inst_target_Dhl, 2'b0 };
+
+  // Register file, read at the physical registers rs and rt are
+  // renamed to
+
+  wire [31:0] rf_rdata0_Dhl;
+  wire [31:0] rf_rdata1_Dhl;
+
+  // Jump reg address
+
+  wire [31:0] jumpreg_targ_Dhl;
+
+  assign jumpreg_targ_Dhl  = op0_byp_mux_out_Dhl;
+
+  // Check a return against the target the RAS predicted in F
+
+  assign ras_targ_match_Dhl = ( jumpreg_targ_Dhl == ras_targ_Dhl );
+
+  // Zero and sign extension immediate
+
+  wire [31:0] imm_sext_Dhl = { {16{inst_imm_sign_Dhl}}, inst_imm_Dhl };
+  wire [31:0] imm_zext_Dhl = { 16'b0, inst_imm_Dhl };
+
+  // Shift amount immediate
+
+  wire [31:0] shamt_Dhl = { 27'b0, inst_shamt_Dhl };
+
+  // Constant operand mux inputs
+
+  wire [31:0] const0    = 32'd0;
+  wire [31:0] const16   = 32'd16;
+
+  // Operand 0 bypass mux
+
+  wire [31:0] op0_byp_mux_out_Dhl
+    = ( op0_byp_mux_sel_Dhl == 3'd0 ) ? rf_rdata0_Dhl
+    : ( op0_byp_mux_sel_Dhl == 3'd1 ) ? execute_mux_out_Xhl
+    : ( op0_byp_mux_sel_Dhl == 3'd2 ) ? dmemresp_queue_mux_out_Mhl
+    : ( op0_byp_mux_sel_Dhl == 3'd3 ) ? muldiv_mux_out_X3hl
+    : ( op0_byp_mux_sel_Dhl == 3'd4 ) ? wb_mux_out_Whl
+    :                                   32'bx;
+
+  // Operand 0 mux
+
+  wire [31:0] op0_mux_out_Dhl
+    = ( op0_mux_sel_Dhl == 2'd0 ) ? op0_byp_mux_out_Dhl
+    : ( op0_mux_sel_Dhl == 2'd1 ) ? shamt_Dhl
+    : ( op0_mux_sel_Dhl == 2'd2 ) ? const16
+    : ( op0_mux_sel_Dhl == 2'd3 ) ? const0
+    :                               32'bx;
+
+  // Operand 1 bypass mux
+
+  wire [31:0] op1_byp_mux_out_Dhl
+    = ( op1_byp_mux_sel_Dhl == 3'd0 ) ? rf_rdata1_Dhl
+    : ( op1_byp_mux_sel_Dhl == 3'd1 ) ? execute_mux_out_Xhl
+    : ( op1_byp_mux_sel_Dhl == 3'd2 ) ? dmemresp_queue_mux_out_Mhl
+    : ( op1_byp_mux_sel_Dhl == 3'd3 ) ? muldiv_mux_out_X3hl
+    : ( op1_byp_mux_sel_Dhl == 3'd4 ) ? wb_mux_out_Whl
+    :                                   32'bx;
+
+  // Operand 1 mux
+
+  wire [31:0] op1_mux_out_Dhl
+    = ( op1_mux_sel_Dhl == 3'd0 ) ? op1_byp_mux_out_Dhl
+    : ( op1_mux_sel_Dhl == 3'd1 ) ? imm_zext_Dhl
+    : ( op1_mux_sel_Dhl == 3'd2 ) ? imm_sext_Dhl
+    : ( op1_mux_sel_Dhl == 3'd3 ) ? pc_plus4_Dhl
+    : ( op1_mux_sel_Dhl == 3'd4 ) ? const0
+    :                               32'bx;
+
+  // wdata with bypassing
+
+  wire [31:0] wdata_Dhl = op1_byp_mux_out_Dhl;
+
+  //----------------------------------------------------------------------
+  // X <- D
+  //----------------------------------------------------------------------
+
+  reg [31:0] pc_Xhl;
+  reg [31:0] pc_plus4_Xhl;
+  reg [31:0] branch_targ_Xhl;
+  reg [31:0] jump_targ_Xhl;
+  reg  [2:0] ras_tos_Xhl;
+  reg [31:0] ras_top_Xhl;
+  reg [31:0] op0_mux_out_Xhl;
+  reg [31:0] op1_mux_out_Xhl;
+  reg [31:0] wdata_Xhl;
+
+  always @ (posedge clk) begin
+    if( !stall_Xhl ) begin
+      pc_Xhl          <= pc_Dhl;
+      pc_plus4_Xhl    <= pc_plus4_Dhl;
+      branch_targ_Xhl <= branch_targ_Dhl;
+      jump_targ_Xhl   <= jump_targ_Dhl;
+      ras_tos_Xhl     <= ras_tos_Dhl;
+      ras_top_Xhl     <= ras_top_Dhl;
+      op0_mux_out_Xhl <= op0_mux_out_Dhl;
+      op1_mux_out_Xhl <= op1_mux_out_Dhl;
+      wdata_Xhl       <= wdata_Dhl;
+    end
+  end
+
+  //----------------------------------------------------------------------
+  // Execute Stage
+  //----------------------------------------------------------------------
+
+  // ALU
+
+  wire [31:0] alu_out_Xhl;
+
+  parc_CoreDpathAlu alu
+  (
+    .in0  (op0_mux_out_Xhl),
+    .in1  (op1_mux_out_Xhl),
+    .fn   (alu_fn_Xhl),
+    .out  (alu_out_Xhl)
+  );
+
+  // Branch condition logic
+
+  assign branch_cond_eq_Xhl    = ( alu_out_Xhl == 32'd0 );
+  assign branch_cond_zero_Xhl  = ( op0_mux_out_Xhl == 32'd0 );
+  assign branch_cond_neg_Xhl   = ( op0_mux_out_Xhl[31] == 1'b1 );
+
+  // Store buffer: a store or mtc0 the ROB holds until commit leaves its
+  // address and data here, in its ROB slot. For an mtc0 the data is the
+  // value written to CP0.
+
+  reg [31:0] stbuf_addr [15:0];
+  reg [31:0] stbuf_data [15:0];
+
+  always @ (posedge clk) begin
+    if ( stbuf_wen_Xhl ) begin
+      stbuf_addr[stbuf_waddr_Xhl] <= alu_out_Xhl;
+      stbuf_data[stbuf_waddr_Xhl] <= wdata_Xhl;
+    end
+  end
+
+  assign proc2cop_data_Chl = stbuf_data[stbuf_raddr_Chl];
+
+  // Send out memory request during X, response returns in M. A buffered
+  // store sends its request from the store buffer as it commits.
+
+  assign dmemreq_msg_addr = stbuf_req_Chl ? stbuf_addr[stbuf_raddr_Chl] : alu_out_Xhl;
+  assign dmemreq_msg_data = stbuf_req_Chl ? stbuf_data[stbuf_raddr_Chl] : wdata_Xhl;
+
+  // Muldiv Unit
+
+  wire [63:0] muldivresp_msg_result_X3hl;
+  wire [63:0] divresp_msg_result;
+
+  parc_CoreDpathPipeMulDiv muldiv
+  (
+    .clk                   (clk),
+    .reset                 (reset),
+    .stall_mult1           (stall_Mhl),
+    .muldivreq_msg_fn      (muldivreq_msg_fn_Dhl),
+    .muldivreq_msg_a       (op0_mux_out_Dhl),
+    .muldivreq_msg_b       (op1_mux_out_Dhl),
+    .muldivreq_val         (muldivreq_val),
+    .muldivreq_rdy         (muldivreq_rdy),
+    .muldivresp_msg_result (muldivresp_msg_result_X3hl),
+    .muldivresp_val        (muldivresp_val),
+    .muldivresp_rdy        (muldivresp_rdy),
+    .divresp_msg_result    (divresp_msg_result),
+    .divresp_val           (divresp_val),
+    .divresp_rdy           (divresp_rdy)
+  );
+
+  // Muldiv Result Mux
+
+  wire [31:0] muldiv_mux_out_X3hl
+    = ( muldiv_mux_sel_X3hl == 1'd0 ) ? muldivresp_msg_result_X3hl[31:0]
+    : ( muldiv_mux_sel_X3hl == 1'd1 ) ? muldivresp_msg_result_X3hl[63:32]
+    :                                   32'bx;
+
+  // A divide leaves D with the divider result and writes it back down
+  // the ALU lane, so X selects it in place of the ALU output
+
+  reg [63:0] divresp_msg_result_Xhl;
+
+  always @ (posedge clk) begin
+    if( !stall_Xhl ) begin
+      divresp_msg_result_Xhl <= divresp_msg_result;
+    end
+  end
+
+  wire [31:0] div_mux_out_Xhl
+    = ( muldiv_mux_sel_Xhl == 1'd0 ) ? divresp_msg_result_Xhl[31:0]
+    : ( muldiv_mux_sel_Xhl == 1'd1 ) ? divresp_msg_result_Xhl[63:32]
+    :                                  32'bx;
+
+  // Execute Mux
+
+  wire [31:0] execute_mux_out_Xhl
+    = ( execute_mux_sel_Xhl == 1'd0 ) ? alu_out_Xhl
+    : ( execute_mux_sel_Xhl == 1'd1 ) ? div_mux_out_Xhl
+    :                                   32'bx;
+
+  //----------------------------------------------------------------------
+  // M <- X
+  //----------------------------------------------------------------------
+
+  reg  [31:0] pc_Mhl;
+  reg  [31:0] branch_targ_Mhl;
+  reg   [2:0] ras_tos_Mhl;
+  reg  [31:0] ras_top_Mhl;
+  reg  [31:0] execute_mux_out_Mhl;
+  reg  [31:0] wdata_Mhl;
+
+  always @ (posedge clk) begin
+    if( !stall_Mhl ) begin
+      pc_Mhl              <= pc_Xhl;
+      branch_targ_Mhl     <= branch_targ_Xhl;
+      ras_tos_Mhl         <= ras_tos_Xhl;
+      ras_top_Mhl         <= ras_top_Xhl;
+      wdata_Mhl           <= wdata_Xhl;
+    end
+  end
+
+  //----------------------------------------------------------------------
+  // Memory Stage
+  //----------------------------------------------------------------------
+
+  // Data memory subword adjustment mux
+
+  wire [31:0] dmemresp_lb_Mhl
+    = { {24{dmemresp_msg_data[7]}}, dmemresp_msg_data[7:0] };
+
+  wire [31:0] dmemresp_lbu_Mhl
+    = { {24{1'b0}}, dmemresp_msg_data[7:0] };
+
+  wire [31:0] dmemresp_lh_Mhl
+    = { {16{dmemresp_msg_data[15]}}, dmemresp_msg_data[15:0] };
+
+  wire [31:0] dmemresp_lhu_Mhl
+    = { {16{1'b0}}, dmemresp_msg_data[15:0] };
+
+  wire [31:0] dmemresp_mux_out_Mhl
+    = ( dmemresp_mux_sel_Mhl == 3'd0 ) ? dmemresp_msg_data
+    : ( dmemresp_mux_sel_Mhl == 3'd1 ) ? dmemresp_lb_Mhl
+    : ( dmemresp_mux_sel_Mhl == 3'd2 ) ? dmemresp_lbu_Mhl
+    : ( dmemresp_mux_sel_Mhl == 3'd3 ) ? dmemresp_lh_Mhl
+    : ( dmemresp_mux_sel_Mhl == 3'd4 ) ? dmemresp_lhu_Mhl
+    :                                    32'bx;
+
+  //----------------------------------------------------------------------
+  // Queue for data memory response
+  //----------------------------------------------------------------------
+
+  reg [31:0] dmemresp_queue_reg_Mhl;
+
+  always @ ( posedge clk ) begin
+    if ( dmemresp_queue_en_Mhl ) begin
+      dmemresp_queue_reg_Mhl <= dmemresp_mux_out_Mhl;
+    end
+  end
+
+  //----------------------------------------------------------------------
+  // Data memory queue mux
+  //----------------------------------------------------------------------
+
+  wire [31:0] dmemresp_queue_mux_out_Mhl
+    = ( !dmemresp_queue_val_Mhl ) ? dmemresp_mux_out_Mhl
+    : ( dmemresp_queue_val_Mhl )  ? dmemresp_queue_reg_Mhl
+    :                               32'bx;
+
+  //----------------------------------------------------------------------
+  // X2 <- M
+  //----------------------------------------------------------------------
+
+  reg [31:0] pc_X2hl;
+  reg [31:0] branch_targ_X2hl;
+  reg  [2:0] ras_tos_X2hl;
+  reg [31:0] ras_top_X2hl;
+  
+  always @(posedge clk) begin
+    pc_X2hl          <= pc_Mhl;
+    branch_targ_X2hl <= branch_targ_Mhl;
+    ras_tos_X2hl     <= ras_tos_Mhl;
+    ras_top_X2hl     <= ras_top_Mhl;
+  end
+
+  //----------------------------------------------------------------------
+  // X3 <- X2 
+  //----------------------------------------------------------------------
+
+  reg [31:0] pc_X3hl;
+  reg [31:0] branch_targ_X3hl;
+  reg  [2:0] ras_tos_X3hl;
+  reg [31:0] ras_top_X3hl;
+  
+  always @(posedge clk) begin
+    pc_X3hl          <= pc_X2hl;
+    branch_targ_X3hl <= branch_targ_X2hl;
+    ras_tos_X3hl     <= ras_tos_X2hl;
+    ras_top_X3hl     <= ras_top_X2hl;
+  end
+
+  //----------------------------------------------------------------------
+  // W <- M
+  //----------------------------------------------------------------------
+
+  reg  [31:0] pc_Whl;
+  reg  [31:0] branch_targ_Whl;
+  reg   [2:0] ras_tos_Whl;
+  reg  [31:0] ras_top_Whl;
+  reg  [31:0] wb_mux_out_Whl;
+
+  reg  [31:0] next_pc_Whl;
+  reg  [31:0] next_wb_mux_out_Whl;
+
+  always @(*) begin
+    case(wb_mux_sel_Whl)
+    2'd1: begin
+      next_pc_Whl                 = pc_Xhl;
+      next_wb_mux_out_Whl         = execute_mux_out_Xhl;
+    end
+    2'd2: begin
+      next_pc_Whl                 = pc_Mhl;
+      next_wb_mux_out_Whl         = dmemresp_queue_mux_out_Mhl;
+    end
+    2'd3: begin
+      next_pc_Whl                 = pc_X3hl;
+      next_wb_mux_out_Whl         = muldiv_mux_out_X3hl;
+    end
+    default: begin
+      next_pc_Whl                 = 32'b0;
+      next_wb_mux_out_Whl         = 32'b0;
+    end
+    endcase
+  end
+
+  always @(posedge clk) begin
+    if( !stall_Whl ) begin
+      pc_Whl          <= next_pc_Whl;
+      branch_targ_Whl <= branch_targ_X3hl;
+      ras_tos_Whl     <= ras_tos_X3hl;
+      ras_top_Whl     <= ras_top_X3hl;
+      wb_mux_out_Whl  <= next_wb_mux_out_Whl;
+    end
+  end
+
+  //----------------------------------------------------------------------
+  // Writeback Stage
+  //----------------------------------------------------------------------
+
+  // CP0 write data
+
+  assign proc2cop_data_Whl = wb_mux_out_Whl;
+
+  // Fall-through of a speculative branch
+
+  wire [31:0] pc_plus4_Whl = pc_Whl + 32'd4;
+
+  // Speculative branches come down the muldiv lane and compare their
+  // sources here, by which time every older write has reached the
+  // register file
+
+  wire [31:0] br_rdata0_Whl;
+  wire [31:0] br_rdata1_Whl;
+
+  assign branch_cond_eq_Whl    = ( br_rdata0_Whl == br_rdata1_Whl );
+  assign branch_cond_zero_Whl  = ( br_rdata0_Whl == 32'd0 );
+  assign branch_cond_neg_Whl   = ( br_rdata0_Whl[31] == 1'b1 );
+
+  // Results are written to their physical register as soon as they are
+  // ready; the ROB only decides when the architectural mapping moves
+
+  parc_CoreDpathRegfile rfile
+  (
+    .clk     (clk),
+    .raddr0  (rf_raddr0_Dhl),
+    .rdata0  (rf_rdata0_Dhl),
+    .raddr1  (rf_raddr1_Dhl),
+    .rdata1  (rf_rdata1_Dhl),
+    .raddr2  (br_raddr0_Whl),
+    .rdata2  (br_rdata0_Whl),
+    .raddr3  (br_raddr1_Whl),
+    .rdata3  (br_rdata1_Whl),
+    .wen_p   (rf_wen_Whl),
+    .waddr_p (rf_waddr_Whl),
+    .wdata_p (wb_mux_out_Whl)
+  );
+
+  //----------------------------------------------------------------------
+  // Debug registers for instruction disassembly
+  //----------------------------------------------------------------------
+
+  reg [31:0] pc_debug;
+
+  always @ ( posedge clk ) begin
+    pc_debug <= pc_Whl;
+  end
+
+endmodule
+
+`endif
+
@@ -0,0 +1,60 @@
+//=========================================================================
+// 5-Stage PARC Register File
+//=========================================================================
+// 64 physical registers, mapped onto the architectural registers by
+// parc_CoreRenameTable. p0 holds r0 and always reads as zero. Ports 2
+// and 3 read the sources of a speculative branch as it resolves in W.
+
+`ifndef PARC_CORE_DPATH_REGFILE_V
+`define PARC_CORE_DPATH_REGFILE_V
+
+`include "vc-Regfiles.v"
+
+module parc_CoreDpathRegfile
+(
+  input         clk,
+  input  [ 5:0] raddr0,  // Read 0 address (combinational input)
+  output [31:0] rdata0,  // Read 0 data (combinational on raddr)
+  input  [ 5:0] raddr1,  // Read 1 address (combinational input)
+  output [31:0] rdata1,  // Read 1 data (combinational on raddr)
+  input  [ 5:0] raddr2,  // Read 2 address (combinational input)
+  output [31:0] rdata2,  // Read 2 data (combinational on raddr)
+  input  [ 5:0] raddr3,  // Read 3 address (combinational input)
+  output [31:0] rdata3,  // Read 3 data (combinational on raddr)
+  input         wen_p,   // Write enable (sample on rising clk edge)
+  input  [ 5:0] waddr_p, // Write address (sample on rising clk edge)
+  input  [31:0] wdata_p  // Write data (sample on rising clk edge)
+);
+
+  wire [31:0] regs_rdata0;
+  wire [31:0] regs_rdata1;
+  wire [31:0] regs_rdata2;
+  wire [31:0] regs_rdata3;
+
+  vc_Regfile_1w4r_pf#(32,64,6) regs
+  (
+    .clk     (clk),
+    .raddr0  (raddr0),
+    .rdata0  (regs_rdata0),
+    .raddr1  (raddr1),
+    .rdata1  (regs_rdata1),
+    .raddr2  (raddr2),
+    .rdata2  (regs_rdata2),
+    .raddr3  (raddr3),
+    .rdata3  (regs_rdata3),
+    .wen_p   (wen_p && (waddr_p != 6'b0)),
+    .waddr_p (waddr_p),
+    .wdata_p (wdata_p)
+  );
+
+  // p0 is never written, so reads of it are forced to zero here
+
+  assign rdata0 = ( raddr0 == 0 ) ? 32'b0 : regs_rdata0;
+  assign rdata1 = ( raddr1 == 0 ) ? 32'b0 : regs_rdata1;
+  assign rdata2 = ( raddr2 == 0 ) ? 32'b0 : regs_rdata2;
+  assign rdata3 = ( raddr3 == 0 ) ? 32'b0 : regs_rdata3;
+
+endmodule
+
+`endif
+
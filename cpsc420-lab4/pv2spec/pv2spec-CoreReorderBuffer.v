@@ -0,0 +1,160 @@
+//=========================================================================
+// 5-Stage PARC Reorder Buffer
+//=========================================================================
+// A 16-entry circular buffer of register writes, speculative branches
+// and buffered stores, allocated in program order in decode, filled out
+// of order in writeback and committed in order, one per cycle, from the
+// head. The write data is already in the physical register file by
+// then; a slot only holds its valid/ready bits and, for a register
+// write, the destination's architectural register, its physical
+// register and the physical register it replaced, which commit returns
+// to the free list.
+//
+// A speculative branch holds a slot so nothing younger can commit before
+// it resolves. If it was mispredicted, rob_squash_val drops every slot
+// allocated after it by moving the tail back to rob_squash_tail.
+//
+// A store or mtc0 issued while a speculative branch is in flight also
+// holds a slot, with rob_alloc_req_st set, and only takes effect when it
+// commits. Its slot waits at the head until rob_commit_st_rdy says the
+// memory port or CP0 is free for it. rob_st_busy says whether any
+// allocated slot is such a buffered store.
+
+`ifndef PARC_CORE_REORDERBUFFER_V
+`define PARC_CORE_REORDERBUFFER_V
+
+module parc_CoreReorderBuffer
+(
+  input         clk,
+  input         reset,
+
+  input         rob_alloc_req_val,
+  output        rob_alloc_req_rdy,
+  input         rob_alloc_req_wen,
+  input  [ 4:0] rob_alloc_req_areg,
+  input  [ 5:0] rob_alloc_req_preg,
+  input  [ 5:0] rob_alloc_req_old_preg,
+  input         rob_alloc_req_st,
+
+  output [ 3:0] rob_alloc_resp_slot,
+
+  input         rob_fill_val,
+  input  [ 3:0] rob_fill_slot,
+
+  input         rob_squash_val,
+  input  [ 3:0] rob_squash_tail,
+
+  output        rob_commit_wen,
+  output [ 3:0] rob_commit_slot,
+  output [ 4:0] rob_commit_areg,
+  output [ 5:0] rob_commit_preg,
+  output [ 5:0] rob_commit_old_preg,
+  output        rob_commit_st,
+  input         rob_commit_st_rdy,
+
+  output        rob_st_busy
+);
+
+  reg        valid    [15:0];  // Slot allocated and not yet committed
+  reg        ready    [15:0];  // Slot has been filled in writeback
+  reg        wen      [15:0];  // Slot writes a register
+  reg  [4:0] areg     [15:0];  // Destination architectural register
+  reg  [5:0] preg     [15:0];  // Destination physical register
+  reg  [5:0] old_preg [15:0];  // Physical register areg mapped to before
+  reg        st       [15:0];  // Slot commits a store or mtc0
+
+  // Pointers carry a wrap bit so a full buffer can be told from an
+  // empty one
+
+  reg  [4:0] head;             // Oldest allocated slot
+  reg  [4:0] tail;             // Next slot to allocate
+
+  wire [4:0] count = tail - head;
+
+  // Commit the head once it has been filled, and for a store or mtc0
+  // once it may go ahead
+
+  wire   head_rdy            = valid[head[3:0]] && ready[head[3:0]];
+  wire   commit              = head_rdy && ( !st[head[3:0]] || rob_commit_st_rdy );
+
+  assign rob_commit_wen      = commit && wen[head[3:0]];
+  assign rob_commit_slot     = head[3:0];
+  assign rob_commit_areg     = areg[head[3:0]];
+  assign rob_commit_preg     = preg[head[3:0]];
+  assign rob_commit_old_preg = old_preg[head[3:0]];
+  assign rob_commit_st       = head_rdy && st[head[3:0]];
+
+  // Allocate at the tail. A full buffer can still allocate in a cycle
+  // where the head commits, since that frees the slot being reused.
+
+  assign rob_alloc_req_rdy   = ( count != 5'd16 ) || commit;
+  assign rob_alloc_resp_slot = tail[3:0];
+
+  wire alloc = rob_alloc_req_val && rob_alloc_req_rdy;
+
+  // Slots from the squash point up to the tail are dropped. The squash
+  // point is always at or after the head, since the branch that
+  // squashes is itself still in the buffer.
+
+  wire [3:0] squash_num  = tail[3:0] - rob_squash_tail;
+  wire [4:0] squash_tail = tail - { 1'b0, squash_num };
+
+  always @(posedge clk) begin
+    if (reset) begin
+      head  <= 5'b0;
+      tail  <= 5'b0;
+    end else begin
+      if (rob_squash_val)
+        tail <= squash_tail;
+      else if (alloc)
+        tail <= tail + 1'b1;
+      if (commit)
+        head <= head + 1'b1;
+    end
+  end
+
+  wire [15:0] st_busy;
+
+  assign rob_st_busy = ( st_busy != 16'b0 );
+
+  genvar s;
+  generate
+  for( s = 0; s < 16; s = s + 1)
+  begin: rob_entry
+
+    assign st_busy[s] = valid[s] && st[s];
+
+    // Distance from the squash point, in allocation order
+
+    wire [3:0] squash_dist = s - rob_squash_tail;
+    wire       squash      = rob_squash_val && ( squash_dist < squash_num );
+
+    always @(posedge clk) begin
+      if (reset) begin
+        valid[s] <= 1'b0;
+        ready[s] <= 1'b0;
+      end else if (squash) begin
+        valid[s] <= 1'b0;
+        ready[s] <= 1'b0;
+      end else if ( alloc && (s == tail[3:0]) ) begin
+        valid[s]    <= 1'b1;
+        ready[s]    <= 1'b0;
+        wen[s]      <= rob_alloc_req_wen;
+        areg[s]     <= rob_alloc_req_areg;
+        preg[s]     <= rob_alloc_req_preg;
+        old_preg[s] <= rob_alloc_req_old_preg;
+        st[s]       <= rob_alloc_req_st;
+      end else if ( commit && (s == head[3:0]) ) begin
+        valid[s] <= 1'b0;
+        ready[s] <= 1'b0;
+      end else if ( rob_fill_val && (s == rob_fill_slot) ) begin
+        ready[s] <= 1'b1;
+      end
+    end
+  end
+  endgenerate
+
+endmodule
+
+`endif
+
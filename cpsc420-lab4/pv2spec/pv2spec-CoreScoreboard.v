@@ -0,0 +1,141 @@
+//=========================================================================
+// 5-Stage PARC Scoreboard
+//=========================================================================
+// Tracks the physical registers handed out by parc_CoreRenameTable. A
+// physical register is pending from rename until its value is written
+// to the physical register file in writeback; until then a reader is
+// bypassed from the functional unit or the writeback stage. Since every
+// write gets a fresh physical register, there are no WAW or WAR hazards
+// to check here.
+//
+// A conditional branch whose sources are not ready yet does not wait for
+// them: with src_spec set it issues anyway and reads its sources later,
+// as it resolves in writeback. src_rdy tells decode which case it is.
+//
+// There is only one writeback stage. Which unit gets it is decided in
+// the control unit each cycle, and a unit that loses holds its
+// instruction like any other stall, so this only has to follow the
+// stalls of the stages an instruction can be held in.
+
+`ifndef PARC_CORE_SCOREBOARD_V
+`define PARC_CORE_SCOREBOARD_V
+
+`define FUNC_UNIT_ALU 1
+`define FUNC_UNIT_MEM 2
+`define FUNC_UNIT_MUL 3
+
+module parc_CoreScoreboard
+(
+  input         clk,
+  input         reset,
+  input  [ 5:0] src0,             // Source physical register 0
+  input         src0_en,          // Use source register 0
+  input  [ 5:0] src1,             // Source physical register 1
+  input         src1_en,          // Use source register 1
+  input  [ 5:0] dst,              // Destination physical register
+  input         dst_en,           // Write to destination register
+  input  [ 2:0] func_unit,        // Functional Unit
+  input  [ 4:0] latency,          // Instruction latency (one-hot)
+  input         inst_val_Dhl,     // Instruction valid
+  input         src_spec,         // May issue before sources are ready
+
+  input         alloc_rdy,        // ROB slot and physical reg free
+
+  input         stall_Xhl,        // X stage stalled
+  input         stall_Mhl,        // M stage stalled
+
+  output [ 2:0] src0_byp_mux_sel, // Source reg 0 byp mux
+  output [ 2:0] src1_byp_mux_sel, // Source reg 1 byp mux
+
+  output        src_rdy,          // Both sources can be read or bypassed
+  output        stall_hazard      // Destination register ready
+);
+
+  reg       pending          [63:0];
+  reg [2:0] functional_unit  [63:0];
+  reg [4:0] reg_latency      [63:0];
+
+  // Check if src registers are ready
+
+  wire src0_can_byp = pending[src0] && (reg_latency[src0] < 5'b00100);
+  wire src1_can_byp = pending[src1] && (reg_latency[src1] < 5'b00100);
+
+  wire src0_ok = !pending[src0] || src0_can_byp || !src0_en;
+  wire src1_ok = !pending[src1] || src1_can_byp || !src1_en;
+
+  assign src_rdy = src0_ok && src1_ok;
+
+  reg [2:0] src0_byp_mux_sel;
+  reg [2:0] src1_byp_mux_sel;
+
+  always @(*) begin
+    if (!pending[src0] || src0 == 6'b0)
+      src0_byp_mux_sel = 3'b0;
+    else if (reg_latency[src0] == 5'b00001)
+      src0_byp_mux_sel = 3'd4;
+    else
+      src0_byp_mux_sel = functional_unit[src0];
+  end
+
+  always @(*) begin
+    if (!pending[src1] || src1 == 6'b0)
+      src1_byp_mux_sel = 3'b0;
+    else if (reg_latency[src1] == 5'b00001)
+      src1_byp_mux_sel = 3'd4;
+    else
+      src1_byp_mux_sel = functional_unit[src1];
+  end
+
+  // Check for hazards
+
+  wire accept = ( src_rdy || src_spec ) && inst_val_Dhl;
+
+  wire stall_hazard = ~accept;
+
+  // The instruction only leaves decode if X is not stalled and it got a
+  // ROB slot and a physical register; until then it must not show up as
+  // pending, or it would bypass its own result to itself
+
+  wire issue = accept && !stall_Xhl && alloc_rdy;
+
+  // Advance one cycle. The latency is one-hot in the number of cycles
+  // left until writeback, so which stage an instruction is in follows
+  // from its functional unit; it holds while that stage is stalled.
+
+  wire [4:0] latency_next [63:0];
+
+  genvar r;
+  generate
+  for( r = 0; r < 64; r = r + 1)
+  begin: sb_entry
+    wire in_X = ( functional_unit[r] == `FUNC_UNIT_ALU ) ? reg_latency[r][1]
+              : ( functional_unit[r] == `FUNC_UNIT_MEM ) ? reg_latency[r][2]
+              :                                            reg_latency[r][4];
+    wire in_M = ( functional_unit[r] == `FUNC_UNIT_MEM ) ? reg_latency[r][1]
+              : ( functional_unit[r] == `FUNC_UNIT_MUL ) ? reg_latency[r][3]
+              :                                            1'b0;
+
+    wire hold = ( in_X && stall_Xhl ) || ( in_M && stall_Mhl );
+
+    assign latency_next[r] = hold ? reg_latency[r] : ( reg_latency[r] >> 1 );
+
+    always @(posedge clk) begin
+      if (reset) begin
+        reg_latency[r]     <= 5'b0;
+        pending[r]         <= 1'b0;
+        functional_unit[r] <= 3'b0;
+      end else if ( issue && dst_en && (r == dst) ) begin
+        reg_latency[r]     <= latency;
+        pending[r]         <= 1'b1;
+        functional_unit[r] <= func_unit;
+      end else begin
+        reg_latency[r]     <= latency_next[r];
+        pending[r]         <= pending[r] && ( latency_next[r] != 5'b0 );
+      end
+    end
+  end
+  endgenerate
+
+endmodule
+
+`endif
@@ -120,6 +120,208 @@ module tester;
   end
   `VC_TEST_CASE_END
 
-  `VC_TEST_SUITE_END( 1 )
+  //----------------------------------------------------------------------
+  // Test vc_Regfile_1w4r_pf
+  //----------------------------------------------------------------------
+
+  localparam T2_DATA_SZ = 8;
+  localparam T2_ENTRIES = 4;
+  localparam T2_ADDR_SZ = 2;
+
+  reg  [T2_ADDR_SZ-1:0] t2_raddr0;
+  wire [T2_DATA_SZ-1:0] t2_rdata0;
+  reg  [T2_ADDR_SZ-1:0] t2_raddr1;
+  wire [T2_DATA_SZ-1:0] t2_rdata1;
+  reg  [T2_ADDR_SZ-1:0] t2_raddr2;
+  wire [T2_DATA_SZ-1:0] t2_rdata2;
+  reg  [T2_ADDR_SZ-1:0] t2_raddr3;
+  wire [T2_DATA_SZ-1:0] t2_rdata3;
+  reg                   t2_wen = 0;
+  reg  [T2_ADDR_SZ-1:0] t2_waddr;
+  reg  [T2_DATA_SZ-1:0] t2_wdata;
+
+  vc_Regfile_1w4r_pf#(T2_DATA_SZ,T2_ENTRIES,T2_ADDR_SZ) t2_regfile
+  (
+    .clk     (clk),
+    .raddr0  (t2_raddr0),
+    .rdata0  (t2_rdata0),
+    .raddr1  (t2_raddr1),
+    .rdata1  (t2_rdata1),
+    .raddr2  (t2_raddr2),
+    .rdata2  (t2_rdata2),
+    .raddr3  (t2_raddr3),
+    .rdata3  (t2_rdata3),
+    .wen_p   (t2_wen),
+    .waddr_p (t2_waddr),
+    .wdata_p (t2_wdata)
+  );
+
+  // Helper task
+
+  task t2_do_test
+  (
+    input [22*8-1:0]       test_case_str,
+    input [T2_ADDR_SZ-1:0] tst_raddr0,
+    input [T2_DATA_SZ-1:0] tst_rdata0,
+    input [T2_ADDR_SZ-1:0] tst_raddr1,
+    input [T2_DATA_SZ-1:0] tst_rdata1,
+    input [T2_ADDR_SZ-1:0] tst_raddr2,
+    input [T2_DATA_SZ-1:0] tst_rdata2,
+    input [T2_ADDR_SZ-1:0] tst_raddr3,
+    input [T2_DATA_SZ-1:0] tst_rdata3,
+    input                  tst_wen,
+    input [T2_ADDR_SZ-1:0] tst_waddr,
+    input [T2_DATA_SZ-1:0] tst_wdata
+  );
+  begin
+    t2_raddr0 = tst_raddr0;
+    t2_raddr1 = tst_raddr1;
+    t2_raddr2 = tst_raddr2;
+    t2_raddr3 = tst_raddr3;
+    t2_wen    = tst_wen;
+    t2_waddr  = tst_waddr;
+    t2_wdata  = tst_wdata;
+    #1;
+    `VC_TEST_NOTE( test_case_str )
+    `VC_TEST_EQ4( "rdata", t2_rdata0, tst_rdata0, t2_rdata1, tst_rdata1,
+                           t2_rdata2, tst_rdata2, t2_rdata3, tst_rdata3 )
+    #9;
+  end
+  endtask
+
+  // Actual test case
+
+  `VC_TEST_CASE_BEGIN( 2, "vc_Regfile_1w4r_pf" )
+  begin
+
+    #1;
+
+    //                                    ---------------- read ----------------  --- write ---
+    //                                    addr data addr data addr data addr data wen addr data
+
+    t2_do_test( "           | write 0 aa", 'hx, 'h??, 'hx, 'h??, 'hx, 'h??, 'hx, 'h??, 1,  0,  'haa );
+    t2_do_test( "           | write 1 bb", 'hx, 'h??, 'hx, 'h??, 'hx, 'h??, 'hx, 'h??, 1,  1,  'hbb );
+    t2_do_test( "           | write 2 cc", 'hx, 'h??, 'hx, 'h??, 'hx, 'h??, 'hx, 'h??, 1,  2,  'hcc );
+    t2_do_test( "           | write 3 dd", 'hx, 'h??, 'hx, 'h??, 'hx, 'h??, 'hx, 'h??, 1,  3,  'hdd );
+
+    // Every port reads a different entry, then all read the same one
+
+    t2_do_test( "read 0123  |           ",  0,  'haa,  1,  'hbb,  2,  'hcc,  3,  'hdd, 0, 'hx, 'hxx );
+    t2_do_test( "read 3210  |           ",  3,  'hdd,  2,  'hcc,  1,  'hbb,  0,  'haa, 0, 'hx, 'hxx );
+    t2_do_test( "read 2222  |           ",  2,  'hcc,  2,  'hcc,  2,  'hcc,  2,  'hcc, 0, 'hx, 'hxx );
+
+    // Concurrent read/write: reads see the old value until the edge
+
+    t2_do_test( "read 1111  | write 1 1b",  1,  'hbb,  1,  'hbb,  1,  'hbb,  1,  'hbb, 1,  1,  'h1b );
+    t2_do_test( "read 1032  | write 3 3d",  1,  'h1b,  0,  'haa,  3,  'hdd,  2,  'hcc, 1,  3,  'h3d );
+    t2_do_test( "read 3333  |           ",  3,  'h3d,  3,  'h3d,  3,  'h3d,  3,  'h3d, 0, 'hx, 'hxx );
+
+  end
+  `VC_TEST_CASE_END
+
+  //----------------------------------------------------------------------
+  // Test vc_Regfile_3w2r_pf
+  //----------------------------------------------------------------------
+
+  localparam T3_DATA_SZ = 8;
+  localparam T3_ENTRIES = 4;
+  localparam T3_ADDR_SZ = 2;
+
+  reg  [T3_ADDR_SZ-1:0] t3_raddr0;
+  wire [T3_DATA_SZ-1:0] t3_rdata0;
+  reg  [T3_ADDR_SZ-1:0] t3_raddr1;
+  wire [T3_DATA_SZ-1:0] t3_rdata1;
+  reg                   t3_wen0 = 0;
+  reg  [T3_ADDR_SZ-1:0] t3_waddr0;
+  reg  [T3_DATA_SZ-1:0] t3_wdata0;
+  reg                   t3_wen1 = 0;
+  reg  [T3_ADDR_SZ-1:0] t3_waddr1;
+  reg  [T3_DATA_SZ-1:0] t3_wdata1;
+  reg                   t3_wen2 = 0;
+  reg  [T3_ADDR_SZ-1:0] t3_waddr2;
+  reg  [T3_DATA_SZ-1:0] t3_wdata2;
+
+  vc_Regfile_3w2r_pf#(T3_DATA_SZ,T3_ENTRIES,T3_ADDR_SZ) t3_regfile
+  (
+    .clk      (clk),
+    .raddr0   (t3_raddr0),
+    .rdata0   (t3_rdata0),
+    .raddr1   (t3_raddr1),
+    .rdata1   (t3_rdata1),
+    .wen0_p   (t3_wen0),
+    .waddr0_p (t3_waddr0),
+    .wdata0_p (t3_wdata0),
+    .wen1_p   (t3_wen1),
+    .waddr1_p (t3_waddr1),
+    .wdata1_p (t3_wdata1),
+    .wen2_p   (t3_wen2),
+    .waddr2_p (t3_waddr2),
+    .wdata2_p (t3_wdata2)
+  );
+
+  // Helper task
+
+  task t3_do_test
+  (
+    input [22*8-1:0]       test_case_str,
+    input [T3_ADDR_SZ-1:0] tst_raddr0,
+    input [T3_DATA_SZ-1:0] tst_rdata0,
+    input [T3_ADDR_SZ-1:0] tst_raddr1,
+    input [T3_DATA_SZ-1:0] tst_rdata1,
+    input                  tst_wen0,
+    input [T3_ADDR_SZ-1:0] tst_waddr0,
+    input [T3_DATA_SZ-1:0] tst_wdata0,
+    input                  tst_wen1,
+    input [T3_ADDR_SZ-1:0] tst_waddr1,
+    input [T3_DATA_SZ-1:0] tst_wdata1,
+    input                  tst_wen2,
+    input [T3_ADDR_SZ-1:0] tst_waddr2,
+    input [T3_DATA_SZ-1:0] tst_wdata2
+  );
+  begin
+    t3_raddr0 = tst_raddr0;
+    t3_raddr1 = tst_raddr1;
+    t3_wen0   = tst_wen0;
+    t3_waddr0 = tst_waddr0;
+    t3_wdata0 = tst_wdata0;
+    t3_wen1   = tst_wen1;
+    t3_waddr1 = tst_waddr1;
+    t3_wdata1 = tst_wdata1;
+    t3_wen2   = tst_wen2;
+    t3_waddr2 = tst_waddr2;
+    t3_wdata2 = tst_wdata2;
+    #1;
+    `VC_TEST_NOTE( test_case_str )
+    `VC_TEST_EQ2( "rdata", t3_rdata0, tst_rdata0, t3_rdata1, tst_rdata1 )
+    #9;
+  end
+  endtask
+
+  // Actual test case
+
+  `VC_TEST_CASE_BEGIN( 3, "vc_Regfile_3w2r_pf" )
+  begin
+
+    #1;
+
+    //                                    ------ read ------  --- write 0 --- --- write 1 --- --- write 2 ---
+    //                                    addr data addr data wen addr data   wen addr data   wen addr data
+
+    t3_do_test( "     | w0 0 aa w1 1 bb", 'hx, 'h??, 'hx, 'h??, 1,  0, 'haa,  1,  1, 'hbb,  0, 'hx, 'hxx );
+    t3_do_test( "     | w2 2 cc w0 3 dd", 'hx, 'h??, 'hx, 'h??, 1,  3, 'hdd,  0, 'hx, 'hxx, 1,  2, 'hcc );
+    t3_do_test( "rd 01 |               ",  0,  'haa,  1,  'hbb, 0, 'hx, 'hxx,  0, 'hx, 'hxx, 0, 'hx, 'hxx );
+    t3_do_test( "rd 23 |               ",  2,  'hcc,  3,  'hdd, 0, 'hx, 'hxx,  0, 'hx, 'hxx, 0, 'hx, 'hxx );
+
+    // All three ports write different entries in one cycle, and reads
+    // see the old values until the edge
+
+    t3_do_test( "rd 12 | w 1b 2c 3d   ",  1,  'hbb,  2,  'hcc, 1,  1, 'h1b,  1,  2, 'h2c,  1,  3, 'h3d );
+    t3_do_test( "rd 12 |               ",  1,  'h1b,  2,  'h2c, 0, 'hx, 'hxx,  0, 'hx, 'hxx, 0, 'hx, 'hxx );
+    t3_do_test( "rd 30 |               ",  3,  'h3d,  0,  'haa, 0, 'hx, 'hxx,  0, 'hx, 'hxx, 0, 'hx, 'hxx );
+
+  end
+  `VC_TEST_CASE_END
+
+  `VC_TEST_SUITE_END( 3 )
 endmodule
 
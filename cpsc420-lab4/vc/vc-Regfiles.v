@@ -147,6 +147,94 @@ module vc_Regfile_1w2r_pf
 
 endmodule
 
+//------------------------------------------------------------------------
+// 1w4r register file using flip-flops
+//------------------------------------------------------------------------
+
+module vc_Regfile_1w4r_pf
+#(
+  parameter DATA_SZ = 1,
+  parameter ENTRIES = 2,
+  parameter ADDR_SZ = 1
+)(
+  input                clk,
+  input  [ADDR_SZ-1:0] raddr0,  // Read 0 address (combinational input)
+  output [DATA_SZ-1:0] rdata0,  // Read 0 data (combinational on raddr)
+  input  [ADDR_SZ-1:0] raddr1,  // Read 1 address (combinational input)
+  output [DATA_SZ-1:0] rdata1,  // Read 1 data (combinational on raddr)
+  input  [ADDR_SZ-1:0] raddr2,  // Read 2 address (combinational input)
+  output [DATA_SZ-1:0] rdata2,  // Read 2 data (combinational on raddr)
+  input  [ADDR_SZ-1:0] raddr3,  // Read 3 address (combinational input)
+  output [DATA_SZ-1:0] rdata3,  // Read 3 data (combinational on raddr)
+  input                wen_p,   // Write enable (sample on rising clk edge)
+  input  [ADDR_SZ-1:0] waddr_p, // Write addr (sample on rising clk edge)
+  input  [DATA_SZ-1:0] wdata_p  // Write data (sample on rising clk edge)
+);
+
+  reg [DATA_SZ-1:0] rfile[ENTRIES-1:0];
+
+  // Combinational read
+
+  assign rdata0 = rfile[raddr0];
+  assign rdata1 = rfile[raddr1];
+  assign rdata2 = rfile[raddr2];
+  assign rdata3 = rfile[raddr3];
+
+  // Write on positive clock edge
+
+  always @( posedge clk )
+    if ( wen_p )
+      rfile[waddr_p] <= wdata_p;
+
+endmodule
+
+//------------------------------------------------------------------------
+// 3w2r register file using flip-flops
+//------------------------------------------------------------------------
+// The write ports must never write the same entry in the same cycle.
+
+module vc_Regfile_3w2r_pf
+#(
+  parameter DATA_SZ = 1,
+  parameter ENTRIES = 2,
+  parameter ADDR_SZ = 1
+)(
+  input                clk,
+  input  [ADDR_SZ-1:0] raddr0,   // Read 0 address (combinational input)
+  output [DATA_SZ-1:0] rdata0,   // Read 0 data (combinational on raddr)
+  input  [ADDR_SZ-1:0] raddr1,   // Read 1 address (combinational input)
+  output [DATA_SZ-1:0] rdata1,   // Read 1 data (combinational on raddr)
+  input                wen0_p,   // Write 0 enable (sample on rising clk edge)
+  input  [ADDR_SZ-1:0] waddr0_p, // Write 0 addr (sample on rising clk edge)
+  input  [DATA_SZ-1:0] wdata0_p, // Write 0 data (sample on rising clk edge)
+  input                wen1_p,   // Write 1 enable (sample on rising clk edge)
+  input  [ADDR_SZ-1:0] waddr1_p, // Write 1 addr (sample on rising clk edge)
+  input  [DATA_SZ-1:0] wdata1_p, // Write 1 data (sample on rising clk edge)
+  input                wen2_p,   // Write 2 enable (sample on rising clk edge)
+  input  [ADDR_SZ-1:0] waddr2_p, // Write 2 addr (sample on rising clk edge)
+  input  [DATA_SZ-1:0] wdata2_p  // Write 2 data (sample on rising clk edge)
+);
+
+  reg [DATA_SZ-1:0] rfile[ENTRIES-1:0];
+
+  // Combinational read
+
+  assign rdata0 = rfile[raddr0];
+  assign rdata1 = rfile[raddr1];
+
+  // Write on positive clock edge
+
+  always @( posedge clk ) begin
+    if ( wen0_p )
+      rfile[waddr0_p] <= wdata0_p;
+    if ( wen1_p )
+      rfile[waddr1_p] <= wdata1_p;
+    if ( wen2_p )
+      rfile[waddr2_p] <= wdata2_p;
+  end
+
+endmodule
+
 //------------------------------------------------------------------------
 // 1w1r register file using level-high latches
 //------------------------------------------------------------------------